@@ -47,10 +47,12 @@ struct ChimeraTensorType {
 // Graph type (represents user-level graphs) 
 struct ChimeraGraphType {
  // Need definitions for Node/Edge types, potentially recursive ChimeraType 
-// Placeholder for now 
+// Stored in memory as CSR offsets/targets arrays of index_type (UINT32 or UINT64) for
+// GRAPH_TRAVERSE; an undirected graph lists every edge both ways
 std::string node_type_name; 
 std::string edge_type_name; 
 bool directed = true; 
+BDIType index_type = BDIType::UINT32; 
 bool operator==(const ChimeraGraphType&) const = default; 
 }; 
 // Memory Region handle type 
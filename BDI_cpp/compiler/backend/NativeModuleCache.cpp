@@ -0,0 +1,194 @@
+#include "NativeModuleCache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <filesystem>
+#include <fstream>
+#include <spawn.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+namespace chimera::backend {
+namespace fs = std::filesystem;
+namespace {
+const char* const CC_FLAGS[] = {"-std=c99", "-O2", "-fwrapv", "-fPIC", "-shared"};
+std::string compilerPath() {
+    const char* cc_env = std::getenv("CC");
+    return (cc_env && *cc_env) ? cc_env : "cc";
+}
+// FNV-1a over the bytes of 'v', as BDIGraph::computeContentHash
+void mix(uint64_t& key, uint64_t v) {
+    for (int i = 0; i < 8; ++i) { key ^= (v >> (i * 8)) & 0xFF; key *= 0x100000001b3ULL; }
+}
+void mix(uint64_t& key, const std::string& s) {
+    mix(key, s.size());
+    for (unsigned char c : s) { key ^= c; key *= 0x100000001b3ULL; }
+}
+// Anything that changes the object built for a graph: emitter, compiler and flags
+uint64_t toolchainKey(uint64_t content_hash) {
+    uint64_t key = content_hash;
+    mix(key, BDIToC::EMITTER_VERSION);
+    mix(key, compilerPath());
+    for (const char* flag : CC_FLAGS) mix(key, std::string(flag));
+    return key;
+}
+// Per-user default: $XDG_CACHE_HOME/bdi, then ~/.cache/bdi, then a uid-suffixed temp dir
+std::string defaultCacheDir() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg == '/') return (fs::path(xdg) / "bdi").string();
+    const char* home = std::getenv("HOME");
+    if (home && *home == '/') return (fs::path(home) / ".cache" / "bdi").string();
+    std::error_code ec;
+    fs::path tmp = fs::temp_directory_path(ec);
+    return ((ec ? fs::path("/tmp") : tmp) / ("bdi_aot_cache_" + std::to_string(::geteuid()))).string();
+}
+// Objects in the cache are dlopen'ed, so only trust a directory or file (not a symlink)
+// that this user owns and nobody else can write
+bool ownedPrivately(const std::string& path, bool directory) {
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0) return false;
+    if (directory ? !S_ISDIR(st.st_mode) : !S_ISREG(st.st_mode)) return false;
+    return st.st_uid == ::geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+// Tells apart concurrent builds within this process; the pid does so across processes
+std::atomic<uint64_t> build_serial{0};
+} // namespace
+// --- NativeModule ---
+NativeModule::NativeModule(void* handle, uint64_t key, std::vector<NativeEntry> entries)
+    : handle_(handle), key_(key), entries_(std::move(entries)) {}
+NativeModule::~NativeModule() {
+    if (handle_) dlclose(handle_);
+}
+const NativeEntry* NativeModule::findEntry(NodeID entry_node_id) const {
+    for (const auto& entry : entries_) {
+        if (entry.entry_node_id == entry_node_id) return &entry;
+    }
+    return nullptr;
+}
+// --- NativeModuleCache ---
+NativeModuleCache::NativeModuleCache(std::string cache_dir) : cache_dir_(std::move(cache_dir)) {
+    if (cache_dir_.empty()) cache_dir_ = defaultCacheDir();
+}
+std::shared_ptr<NativeModule> NativeModuleCache::getOrCompile(const BDIGraph& graph) {
+    const uint64_t key = toolchainKey(graph.computeContentHash());
+    if (auto module = find(key)) return module;
+    BDIToC emitter;
+    auto emitted = emitter.convertGraph(graph);
+    return build(key, emitted, emitter.getLastError());
+}
+std::shared_ptr<NativeModule> NativeModuleCache::getOrCompile(const BDIGraph& graph,
+                                                              const std::vector<NodeID>& entries,
+                                                              const std::unordered_set<NodeID>& partition) {
+    // Mix entries and (sorted) partition members into the key
+    uint64_t key = toolchainKey(graph.computeContentHash());
+    std::vector<NodeID> members(partition.begin(), partition.end());
+    std::sort(members.begin(), members.end());
+    mix(key, entries.size());
+    for (NodeID id : entries) mix(key, id);
+    mix(key, members.size());
+    for (NodeID id : members) mix(key, id);
+    if (auto module = find(key)) return module;
+    BDIToC emitter;
+    auto emitted = emitter.convertPartition(graph, entries, partition);
+    return build(key, emitted, emitter.getLastError());
+}
+std::shared_ptr<NativeModule> NativeModuleCache::find(uint64_t key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = modules_.find(key);
+    return it != modules_.end() ? it->second : nullptr;
+}
+std::shared_ptr<NativeModule> NativeModuleCache::build(uint64_t key, const std::optional<CEmitResult>& emitted, const std::string& emit_error) {
+    if (!emitted) return fail("C emission failed: " + emit_error);
+    std::error_code ec;
+    fs::create_directories(fs::path(cache_dir_).parent_path(), ec);
+    ::mkdir(cache_dir_.c_str(), 0700); // EEXIST is fine; the ownership check decides
+    if (!ownedPrivately(cache_dir_, true)) return fail("cache directory " + cache_dir_ + " is not private to this user");
+    std::ostringstream name;
+    name << "bdi_" << std::hex << key;
+    const std::string base = (fs::path(cache_dir_) / name.str()).string();
+    const std::string so_path = base + ".so";
+    // Emission is deterministic, so an existing object for this key is reused as-is.
+    // The source is still regenerated above to recover entry and live-in/out metadata.
+    // Concurrent builders of one key each compile a private object and rename it into
+    // place; whichever rename lands last wins, and both are identical.
+    if (!fs::exists(so_path)) {
+        const std::string tmp_base = base + "." + std::to_string(::getpid()) + "." + std::to_string(build_serial.fetch_add(1));
+        const std::string c_path = tmp_base + ".c";
+        std::ofstream c_file(c_path, std::ios::trunc);
+        if (!c_file) return fail("cannot write " + c_path);
+        c_file << emitted->source;
+        c_file.close();
+        const bool compiled = compile(c_path, tmp_base + ".so");
+        if (compiled) fs::rename(tmp_base + ".so", so_path, ec);
+        fs::rename(c_path, base + ".c", ec); // Kept next to the object for inspection
+        if (!compiled) return nullptr;
+        if (!fs::exists(so_path)) return fail("cannot install " + so_path);
+    }
+    if (!ownedPrivately(so_path, false)) return fail("refusing to load " + so_path + ": not private to this user");
+    void* handle = dlopen(so_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* err = dlerror();
+        return fail(std::string("dlopen failed: ") + (err ? err : "unknown"));
+    }
+    std::vector<NativeEntry> entries;
+    for (const auto& info : emitted->entries) {
+        void* sym = dlsym(handle, info.symbol.c_str());
+        if (!sym) {
+            dlclose(handle);
+            return fail("missing symbol " + info.symbol + " in " + so_path);
+        }
+        entries.push_back({info.entry_node_id, reinterpret_cast<BDIAotEntryFn>(sym), info.live_ins, info.live_outs});
+    }
+    auto module = std::make_shared<NativeModule>(handle, key, std::move(entries));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return modules_.emplace(key, std::move(module)).first->second; // Another builder may have published first
+}
+bool NativeModuleCache::compile(const std::string& c_path, const std::string& so_path) {
+    std::vector<std::string> args = {compilerPath()};
+    args.insert(args.end(), std::begin(CC_FLAGS), std::end(CC_FLAGS));
+    args.insert(args.end(), {"-o", so_path, c_path, "-lm"});
+    std::vector<char*> argv;
+    for (std::string& arg : args) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    std::string command;
+    for (const std::string& arg : args) command += (command.empty() ? "" : " ") + arg;
+    pid_t pid = 0;
+    const int spawned = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+    if (spawned != 0) {
+        fail("cannot run " + args[0] + ": " + std::strerror(spawned));
+        return false;
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            fail("lost native compile: " + command);
+            return false;
+        }
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::error_code ec;
+        fs::remove(so_path, ec);
+        fail("native compile failed: " + command);
+        return false;
+    }
+    return true;
+}
+std::shared_ptr<NativeModule> NativeModuleCache::fail(std::string message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_error_ = std::move(message);
+    return nullptr;
+}
+void NativeModuleCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    modules_.clear();
+}
+std::string NativeModuleCache::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
+} // namespace chimera::backend
@@ -0,0 +1,65 @@
+#ifndef CHIMERA_BACKEND_NATIVEMODULECACHE_HPP
+#define CHIMERA_BACKEND_NATIVEMODULECACHE_HPP
+#include "BDIToC.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace chimera::backend {
+// One callable entry of a loaded native module
+struct NativeEntry {
+    NodeID entry_node_id = 0;
+    BDIAotEntryFn fn = nullptr;
+    std::vector<PortRef> live_ins;
+    std::vector<PortRef> live_outs;
+};
+// A dlopen'ed shared object produced from emitted C. Unloaded on destruction.
+class NativeModule {
+public:
+    NativeModule(void* handle, uint64_t key, std::vector<NativeEntry> entries);
+    ~NativeModule();
+    NativeModule(const NativeModule&) = delete;
+    NativeModule& operator=(const NativeModule&) = delete;
+    uint64_t getKey() const { return key_; }
+    const std::vector<NativeEntry>& getEntries() const { return entries_; }
+    const NativeEntry* findEntry(NodeID entry_node_id) const;
+private:
+    void* handle_ = nullptr;
+    uint64_t key_ = 0;
+    std::vector<NativeEntry> entries_;
+};
+// Ahead-of-time compilation cache. Graphs are emitted as C, compiled with the system
+// compiler ($CC, default "cc"; run directly, not through a shell) into
+// <cache_dir>/bdi_<key>.so and dlopen'ed. The key is BDIGraph::computeContentHash()
+// mixed with the partition (if any), BDIToC::EMITTER_VERSION, the compiler and its flags,
+// so an unchanged graph and toolchain reuse both the in-process module and the on-disk
+// object. Compilation runs without the lock; objects are published by atomic rename.
+// The default cache_dir is per user ($XDG_CACHE_HOME/bdi, created 0700); the directory
+// and every object must be owned by this user and not group- or world-writable, or
+// nothing in it is loaded.
+class NativeModuleCache {
+public:
+    explicit NativeModuleCache(std::string cache_dir = "");
+    // Returns nullptr if the graph cannot be lowered or compiled; callers keep interpreting.
+    std::shared_ptr<NativeModule> getOrCompile(const BDIGraph& graph);
+    std::shared_ptr<NativeModule> getOrCompile(const BDIGraph& graph,
+                                               const std::vector<NodeID>& entries,
+                                               const std::unordered_set<NodeID>& partition);
+    void clear();
+    const std::string& getCacheDir() const { return cache_dir_; }
+    std::string getLastError() const;
+private:
+    std::string cache_dir_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<NativeModule>> modules_;
+    std::string last_error_;
+    std::shared_ptr<NativeModule> find(uint64_t key) const;
+    std::shared_ptr<NativeModule> build(uint64_t key, const std::optional<CEmitResult>& emitted, const std::string& emit_error);
+    bool compile(const std::string& c_path, const std::string& so_path);
+    std::shared_ptr<NativeModule> fail(std::string message);
+};
+} // namespace chimera::backend
+#endif // CHIMERA_BACKEND_NATIVEMODULECACHE_HPP
@@ -0,0 +1,599 @@
+#include "BDIToC.hpp"
+#include "BDINode.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <sstream>
+namespace chimera::backend {
+namespace {
+// --- BDIType classification helpers (emitter-local) ---
+bool isFloatType(BDIType t) { return t == BDIType::FLOAT32 || t == BDIType::FLOAT64; }
+bool isSignedIntType(BDIType t) {
+    return t == BDIType::INT8 || t == BDIType::INT16 || t == BDIType::INT32 || t == BDIType::INT64;
+}
+bool isIntLikeType(BDIType t) { // Everything lowered to a C integer type
+    return !isFloatType(t) && cTypeForBDIType(t)[0] != '\0';
+}
+unsigned bitWidth(BDIType t) { return static_cast<unsigned>(getBdiTypeSize(t) * 8); }
+const char* unsignedCType(BDIType t) {
+    switch (getBdiTypeSize(t)) {
+        case 1: return "uint8_t";
+        case 2: return "uint16_t";
+        case 4: return "uint32_t";
+        default: return "uint64_t";
+    }
+}
+const char* signedMinMacro(BDIType t) {
+    switch (t) {
+        case BDIType::INT8:  return "INT8_MIN";
+        case BDIType::INT16: return "INT16_MIN";
+        case BDIType::INT32: return "INT32_MIN";
+        default:             return "INT64_MIN";
+    }
+}
+// Type a value of 'type' has in the interpreter: pointers and IDs are uint64 values
+BDIType valueType(BDIType type) {
+    switch (type) {
+        case BDIType::POINTER: case BDIType::MEM_REF: case BDIType::FUNC_PTR:
+        case BDIType::NODE_ID: case BDIType::REGION_ID:
+            return BDIType::UINT64;
+        default:
+            return type;
+    }
+}
+// vm_ops::detail::promote on tags: the type a binary op on x and y is computed in.
+// UNKNOWN where the interpreter reports TYPE_MISMATCH (BOOL is not numeric).
+BDIType promotedType(BDIType x, BDIType y) {
+    x = valueType(x);
+    y = valueType(y);
+    if (x == BDIType::BOOL || y == BDIType::BOOL) return BDIType::UNKNOWN;
+    if (cTypeForBDIType(x)[0] == '\0' || cTypeForBDIType(y)[0] == '\0') return BDIType::UNKNOWN;
+    if (isFloatType(x) || isFloatType(y)) return x == BDIType::FLOAT64 || y == BDIType::FLOAT64 ? BDIType::FLOAT64 : BDIType::FLOAT32;
+    const size_t x_size = getBdiTypeSize(x), y_size = getBdiTypeSize(y);
+    if (isSignedIntType(x) != isSignedIntType(y)) {
+        // An unsigned operand at least as wide wins; otherwise the wider signed one
+        if (!isSignedIntType(x) && x_size >= y_size) return x;
+        if (!isSignedIntType(y) && y_size >= x_size) return y;
+        return isSignedIntType(x) ? x : y;
+    }
+    return x_size >= y_size ? x : y;
+}
+uint64_t maxValue(BDIType t) {
+    const unsigned bits = bitWidth(t) - (isSignedIntType(t) ? 1 : 0);
+    return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+// C condition that holds when integer 'x' of type 'from' does not fit 'to', as
+// tryConvert's std::in_range check; empty if every value fits
+std::string outOfRange(const std::string& x, BDIType from, BDIType to) {
+    from = valueType(from);
+    to = valueType(to);
+    if (from == BDIType::BOOL) return "";
+    std::string condition;
+    if (isSignedIntType(from)) {
+        const std::string value = "(int64_t)" + x;
+        if (!isSignedIntType(to)) condition = value + " < 0";
+        else if (bitWidth(to) < bitWidth(from)) condition = value + " < INT64_C(-" + std::to_string(maxValue(to)) + ") - 1";
+        if (bitWidth(to) < bitWidth(from)) condition += " || " + value + " > INT64_C(" + std::to_string(maxValue(to)) + ")";
+    } else if (maxValue(to) < maxValue(from)) {
+        condition = "(uint64_t)" + x + " > UINT64_C(" + std::to_string(maxValue(to)) + ")";
+    }
+    return condition;
+}
+// Decode a slot's raw bits into a C expression of 'type'
+std::string fromBits(const std::string& bits_expr, BDIType type) {
+    if (type == BDIType::FLOAT32) return "bdi_f32(" + bits_expr + ")";
+    if (type == BDIType::FLOAT64) return "bdi_f64(" + bits_expr + ")";
+    return "(" + std::string(cTypeForBDIType(type)) + ")(" + bits_expr + ")";
+}
+// Encode a C value of 'type' into raw slot bits (signed values are sign-extended)
+std::string toBits(const std::string& value_expr, BDIType type) {
+    if (type == BDIType::FLOAT32) return "bdi_bits_f32(" + value_expr + ")";
+    if (type == BDIType::FLOAT64) return "bdi_bits_f64(" + value_expr + ")";
+    if (isSignedIntType(type)) return "(uint64_t)(int64_t)(" + value_expr + ")";
+    return "(uint64_t)(" + value_expr + ")";
+}
+// Literal spelling of a constant payload
+std::optional<std::string> payloadLiteral(const TypedPayload& payload) {
+    const size_t size = payload.data.size();
+    if (size == 0 || size > 8 || size != getBdiTypeSize(payload.type)) return std::nullopt;
+    uint64_t raw = 0;
+    std::memcpy(&raw, payload.data.data(), size); // Host little-endian layout, as in TypedPayload::createFrom
+    std::ostringstream oss;
+    if (payload.type == BDIType::FLOAT32) {
+        oss << "bdi_f32(UINT64_C(0x" << std::hex << raw << "))";
+    } else if (payload.type == BDIType::FLOAT64) {
+        oss << "bdi_f64(UINT64_C(0x" << std::hex << raw << "))";
+    } else if (isSignedIntType(payload.type)) {
+        const unsigned shift = 64 - static_cast<unsigned>(size * 8);
+        const int64_t value = static_cast<int64_t>(raw << shift) >> shift; // Sign-extend
+        oss << "(" << cTypeForBDIType(payload.type) << ")INT64_C(" << value << ")";
+    } else if (payload.type == BDIType::BOOL) {
+        oss << (raw != 0 ? "(uint8_t)1" : "(uint8_t)0");
+    } else {
+        oss << "(" << cTypeForBDIType(payload.type) << ")UINT64_C(" << raw << ")";
+    }
+    return oss.str();
+}
+const char* C_PREAMBLE =
+    "/* Generated by chimera::backend::BDIToC. Do not edit. */\n"
+    "#include <stdint.h>\n"
+    "#include <string.h>\n"
+    "#include <math.h>\n"
+    "typedef struct { uint64_t bits; uint32_t type; uint32_t reserved; } bdi_aot_slot;\n"
+    "#define BDI_AOT_TRAP (~(uint64_t)0)\n"
+    "static inline uint64_t bdi_bits_f32(float v) { uint32_t u; memcpy(&u, &v, 4); return u; }\n"
+    "static inline uint64_t bdi_bits_f64(double v) { uint64_t u; memcpy(&u, &v, 8); return u; }\n"
+    "static inline float bdi_f32(uint64_t b) { uint32_t u = (uint32_t)b; float v; memcpy(&v, &u, 4); return v; }\n"
+    "static inline double bdi_f64(uint64_t b) { double v; memcpy(&v, &b, 8); return v; }\n"
+    "static inline uint64_t bdi_popcount(uint64_t x) { uint64_t n = 0; while (x) { x &= x - 1; ++n; } return n; }\n"
+    "static inline uint64_t bdi_clz(uint64_t x, unsigned w) { uint64_t n = 0; unsigned i; for (i = w; i-- > 0 && !((x >> i) & 1u);) ++n; return n; }\n"
+    "static inline uint64_t bdi_ctz(uint64_t x, unsigned w) { uint64_t n = 0; while (n < w && !((x >> n) & 1u)) ++n; return n; }\n"
+    "\n";
+} // namespace
+const char* cTypeForBDIType(BDIType type) {
+    switch (type) {
+        case BDIType::BOOL:    return "uint8_t"; // Normalised to 0/1
+        case BDIType::INT8:    return "int8_t";
+        case BDIType::UINT8:   return "uint8_t";
+        case BDIType::INT16:   return "int16_t";
+        case BDIType::UINT16:  return "uint16_t";
+        case BDIType::INT32:   return "int32_t";
+        case BDIType::UINT32:  return "uint32_t";
+        case BDIType::INT64:   return "int64_t";
+        case BDIType::UINT64:  return "uint64_t";
+        case BDIType::FLOAT32: return "float";
+        case BDIType::FLOAT64: return "double";
+        case BDIType::POINTER:
+        case BDIType::MEM_REF:
+        case BDIType::FUNC_PTR:
+        case BDIType::NODE_ID:
+        case BDIType::REGION_ID: return "uint64_t"; // Offsets into MemoryManager space / IDs
+        default: return "";
+    }
+}
+// --- Entry points ---
+std::optional<CEmitResult> BDIToC::convertGraph(const BDIGraph& graph, const std::string& symbol_prefix) {
+    std::vector<NodeID> entries;
+    for (const auto& pair : graph) {
+        if (pair.second && pair.second->operation == BDIOperationType::META_START) entries.push_back(pair.first);
+    }
+    std::sort(entries.begin(), entries.end());
+    partition_ = nullptr;
+    graph_ = &graph;
+    if (entries.empty()) { fail("graph has no META_START node"); return std::nullopt; }
+    CEmitResult result;
+    result.source = C_PREAMBLE;
+    for (NodeID entry : entries) {
+        CEntryInfo info;
+        if (!emitFunction(entry, symbol_prefix + "_" + std::to_string(entry), info, result.source)) return std::nullopt;
+        result.entries.push_back(std::move(info));
+    }
+    graph_ = nullptr;
+    return result;
+}
+std::optional<CEmitResult> BDIToC::convertPartition(const BDIGraph& graph,
+                                                    const std::vector<NodeID>& entries,
+                                                    const std::unordered_set<NodeID>& partition,
+                                                    const std::string& symbol_prefix) {
+    graph_ = &graph;
+    partition_ = &partition;
+    CEmitResult result;
+    result.source = C_PREAMBLE;
+    for (NodeID entry : entries) {
+        if (!partition.count(entry)) { fail("entry " + std::to_string(entry) + " is outside the partition"); return std::nullopt; }
+        CEntryInfo info;
+        if (!emitFunction(entry, symbol_prefix + "_" + std::to_string(entry), info, result.source)) return std::nullopt;
+        result.entries.push_back(std::move(info));
+    }
+    graph_ = nullptr;
+    partition_ = nullptr;
+    return result;
+}
+// --- Helpers ---
+bool BDIToC::fail(const std::string& message) {
+    last_error_ = message;
+    BDI_LOG_WARN(BACKEND, "BDIToC: " << message);
+    graph_ = nullptr;
+    partition_ = nullptr;
+    return false;
+}
+bool BDIToC::isConstantNode(const BDINode& node) const {
+    // Same convention as ConstantFolding: META_CONST, or NOP carrying a non-void payload
+    if (node.operation != BDIOperationType::META_CONST && node.operation != BDIOperationType::META_NOP) return false;
+    return node.payload.isValid() && node.payload.type != BDIType::VOID;
+}
+BDIType BDIToC::portType(const PortRef& port) const {
+    auto node_opt = graph_->getNode(port.node_id);
+    if (!node_opt) return BDIType::UNKNOWN;
+    const BDINode& node = node_opt.value();
+    BDIType type = node.getOutputType(port.port_index);
+    if (type == BDIType::UNKNOWN && isConstantNode(node) && port.port_index == 0) type = node.payload.type;
+    return type;
+}
+std::string BDIToC::portName(const PortRef& port) const {
+    return "p" + std::to_string(port.node_id) + "_" + std::to_string(port.port_index);
+}
+std::string BDIToC::operand(const BDINode& node, size_t input_idx, BDIType as_type) const {
+    const PortRef& src = node.data_inputs[input_idx];
+    if (portType(src) == as_type) return portName(src);
+    return "((" + std::string(cTypeForBDIType(as_type)) + ")" + portName(src) + ")";
+}
+std::string BDIToC::emitLiveOutStores() const {
+    std::string out;
+    for (size_t i = 0; i < live_outs_.size(); ++i) {
+        BDIType type = portType(live_outs_[i]);
+        out += "    live_out[" + std::to_string(i) + "].bits = " + toBits(portName(live_outs_[i]), type) + "; ";
+        out += "live_out[" + std::to_string(i) + "].type = " + std::to_string(static_cast<uint32_t>(type)) + "u;\n";
+    }
+    return out;
+}
+std::string BDIToC::emitTransfer(NodeID target) const {
+    if (target != 0 && reachable_.count(target)) return "goto n_" + std::to_string(target) + ";";
+    // Leaving the function: publish live-outs and report where the interpreter should resume
+    const std::string exit = "return UINT64_C(" + std::to_string(target) + ");";
+    if (live_outs_.empty()) return exit;
+    return "{\n" + emitLiveOutStores() + "    " + exit + " }";
+}
+// --- Function emission ---
+bool BDIToC::emitFunction(NodeID entry_id, const std::string& symbol, CEntryInfo& info, std::string& out) {
+    reachable_.clear();
+    live_in_index_.clear();
+    live_outs_.clear();
+    info = CEntryInfo{};
+    info.entry_node_id = entry_id;
+    info.symbol = symbol;
+    // 1. Nodes reachable along control edges inside the partition, in discovery order
+    std::vector<NodeID> order;
+    std::deque<NodeID> worklist{entry_id};
+    while (!worklist.empty()) {
+        NodeID id = worklist.front();
+        worklist.pop_front();
+        if (id == 0 || reachable_.count(id) || !inPartition(id)) continue;
+        auto node_opt = graph_->getNode(id);
+        if (!node_opt) return fail("control edge to missing node " + std::to_string(id));
+        reachable_.insert(id);
+        order.push_back(id);
+        for (NodeID succ : node_opt.value().get().control_outputs) worklist.push_back(succ);
+    }
+    // 2. Classify every data source used by the function
+    std::vector<PortRef> locals;       // Ports computed inside the function
+    std::vector<PortRef> constants;    // Hoisted constant ports
+    std::unordered_set<PortRef, PortRefHash> seen;
+    auto note_port = [&](const PortRef& port, std::vector<PortRef>& bucket) {
+        if (seen.insert(port).second) bucket.push_back(port);
+    };
+    for (NodeID id : order) {
+        const BDINode& node = graph_->getNode(id).value();
+        for (PortIndex i = 0; i < node.data_outputs.size(); ++i) note_port({id, i}, locals);
+    }
+    for (NodeID id : order) {
+        const BDINode& node = graph_->getNode(id).value();
+        for (const PortRef& src : node.data_inputs) {
+            auto src_opt = graph_->getNode(src.node_id);
+            if (!src_opt) return fail("node " + std::to_string(id) + " reads from missing node " + std::to_string(src.node_id));
+            if (isConstantNode(src_opt.value())) {
+                note_port(src, constants);
+            } else if (!reachable_.count(src.node_id) && seen.insert(src).second) {
+                live_in_index_[src] = info.live_ins.size();
+                info.live_ins.push_back(src);
+            }
+        }
+    }
+    for (const auto& pair : *graph_) {
+        if (!pair.second || reachable_.count(pair.first)) continue;
+        for (const PortRef& src : pair.second->data_inputs) {
+            if (reachable_.count(src.node_id) &&
+                std::find(live_outs_.begin(), live_outs_.end(), src) == live_outs_.end()) {
+                live_outs_.push_back(src);
+            }
+        }
+    }
+    std::sort(live_outs_.begin(), live_outs_.end(), [](const PortRef& a, const PortRef& b) {
+        return a.node_id != b.node_id ? a.node_id < b.node_id : a.port_index < b.port_index;
+    });
+    info.live_outs = live_outs_;
+    // 3. Prologue: declarations, live-ins, constants
+    out += "uint64_t " + symbol + "(const bdi_aot_slot* args, uint32_t arg_count, const bdi_aot_slot* live_in, "
+           "bdi_aot_slot* live_out, bdi_aot_slot* ret, uint8_t* mem, uint64_t mem_size) {\n";
+    out += "    (void)args; (void)arg_count; (void)live_in; (void)live_out; (void)ret; (void)mem; (void)mem_size;\n";
+    auto declare = [&](const PortRef& port) -> bool {
+        BDIType type = portType(port);
+        const char* c_type = cTypeForBDIType(type);
+        if (c_type[0] == '\0') return fail("port " + portName(port) + " has no C representation (type " + std::to_string(static_cast<int>(type)) + ")");
+        out += "    " + std::string(c_type) + " " + portName(port) + " = 0;\n";
+        return true;
+    };
+    for (const auto& port : locals) if (!declare(port)) return false;
+    for (const auto& port : constants) if (!declare(port)) return false;
+    for (const auto& port : info.live_ins) if (!declare(port)) return false;
+    for (size_t i = 0; i < info.live_ins.size(); ++i) {
+        const PortRef& port = info.live_ins[i];
+        out += "    " + portName(port) + " = " + fromBits("live_in[" + std::to_string(i) + "].bits", portType(port)) + ";\n";
+    }
+    for (const auto& port : constants) {
+        const BDINode& node = graph_->getNode(port.node_id).value();
+        auto literal = payloadLiteral(node.payload);
+        if (!literal) return fail("cannot encode constant payload of node " + std::to_string(port.node_id));
+        out += "    " + portName(port) + " = " + *literal + ";\n";
+    }
+    out += "    goto n_" + std::to_string(entry_id) + ";\n";
+    // 4. Body: one label per node
+    for (NodeID id : order) {
+        if (!emitNode(graph_->getNode(id).value(), out)) return false;
+    }
+    out += "}\n\n";
+    return true;
+}
+bool BDIToC::emitNode(const BDINode& node, std::string& out) {
+    using Op = BDIOperationType;
+    const std::string id_str = std::to_string(node.id);
+    const std::string trap = "return BDI_AOT_TRAP;";
+    out += "n_" + id_str + ":;\n";
+    auto need_inputs = [&](size_t n) -> bool {
+        if (node.data_inputs.size() < n) return fail("node " + id_str + " expects " + std::to_string(n) + " inputs");
+        return true;
+    };
+    auto need_output = [&]() -> bool {
+        if (node.data_outputs.empty()) return fail("node " + id_str + " has no output port");
+        return true;
+    };
+    // Result type: declared output type, or the type of input 0 when undeclared
+    auto result_type = [&]() -> BDIType {
+        BDIType t = node.getOutputType(0);
+        if (t == BDIType::UNKNOWN && !node.data_inputs.empty()) t = portType(node.data_inputs[0]);
+        return t;
+    };
+    // Type the interpreter computes an op in: the promoted operand type ('binary') or the
+    // operand's own. The output's C local has one type, so a different declared type fails.
+    auto operation_type = [&](bool binary, BDIType& t) -> bool {
+        t = binary ? promotedType(portType(node.data_inputs[0]), portType(node.data_inputs[1])) : valueType(portType(node.data_inputs[0]));
+        if (t == BDIType::UNKNOWN) return fail("operands of node " + id_str + " have no common numeric type");
+        const BDIType declared = node.getOutputType(0);
+        if (declared != BDIType::UNKNOWN && valueType(declared) != t) {
+            return fail("node " + id_str + " declares type " + std::to_string(static_cast<int>(declared)) +
+                        " but computes " + std::to_string(static_cast<int>(t)));
+        }
+        return true;
+    };
+    auto assign = [&](const std::string& expr) {
+        out += "    " + portName({node.id, 0}) + " = " + expr + ";\n";
+    };
+    auto next = [&]() -> std::string {
+        return node.control_outputs.empty() ? emitTransfer(0) : emitTransfer(node.control_outputs[0]);
+    };
+    switch (node.operation) {
+        // --- Meta ---
+        case Op::META_START:
+            for (PortIndex i = 0; i < node.data_outputs.size(); ++i) {
+                const std::string idx = std::to_string(i);
+                out += "    if (" + idx + "u < arg_count) " + portName({node.id, i}) + " = " +
+                       fromBits("args[" + idx + "].bits", node.data_outputs[i].type) + ";\n";
+            }
+            break;
+        case Op::META_NOP:
+        case Op::META_COMMENT:
+        case Op::META_CONST:
+            break; // Constants are hoisted into the prologue
+        case Op::META_END:
+            out += "    " + emitTransfer(0) + "\n";
+            return true;
+        case Op::META_ASSERT:
+            if (!need_inputs(1)) return false;
+            out += "    if (!" + portName(node.data_inputs[0]) + ") " + trap + "\n";
+            break;
+        // --- Arithmetic ---
+        case Op::ARITH_ADD: case Op::ARITH_SUB: case Op::ARITH_MUL: {
+            BDIType t;
+            if (!need_inputs(2) || !need_output() || !operation_type(true, t)) return false;
+            const char* sym = node.operation == Op::ARITH_ADD ? " + " : node.operation == Op::ARITH_SUB ? " - " : " * ";
+            assign("(" + std::string(cTypeForBDIType(t)) + ")(" + operand(node, 0, t) + sym + operand(node, 1, t) + ")");
+            break;
+        }
+        case Op::ARITH_DIV: case Op::ARITH_MOD: {
+            BDIType t;
+            if (!need_inputs(2) || !need_output() || !operation_type(true, t)) return false;
+            std::string a = operand(node, 0, t), b = operand(node, 1, t);
+            if (isFloatType(t)) {
+                if (node.operation == Op::ARITH_MOD) return fail("ARITH_MOD requires integers (node " + id_str + ")");
+                assign(a + " / " + b);
+                break;
+            }
+            out += "    if (" + b + " == 0) " + trap + "\n";
+            const std::string c_type = cTypeForBDIType(t);
+            if (node.operation == Op::ARITH_MOD) {
+                // As tryModulo: x % -1 is 0 (min % -1 would trap in C)
+                if (isSignedIntType(t)) assign("(" + c_type + ")(" + b + " == -1 ? 0 : " + a + " % " + b + ")");
+                else assign("(" + c_type + ")(" + a + " % " + b + ")");
+                break;
+            }
+            if (isSignedIntType(t)) out += "    if (" + b + " == -1 && " + a + " == " + signedMinMacro(t) + ") " + trap + "\n";
+            assign("(" + c_type + ")(" + a + " / " + b + ")");
+            break;
+        }
+        case Op::ARITH_NEG: case Op::ARITH_ABS: {
+            BDIType t;
+            if (!need_inputs(1) || !need_output() || !operation_type(false, t)) return false;
+            if (t == BDIType::BOOL) return fail("arithmetic on BOOL (node " + id_str + ")");
+            std::string a = operand(node, 0, t), c_type = cTypeForBDIType(t);
+            if (node.operation == Op::ARITH_NEG) {
+                if (!isFloatType(t) && !isSignedIntType(t)) return fail("cannot negate unsigned value (node " + id_str + ")");
+                assign("(" + c_type + ")(-" + a + ")");
+            } else if (t == BDIType::FLOAT32) {
+                assign("fabsf(" + a + ")");
+            } else if (t == BDIType::FLOAT64) {
+                assign("fabs(" + a + ")");
+            } else if (isSignedIntType(t)) {
+                out += "    if (" + a + " == " + signedMinMacro(t) + ") " + trap + "\n"; // tryAbsolute: OUT_OF_RANGE
+                assign("(" + c_type + ")(" + a + " < 0 ? -" + a + " : " + a + ")");
+            } else {
+                assign(a);
+            }
+            break;
+        }
+        case Op::ARITH_INC: case Op::ARITH_DEC: {
+            if (!need_inputs(1) || !need_output()) return false;
+            BDIType t = result_type();
+            std::string a = operand(node, 0, t), c_type = cTypeForBDIType(t);
+            assign("(" + c_type + ")(" + a + (node.operation == Op::ARITH_INC ? " + 1" : " - 1") + ")");
+            break;
+        }
+        case Op::ARITH_FMA: {
+            if (!need_inputs(3) || !need_output()) return false;
+            BDIType t = result_type();
+            assign("(" + std::string(cTypeForBDIType(t)) + ")(" + operand(node, 0, t) + " * " + operand(node, 1, t) + " + " + operand(node, 2, t) + ")");
+            break;
+        }
+        // --- Bitwise ---
+        case Op::BIT_AND: case Op::BIT_OR: case Op::BIT_XOR: {
+            BDIType t;
+            if (!need_inputs(2) || !need_output() || !operation_type(true, t)) return false;
+            if (!isIntLikeType(t)) return fail("bitwise op requires integers (node " + id_str + ")");
+            const char* sym = node.operation == Op::BIT_AND ? " & " : node.operation == Op::BIT_OR ? " | " : " ^ ";
+            assign("(" + std::string(cTypeForBDIType(t)) + ")(" + operand(node, 0, t) + sym + operand(node, 1, t) + ")");
+            break;
+        }
+        case Op::BIT_NOT: case Op::BIT_POPCOUNT: case Op::BIT_LZCNT: case Op::BIT_TZCNT: {
+            if (!need_inputs(1) || !need_output()) return false;
+            BDIType in_t = portType(node.data_inputs[0]);
+            if (!isIntLikeType(in_t)) return fail("bitwise op requires integers (node " + id_str + ")");
+            BDIType t = result_type();
+            const std::string u = "(uint64_t)(" + std::string(unsignedCType(in_t)) + ")" + portName(node.data_inputs[0]);
+            const std::string w = std::to_string(bitWidth(in_t)) + "u";
+            const std::string cast = "(" + std::string(cTypeForBDIType(t)) + ")";
+            if (node.operation == Op::BIT_NOT) assign(cast + "(~" + operand(node, 0, t) + ")");
+            else if (node.operation == Op::BIT_POPCOUNT) assign(cast + "bdi_popcount(" + u + ")");
+            else if (node.operation == Op::BIT_LZCNT) assign(cast + "bdi_clz(" + u + ", " + w + ")");
+            else assign(cast + "bdi_ctz(" + u + ", " + w + ")");
+            break;
+        }
+        case Op::BIT_SHL: case Op::BIT_SHR: case Op::BIT_ASHR: case Op::BIT_ROL: case Op::BIT_ROR: {
+            if (!need_inputs(2) || !need_output()) return false;
+            BDIType t = result_type();
+            if (!isIntLikeType(t)) return fail("shift value must be integer (node " + id_str + ")");
+            const std::string c_type = cTypeForBDIType(t), u_type = unsignedCType(t);
+            const std::string a = operand(node, 0, t), s = "(uint64_t)" + portName(node.data_inputs[1]);
+            const std::string w = std::to_string(bitWidth(t)) + "u";
+            if (node.operation == Op::BIT_ROL || node.operation == Op::BIT_ROR) {
+                // Rotates are defined for any amount (taken modulo width)
+                const std::string r = "(unsigned)(" + s + " % " + w + ")";
+                const char* first = node.operation == Op::BIT_ROL ? " << " : " >> ";
+                const char* second = node.operation == Op::BIT_ROL ? " >> " : " << ";
+                assign("(" + c_type + ")(((" + u_type + ")" + a + first + r + ") | ((" + u_type + ")" + a + second + "((" + w + " - " + r + ") % " + w + ")))");
+                break;
+            }
+            out += "    if (" + s + " >= " + w + ") " + trap + "\n"; // Matches interpreter: shift >= width is an error
+            if (node.operation == Op::BIT_SHL) {
+                assign("(" + c_type + ")((" + u_type + ")" + a + " << " + s + ")");
+            } else if (node.operation == Op::BIT_SHR) {
+                assign("(" + c_type + ")((" + u_type + ")" + a + " >> " + s + ")");
+            } else {
+                if (!isSignedIntType(t)) return fail("ASHR called on unsigned type (node " + id_str + ")");
+                assign("(" + c_type + ")(" + a + " >> " + s + ")");
+            }
+            break;
+        }
+        // --- Logical ---
+        case Op::LOGIC_AND: case Op::LOGIC_OR: case Op::LOGIC_XOR: {
+            if (!need_inputs(2) || !need_output()) return false;
+            const std::string a = "(" + portName(node.data_inputs[0]) + " != 0)", b = "(" + portName(node.data_inputs[1]) + " != 0)";
+            const char* sym = node.operation == Op::LOGIC_AND ? " && " : node.operation == Op::LOGIC_OR ? " || " : " ^ ";
+            assign("(uint8_t)(" + a + sym + b + ")");
+            break;
+        }
+        case Op::LOGIC_NOT:
+            if (!need_inputs(1) || !need_output()) return false;
+            assign("(uint8_t)(" + portName(node.data_inputs[0]) + " == 0)");
+            break;
+        // --- Comparison ---
+        case Op::CMP_EQ: case Op::CMP_NE: case Op::CMP_LT: case Op::CMP_LE: case Op::CMP_GT: case Op::CMP_GE: {
+            if (!need_inputs(2) || !need_output()) return false;
+            // Same types compare as they are, mixed ones in the promoted type, as detail::compare
+            const BDIType left = valueType(portType(node.data_inputs[0])), right = valueType(portType(node.data_inputs[1]));
+            const BDIType t = left == right ? left : promotedType(left, right);
+            if (t == BDIType::UNKNOWN || cTypeForBDIType(t)[0] == '\0') return fail("operands of node " + id_str + " are not comparable");
+            const char* sym = node.operation == Op::CMP_EQ ? " == " : node.operation == Op::CMP_NE ? " != " :
+                              node.operation == Op::CMP_LT ? " < " : node.operation == Op::CMP_LE ? " <= " :
+                              node.operation == Op::CMP_GT ? " > " : " >= ";
+            assign("(uint8_t)(" + operand(node, 0, t) + sym + operand(node, 1, t) + ")");
+            break;
+        }
+        // --- Conversions ---
+        case Op::CONV_TRUNC: case Op::CONV_EXTEND_SIGN: case Op::CONV_EXTEND_ZERO:
+        case Op::CONV_FLOAT_TO_INT: case Op::CONV_INT_TO_FLOAT: {
+            if (!need_inputs(1) || !need_output()) return false;
+            BDIType t = node.getOutputType(0);
+            if (cTypeForBDIType(t)[0] == '\0') return fail("conversion target not representable (node " + id_str + ")");
+            const BDIType from = portType(node.data_inputs[0]);
+            if (t == BDIType::BOOL) {
+                assign("(uint8_t)(" + portName(node.data_inputs[0]) + " != 0)");
+            } else if (isFloatType(from) && !isFloatType(t)) {
+                // Truncate, and trap on NaN or out of range like the interpreter's tryConvert
+                // (a C cast would be undefined there)
+                const size_t digits = getBdiTypeSize(t) * 8 - (isSignedIntType(t) ? 1 : 0);
+                const std::string upper = "ldexp(1.0, " + std::to_string(digits) + ")";
+                const std::string lower = isSignedIntType(t) ? "-" + upper : "0.0";
+                const std::string truncated = "trunc((double)" + portName(node.data_inputs[0]) + ")";
+                out += "    if (!(" + truncated + " >= " + lower + " && " + truncated + " < " + upper + ")) " + trap + "\n";
+                assign("(" + std::string(cTypeForBDIType(t)) + ")" + truncated);
+            } else {
+                // Integer narrowing and sign changes trap where tryConvert reports OUT_OF_RANGE
+                if (!isFloatType(from) && !isFloatType(t)) {
+                    const std::string check = outOfRange(portName(node.data_inputs[0]), from, t);
+                    if (!check.empty()) out += "    if (" + check + ") " + trap + "\n";
+                }
+                assign(operand(node, 0, t));
+            }
+            break;
+        }
+        case Op::CONV_BITCAST: {
+            if (!need_inputs(1) || !need_output()) return false;
+            BDIType from = portType(node.data_inputs[0]), to = node.getOutputType(0);
+            if (getBdiTypeSize(from) != getBdiTypeSize(to) || getBdiTypeSize(to) == 0) return fail("bitcast requires equal non-zero sizes (node " + id_str + ")");
+            out += "    memcpy(&" + portName({node.id, 0}) + ", &" + portName(node.data_inputs[0]) + ", sizeof(" + portName({node.id, 0}) + "));\n";
+            break;
+        }
+        // --- Memory (offsets into the MemoryManager block passed as 'mem') ---
+        case Op::MEM_LOAD: {
+            if (!need_inputs(1) || !need_output()) return false;
+            const std::string addr = "(uint64_t)" + portName(node.data_inputs[0]);
+            const std::string size = std::to_string(getBdiTypeSize(node.getOutputType(0)));
+            out += "    if (" + addr + " > mem_size || mem_size - " + addr + " < " + size + "u) " + trap + "\n";
+            out += "    memcpy(&" + portName({node.id, 0}) + ", mem + " + addr + ", " + size + ");\n";
+            break;
+        }
+        case Op::MEM_STORE: {
+            if (!need_inputs(2)) return false;
+            const std::string addr = "(uint64_t)" + portName(node.data_inputs[0]);
+            const std::string size = std::to_string(getBdiTypeSize(portType(node.data_inputs[1])));
+            out += "    if (" + addr + " > mem_size || mem_size - " + addr + " < " + size + "u) " + trap + "\n";
+            out += "    memcpy(mem + " + addr + ", &" + portName(node.data_inputs[1]) + ", " + size + ");\n";
+            break;
+        }
+        // --- Control flow ---
+        case Op::CTRL_JUMP:
+            if (node.control_outputs.empty()) return fail("CTRL_JUMP without target (node " + id_str + ")");
+            break; // Falls through to the transfer below
+        case Op::CTRL_BRANCH_COND:
+            if (!need_inputs(1)) return false;
+            if (node.control_outputs.size() < 2) return fail("CTRL_BRANCH_COND needs true and false targets (node " + id_str + ")");
+            out += "    if (" + portName(node.data_inputs[0]) + ") " + emitTransfer(node.control_outputs[0]) + "\n";
+            out += "    " + emitTransfer(node.control_outputs[1]) + "\n";
+            return true;
+        case Op::CTRL_RETURN:
+            if (!node.data_inputs.empty()) {
+                BDIType t = portType(node.data_inputs[0]);
+                out += "    if (ret) { ret->bits = " + toBits(portName(node.data_inputs[0]), t) +
+                       "; ret->type = " + std::to_string(static_cast<uint32_t>(t)) + "u; }\n";
+            } else {
+                out += "    if (ret) { ret->bits = 0; ret->type = " + std::to_string(static_cast<uint32_t>(BDIType::VOID)) + "u; }\n";
+            }
+            out += "    " + emitTransfer(0) + "\n";
+            return true;
+        default:
+            return fail("no C lowering for operation " + std::to_string(static_cast<int>(node.operation)) + " (node " + id_str + ")");
+    }
+    out += "    " + next() + "\n";
+    return true;
+}
+} // namespace chimera::backend
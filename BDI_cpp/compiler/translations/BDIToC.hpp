@@ -0,0 +1,77 @@
+#ifndef CHIMERA_BACKEND_BDITOC_HPP
+#define CHIMERA_BACKEND_BDITOC_HPP
+#include "BDIGraph.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+namespace chimera::backend {
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+// --- Native ABI shared with emitted code ---
+// Every value crossing the native boundary is passed as raw bits plus its BDIType tag.
+struct BDIAotSlot {
+    uint64_t bits = 0;
+    uint32_t type = 0; // static_cast<uint32_t>(BDIType)
+    uint32_t reserved = 0;
+};
+// Entry function signature of emitted code. Returns the NodeID where control leaves
+// the emitted partition (0 when the graph finished via META_END/CTRL_RETURN), or
+// BDI_AOT_TRAP on a runtime fault (out-of-bounds memory, division by zero, failed assert).
+using BDIAotEntryFn = uint64_t (*)(const BDIAotSlot* args, uint32_t arg_count,
+                                   const BDIAotSlot* live_in, BDIAotSlot* live_out,
+                                   BDIAotSlot* ret, uint8_t* mem, uint64_t mem_size);
+constexpr uint64_t BDI_AOT_TRAP = ~uint64_t{0};
+// Describes one emitted entry function
+struct CEntryInfo {
+    NodeID entry_node_id = 0;
+    std::string symbol;
+    std::vector<PortRef> live_ins;  // Values produced outside the function, passed via live_in[]
+    std::vector<PortRef> live_outs; // Values consumed outside the function, written to live_out[]
+};
+struct CEmitResult {
+    std::string source;
+    std::vector<CEntryInfo> entries;
+};
+// Translates a BDIGraph (or a partition of one) into portable C source.
+// One function per entry node, one local per data port, one label + goto per control edge.
+// Ops without a C lowering make the whole conversion fail; callers fall back to the interpreter.
+class BDIToC {
+public:
+    // Bumped whenever the same graph would be emitted differently (native caches key on it)
+    static constexpr uint32_t EMITTER_VERSION = 3;
+    BDIToC() = default;
+    // Emit one function per META_START node in the graph
+    std::optional<CEmitResult> convertGraph(const BDIGraph& graph, const std::string& symbol_prefix = "bdi_aot");
+    // Emit functions for the given entries, restricted to nodes in 'partition'.
+    // Control edges leaving the partition become returns of the target NodeID.
+    std::optional<CEmitResult> convertPartition(const BDIGraph& graph,
+                                                const std::vector<NodeID>& entries,
+                                                const std::unordered_set<NodeID>& partition,
+                                                const std::string& symbol_prefix = "bdi_aot");
+    const std::string& getLastError() const { return last_error_; }
+private:
+    const BDIGraph* graph_ = nullptr;
+    const std::unordered_set<NodeID>* partition_ = nullptr;
+    std::string last_error_;
+    // Per-function state
+    std::unordered_set<NodeID> reachable_;
+    std::unordered_map<PortRef, size_t, PortRefHash> live_in_index_; // PortRef -> live_in slot
+    std::vector<PortRef> live_outs_;
+    bool inPartition(NodeID id) const { return !partition_ || partition_->count(id) > 0; }
+    bool isConstantNode(const BDINode& node) const;
+    BDIType portType(const PortRef& port) const;
+    std::string portName(const PortRef& port) const;
+    std::string operand(const BDINode& node, size_t input_idx, BDIType as_type) const;
+    bool emitFunction(NodeID entry_id, const std::string& symbol, CEntryInfo& info, std::string& out);
+    bool emitNode(const BDINode& node, std::string& out);
+    std::string emitTransfer(NodeID target) const; // goto label, or exit the function
+    std::string emitLiveOutStores() const;
+    bool fail(const std::string& message);
+};
+// C type spelling used for a BDIType in emitted code ("" if not representable)
+const char* cTypeForBDIType(BDIType type);
+} // namespace chimera::backend
+#endif // CHIMERA_BACKEND_BDITOC_HPP
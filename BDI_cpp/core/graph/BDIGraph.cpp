@@ -585,5 +585,46 @@ bool BDIGraph::serialize(std::ostream& os) const {
      if (!is) return nullptr;
      return graph;
  }
+ // --- Identity --
+ // FNV-1a over nodes in ascending NodeID order so the result does not depend on
+ // unordered_map iteration order. Names and metadata handles are not hashed.
+ uint64_t BDIGraph::computeContentHash() const {
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+    uint64_t hash = FNV_OFFSET;
+    auto mix_bytes = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+    };
+    auto mix = [&mix_bytes](auto value) { mix_bytes(&value, sizeof(value)); };
+    std::vector<NodeID> ids;
+    ids.reserve(nodes_.size());
+    for (const auto& pair : nodes_) {
+        if (pair.second) ids.push_back(pair.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (NodeID id : ids) {
+        const BDINode& node = *nodes_.at(id);
+        mix(node.id);
+        mix(static_cast<uint16_t>(node.operation));
+        mix(node.region_id);
+        mix(static_cast<uint32_t>(node.payload.type));
+        mix(static_cast<uint64_t>(node.payload.data.size()));
+        if (!node.payload.data.empty()) mix_bytes(node.payload.data.data(), node.payload.data.size());
+        mix(static_cast<uint32_t>(node.data_inputs.size()));
+        for (const auto& port_ref : node.data_inputs) {
+            mix(port_ref.node_id);
+            mix(port_ref.port_index);
+        }
+        mix(static_cast<uint32_t>(node.data_outputs.size()));
+        for (const auto& port_info : node.data_outputs) mix(static_cast<uint32_t>(port_info.type));
+        mix(static_cast<uint32_t>(node.control_outputs.size()));
+        for (NodeID succ : node.control_outputs) mix(succ);
+    }
+    return hash;
+ }
  // ... rest of BDIGraph.cpp ...
  } // namespace bdi::core::graph
@@ -49,6 +49,10 @@
     // --- Serialization --
     // TODO: bool serialize(std::ostream& os) const;
     // TODO: static std::unique_ptr<BDIGraph> deserialize(std::istream& is);
+    // --- Identity --
+    // Stable hash over topology, op codes, port types and payload bytes (name excluded).
+    // Used as a cache key by backends that compile graphs ahead of time.
+    uint64_t computeContentHash() const;
  private:
     std::string name_;
     std::unordered_map<NodeID, std::unique_ptr<BDINode>> nodes_; // Using unique_ptr for ownership
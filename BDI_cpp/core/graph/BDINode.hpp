@@ -4,6 +4,7 @@
  #include "TypedPayload.hpp"
  #include "OperationTypes.hpp"
  #include <cstdint>
+ #include <functional>
  #include <vector>
  #include <string>
  #include <map> // Or unordered_map if performance critical and hashing is fine
@@ -21,6 +22,14 @@
     PortIndex port_index = 0;
     bool operator==(const PortRef&) const = default; // For use in maps/sets
  };
+ // Hash function for PortRef to use it in unordered_map
+ struct PortRefHash {
+    std::size_t operator()(const PortRef& pr) const noexcept {
+        std::size_t h1 = std::hash<NodeID>{}(pr.node_id);
+        std::size_t h2 = std::hash<PortIndex>{}(pr.port_index);
+        return h1 ^ (h2 << 1);
+    }
+ };
  // Describes an output port of a node
  struct PortInfo {
     BDIType type = BDIType::UNKNOWN;
@@ -5,6 +5,8 @@
  namespace bdi::optimizer {
  using bdi::core::graph::BDIGraph;
  using bdi::core::graph::BDINode;
+ using bdi::core::graph::NodeID;
+ using bdi::core::graph::BDIOperationType;
  // Abstract base class for graph visitors (used by optimizers, analyzers, etc.)
  class GraphVisitor {
  public:
@@ -1,8 +1,10 @@
  #ifndef BDI_RUNTIME_BDIVALUEVARIANT_HPP
  #define BDI_RUNTIME_BDIVALUEVARIANT_HPP
  #include "BDITypes.hpp"
+ #include "PackedVector.hpp"
  #include <variant>
  #include <cstdint>
+ #include <type_traits>
  #include <string> // For potential errors
  namespace bdi::runtime {
  using bdi::core::types::BDIType;
@@ -18,9 +20,33 @@
     int64_t, uint64_t,
     float, // Corresponds to FLOAT32
     double, // Corresponds to FLOAT64
-    uintptr_t // Represents POINTER, MEM_REF, potentially FUNC_PTR
+    uintptr_t, // Represents POINTER, MEM_REF, potentially FUNC_PTR
+    VectorRef // VEC_* ops (reported as BDIType::ARRAY); borrows the lanes of a PackedVector
     // Add other potential direct value types: NodeID, RegionID?
  >;
+ static_assert(std::is_trivially_copyable_v<BDIValueVariant>, "Values copy without visiting their alternative");
+ // Owner of a value's vector lanes (empty for scalars)
+ inline PackedVector retainVector(const BDIValueVariant& value) {
+    const VectorRef* vector = std::get_if<VectorRef>(&value);
+    return vector ? PackedVector(*vector) : PackedVector{};
+ }
+ // A value that keeps its vector alive: for holders that outlive the op that produced it
+ class HeldValue {
+ public:
+    HeldValue() = default;
+    HeldValue(const BDIValueVariant& value) : value_(value), vector_(retainVector(value)) {}
+    template <typename T>
+        requires std::is_arithmetic_v<T> || std::is_same_v<T, std::monostate>
+    HeldValue(T scalar) : value_(scalar) {}
+    // Takes over a freshly built vector
+    HeldValue(PackedVector vector) : value_(vector.ref()), vector_(std::move(vector)) {}
+    const BDIValueVariant& get() const { return value_; }
+    operator const BDIValueVariant&() const { return value_; }
+    bool operator==(const HeldValue& other) const { return value_ == other.value_; }
+ private:
+    BDIValueVariant value_;
+    PackedVector vector_;
+ };
  // Helper to get BDIType from a BDIValueVariant
  inline BDIType getBDIType(const BDIValueVariant& value) {
     using namespace bdi::core::types;
@@ -40,6 +66,7 @@
         else if constexpr (std::is_same_v<T, float>)     { result = BDIType::FLOAT32; }
         else if constexpr (std::is_same_v<T, double>)    { result = BDIType::FLOAT64; }
         else if constexpr (std::is_same_v<T, uintptr_t>) { result = BDIType::POINTER; } // Default mapping for uintptr_t
+        else if constexpr (std::is_same_v<T, VectorRef>) { result = BDIType::ARRAY; }
         // Add mappings for other types if included in the variant
     }, value);
     return result;
@@ -0,0 +1,119 @@
+ #ifndef BDI_RUNTIME_PACKEDVECTOR_HPP
+ #define BDI_RUNTIME_PACKEDVECTOR_HPP
+ #include "BDITypes.hpp"
+ #include <atomic>
+ #include <cstddef>
+ #include <cstdint>
+ #include <cstring>
+ #include <new>
+ #include <utility>
+ namespace bdi::runtime {
+ using bdi::core::types::BDIType;
+ namespace detail {
+ // Padded to the alignment, so the lanes that follow it are aligned too
+ struct alignas(64) VectorHeader {
+    std::atomic<uint32_t> refs;
+    BDIType element_type;
+    uint32_t element_size;
+    size_t lanes;
+ };
+ }
+ // --- Vector Ref --
+ // What BDIValueVariant holds for a vector: one pointer, trivially copyable, so copying a
+ // variant never has to visit it. A ref owns nothing; it stays valid while a PackedVector
+ // for the same lanes lives. Holders that keep a value past the op that produced it keep
+ // a PackedVector beside it (see retainVector() and HeldValue).
+ class VectorRef {
+ public:
+    VectorRef() = default;
+    bool empty() const { return header_ == nullptr; }
+    BDIType getElementType() const { return header_ ? header_->element_type : BDIType::UNKNOWN; }
+    size_t getElementSize() const { return header_ ? header_->element_size : 0; }
+    size_t getLaneCount() const { return header_ ? header_->lanes : 0; }
+    size_t getByteSize() const { return getLaneCount() * getElementSize(); }
+    const std::byte* data() const { return header_ ? reinterpret_cast<const std::byte*>(header_ + 1) : nullptr; }
+    template <typename T>
+    const T* lanes() const { return reinterpret_cast<const T*>(data()); }
+    // Same element type and lanes, compared bitwise
+    bool operator==(const VectorRef& other) const {
+        if (header_ == other.header_) return true;
+        return getElementType() == other.getElementType() && getLaneCount() == other.getLaneCount() &&
+               std::memcmp(data(), other.data(), getByteSize()) == 0;
+    }
+ private:
+    friend class PackedVector;
+    explicit VectorRef(detail::VectorHeader* header) : header_(header) {}
+    detail::VectorHeader* header_ = nullptr;
+ };
+ // --- Packed Vector --
+ // Value of the VEC_* ops: 'lanes' scalars of one integer or FLOAT32/FLOAT64 element type,
+ // contiguous and 64-byte aligned so SIMD kernels can stream through them. A vector is
+ // immutable once shared: copies only bump a reference count, and every kernel writes
+ // into a freshly allocated vector. PackedVector owns the lanes; values carry a VectorRef.
+ class PackedVector {
+ public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t MAX_BYTES = size_t{1} << 30;
+    static bool isElementType(BDIType type) {
+        switch (type) {
+            case BDIType::INT8: case BDIType::UINT8: case BDIType::INT16: case BDIType::UINT16:
+            case BDIType::INT32: case BDIType::UINT32: case BDIType::INT64: case BDIType::UINT64:
+            case BDIType::FLOAT32: case BDIType::FLOAT64:
+                return true;
+            default:
+                return false;
+        }
+    }
+    PackedVector() = default;
+    // Uninitialized lanes, writable through mutableData() until the vector is first copied.
+    // Empty if the element type is not packable or the size is 0 or above MAX_BYTES.
+    static PackedVector allocate(BDIType element_type, size_t lanes) {
+        PackedVector vector;
+        if (!isElementType(element_type) || lanes == 0) return vector;
+        const size_t element_size = core::types::getBdiTypeSize(element_type);
+        if (lanes > MAX_BYTES / element_size) return vector;
+        void* memory = ::operator new(sizeof(Header) + lanes * element_size, std::align_val_t{ALIGNMENT});
+        vector.header_ = new (memory) Header{{1}, element_type, static_cast<uint32_t>(element_size), lanes};
+        return vector;
+    }
+    PackedVector(const PackedVector& other) noexcept : header_(other.header_) {
+        if (header_) header_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Shares the lanes 'ref' points at; the ref must still be valid
+    explicit PackedVector(VectorRef ref) noexcept : header_(ref.header_) {
+        if (header_) header_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    PackedVector(PackedVector&& other) noexcept : header_(std::exchange(other.header_, nullptr)) {}
+    PackedVector& operator=(PackedVector other) noexcept {
+        std::swap(header_, other.header_);
+        return *this;
+    }
+    ~PackedVector() {
+        if (header_ && header_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            header_->~Header();
+            ::operator delete(header_, std::align_val_t{ALIGNMENT});
+        }
+    }
+    VectorRef ref() const { return VectorRef(header_); }
+    bool empty() const { return header_ == nullptr; }
+    BDIType getElementType() const { return header_ ? header_->element_type : BDIType::UNKNOWN; }
+    size_t getElementSize() const { return header_ ? header_->element_size : 0; }
+    size_t getLaneCount() const { return header_ ? header_->lanes : 0; }
+    size_t getByteSize() const { return getLaneCount() * getElementSize(); }
+    const std::byte* data() const { return header_ ? reinterpret_cast<const std::byte*>(header_ + 1) : nullptr; }
+    std::byte* mutableData() { return header_ ? reinterpret_cast<std::byte*>(header_ + 1) : nullptr; } // Before sharing only
+    template <typename T>
+    const T* lanes() const { return reinterpret_cast<const T*>(data()); }
+    // Same element type and lanes, compared bitwise
+    bool operator==(const PackedVector& other) const {
+        if (header_ == other.header_) return true;
+        return getElementType() == other.getElementType() && getLaneCount() == other.getLaneCount() &&
+               std::memcmp(data(), other.data(), getByteSize()) == 0;
+    }
+ private:
+    using Header = detail::VectorHeader;
+    static_assert(alignof(Header) == ALIGNMENT);
+    Header* header_ = nullptr;
+ };
+ } // namespace bdi::runtime
+ #endif // BDI_RUNTIME_PACKEDVECTOR_HPP
@@ -0,0 +1,86 @@
+ #ifndef BDI_RUNTIME_TAGGEDVALUE_HPP
+ #define BDI_RUNTIME_TAGGEDVALUE_HPP
+ #include "BDIValueVariant.hpp"
+ #include <bit>
+ #include <cstdint>
+ #include <optional>
+ #include <type_traits>
+ namespace bdi::runtime {
+ // --- Tagged Value --
+ // Compact runtime value: 8 payload bytes and a BDIType tag, 16 bytes in all and
+ // trivially copyable, so it moves in two registers and copies without a visit. Integers
+ // are stored sign- or zero-extended to 64 bits, floats as their bit pattern, so the typed
+ // accessors are a truncation or a bit cast and never branch on the tag. There is no room
+ // for a PackedVector: a holder that needs one keeps it on the side and tags the slot
+ // ARRAY (see ExecutionContext). Convert to/from BDIValueVariant at API boundaries.
+ struct TaggedValue {
+    uint64_t bits = 0;
+    BDIType type = BDIType::VOID;
+    constexpr TaggedValue() = default;
+    constexpr TaggedValue(uint64_t raw, BDIType tag) : bits(raw), type(tag) {}
+    template <typename T>
+    static constexpr TaggedValue of(T value) {
+        if constexpr (std::is_same_v<T, bool>) return {value ? 1u : 0u, BDIType::BOOL};
+        else if constexpr (std::is_same_v<T, float>) return {std::bit_cast<uint32_t>(value), BDIType::FLOAT32};
+        else if constexpr (std::is_same_v<T, double>) return {std::bit_cast<uint64_t>(value), BDIType::FLOAT64};
+        else if constexpr (std::is_signed_v<T>) return {static_cast<uint64_t>(static_cast<int64_t>(value)), tagOf<T>()};
+        else return {static_cast<uint64_t>(value), tagOf<T>()};
+    }
+    // Reads the payload as T whatever the tag says; the caller knows the type
+    template <typename T>
+    constexpr T as() const noexcept {
+        if constexpr (std::is_same_v<T, bool>) return bits != 0;
+        else if constexpr (std::is_same_v<T, float>) return std::bit_cast<float>(static_cast<uint32_t>(bits));
+        else if constexpr (std::is_same_v<T, double>) return std::bit_cast<double>(bits);
+        else return static_cast<T>(bits);
+    }
+    constexpr bool isVoid() const { return type == BDIType::VOID; }
+    constexpr bool operator==(const TaggedValue&) const = default;
+    // nullopt for a vector
+    static std::optional<TaggedValue> fromVariant(const BDIValueVariant& value) {
+        std::optional<TaggedValue> result;
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, std::monostate>) result = TaggedValue{};
+            else if constexpr (std::is_same_v<T, uintptr_t> && !std::is_same_v<uintptr_t, uint64_t>) result = TaggedValue{arg, BDIType::POINTER};
+            else if constexpr (!std::is_same_v<T, VectorRef>) result = of(arg);
+        }, value);
+        return result;
+    }
+    // A tag without a scalar alternative (ARRAY, STRUCT, ...) converts to monostate
+    BDIValueVariant toVariant() const {
+        switch (type) {
+            case BDIType::BOOL:    return as<bool>();
+            case BDIType::INT8:    return as<int8_t>();
+            case BDIType::UINT8:   return as<uint8_t>();
+            case BDIType::INT16:   return as<int16_t>();
+            case BDIType::UINT16:  return as<uint16_t>();
+            case BDIType::INT32:   return as<int32_t>();
+            case BDIType::UINT32:  return as<uint32_t>();
+            case BDIType::INT64:   return as<int64_t>();
+            case BDIType::UINT64:  return as<uint64_t>();
+            case BDIType::FLOAT32: return as<float>();
+            case BDIType::FLOAT64: return as<double>();
+            case BDIType::POINTER:
+            case BDIType::MEM_REF:
+            case BDIType::FUNC_PTR: return as<uintptr_t>();
+            default:               return std::monostate{};
+        }
+    }
+ private:
+    template <typename T>
+    static constexpr BDIType tagOf() {
+        if constexpr (std::is_same_v<T, int8_t>) return BDIType::INT8;
+        else if constexpr (std::is_same_v<T, uint8_t>) return BDIType::UINT8;
+        else if constexpr (std::is_same_v<T, int16_t>) return BDIType::INT16;
+        else if constexpr (std::is_same_v<T, uint16_t>) return BDIType::UINT16;
+        else if constexpr (std::is_same_v<T, int32_t>) return BDIType::INT32;
+        else if constexpr (std::is_same_v<T, uint32_t>) return BDIType::UINT32;
+        else if constexpr (std::is_same_v<T, int64_t>) return BDIType::INT64;
+        else if constexpr (std::is_same_v<T, uint64_t>) return BDIType::UINT64;
+        else static_assert(sizeof(T) == 0, "TaggedValue holds BDIValueVariant scalars only");
+    }
+ };
+ static_assert(sizeof(TaggedValue) == 16 && std::is_trivially_copyable_v<TaggedValue>, "TaggedValue is two machine words");
+ } // namespace bdi::runtime
+ #endif // BDI_RUNTIME_TAGGEDVALUE_HPP
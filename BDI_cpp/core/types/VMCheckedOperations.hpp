@@ -0,0 +1,305 @@
+ #ifndef BDI_RUNTIME_VMCHECKEDOPERATIONS_HPP
+ #define BDI_RUNTIME_VMCHECKEDOPERATIONS_HPP
+ #include "BDIValueVariant.hpp"
+ #include "VMStatus.hpp"
+ #include <cmath>
+ #include <cstring>
+ #include <limits>
+ #include <type_traits>
+ #include <utility>
+ #include <variant>
+ namespace bdi::runtime::vm_ops {
+ // --- Exception-Free Operations --
+ // Non-throwing counterparts of the perform* helpers in VMTypeOperations.hpp: same type
+ // promotion (TypeSystem::getPromotedType, resolved at compile time per operand pair),
+ // but every failure is a VMStatus. Integer arithmetic wraps.
+ namespace detail {
+ template <typename T> struct TypeTag { using type = T; };
+ template <typename X, typename Y>
+ constexpr auto promote() {
+    if constexpr (std::is_same_v<X, bool> || std::is_same_v<Y, bool>) {
+        return TypeTag<void>{}; // BOOL is not numeric
+    } else if constexpr (std::is_floating_point_v<X> || std::is_floating_point_v<Y>) {
+        if constexpr (std::is_same_v<X, double> || std::is_same_v<Y, double>) return TypeTag<double>{};
+        else return TypeTag<float>{};
+    } else if constexpr (std::is_signed_v<X> != std::is_signed_v<Y>) {
+        // An unsigned operand at least as wide wins; otherwise the wider signed one
+        if constexpr (std::is_unsigned_v<X> && sizeof(X) >= sizeof(Y)) return TypeTag<X>{};
+        else if constexpr (std::is_unsigned_v<Y> && sizeof(Y) >= sizeof(X)) return TypeTag<Y>{};
+        else if constexpr (std::is_signed_v<X>) return TypeTag<X>{};
+        else return TypeTag<Y>{};
+    } else if constexpr (sizeof(X) >= sizeof(Y)) {
+        return TypeTag<X>{};
+    } else {
+        return TypeTag<Y>{};
+    }
+ }
+ template <typename X, typename Y>
+ using Promoted = typename decltype(promote<X, Y>())::type;
+ template <typename T>
+ constexpr bool isVoid = std::is_same_v<T, std::monostate>;
+ template <typename T>
+ constexpr bool isVector = std::is_same_v<T, VectorRef>; // Only the VEC_* ops take vectors
+ // Wrapping arithmetic without signed overflow or narrow-type integer promotion
+ template <typename R, typename Op>
+ R wrapping(R a, R b, Op op) {
+    using U = std::conditional_t<(sizeof(R) < sizeof(unsigned)), unsigned, std::make_unsigned_t<R>>;
+    return static_cast<R>(op(static_cast<U>(a), static_cast<U>(b)));
+ }
+ template <bool IntegerOnly, typename Op>
+ VMResult<BDIValueVariant> binary(const BDIValueVariant& lhs, const BDIValueVariant& rhs, Op op) {
+    return std::visit([&op](auto a, auto b) -> VMResult<BDIValueVariant> {
+        using A = decltype(a);
+        using B = decltype(b);
+        if constexpr (isVoid<A> || isVoid<B>) {
+            return VMStatus::VOID_OPERAND;
+        } else if constexpr (isVector<A> || isVector<B>) {
+            return VMStatus::TYPE_MISMATCH;
+        } else {
+            using R = Promoted<A, B>;
+            if constexpr (std::is_void_v<R>) return VMStatus::TYPE_MISMATCH;
+            else if constexpr (IntegerOnly && !std::is_integral_v<R>) return VMStatus::TYPE_MISMATCH;
+            else return op(static_cast<R>(a), static_cast<R>(b));
+        }
+    }, lhs, rhs);
+ }
+ template <bool IntegerOnly, typename Op>
+ VMResult<BDIValueVariant> unary(const BDIValueVariant& value, Op op) {
+    return std::visit([&op](auto a) -> VMResult<BDIValueVariant> {
+        using A = decltype(a);
+        if constexpr (isVoid<A>) return VMStatus::VOID_OPERAND;
+        else if constexpr (std::is_same_v<A, bool> || isVector<A>) return VMStatus::TYPE_MISMATCH;
+        else if constexpr (IntegerOnly && !std::is_integral_v<A>) return VMStatus::TYPE_MISMATCH;
+        else return op(a);
+    }, value);
+ }
+ template <typename Op>
+ VMResult<BDIValueVariant> compare(const BDIValueVariant& lhs, const BDIValueVariant& rhs, Op op) {
+    return std::visit([&op](auto a, auto b) -> VMResult<BDIValueVariant> {
+        using A = decltype(a);
+        using B = decltype(b);
+        if constexpr (isVoid<A> || isVoid<B>) {
+            return VMStatus::VOID_OPERAND;
+        } else if constexpr (isVector<A> || isVector<B>) {
+            return VMStatus::TYPE_MISMATCH;
+        } else if constexpr (std::is_same_v<A, B>) {
+            return BDIValueVariant(static_cast<bool>(op(a, b)));
+        } else {
+            using R = Promoted<A, B>;
+            if constexpr (std::is_void_v<R>) return VMStatus::TYPE_MISMATCH;
+            else return BDIValueVariant(static_cast<bool>(op(static_cast<R>(a), static_cast<R>(b))));
+        }
+    }, lhs, rhs);
+ }
+ } // namespace detail
+ // --- Conversion --
+ // Float to integer T: truncated toward zero, OUT_OF_RANGE if the result does not fit (or is NaN)
+ template <typename T, typename X>
+ VMResult<T> truncateToInt(X x) {
+    const X upper = std::ldexp(X{1}, std::numeric_limits<T>::digits); // 2^digits is exact in X
+    const X lower = std::is_signed_v<T> ? -upper : X{0};
+    const X truncated = std::trunc(x);
+    if (!(truncated >= lower && truncated < upper)) return VMStatus::OUT_OF_RANGE; // Also rejects NaN
+    return static_cast<T>(truncated);
+ }
+ // Range-checked: integers must fit, floats are truncated and must fit, anything to BOOL is != 0
+ template <typename T>
+ VMResult<T> tryConvert(const BDIValueVariant& value) {
+    return std::visit([](auto x) -> VMResult<T> {
+        using X = decltype(x);
+        if constexpr (detail::isVoid<X>) {
+            return VMStatus::VOID_OPERAND;
+        } else if constexpr (detail::isVector<X>) {
+            return VMStatus::TYPE_MISMATCH;
+        } else if constexpr (std::is_same_v<X, T>) {
+            return x;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return x != X{};
+        } else if constexpr (std::is_same_v<X, bool> || std::is_floating_point_v<T>) {
+            return static_cast<T>(x);
+        } else if constexpr (std::is_integral_v<X>) {
+            if (!std::in_range<T>(x)) return VMStatus::OUT_OF_RANGE;
+            return static_cast<T>(x);
+        } else {
+            return truncateToInt<T>(x);
+        }
+    }, value);
+ }
+ inline VMResult<BDIValueVariant> tryConversion(const BDIValueVariant& value, BDIType target) {
+    auto wrap = [](auto result) -> VMResult<BDIValueVariant> {
+        if (!result) return result.error();
+        return BDIValueVariant(*result);
+    };
+    switch (target) {
+        case BDIType::BOOL: return wrap(tryConvert<bool>(value));
+        case BDIType::INT8: return wrap(tryConvert<int8_t>(value));
+        case BDIType::UINT8: return wrap(tryConvert<uint8_t>(value));
+        case BDIType::INT16: return wrap(tryConvert<int16_t>(value));
+        case BDIType::UINT16: return wrap(tryConvert<uint16_t>(value));
+        case BDIType::INT32: return wrap(tryConvert<int32_t>(value));
+        case BDIType::UINT32: return wrap(tryConvert<uint32_t>(value));
+        case BDIType::INT64: return wrap(tryConvert<int64_t>(value));
+        case BDIType::UINT64: return wrap(tryConvert<uint64_t>(value));
+        case BDIType::FLOAT32: return wrap(tryConvert<float>(value));
+        case BDIType::FLOAT64: return wrap(tryConvert<double>(value));
+        default: return VMStatus::TYPE_MISMATCH;
+    }
+ }
+ // Reinterprets the bits; source and target must have the same size
+ inline VMResult<BDIValueVariant> tryBitcast(const BDIValueVariant& value, BDIType target) {
+    auto cast = [&value](auto tag) -> VMResult<BDIValueVariant> {
+        using T = typename decltype(tag)::type;
+        return std::visit([](auto x) -> VMResult<BDIValueVariant> {
+            using X = decltype(x);
+            if constexpr (detail::isVoid<X>) return VMStatus::VOID_OPERAND;
+            else if constexpr (detail::isVector<X> || sizeof(X) != sizeof(T)) return VMStatus::TYPE_MISMATCH;
+            else {
+                T out;
+                std::memcpy(&out, &x, sizeof(T));
+                return BDIValueVariant(out);
+            }
+        }, value);
+    };
+    switch (target) {
+        case BDIType::INT8: return cast(detail::TypeTag<int8_t>{});
+        case BDIType::UINT8: return cast(detail::TypeTag<uint8_t>{});
+        case BDIType::INT16: return cast(detail::TypeTag<int16_t>{});
+        case BDIType::UINT16: return cast(detail::TypeTag<uint16_t>{});
+        case BDIType::INT32: return cast(detail::TypeTag<int32_t>{});
+        case BDIType::UINT32: return cast(detail::TypeTag<uint32_t>{});
+        case BDIType::INT64: return cast(detail::TypeTag<int64_t>{});
+        case BDIType::UINT64: return cast(detail::TypeTag<uint64_t>{});
+        case BDIType::FLOAT32: return cast(detail::TypeTag<float>{});
+        case BDIType::FLOAT64: return cast(detail::TypeTag<double>{});
+        default: return VMStatus::TYPE_MISMATCH;
+    }
+ }
+ // --- Arithmetic --
+ inline VMResult<BDIValueVariant> tryAddition(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<false>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> {
+        if constexpr (std::is_integral_v<decltype(a)>) return BDIValueVariant(detail::wrapping(a, b, [](auto x, auto y) { return x + y; }));
+        else return BDIValueVariant(a + b);
+    });
+ }
+ inline VMResult<BDIValueVariant> trySubtraction(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<false>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> {
+        if constexpr (std::is_integral_v<decltype(a)>) return BDIValueVariant(detail::wrapping(a, b, [](auto x, auto y) { return x - y; }));
+        else return BDIValueVariant(a - b);
+    });
+ }
+ inline VMResult<BDIValueVariant> tryMultiplication(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<false>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> {
+        if constexpr (std::is_integral_v<decltype(a)>) return BDIValueVariant(detail::wrapping(a, b, [](auto x, auto y) { return x * y; }));
+        else return BDIValueVariant(a * b);
+    });
+ }
+ inline VMResult<BDIValueVariant> tryDivision(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<false>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> {
+        using R = decltype(a);
+        if (b == R{0}) return VMStatus::DIVISION_BY_ZERO;
+        if constexpr (std::is_integral_v<R> && std::is_signed_v<R>) {
+            if (a == std::numeric_limits<R>::min() && b == R{-1}) return VMStatus::OUT_OF_RANGE;
+        }
+        return BDIValueVariant(static_cast<R>(a / b));
+    });
+ }
+ inline VMResult<BDIValueVariant> tryModulo(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<true>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> {
+        using R = decltype(a);
+        if (b == R{0}) return VMStatus::DIVISION_BY_ZERO;
+        if constexpr (std::is_signed_v<R>) {
+            if (b == R{-1}) return BDIValueVariant(R{0}); // min % -1 would trap
+        }
+        return BDIValueVariant(static_cast<R>(a % b));
+    });
+ }
+ inline VMResult<BDIValueVariant> tryNegation(const BDIValueVariant& v) {
+    return detail::unary<false>(v, [](auto a) -> VMResult<BDIValueVariant> {
+        using A = decltype(a);
+        if constexpr (std::is_unsigned_v<A>) return VMStatus::TYPE_MISMATCH; // Cannot negate unsigned
+        else if constexpr (std::is_integral_v<A>) return BDIValueVariant(detail::wrapping(A{0}, a, [](auto x, auto y) { return x - y; }));
+        else return BDIValueVariant(-a);
+    });
+ }
+ inline VMResult<BDIValueVariant> tryAbsolute(const BDIValueVariant& v) {
+    return detail::unary<false>(v, [](auto a) -> VMResult<BDIValueVariant> {
+        using A = decltype(a);
+        if constexpr (std::is_floating_point_v<A>) return BDIValueVariant(std::fabs(a));
+        else if constexpr (std::is_unsigned_v<A>) return BDIValueVariant(a);
+        else {
+            if (a == std::numeric_limits<A>::min()) return VMStatus::OUT_OF_RANGE;
+            return BDIValueVariant(static_cast<A>(a < 0 ? -a : a));
+        }
+    });
+ }
+ // --- Bitwise --
+ inline VMResult<BDIValueVariant> tryBitwiseAND(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<true>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> { return BDIValueVariant(static_cast<decltype(a)>(a & b)); });
+ }
+ inline VMResult<BDIValueVariant> tryBitwiseOR(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<true>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> { return BDIValueVariant(static_cast<decltype(a)>(a | b)); });
+ }
+ inline VMResult<BDIValueVariant> tryBitwiseXOR(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::binary<true>(l, r, [](auto a, auto b) -> VMResult<BDIValueVariant> { return BDIValueVariant(static_cast<decltype(a)>(a ^ b)); });
+ }
+ inline VMResult<BDIValueVariant> tryBitwiseNOT(const BDIValueVariant& v) {
+    return detail::unary<true>(v, [](auto a) -> VMResult<BDIValueVariant> { return BDIValueVariant(static_cast<decltype(a)>(~a)); });
+ }
+ namespace detail {
+ // Shifts keep the type of the shifted value; the amount must be in [0, bit width)
+ template <typename Op>
+ VMResult<BDIValueVariant> shift(const BDIValueVariant& value, const BDIValueVariant& amount, Op op) {
+    auto count = tryConvert<int64_t>(amount);
+    if (!count) return count.error() == VMStatus::VOID_OPERAND ? VMStatus::VOID_OPERAND : VMStatus::SHIFT_OUT_OF_RANGE;
+    return unary<true>(value, [&op, n = *count](auto a) -> VMResult<BDIValueVariant> {
+        if (n < 0 || n >= static_cast<int64_t>(sizeof(a) * 8)) return VMStatus::SHIFT_OUT_OF_RANGE;
+        return op(a, static_cast<unsigned>(n));
+    });
+ }
+ } // namespace detail
+ inline VMResult<BDIValueVariant> tryBitwiseSHL(const BDIValueVariant& l, const BDIValueVariant& r) {
+    return detail::shift(l, r, [](auto a, unsigned n) -> VMResult<BDIValueVariant> {
+        using U = std::make_unsigned_t<decltype(a)>;
+        return BDIValueVariant(static_cast<decltype(a)>(static_cast<U>(static_cast<U>(a) << n)));
+    });
+ }
+ inline VMResult<BDIValueVariant> tryBitwiseSHR(const BDIValueVariant& l, const BDIValueVariant& r) { // Logical
+    return detail::shift(l, r, [](auto a, unsigned n) -> VMResult<BDIValueVariant> {
+        using U = std::make_unsigned_t<decltype(a)>;
+        return BDIValueVariant(static_cast<decltype(a)>(static_cast<U>(static_cast<U>(a) >> n)));
+    });
+ }
+ inline VMResult<BDIValueVariant> tryBitwiseASHR(const BDIValueVariant& l, const BDIValueVariant& r) { // Arithmetic
+    return detail::shift(l, r, [](auto a, unsigned n) -> VMResult<BDIValueVariant> {
+        if constexpr (std::is_unsigned_v<decltype(a)>) return VMStatus::TYPE_MISMATCH;
+        else return BDIValueVariant(static_cast<decltype(a)>(a >> n));
+    });
+ }
+ // --- Logical --
+ namespace detail {
+ template <typename Op>
+ VMResult<BDIValueVariant> logical(const BDIValueVariant& l, const BDIValueVariant& r, Op op) {
+    auto a = tryConvert<bool>(l);
+    if (!a) return a.error();
+    auto b = tryConvert<bool>(r);
+    if (!b) return b.error();
+    return BDIValueVariant(static_cast<bool>(op(*a, *b)));
+ }
+ } // namespace detail
+ inline VMResult<BDIValueVariant> tryLogicalAND(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::logical(l, r, [](bool a, bool b) { return a && b; }); }
+ inline VMResult<BDIValueVariant> tryLogicalOR(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::logical(l, r, [](bool a, bool b) { return a || b; }); }
+ inline VMResult<BDIValueVariant> tryLogicalXOR(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::logical(l, r, [](bool a, bool b) { return a != b; }); }
+ inline VMResult<BDIValueVariant> tryLogicalNOT(const BDIValueVariant& v) {
+    auto a = tryConvert<bool>(v);
+    if (!a) return a.error();
+    return BDIValueVariant(!*a);
+ }
+ // --- Comparison --
+ inline VMResult<BDIValueVariant> tryComparisonEQ(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a == b; }); }
+ inline VMResult<BDIValueVariant> tryComparisonNE(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a != b; }); }
+ inline VMResult<BDIValueVariant> tryComparisonLT(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a < b; }); }
+ inline VMResult<BDIValueVariant> tryComparisonLE(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a <= b; }); }
+ inline VMResult<BDIValueVariant> tryComparisonGT(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a > b; }); }
+ inline VMResult<BDIValueVariant> tryComparisonGE(const BDIValueVariant& l, const BDIValueVariant& r) { return detail::compare(l, r, [](auto a, auto b) { return a >= b; }); }
+ } // namespace bdi::runtime::vm_ops
+ #endif // BDI_RUNTIME_VMCHECKEDOPERATIONS_HPP
@@ -0,0 +1,79 @@
+ #ifndef BDI_RUNTIME_VMSTATUS_HPP
+ #define BDI_RUNTIME_VMSTATUS_HPP
+ #include "BDIValueVariant.hpp"
+ #include <cstdint>
+ #include <string>
+ #include <utility>
+ // BDI_VM_EXCEPTIONS=0 builds the op handlers (NodeEvaluator, TaskEngine, DataflowExecutor)
+ // without exceptions: faults travel only as VMStatus codes, and the throwing wrappers
+ // (NodeEvaluator::evaluate) are compiled out. Set by the BDI_VM_EXCEPTIONS CMake option.
+ #ifndef BDI_VM_EXCEPTIONS
+ #define BDI_VM_EXCEPTIONS 1
+ #endif
+ namespace bdi::runtime {
+ // --- Status Codes ---
+ enum class VMStatus : uint8_t {
+    OK,
+    ARITY,              // Wrong number of inputs
+    VOID_OPERAND,       // Input holds no value
+    TYPE_MISMATCH,      // No promotion/conversion between the operand types
+    OUT_OF_RANGE,       // Value does not fit the target type
+    DIVISION_BY_ZERO,
+    SHIFT_OUT_OF_RANGE, // Shift amount negative or >= bit width
+    ASSERTION_FAILED,
+    MEMORY_FAULT,       // Read/write/alloc/free rejected by the MemoryManager
+    NO_MEMORY_MANAGER,
+    UNSUPPORTED_OP      // Not handled by this evaluator
+ };
+ constexpr const char* toString(VMStatus status) {
+    switch (status) {
+        case VMStatus::OK: return "ok";
+        case VMStatus::ARITY: return "wrong number of inputs";
+        case VMStatus::VOID_OPERAND: return "void operand";
+        case VMStatus::TYPE_MISMATCH: return "type mismatch";
+        case VMStatus::OUT_OF_RANGE: return "value out of range";
+        case VMStatus::DIVISION_BY_ZERO: return "division by zero";
+        case VMStatus::SHIFT_OUT_OF_RANGE: return "shift amount out of range";
+        case VMStatus::ASSERTION_FAILED: return "assertion failed";
+        case VMStatus::MEMORY_FAULT: return "memory fault";
+        case VMStatus::NO_MEMORY_MANAGER: return "no MemoryManager";
+        case VMStatus::UNSUPPORTED_OP: return "unsupported operation";
+    }
+    return "unknown status";
+ }
+ // --- Error Side Channel ---
+ // Where and why the last op failed. Kept out of the return value so the hot path only
+ // passes a one-byte VMStatus; 'detail' is a static string, so recording an error never allocates.
+ struct VMErrorInfo {
+    VMStatus status = VMStatus::OK;
+    NodeID node_id = 0;
+    const char* detail = "";
+    bool ok() const { return status == VMStatus::OK; }
+    std::string message() const {
+        std::string text = toString(status);
+        if (detail && *detail) text += std::string(" (") + detail + ")";
+        return text;
+    }
+    std::string describe() const { return "node " + std::to_string(node_id) + ": " + message(); }
+ };
+ // --- Result Type ---
+ // The subset of std::expected<T, VMStatus> the op handlers need (the tree builds as C++20).
+ template <typename T>
+ class VMResult {
+ public:
+    VMResult(T value) : value_(std::move(value)) {}
+    VMResult(VMStatus status) : status_(status) {}
+    bool has_value() const { return status_ == VMStatus::OK; }
+    explicit operator bool() const { return has_value(); }
+    VMStatus error() const { return status_; }
+    T& value() { return value_; }
+    const T& value() const { return value_; }
+    T& operator*() { return value_; }
+    const T& operator*() const { return value_; }
+    T value_or(T fallback) const { return has_value() ? value_ : std::move(fallback); }
+ private:
+    T value_{};
+    VMStatus status_ = VMStatus::OK;
+ };
+ } // namespace bdi::runtime
+ #endif // BDI_RUNTIME_VMSTATUS_HPP
@@ -3,13 +3,15 @@
  #include "BDIValueVariant.hpp"
  #include "TypeSystem.hpp"
  #include "MapCppTypeToBdiType.hpp" // Include mapping
+ #include "Logger.hpp"
  #include <optional>
  #include <cmath>
  #include <limits>
  #include <stdexcept>
- #include <iostream> // For errors
  #include <type_traits>
  #include <bit> // For bit_cast and integral checks in C++23
+ // Throwing API used by BDIVirtualMachine. Exception-free handlers (NodeEvaluator, TaskEngine,
+ // DataflowExecutor) use the VMStatus-returning try* variants in VMCheckedOperations.hpp.
  namespace bdi::runtime::vm_ops {
     // Custom Exception for VM runtime errors
     class BDIExecutionError : public std::runtime_error {
@@ -63,7 +65,7 @@
                         !std::isfinite(arg)) // Also check for NaN/Inf
                     {
  (std::numeric_limits<TargetType>::max())) { // Range check }
-                       std::cerr << "VM Convert Warning: Float->Int overflow/underflow detected." << std::endl;
+                       BDI_LOG_WARN(VM, "Float->Int overflow/underflow detected.");
                        result = static_cast<TargetType>(arg);
                        success = true;
                        // Decide on behavior: saturate, wrap (for unsigned?), error out? For now, allow standard cast.
@@ -75,8 +77,8 @@
                         arg > static_cast<SourceCppType>(std::numeric_limits<TargetType>::max()) ||
                         !std::isfinite(arg)) // Also check for NaN/Inf
                     {
-                         std::cerr << "VM Convert Warning: Float->Int overflow/underflow/invalid detected ("
-                                   << arg << " to " << core::types::bdiTypeToString(target_bdi_type) << ")." << std::endl;
+                         BDI_LOG_WARN(VM, "Float->Int overflow/underflow/invalid detected ("
+                                   << arg << " to " << core::types::bdiTypeToString(target_bdi_type) << ").");
                          // Decide behavior: fail, saturate? For now, fail.
                          success = false; return;
                     }
@@ -130,8 +132,8 @@
                     // Narrowing Int -> Int: Check range
                     if (arg < static_cast<SourceCppType>(std::numeric_limits<TargetType>::min()) ||
                         arg > static_cast<SourceCppType>(std::numeric_limits<TargetType>::max())) {
-                         std::cerr << "VM Convert Warning: Narrowing integer conversion out of range ("
-                                   << arg << " to " << core::types::bdiTypeToString(target_bdi_type) << ")." << std::endl;
+                         BDI_LOG_WARN(VM, "Narrowing integer conversion out of range ("
+                                   << arg << " to " << core::types::bdiTypeToString(target_bdi_type) << ").");
                          success = false; return; // Fail on overflow
                     }
                  } else if constexpr (std::is_floating_point_v<TargetType> && std::is_floating_point_v<SourceCppType> && sizeof(SourceCppType) >
@@ -161,8 +163,8 @@
     }
     // Log failure if not converting monostate
     if (!std::holds_alternative<std::monostate>(value_var)) {
-         std::cerr << "VM Convert Error: Failed to convert " << core::types::bdiTypeToString(getBDIType(value_var))
-                   << " to " << core::types::bdiTypeToString(target_bdi_type) << std::endl;
+         BDI_LOG_ERROR(VM, "Failed to convert " << core::types::bdiTypeToString(getBDIType(value_var))
+                   << " to " << core::types::bdiTypeToString(target_bdi_type));
     }
                        result = static_cast<TargetType>(arg);
                        success = true;
@@ -173,9 +175,9 @@
                  result = static_cast<TargetType>(arg);
                  success = true;
              } else {
-                  std::cerr << "VM Convert Error: Implicit conversion not allowed by TypeSystem from "
+                  BDI_LOG_ERROR(VM, "Implicit conversion not allowed by TypeSystem from "
                             << core::types::bdiTypeToString(source_bdi_type) << " to "
-                            << core::types::bdiTypeToString(target_bdi_type) << std::endl;
+                            << core::types::bdiTypeToString(target_bdi_type));
              }
         }
     }, value_var);
@@ -202,8 +204,7 @@ inline BDIValueVariant performAddition(const BDIValueVariant& lhs_var, const BDI
          if (v1 && v2) return *v1 + *v2;
     }
     // Add UINT cases...
-    std::cerr << "VM Op Error: Addition failed for types " << core::types::bdiTypeToString(type1) << ", " << core::types::bdiTypeToString(type2) <<
- std::endl;
+    BDI_LOG_ERROR(VM, "Addition failed for types " << core::types::bdiTypeToString(type1) << ", " << core::types::bdiTypeToString(type2));
     return std::monostate{}; // Error
  }
  // Implement performSubtraction, performMultiplication, performDivision (with zero check), etc. similarly
@@ -565,7 +566,7 @@ BDIValueVariant performComparison(const BDIValueVariant& lhs_var, const BDIValue
     size_t source_size = core::types::getBdiTypeSize(source_type);
     size_t target_size = core::types::getBdiTypeSize(target_bdi_type);
     if (source_size != target_size || source_size == 0) {
-         std::cerr << "VM Error: BITCAST requires source and target types of equal non-zero size." << std::endl;
+         BDI_LOG_ERROR(VM, "BITCAST requires source and target types of equal non-zero size.");
         return std::monostate{};
     }
     // Convert input variant to payload, then payload back to target variant type
@@ -52,7 +52,7 @@ virtual bool writePhysical(uint64_t physical_address, const std::byte* buffer, s
      * if running in identity-mapped mode initially. Needs careful design. 
 * Returns the *virtual* address BDI should use. 
      */ 
-virtual std::optional<uintptr_t> mapPhysicalMemory(uint64_t physical_address, size_t size_bytes, uint64_t flags /* e.g., cacheable, writab
+virtual std::optional<uintptr_t> mapPhysicalMemory(uint64_t physical_address, size_t size_bytes, uint64_t flags /* e.g., cacheable, writable */) = 0; 
  /** @brief Unmaps a previously mapped region. */ 
 virtual bool unmapMemory(uintptr_t virtual_address, size_t size_bytes) = 0; 
 /** @brief Enables hardware interrupts. */ 
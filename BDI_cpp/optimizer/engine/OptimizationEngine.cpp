@@ -1,11 +1,20 @@
  #include "OptimizationEngine.hpp"
- #include <iostream>
+ #include "Logger.hpp"
  namespace bdi::optimizer {
  void OptimizationEngine::addPass(std::unique_ptr<OptimizationPassBase> pass) {
     if (pass) {
+        pass->setProfile(getProfile());
         passes_.push_back(std::move(pass));
     }
  }
+ void OptimizationEngine::setProfile(ProfileGuidance profile) {
+    profile_ = std::move(profile);
+    for (const auto& pass : passes_) pass->setProfile(&*profile_);
+ }
+ void OptimizationEngine::clearProfile() {
+    profile_.reset();
+    for (const auto& pass : passes_) pass->setProfile(nullptr);
+ }
  bool OptimizationEngine::run(BDIGraph& graph, int max_iterations) {
     bool changed_overall = false;
     bool changed_in_iteration = false;
@@ -13,16 +22,16 @@
     if (passes_.empty()) {
         return false;
     }
-    std::cout << "OptimizationEngine: Running passes..." << std::endl;
+    BDI_LOG_DEBUG(OPTIMIZER, "Running " << passes_.size() << " pass(es)");
     do {
         changed_in_iteration = false;
         iteration++;
-        std::cout << "  Iteration " << iteration << "..." << std::endl;
+        BDI_LOG_TRACE(OPTIMIZER, "Iteration " << iteration);
         for (const auto& pass : passes_) {
-            std::cout << "    Running Pass: " << pass->getName() << "..." << std::endl;
+            BDI_LOG_TRACE(OPTIMIZER, "Running pass " << pass->getName());
             bool pass_changed = pass->run(graph);
             if (pass_changed) {
-                std::cout << "      Graph modified by " << pass->getName() << "." << std::endl;
+                BDI_LOG_DEBUG(OPTIMIZER, "Graph modified by " << pass->getName() << " in iteration " << iteration);
                 changed_in_iteration = true;
                 changed_overall = true;
                  // Optional: Re-validate graph after modification?
@@ -31,14 +40,14 @@
                  //     return changed_overall; // Abort?
                  // }
             }
+        }
          if (!changed_in_iteration) {
-             std::cout << "  No changes in iteration " << iteration << ". Optimization stable." << std::endl;
+             BDI_LOG_DEBUG(OPTIMIZER, "No changes in iteration " << iteration << ", optimization stable");
         }
     } while (changed_in_iteration && iteration < max_iterations);
     if (iteration >= max_iterations && changed_in_iteration) {
-         std::cout << "OptimizationEngine: Warning - Max iterations reached, optimizations might not be stable." << std::endl;
+         BDI_LOG_WARN(OPTIMIZER, "Max iterations (" << max_iterations << ") reached, optimizations might not be stable");
     }
-     std::cout << "OptimizationEngine: Finished." << std::endl;
     return changed_overall;
  }
  } // namespace bdi::optimizer
@@ -2,6 +2,8 @@
  #define BDI_OPTIMIZER_OPTIMIZATIONENGINE_HPP
  #include "OptimizationPassBase.hpp"
  #include "BDIGraph.hpp"
+ #include "ProfileGuidance.hpp"
+ #include <optional>
  #include <vector>
  #include <memory> // For unique_ptr
  namespace bdi::optimizer {
@@ -10,11 +12,16 @@
     OptimizationEngine() = default;
     // Add an optimization pass to the pipeline
     void addPass(std::unique_ptr<OptimizationPassBase> pass);
+    // Execution profile made available to every pass (see runtime Profiler); replaces any previous one
+    void setProfile(ProfileGuidance profile);
+    void clearProfile();
+    const ProfileGuidance* getProfile() const { return profile_ ? &*profile_ : nullptr; }
     // Run all registered passes on the graph until no more changes occur (optional)
     // or for a fixed number of iterations. Returns true if any changes were made.
     bool run(BDIGraph& graph, int max_iterations = 10);
  private:
     std::vector<std::unique_ptr<OptimizationPassBase>> passes_;
+    std::optional<ProfileGuidance> profile_;
  };
  } // namespace bdi::optimizer
  #endif // BDI_OPTIMIZER_OPTIMIZATIONENGINE_HPP
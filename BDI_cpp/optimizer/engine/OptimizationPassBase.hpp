@@ -1,6 +1,7 @@
  #ifndef BDI_OPTIMIZER_OPTIMIZATIONPASSBASE_HPP
  #define BDI_OPTIMIZER_OPTIMIZATIONPASSBASE_HPP
  #include "GraphVisitor.hpp"
+ #include "ProfileGuidance.hpp"
  #include <string>
  namespace bdi::optimizer {
  // Base class for optimization passes, inheriting from GraphVisitor
@@ -16,13 +17,18 @@
         return graph_modified_;  // Return whether the graph was changed
     }
     const std::string& getName() const { return name_; }
+    // Set by the OptimizationEngine; nullptr when no profile was collected
+    void setProfile(const ProfileGuidance* profile) { profile_ = profile; }
  protected:
     // Helper for derived classes to signal modification
     void markGraphModified() { graph_modified_ = true; }
     bool wasGraphModified() const { return graph_modified_; }
+    // Profile-guided passes consult this (e.g. only duplicate/unroll hot nodes)
+    const ProfileGuidance* getProfile() const { return profile_; }
  private:
     std::string name_;
     bool graph_modified_;
+    const ProfileGuidance* profile_ = nullptr;
  };
  } // namespace bdi::optimizer
  #endif // BDI_OPTIMIZER_OPTIMIZATIONPASSBASE_HPP
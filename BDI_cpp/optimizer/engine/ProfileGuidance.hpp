@@ -0,0 +1,33 @@
+ #ifndef BDI_OPTIMIZER_PROFILEGUIDANCE_HPP
+ #define BDI_OPTIMIZER_PROFILEGUIDANCE_HPP
+ #include "BDINode.hpp"
+ #include <cstdint>
+ #include <unordered_map>
+ namespace bdi::optimizer {
+ using bdi::core::graph::NodeID;
+ // Measured execution profile of one graph, handed to passes by the OptimizationEngine.
+ // Produced by the runtime profiler (ProfileData::toGuidance); passes treat it as a hint
+ // and must stay correct when a node has no entry.
+ struct ProfileGuidance {
+    struct NodeWeight {
+        uint64_t count = 0;  // Executions
+        uint64_t cycles = 0; // Inclusive of the node's own work only
+    };
+    std::unordered_map<NodeID, NodeWeight> nodes;
+    uint64_t total_cycles = 0;
+    uint64_t getCount(NodeID id) const {
+        auto it = nodes.find(id);
+        return it == nodes.end() ? 0 : it->second.count;
+    }
+    uint64_t getCycles(NodeID id) const {
+        auto it = nodes.find(id);
+        return it == nodes.end() ? 0 : it->second.cycles;
+    }
+    // True if the node accounts for at least 'fraction' (0..1) of all profiled cycles
+    bool isHot(NodeID id, double fraction = 0.01) const {
+        return total_cycles != 0 && static_cast<double>(getCycles(id)) >= fraction * static_cast<double>(total_cycles);
+    }
+    bool empty() const { return nodes.empty(); }
+ };
+ } // namespace bdi::optimizer
+ #endif // BDI_OPTIMIZER_PROFILEGUIDANCE_HPP
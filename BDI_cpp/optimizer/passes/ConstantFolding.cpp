@@ -3,7 +3,7 @@
  #include "TypeSystem.hpp"
  #include "ExecutionContext.hpp" // For payload<->variant conversion
  #include "BDIValueVariant.hpp" // For evaluation result
- #include <iostream>
+ #include "Logger.hpp"
  #include <variant>
  #include <set> // To avoid duplicate rewiring
  namespace bdi::optimizer {
@@ -16,14 +16,15 @@
     if (!current_graph_) return std::nullopt;
     auto node_opt = current_graph_->getNode(node_id);
     if (!node_opt) return std::nullopt;
-    // ... (Check cache first) ... 
+    if (auto pooled = constant_pool_.getValue(node_id)) return pooled; // Decoded once per visit
     const BDINode& node = node_opt.value();
     // Define what constitutes a "constant" node for this pass
     // Option 1: Specific META_CONST operation type (preferred)
     // if (node.operation == BDIOperationType::META_CONST) { ... }
     // Option 2: Use NOP nodes with payloads (as used in tests)
     // Check for new META_CONST type 
-    if (node.operation == BDIOperationType::META_NOP && node.payload.isValid() && node.payload.type != BDIType::VOID) {
+    // Constant nodes added by folding are not in the pool
+    if (ConstantPool::isConstantNode(node)) {
         return ExecutionContext::payloadToVariant(node.payload);
     }
     // Keep NOP check for backward compatibility or specific cases? Remove if META_CONST is sole method. 
@@ -140,7 +141,7 @@
             default: break; // Cannot fold this operation
         }
     } catch (const std::exception& e) {
-         std::cerr << "ConstantFolding: Evaluation error for Node " << node.id << ": " << e.what() << std::endl;
+         BDI_LOG_WARN(OPTIMIZER, "Evaluation error for Node " << node.id << ": " << e.what());
          return std::nullopt; // Evaluation failed
     }
     if (std::holds_alternative<std::monostate>(result_var)) {
@@ -163,7 +164,7 @@
  void ConstantFolding::replaceNodeWithConstant(BDINode& node_to_replace, const BDIValueVariant& constant_result) {
      if (!current_graph_) return;
      NodeID old_node_id = node_to_replace.id;
-     std::cout << "  Folding node " << old_node_id << " to constant." << std::endl;
+     BDI_LOG_DEBUG(OPTIMIZER, "Folding node " << old_node_id << " to constant");
      // 1. Create Payload for the constant result
      TypedPayload constant_payload = ExecutionContext::variantToPayload(constant_result);
      if (constant_payload.type == BDIType::UNKNOWN) return;
@@ -177,14 +178,14 @@
      for(auto& port_info : new_const_node->data_outputs) {
          port_info.name += "_folded";
      }
-          std::cerr << "    Error: Failed to create payload for constant result." << std::endl;
+          BDI_LOG_ERROR(OPTIMIZER, "Failed to create payload for constant result.");
           return;
      }
      // 2. Create the new constant node (using NOP for now)
      NodeID new_const_node_id = current_graph_->addNode(BDIOperationType::META_NOP); // Or META_CONST if defined
      BDINode* new_const_node = current_graph_->getNodeMutable(new_const_node_id); // Need mutable access via graph
      if (!new_const_node) {
-         std::cerr << "    Error: Failed to create new constant node." << std::endl;
+         BDI_LOG_ERROR(OPTIMIZER, "Failed to create new constant node.");
          current_graph_->removeNode(new_const_node_id); // Clean up potentially added node
          return;
      }
@@ -193,7 +194,7 @@
      NodeID new_const_node_id = current_graph_->addNode(BDIOperationType::META_CONST); // Use META_CONST 
      BDINode* new_const_node = current_graph_->getNodeMutable(new_const_node_id);
      if (!new_const_node) {
-         std::cerr << "    Error: Failed to create new constant node." << std::endl;
+         BDI_LOG_ERROR(OPTIMIZER, "Failed to create new constant node.");
          current_graph_->removeNode(new_const_node_id); // Clean up potentially added node
          return;
      }
@@ -207,7 +208,7 @@
          new_const_node->data_outputs.push_back({constant_payload.type, node_to_replace.data_outputs[0].name + "_folded"});
      } else {
          // Handle case where original node had no output? Maybe error.
-         std::cerr << "    Warning: Original node " << old_node_id << " had no output port defined." << std::endl;
+         BDI_LOG_WARN(OPTIMIZER, "Original node " << old_node_id << " had no output port defined.");
           new_const_node->data_outputs.push_back({constant_payload.type, "_folded"});
      }
      // 3. Find all consumers of the original node's output(s) and rewire them
@@ -231,8 +232,8 @@
                      consumers_updated.push_back({potential_consumer.id, (PortIndex)input_idx});
                      markGraphModified();
                  } else {
-                     std::cerr << "    Warning: Consumer Node " << potential_consumer.id << " used invalid Port "
-                               << input_ref.port_index << " from folded Node " << old_node_id << std::endl;
+                     BDI_LOG_WARN(OPTIMIZER, "Consumer Node " << potential_consumer.id << " used invalid Port "
+                               << input_ref.port_index << " from folded Node " << old_node_id);
                  }
              }
          }
@@ -297,6 +298,7 @@
  void ConstantFolding::visitGraph(BDIGraph& graph) {
     current_graph_ = &graph;
     constant_values_.clear();
+    constant_pool_ = ConstantPool(graph);
     bool changed_in_pass;
     // Iterate multiple times until no more folding occurs in a pass
     // Or use a worklist approach for efficiency
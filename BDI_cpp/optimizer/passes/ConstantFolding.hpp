@@ -2,12 +2,14 @@
  #define BDI_OPTIMIZER_PASSES_CONSTANTFOLDING_HPP
  #include "OptimizationPassBase.hpp"
  #include "BDIValueVariant.hpp" // Need variant for evaluation
+ #include "ConstantPool.hpp"
  #include <unordered_map>
  #include <optional>
  namespace bdi::optimizer {
  using bdi::runtime::BDIValueVariant;
  using bdi::core::graph::NodeID;
  using bdi::core::graph::PortRef;
+ using bdi::core::graph::PortRefHash;
  // Simple constant folding pass
  class ConstantFolding : public OptimizationPassBase {
  public:
@@ -15,7 +17,8 @@
     void visitGraph(BDIGraph& graph) override;
  private:
     // Structure to hold constant values found during traversal
-    std::unordered_map<PortRef, BDIValueVariant, bdi::runtime::PortRefHash> constant_values_;
+    std::unordered_map<PortRef, BDIValueVariant, PortRefHash> constant_values_;
+    bdi::runtime::ConstantPool constant_pool_; // Constant nodes of the graph as visitGraph found it
     BDIGraph* current_graph_ = nullptr; // Need graph access for rewiring
     // Attempts to evaluate a node if all its inputs are constant
     std::optional<BDIValueVariant> evaluateConstantNode(BDINode& node);
@@ -1,5 +1,5 @@
  #include "DeadCodeElimination.hpp"
- #include <iostream>
+ #include "Logger.hpp"
  #include <vector>
  #include <algorithm>
  namespace bdi::optimizer {
@@ -7,6 +7,10 @@
     // Define operations considered to have side effects
     switch (node.operation) {
         case BDIOperationType::MEM_STORE:
+        case BDIOperationType::VEC_STORE_PACKED:
+        case BDIOperationType::GRAPH_TRAVERSE: // Writes its output array in memory
+        case BDIOperationType::LINALG_MATMUL: // Writes its C matrix in memory
+        case BDIOperationType::SIGNAL_FFT: // Transforms its buffer in place
         case BDIOperationType::MEM_FREE:
         case BDIOperationType::IO_WRITE_PORT:
         case BDIOperationType::IO_PRINT:
@@ -60,7 +64,7 @@
          }
     }
      if (root_live_nodes.empty()) {
-          std::cout << "    DCE Warning: No essential live nodes found (e.g., META_END). Graph might be empty or invalid." << std::endl;
+          BDI_LOG_WARN(OPTIMIZER, "DCE: No essential live nodes found (e.g., META_END). Graph might be empty or invalid.");
           // Maybe find the designated START node if no END node?
           // return false; // No changes if nothing is live
      }
@@ -77,20 +81,18 @@
     }
     // 4. Remove dead nodes (carefully, consider dependencies within dead nodes)
     if (!dead_nodes.empty()) {
-        std::cout << "    DCE Found dead nodes: ";
-        for(NodeID id : dead_nodes) std::cout << id << " ";
-        std::cout << std::endl;
+        BDI_LOG_DEBUG(OPTIMIZER, "DCE: Removing " << dead_nodes.size() << " dead node(s)");
         for (NodeID dead_id : dead_nodes) {
             // Removal logic needs to handle edges cleanly. BDIGraph::removeNode should do this.
             if (graph.removeNode(dead_id)) {
                  markGraphModified();
                  //std::cout << "      Removed dead node: " << dead_id << std::endl;
             } else {
-                 std::cerr << "      DCE Error: Failed to remove dead node " << dead_id << std::endl;
+                 BDI_LOG_ERROR(OPTIMIZER, "DCE: Failed to remove dead node " << dead_id);
             }
         }
     } else {
-         std::cout << "    DCE: No dead nodes found." << std::endl;
+         BDI_LOG_TRACE(OPTIMIZER, "DCE: No dead nodes found");
     }
     current_graph_ = nullptr;
     return wasGraphModified();
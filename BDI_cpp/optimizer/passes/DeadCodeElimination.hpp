@@ -8,13 +8,14 @@
     DeadCodeElimination() : OptimizationPassBase("DeadCodeElimination") {}
     // Override run to perform analysis and removal
     bool run(BDIGraph& graph) override;
+    // Check if a node has side effects (memory write, IO, volatile op, etc.)
+    // Static so runtime schedulers can share the same classification.
+    static bool hasSideEffects(const BDINode& node);
  private:
     std::set<NodeID> live_nodes_; // Nodes identified as live
     BDIGraph* current_graph_ = nullptr;
     // Mark nodes reachable backwards from essential nodes
     void markLiveNodes(NodeID current_node_id);
-    // Check if a node has side effects (memory write, IO, volatile op, etc.)
-    bool hasSideEffects(const BDINode& node);
  };
  } // namespace bdi::optimizer
  #endif // BDI_OPTIMIZER_PASSES_DEADCODEELIMINATION_HPP
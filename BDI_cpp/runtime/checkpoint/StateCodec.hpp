@@ -0,0 +1,140 @@
+#ifndef BDI_RUNTIME_STATECODEC_HPP
+#define BDI_RUNTIME_STATECODEC_HPP
+#include "BDIValueVariant.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+namespace bdi::runtime::state_codec {
+// Host-endian byte streams for runtime state files (VM checkpoints, execution journals).
+// Writers record a byte order mark in their file header; readers bounds-check every field.
+// Values are stored as (alternative index, 8 raw bytes). A vector's 8 bytes hold its
+// element type (low byte) and lane count, and its lanes follow.
+template <typename T>
+constexpr bool fitsRawSlot() {
+    if constexpr (std::is_same_v<T, std::monostate> || std::is_same_v<T, VectorRef>) return true;
+    else return std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t);
+}
+template <size_t... I>
+constexpr bool allFitRawSlot(std::index_sequence<I...>) {
+    return (fitsRawSlot<std::variant_alternative_t<I, BDIValueVariant>>() && ...);
+}
+static_assert(allFitRawSlot(std::make_index_sequence<std::variant_size_v<BDIValueVariant>>{}),
+              "State value encoding assumes scalar BDIValueVariant alternatives (besides VectorRef)");
+template <typename T>
+BDIValueVariant loadAlternative(uint64_t raw) {
+    if constexpr (std::is_same_v<T, std::monostate> || std::is_same_v<T, VectorRef>) {
+        return std::monostate{}; // Vectors are decoded by ByteReader::getValue()
+    } else {
+        T value;
+        std::memcpy(&value, &raw, sizeof(T));
+        return value;
+    }
+}
+template <size_t... I>
+BDIValueVariant makeValue(size_t index, uint64_t raw, std::index_sequence<I...>) {
+    BDIValueVariant result;
+    ((index == I ? (result = loadAlternative<std::variant_alternative_t<I, BDIValueVariant>>(raw), true) : false) || ...);
+    return result;
+}
+template <typename T, size_t I = 0>
+constexpr size_t alternativeIndex() {
+    if constexpr (std::is_same_v<std::variant_alternative_t<I, BDIValueVariant>, T>) return I;
+    else return alternativeIndex<T, I + 1>();
+}
+constexpr size_t kVectorIndex = alternativeIndex<VectorRef>();
+class ByteWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+    void putValue(const BDIValueVariant& value) {
+        put(static_cast<uint8_t>(value.index()));
+        uint64_t raw = 0;
+        const VectorRef* vector = nullptr;
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, VectorRef>) {
+                raw = static_cast<uint64_t>(v.getElementType()) | (static_cast<uint64_t>(v.getLaneCount()) << 8);
+                vector = &v;
+            } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                std::memcpy(&raw, &v, sizeof(T));
+            }
+        }, value);
+        put(raw);
+        if (vector) buffer_.insert(buffer_.end(), vector->data(), vector->data() + vector->getByteSize());
+    }
+    void putOptionalValue(const std::optional<BDIValueVariant>& value) {
+        put(static_cast<uint8_t>(value.has_value()));
+        if (value) putValue(*value);
+    }
+    std::vector<std::byte>& buffer() { return buffer_; }
+private:
+    std::vector<std::byte> buffer_;
+};
+// A decoded vector is owned by the reader: holders that outlive it must retain it
+class ByteReader {
+public:
+    explicit ByteReader(const std::vector<std::byte>& buffer) : buffer_(buffer) {}
+    template <typename T>
+    bool get(T& out) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (buffer_.size() - offset_ < sizeof(T)) return false;
+        std::memcpy(&out, buffer_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+    bool getValue(BDIValueVariant& out) {
+        uint8_t index = 0;
+        uint64_t raw = 0;
+        if (!get(index) || !get(raw) || index >= std::variant_size_v<BDIValueVariant>) return false;
+        if (index == kVectorIndex) return getVector(raw, out);
+        out = makeValue(index, raw, std::make_index_sequence<std::variant_size_v<BDIValueVariant>>{});
+        return true;
+    }
+    bool getOptionalValue(std::optional<BDIValueVariant>& out) {
+        uint8_t present = 0;
+        if (!get(present)) return false;
+        if (!present) {
+            out.reset();
+            return true;
+        }
+        BDIValueVariant value;
+        if (!getValue(value)) return false;
+        out = std::move(value);
+        return true;
+    }
+    // Element counts are checked against the bytes left, so a corrupt count cannot drive a huge allocation
+    bool getCount(uint64_t& count, size_t min_element_size) {
+        return get(count) && count <= (buffer_.size() - offset_) / min_element_size;
+    }
+    bool atEnd() const { return offset_ == buffer_.size(); }
+private:
+    const std::vector<std::byte>& buffer_;
+    size_t offset_ = 0;
+    std::vector<PackedVector> vectors_; // Lanes of the decoded VectorRefs
+    bool getVector(uint64_t raw, BDIValueVariant& out) {
+        const auto type = static_cast<BDIType>(raw & 0xFF);
+        const uint64_t lanes = raw >> 8;
+        if (!PackedVector::isElementType(type)) return false;
+        const size_t element_size = core::types::getBdiTypeSize(type);
+        if (lanes == 0 || lanes > (buffer_.size() - offset_) / element_size) return false;
+        PackedVector vector = PackedVector::allocate(type, lanes);
+        if (vector.empty()) return false;
+        std::memcpy(vector.mutableData(), buffer_.data() + offset_, vector.getByteSize());
+        offset_ += vector.getByteSize();
+        out = vector.ref();
+        vectors_.push_back(std::move(vector));
+        return true;
+    }
+};
+constexpr size_t kValueSize = 9; // Encoded size of one scalar BDIValueVariant (the minimum)
+} // namespace bdi::runtime::state_codec
+#endif // BDI_RUNTIME_STATECODEC_HPP
@@ -0,0 +1,405 @@
+#include "VMCheckpointer.hpp"
+#include "Logger.hpp"
+#include "StateCodec.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <type_traits>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define BDI_HAVE_POSIX_FILES 1
+#endif
+namespace bdi::runtime {
+using namespace state_codec;
+namespace {
+constexpr char kMagic[8] = {'B', 'D', 'I', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t kVersion = 2; // 2: call frame arguments are positional slots
+constexpr uint32_t kByteOrderMark = 0x01020304; // Checkpoints are host-endian
+constexpr uint64_t kImageAlignment = 64 * 1024;  // >= the page size of every supported host, so the image is mmap-able
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t page_size;         // MemoryManager::PAGE_SIZE at write time
+    uint64_t chain_id;          // Shared by a full checkpoint and its incrementals
+    uint64_t sequence;          // 1 for the full checkpoint, +1 per incremental
+    uint64_t parent_sequence;   // 0 for a full checkpoint
+    uint64_t memory_size;
+    uint64_t page_count;        // Pages stored in this file
+    uint64_t page_table_offset; // Incremental only: page_count u64 page indices
+    uint64_t page_data_offset;  // kImageAlignment-aligned
+    uint64_t state_offset;
+    uint64_t state_size;
+    uint32_t byte_order;
+    uint32_t reserved;
+};
+static_assert(sizeof(CheckpointHeader) == 96, "CheckpointHeader is a binary format");
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+bool readHeader(std::ifstream& in, const std::string& path, CheckpointHeader& header) {
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " is not a BDI checkpoint");
+        return false;
+    }
+    if (header.version != kVersion || header.byte_order != kByteOrderMark || header.page_size != MemoryManager::PAGE_SIZE) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " has an unsupported version, byte order or page size");
+        return false;
+    }
+    // Sections must lie inside the file before anything is sized from them
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(path, ec);
+    const bool full = header.parent_sequence == 0;
+    const uint64_t data_size = full ? header.memory_size : header.page_count * MemoryManager::PAGE_SIZE;
+    if (ec || header.state_offset > file_size || header.state_size > file_size - header.state_offset ||
+        (data_size != 0 && (header.page_data_offset > file_size || data_size > file_size - header.page_data_offset)) ||
+        (!full && (header.page_table_offset > header.page_data_offset ||
+                   header.page_count > (header.page_data_offset - header.page_table_offset) / sizeof(uint64_t)))) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " is truncated or corrupt");
+        return false;
+    }
+    return true;
+}
+bool readBlob(std::ifstream& in, uint64_t offset, uint64_t size, std::vector<std::byte>& out) {
+    out.resize(size);
+    in.seekg(static_cast<std::streamoff>(offset));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(size)));
+}
+}
+// --- Writing ---
+VMCheckpointer::VMCheckpointer(MemoryManager& memory, ExecutionContext& context) : memory_(memory), context_(context) {}
+bool VMCheckpointer::writeFull(const std::string& path, NodeID current_node_id) {
+    return write(path, current_node_id, true);
+}
+bool VMCheckpointer::writeIncremental(const std::string& path, NodeID current_node_id) {
+    if (sequence_ == 0) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: Incremental checkpoint without a full checkpoint to build on");
+        return false;
+    }
+    return write(path, current_node_id, false);
+}
+std::vector<std::byte> VMCheckpointer::encodeState(NodeID current_node_id, bool full) const {
+    ByteWriter w;
+    w.put(current_node_id);
+    // Port slots: everything (full) or those dirtied and erased since the last checkpoint
+    w.put(static_cast<uint8_t>(full));
+    std::vector<std::pair<const PortRef*, BDIValueVariant>> changed;
+    for (const auto& [port, slot] : context_.port_values_) {
+        if (!full && !slot.dirty) continue;
+        changed.emplace_back(&port, context_.slotToVariant(port, slot.value));
+    }
+    w.put(static_cast<uint64_t>(changed.size()));
+    for (const auto& [port, value] : changed) {
+        w.put(port->node_id);
+        w.put(port->port_index);
+        w.putValue(value);
+    }
+    std::vector<PortRef> removed;
+    if (!full) {
+        for (const auto& port : context_.erased_ports_) {
+            if (!context_.port_values_.count(port)) removed.push_back(port); // Not set again since
+        }
+    }
+    w.put(static_cast<uint64_t>(removed.size()));
+    for (const auto& port : removed) {
+        w.put(port.node_id);
+        w.put(port.port_index);
+    }
+    // Call stack and pending arguments
+    w.put(static_cast<uint64_t>(context_.call_stack_.size()));
+    for (const auto& frame : context_.call_stack_) {
+        w.put(frame.caller_node_id);
+        w.put(frame.return_node_id);
+        w.put(static_cast<uint64_t>(frame.arg_count));
+        for (const auto& value : context_.getArguments(frame)) w.putValue(value);
+        w.putOptionalValue(frame.return_value);
+    }
+    w.put(static_cast<uint64_t>(context_.staged_count_));
+    for (size_t i = 0; i < context_.staged_count_; ++i) w.putValue(context_.arg_slots_[context_.arg_top_ + i]);
+    w.putOptionalValue(context_.last_return_value_);
+    // Intelligence state
+    w.put(static_cast<uint64_t>(context_.parameter_gradients.size()));
+    for (const auto& [node, value] : context_.parameter_gradients) {
+        w.put(node);
+        w.putValue(value);
+    }
+    w.put(static_cast<uint64_t>(context_.eligibility_traces.size()));
+    for (const auto& [node, trace] : context_.eligibility_traces) {
+        w.put(node);
+        w.put(trace);
+    }
+    w.put(static_cast<uint64_t>(context_.current_state_features.size()));
+    for (const auto& [node, value] : context_.current_state_features) {
+        w.put(node);
+        w.putValue(value);
+    }
+    // Service call stack
+    w.put(static_cast<uint64_t>(context_.service_call_stack_.size()));
+    for (const auto& call : context_.service_call_stack_) {
+        w.put(call.original_caller_node_id);
+        w.put(call.original_resume_node_id);
+    }
+    // Memory regions and allocator
+    auto allocator = memory_.getAllocatorState();
+    w.put(allocator.next_region_id);
+    w.put(static_cast<uint64_t>(allocator.regions.size()));
+    for (const auto& region : allocator.regions) {
+        w.put(region.id);
+        w.put(static_cast<uint64_t>(region.base_address));
+        w.put(static_cast<uint64_t>(region.size));
+        w.put(static_cast<uint8_t>(region.read_only));
+    }
+    w.put(static_cast<uint64_t>(allocator.free_blocks.size()));
+    for (const auto& [address, size] : allocator.free_blocks) {
+        w.put(static_cast<uint64_t>(address));
+        w.put(static_cast<uint64_t>(size));
+    }
+    return std::move(w.buffer());
+}
+bool VMCheckpointer::write(const std::string& path, NodeID current_node_id, bool full) {
+    const size_t memory_size = memory_.getTotalSize();
+    std::vector<size_t> pages = memory_.takeDirtyPages();
+    auto restoreDirty = [&] { // Failed write: the next checkpoint must still see these pages
+        for (size_t page : pages) memory_.markDirty(page * MemoryManager::PAGE_SIZE, MemoryManager::PAGE_SIZE);
+    };
+    std::vector<std::byte> state = encodeState(current_node_id, full);
+    CheckpointHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.page_size = MemoryManager::PAGE_SIZE;
+    header.chain_id = full ? std::random_device{}() ^ (static_cast<uint64_t>(std::random_device{}()) << 32) : chain_id_;
+    header.sequence = full ? 1 : sequence_ + 1;
+    header.parent_sequence = full ? 0 : sequence_;
+    header.memory_size = memory_size;
+    header.page_count = full ? memory_.getPageCount() : pages.size();
+    header.state_offset = sizeof(CheckpointHeader);
+    header.state_size = state.size();
+    header.page_table_offset = full ? 0 : header.state_offset + header.state_size;
+    header.page_data_offset = alignUp(header.state_offset + header.state_size + (full ? 0 : pages.size() * sizeof(uint64_t)), kImageAlignment);
+    header.byte_order = kByteOrderMark;
+    // Written beside the target and renamed, so a crash never leaves a torn checkpoint at 'path'
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            BDI_LOG_ERROR(VM, "VMCheckpointer: Cannot write " << temp_path);
+            restoreDirty();
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(state.data()), static_cast<std::streamsize>(state.size()));
+        if (!full) {
+            for (size_t page : pages) {
+                uint64_t index = page;
+                out.write(reinterpret_cast<const char*>(&index), sizeof(index));
+            }
+        }
+        out.seekp(static_cast<std::streamoff>(header.page_data_offset));
+        const auto* base = reinterpret_cast<const char*>(memory_.getRawPointer(0));
+        if (full) {
+            out.write(base, static_cast<std::streamsize>(memory_size));
+        } else {
+            static const char zeros[MemoryManager::PAGE_SIZE] = {};
+            for (size_t page : pages) {
+                const size_t offset = page * MemoryManager::PAGE_SIZE;
+                const size_t bytes = std::min(MemoryManager::PAGE_SIZE, memory_size - offset);
+                out.write(base + offset, static_cast<std::streamsize>(bytes));
+                out.write(zeros, static_cast<std::streamsize>(MemoryManager::PAGE_SIZE - bytes)); // Pages are fixed-size in the file
+            }
+        }
+        out.flush();
+        if (!out) {
+            BDI_LOG_ERROR(VM, "VMCheckpointer: Short write to " << temp_path);
+            restoreDirty();
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: Cannot move checkpoint into place at " << path << ": " << ec.message());
+        restoreDirty();
+        return false;
+    }
+    chain_id_ = header.chain_id;
+    sequence_ = header.sequence;
+    for (auto& [port, slot] : context_.port_values_) {
+        slot.dirty = false;
+        slot.saved = true;
+    }
+    context_.erased_ports_.clear();
+    return true;
+}
+// --- Restoring ---
+bool VMCheckpointer::decodeState(const std::vector<std::byte>& blob, RestoredVM& vm) {
+    ExecutionContext& ctx = *vm.context;
+    ByteReader r(blob);
+    uint8_t full = 0;
+    uint64_t count = 0;
+    if (!r.get(vm.current_node_id) || !r.get(full)) return false;
+    if (full) {
+        ctx.port_values_.clear();
+        ctx.vector_values_.clear();
+    }
+    if (!r.getCount(count, sizeof(NodeID) + sizeof(PortIndex) + kValueSize)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        PortRef port;
+        BDIValueVariant value;
+        if (!r.get(port.node_id) || !r.get(port.port_index) || !r.getValue(value)) return false;
+        ctx.setPortValue(port, std::move(value));
+    }
+    if (!r.getCount(count, sizeof(NodeID) + sizeof(PortIndex))) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        PortRef port;
+        if (!r.get(port.node_id) || !r.get(port.port_index)) return false;
+        ctx.erasePortValue(port);
+    }
+    // Everything below is stored whole in every checkpoint
+    // Frames' arguments are rebuilt in the arena in push order, staged ones on top
+    ctx.call_stack_.clear();
+    ctx.arg_top_ = 0;
+    ctx.staged_count_ = 0;
+    if (!r.getCount(count, 2 * sizeof(NodeID) + sizeof(uint64_t) + 1)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        ExecutionContext::CallFrame frame{};
+        uint64_t args = 0;
+        if (!r.get(frame.caller_node_id) || !r.get(frame.return_node_id) || !r.getCount(args, kValueSize)) return false;
+        BDIValueVariant* slots = ctx.stageArguments(static_cast<size_t>(args));
+        for (uint64_t a = 0; a < args; ++a) {
+            if (!r.getValue(slots[a])) return false;
+        }
+        if (!r.getOptionalValue(frame.return_value)) return false;
+        if (frame.return_value) frame.return_vector = retainVector(*frame.return_value);
+        frame.arg_base = static_cast<uint32_t>(ctx.arg_top_);
+        frame.arg_count = static_cast<uint32_t>(args);
+        ctx.retainArguments(ctx.arg_top_, ctx.staged_count_);
+        ctx.arg_top_ += ctx.staged_count_;
+        ctx.staged_count_ = 0;
+        ctx.call_stack_.push_back(std::move(frame));
+    }
+    if (!r.getCount(count, kValueSize)) return false;
+    BDIValueVariant* staged = ctx.stageArguments(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!r.getValue(staged[i])) return false;
+    }
+    ctx.retainArguments(ctx.arg_top_, ctx.staged_count_); // Decoded vectors die with the reader
+    if (!r.getOptionalValue(ctx.last_return_value_)) return false;
+    ctx.last_return_vector_ = ctx.last_return_value_ ? retainVector(*ctx.last_return_value_) : PackedVector{};
+    ctx.clearIntelligenceState();
+    if (!r.getCount(count, sizeof(NodeID) + kValueSize)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        NodeID node = 0;
+        BDIValueVariant value;
+        if (!r.get(node) || !r.getValue(value)) return false;
+        ctx.parameter_gradients[node] = std::move(value);
+    }
+    if (!r.getCount(count, sizeof(NodeID) + sizeof(float))) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        NodeID node = 0;
+        float trace = 0.0f;
+        if (!r.get(node) || !r.get(trace)) return false;
+        ctx.eligibility_traces[node] = trace;
+    }
+    if (!r.getCount(count, sizeof(NodeID) + kValueSize)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        NodeID node = 0;
+        BDIValueVariant value;
+        if (!r.get(node) || !r.getValue(value)) return false;
+        ctx.current_state_features[node] = std::move(value);
+    }
+    ctx.service_call_stack_.clear();
+    if (!r.getCount(count, 2 * sizeof(NodeID))) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        ExecutionContext::ServiceCallReturnState call{};
+        if (!r.get(call.original_caller_node_id) || !r.get(call.original_resume_node_id)) return false;
+        ctx.service_call_stack_.push_back(call);
+    }
+    MemoryManager::AllocatorState allocator;
+    if (!r.get(allocator.next_region_id) || !r.getCount(count, sizeof(RegionID) + 2 * sizeof(uint64_t) + 1)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        RegionID id = 0;
+        uint64_t base = 0, size = 0;
+        uint8_t read_only = 0;
+        if (!r.get(id) || !r.get(base) || !r.get(size) || !r.get(read_only)) return false;
+        allocator.regions.emplace_back(id, static_cast<uintptr_t>(base), static_cast<size_t>(size), read_only != 0);
+    }
+    if (!r.getCount(count, 2 * sizeof(uint64_t))) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t address = 0, size = 0;
+        if (!r.get(address) || !r.get(size)) return false;
+        allocator.free_blocks.emplace_back(static_cast<uintptr_t>(address), static_cast<size_t>(size));
+    }
+    return r.atEnd() && vm.memory->restoreAllocatorState(allocator);
+}
+std::optional<RestoredVM> VMCheckpointer::restore(const std::vector<std::string>& chain) {
+    if (chain.empty()) {
+        BDI_LOG_ERROR(VM, "VMCheckpointer: Empty checkpoint chain");
+        return std::nullopt;
+    }
+    RestoredVM vm;
+    CheckpointHeader base{};
+    std::vector<std::byte> blob;
+    for (size_t i = 0; i < chain.size(); ++i) {
+        const std::string& path = chain[i];
+        std::ifstream in(path, std::ios::binary);
+        CheckpointHeader header{};
+        if (!readHeader(in, path, header)) return std::nullopt;
+        if (i == 0) {
+            if (header.parent_sequence != 0 || header.memory_size == 0) {
+                BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " is not a full checkpoint");
+                return std::nullopt;
+            }
+            base = header;
+            vm.memory = std::make_unique<MemoryManager>(static_cast<size_t>(header.memory_size));
+            vm.context = std::make_unique<ExecutionContext>();
+            bool mapped = false;
+#ifdef BDI_HAVE_POSIX_FILES
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                mapped = vm.memory->mapImage(fd, header.page_data_offset);
+                ::close(fd); // The mapping keeps the file referenced
+            }
+#endif
+            if (!mapped) { // No mmap: read the image eagerly
+                in.seekg(static_cast<std::streamoff>(header.page_data_offset));
+                if (!in.read(reinterpret_cast<char*>(vm.memory->getRawPointer(0)), static_cast<std::streamsize>(header.memory_size))) {
+                    BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " has a truncated memory image");
+                    return std::nullopt;
+                }
+            }
+        } else {
+            if (header.chain_id != base.chain_id || header.parent_sequence != vm.sequence || header.memory_size != base.memory_size) {
+                BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " does not continue checkpoint " << vm.sequence << " of this chain");
+                return std::nullopt;
+            }
+            std::vector<std::byte> table;
+            if (!readBlob(in, header.page_table_offset, header.page_count * sizeof(uint64_t), table)) {
+                BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " has a corrupt page table");
+                return std::nullopt;
+            }
+            // Only the listed pages are touched; the rest stay lazily mapped
+            in.seekg(static_cast<std::streamoff>(header.page_data_offset));
+            std::vector<char> page(MemoryManager::PAGE_SIZE);
+            for (uint64_t p = 0; p < header.page_count; ++p) {
+                uint64_t index = 0;
+                std::memcpy(&index, table.data() + p * sizeof(uint64_t), sizeof(index));
+                const uint64_t offset = index * MemoryManager::PAGE_SIZE;
+                if (offset >= header.memory_size || !in.read(page.data(), static_cast<std::streamsize>(page.size()))) {
+                    BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " has a corrupt page " << index);
+                    return std::nullopt;
+                }
+                std::memcpy(vm.memory->getRawPointer(offset), page.data(), std::min<uint64_t>(MemoryManager::PAGE_SIZE, header.memory_size - offset));
+            }
+        }
+        if (!readBlob(in, header.state_offset, header.state_size, blob) || !decodeState(blob, vm)) {
+            BDI_LOG_ERROR(VM, "VMCheckpointer: " << path << " has corrupt VM state");
+            return std::nullopt;
+        }
+        vm.sequence = header.sequence;
+    }
+    vm.memory->takeDirtyPages(); // The restored state is the new baseline
+    return vm;
+}
+} // namespace bdi::runtime
@@ -0,0 +1,48 @@
+#ifndef BDI_RUNTIME_VMCHECKPOINTER_HPP
+#define BDI_RUNTIME_VMCHECKPOINTER_HPP
+#include "ExecutionContext.hpp"
+#include "MemoryManager.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+namespace bdi::runtime {
+// --- VM Checkpoints ---
+// A checkpoint chain is one full checkpoint followed by any number of incremental ones.
+// Each file holds a header, the serialized ExecutionContext (port values, call and
+// service call stacks, pending arguments, intelligence state), the MemoryManager's
+// region table and the current node, then memory pages.
+// - Full: the whole memory image, aligned in the file so restore can mmap it privately;
+//   the kernel pages it in on first touch and copies pages on write.
+// - Incremental: only the pages dirtied (MemoryManager::takeDirtyPages) and the port
+//   slots written or erased since the previous checkpoint of the chain, as tracked by
+//   the ExecutionContext's per-slot dirty bits.
+// Checkpoints must be taken while the VM is quiescent (between slices).
+struct RestoredVM {
+    std::unique_ptr<MemoryManager> memory;
+    std::unique_ptr<ExecutionContext> context;
+    NodeID current_node_id = 0;
+    uint64_t sequence = 0; // Of the last checkpoint applied
+};
+class VMCheckpointer {
+public:
+    VMCheckpointer(MemoryManager& memory, ExecutionContext& context);
+    // Starts a new chain. Clears dirty tracking.
+    bool writeFull(const std::string& path, NodeID current_node_id);
+    // Appends to the chain started by writeFull(); fails if there is none.
+    bool writeIncremental(const std::string& path, NodeID current_node_id);
+    uint64_t getSequence() const { return sequence_; } // 0 = nothing written yet
+    // Restores [full, incremental...] in order. Fails on a broken or mismatched chain.
+    static std::optional<RestoredVM> restore(const std::vector<std::string>& chain);
+private:
+    MemoryManager& memory_;
+    ExecutionContext& context_;
+    uint64_t chain_id_ = 0;
+    uint64_t sequence_ = 0;
+    bool write(const std::string& path, NodeID current_node_id, bool full);
+    std::vector<std::byte> encodeState(NodeID current_node_id, bool full) const;
+    static bool decodeState(const std::vector<std::byte>& blob, RestoredVM& vm);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_VMCHECKPOINTER_HPP
@@ -0,0 +1,61 @@
+#include "Channel.hpp"
+namespace bdi::runtime {
+// --- Channel ---
+Channel::Channel(uint32_t id, BDIType element_type, size_t capacity, Kind kind)
+    : id_(id), element_type_(element_type), kind_(kind) {
+    if (kind == Kind::SPSC) spsc_ = std::make_unique<SpscRing<BDIValueVariant>>(capacity);
+    else mpmc_ = std::make_unique<MpmcRing<BDIValueVariant>>(capacity);
+}
+size_t Channel::getCapacity() const {
+    return spsc_ ? spsc_->capacity() : mpmc_->capacity();
+}
+size_t Channel::sizeApprox() const {
+    return spsc_ ? spsc_->sizeApprox() : mpmc_->sizeApprox();
+}
+bool Channel::trySend(std::span<BDIValueVariant> values) {
+    return spsc_ ? spsc_->tryPush(values) : mpmc_->tryPush(values);
+}
+bool Channel::tryReceive(std::span<BDIValueVariant> out) {
+    return spsc_ ? spsc_->tryPop(out) : mpmc_->tryPop(out);
+}
+void Channel::addWaiter(Direction direction) {
+    waiters(direction).fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in takeWaiters(): either the waiter's retry sees the other
+    // side's ring update, or the other side sees this registration
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+void Channel::cancelWaiter(Direction direction) {
+    auto& count = waiters(direction);
+    uint32_t current = count.load(std::memory_order_relaxed);
+    while (current > 0 && !count.compare_exchange_weak(current, current - 1, std::memory_order_relaxed)) {}
+}
+uint32_t Channel::takeWaiters(Direction direction, uint32_t max) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto& count = waiters(direction);
+    uint32_t current = count.load(std::memory_order_relaxed);
+    uint32_t taken = 0;
+    do {
+        taken = current < max ? current : max;
+        if (taken == 0) return 0;
+    } while (!count.compare_exchange_weak(current, current - taken, std::memory_order_relaxed));
+    return taken;
+}
+// --- Channel Registry ---
+ChannelRegistry::ChannelRegistry(size_t max_channels)
+    : table_(std::make_unique<std::atomic<Channel*>[]>(max_channels + 1)), max_channels_(max_channels) {
+    for (size_t i = 0; i <= max_channels_; ++i) table_[i].store(nullptr, std::memory_order_relaxed);
+}
+uint32_t ChannelRegistry::create(BDIType element_type, size_t capacity, Channel::Kind kind) {
+    if (capacity == 0 || element_type == BDIType::VOID) return 0;
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    if (owned_.size() >= max_channels_) return 0;
+    const uint32_t id = static_cast<uint32_t>(owned_.size() + 1); // 0 is never a channel
+    owned_.push_back(std::make_unique<Channel>(id, element_type, capacity, kind));
+    table_[id].store(owned_.back().get(), std::memory_order_release);
+    return id;
+}
+Channel* ChannelRegistry::find(uint64_t id) const {
+    if (id == 0 || id > max_channels_) return nullptr;
+    return table_[id].load(std::memory_order_acquire);
+}
+} // namespace bdi::runtime
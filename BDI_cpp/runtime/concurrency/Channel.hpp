@@ -0,0 +1,214 @@
+#ifndef BDI_RUNTIME_CHANNEL_HPP
+#define BDI_RUNTIME_CHANNEL_HPP
+#include "BDIValueVariant.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+namespace bdi::runtime {
+using bdi::core::types::BDIType;
+// --- Ring Buffers ---
+// Bounded, lock-free, capacity rounded up to a power of two. Batch operations are
+// all-or-nothing: either every element moves or none does, so a parked task can simply
+// retry the whole batch.
+// Single producer, single consumer: each side owns one index and caches the other's,
+// so the shared cache lines are only touched when the cached view runs out.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity);
+    size_t capacity() const { return mask_ + 1; }
+    bool tryPush(std::span<T> values);        // Moves from 'values' on success
+    bool tryPop(std::span<T> out);
+    size_t sizeApprox() const {
+        const size_t head = head_.load(std::memory_order_acquire); // First, so the difference cannot underflow
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0}; // Next write (producer)
+    size_t cached_head_ = 0;
+    alignas(64) std::atomic<size_t> head_{0}; // Next read (consumer)
+    size_t cached_tail_ = 0;
+};
+// Multi-producer, multi-consumer (Vyukov): every cell carries a sequence number telling
+// which lap may write or read it next, so producers and consumers only contend on their
+// own position counter. A batch claims a run of positions with one CAS after checking
+// that all of its cells are ready.
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity);
+    size_t capacity() const { return mask_ + 1; }
+    bool tryPush(std::span<T> values);
+    bool tryPop(std::span<T> out);
+    size_t sizeApprox() const;
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+// --- Channel ---
+// Typed bounded channel for COMM_CHANNEL_SEND/RECV. Values are converted to the element
+// type by the sender. The channel itself never blocks: a task that finds it full/empty
+// registers as a waiter and parks on the channel's event (see eventFor()); the other
+// side takes all of them after each successful operation and wakes them with that event.
+// Woken tasks retry their whole batch and park again if it still does not fit.
+class Channel {
+public:
+    enum class Kind : uint8_t { SPSC, MPMC };
+    enum class Direction : uint8_t { SEND, RECV };
+    // Event ids with the top bit set are reserved for channels
+    static constexpr uint64_t EVENT_BASE = uint64_t{1} << 63;
+    Channel(uint32_t id, BDIType element_type, size_t capacity, Kind kind);
+    uint32_t getId() const { return id_; }
+    BDIType getElementType() const { return element_type_; }
+    Kind getKind() const { return kind_; }
+    size_t getCapacity() const;
+    size_t sizeApprox() const;
+    bool trySend(std::span<BDIValueVariant> values); // All or nothing
+    bool tryReceive(std::span<BDIValueVariant> out); // All or nothing
+    // Waiter accounting for parking tasks. A task registers, retries once, and parks on
+    // eventFor(direction) only if the retry fails; cancelWaiter() undoes a registration
+    // whose retry succeeded. The opposite side calls takeWaiters() and sends one event
+    // per waiter taken. Races only cause spurious wakeups, never lost ones, because
+    // undelivered events are banked by the scheduler.
+    void addWaiter(Direction direction);
+    void cancelWaiter(Direction direction);
+    uint32_t takeWaiters(Direction direction, uint32_t max);
+    uint64_t eventFor(Direction direction) const { return EVENT_BASE | (uint64_t{id_} << 1) | (direction == Direction::RECV ? 1u : 0u); }
+private:
+    uint32_t id_;
+    BDIType element_type_;
+    Kind kind_;
+    std::unique_ptr<SpscRing<BDIValueVariant>> spsc_;
+    std::unique_ptr<MpmcRing<BDIValueVariant>> mpmc_;
+    alignas(64) std::atomic<uint32_t> send_waiters_{0};
+    std::atomic<uint32_t> recv_waiters_{0};
+    std::atomic<uint32_t>& waiters(Direction direction) { return direction == Direction::SEND ? send_waiters_ : recv_waiters_; }
+};
+// Channels by id. Lookups are lock-free (a fixed table of atomic pointers); channels live
+// as long as the registry. SPSC channels must have one sending and one receiving task.
+class ChannelRegistry {
+public:
+    static constexpr size_t DEFAULT_MAX_CHANNELS = 1024;
+    explicit ChannelRegistry(size_t max_channels = DEFAULT_MAX_CHANNELS);
+    // Returns the new channel's id (> 0), or 0 if the table is full or the arguments are invalid
+    uint32_t create(BDIType element_type, size_t capacity, Channel::Kind kind = Channel::Kind::MPMC);
+    Channel* find(uint64_t id) const;
+private:
+    std::unique_ptr<std::atomic<Channel*>[]> table_;
+    size_t max_channels_;
+    std::mutex create_mutex_;
+    std::vector<std::unique_ptr<Channel>> owned_;
+};
+// --- Ring Implementation ---
+namespace detail {
+inline size_t ringCapacity(size_t requested) {
+    size_t capacity = 1;
+    while (capacity < requested) capacity <<= 1;
+    return capacity;
+}
+}
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity) : mask_(detail::ringCapacity(capacity) - 1) {
+    slots_ = std::make_unique<T[]>(mask_ + 1);
+}
+template <typename T>
+bool SpscRing<T>::tryPush(std::span<T> values) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail + values.size() - cached_head_ > capacity()) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail + values.size() - cached_head_ > capacity()) return false;
+    }
+    for (size_t i = 0; i < values.size(); ++i) slots_[(tail + i) & mask_] = std::move(values[i]);
+    tail_.store(tail + values.size(), std::memory_order_release);
+    return true;
+}
+template <typename T>
+bool SpscRing<T>::tryPop(std::span<T> out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - head < out.size()) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (cached_tail_ - head < out.size()) return false;
+    }
+    for (size_t i = 0; i < out.size(); ++i) out[i] = std::move(slots_[(head + i) & mask_]);
+    head_.store(head + out.size(), std::memory_order_release);
+    return true;
+}
+template <typename T>
+MpmcRing<T>::MpmcRing(size_t capacity) : mask_(detail::ringCapacity(capacity) - 1) {
+    cells_ = std::make_unique<Cell[]>(mask_ + 1);
+    for (size_t i = 0; i <= mask_; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+}
+template <typename T>
+bool MpmcRing<T>::tryPush(std::span<T> values) {
+    if (values.size() > capacity()) return false;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        // A cell at position p is writable when its sequence is p; it cannot move back, so
+        // cells checked here stay writable until someone claims them by moving enqueue_pos_
+        size_t ready = 0;
+        while (ready < values.size()) {
+            const size_t seq = cells_[(pos + ready) & mask_].sequence.load(std::memory_order_acquire);
+            if (seq != pos + ready) break;
+            ++ready;
+        }
+        if (ready < values.size()) {
+            const size_t seq = cells_[(pos + ready) & mask_].sequence.load(std::memory_order_acquire);
+            if (static_cast<std::ptrdiff_t>(seq - (pos + ready)) < 0) return false; // Full
+            pos = enqueue_pos_.load(std::memory_order_relaxed);                       // Lost a race
+            continue;
+        }
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + values.size(), std::memory_order_relaxed)) break;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        cell.value = std::move(values[i]);
+        cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return true;
+}
+template <typename T>
+bool MpmcRing<T>::tryPop(std::span<T> out) {
+    if (out.size() > capacity()) return false;
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        size_t ready = 0;
+        while (ready < out.size()) {
+            const size_t seq = cells_[(pos + ready) & mask_].sequence.load(std::memory_order_acquire);
+            if (seq != pos + ready + 1) break;
+            ++ready;
+        }
+        if (ready < out.size()) {
+            const size_t seq = cells_[(pos + ready) & mask_].sequence.load(std::memory_order_acquire);
+            if (static_cast<std::ptrdiff_t>(seq - (pos + ready + 1)) < 0) return false; // Empty
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + out.size(), std::memory_order_relaxed)) break;
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        out[i] = std::move(cell.value);
+        cell.sequence.store(pos + i + mask_ + 1, std::memory_order_release); // Writable on the next lap
+    }
+    return true;
+}
+template <typename T>
+size_t MpmcRing<T>::sizeApprox() const {
+    const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_CHANNEL_HPP
@@ -0,0 +1,44 @@
+#include "FutexTable.hpp"
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <thread>
+namespace bdi::runtime {
+uint32_t FutexTable::takeWaiters(uint64_t address, uint32_t max) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = waiters_.find(address);
+    if (it == waiters_.end()) return 0;
+    const uint32_t taken = std::min(it->second, max);
+    it->second -= taken;
+    if (it->second == 0) waiters_.erase(it);
+    return taken;
+}
+uint32_t FutexTable::getWaiterCount(uint64_t address) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = waiters_.find(address);
+    return it == waiters_.end() ? 0 : it->second;
+}
+// --- Adaptive Spinning ---
+// Same policy as glibc's adaptive mutexes: allow twice the recent average plus a little
+// slack, and move the average an eighth of the way towards each new observation.
+uint32_t FutexTable::spinLimit(uint64_t address) const {
+    const uint32_t estimate = spin_estimates_[slot(address)].load(std::memory_order_relaxed);
+    return std::min<uint32_t>(MAX_SPINS, estimate * 2 + 10);
+}
+void FutexTable::recordSpins(uint64_t address, uint32_t spins) {
+    auto& estimate = spin_estimates_[slot(address)];
+    const int32_t current = estimate.load(std::memory_order_relaxed);
+    const int32_t observed = static_cast<int32_t>(std::min(spins, MAX_SPINS));
+    estimate.store(static_cast<uint16_t>(current + (observed - current) / 8), std::memory_order_relaxed);
+}
+void FutexTable::cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+} // namespace bdi::runtime
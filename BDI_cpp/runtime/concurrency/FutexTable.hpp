@@ -0,0 +1,50 @@
+#ifndef BDI_RUNTIME_FUTEXTABLE_HPP
+#define BDI_RUNTIME_FUTEXTABLE_HPP
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+namespace bdi::runtime {
+// Parking lot for SYNC_MUTEX_LOCK/UNLOCK, keyed by the mutex word's address in
+// MemoryManager memory. The word itself follows the classic futex mutex protocol
+// (0 free, 1 locked, 2 locked with possible waiters); this table only counts the tasks
+// parked on each address and keeps a per-address estimate of how long to spin first.
+// A task parks on eventFor(address) through the scheduler's event waiters. Thread-safe.
+class FutexTable {
+public:
+    // Event ids with the top two bits set are reserved for mutex words
+    static constexpr uint64_t EVENT_BASE = uint64_t{3} << 62;
+    static constexpr uint32_t MAX_SPINS = 100; // Upper bound of the adaptive spin
+    static uint64_t eventFor(uint64_t address) { return EVENT_BASE | address; }
+    // Registers a waiter on 'address', then runs 'still_blocked' (the caller's final
+    // attempt on the word) under the table lock. Returns true if the caller must park;
+    // false (registration undone) if the attempt succeeded. Because takeWaiters() takes
+    // the same lock, an unlock between the attempt and the park is never lost.
+    template <typename Recheck>
+    bool prepareWait(uint64_t address, Recheck&& still_blocked) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t& count = waiters_[address];
+        ++count;
+        if (still_blocked()) return true;
+        if (--count == 0) waiters_.erase(address);
+        return false;
+    }
+    // Unregisters up to 'max' waiters on 'address'; the caller sends one event per waiter
+    uint32_t takeWaiters(uint64_t address, uint32_t max);
+    // Undoes the registration of a task that prepared to park but will not wait after all
+    void cancelWait(uint64_t address) { takeWaiters(address, 1); }
+    uint32_t getWaiterCount(uint64_t address) const;
+    // Adaptive spinning: spin up to spinLimit() attempts before parking, then report how
+    // many were needed (MAX_SPINS if the lock was not acquired) to tune the next limit.
+    uint32_t spinLimit(uint64_t address) const;
+    void recordSpins(uint64_t address, uint32_t spins);
+    static void cpuRelax();
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, uint32_t> waiters_; // Address -> parked tasks
+    std::array<std::atomic<uint16_t>, 256> spin_estimates_{}; // By address hash; races only blur the estimate
+    static size_t slot(uint64_t address) { return static_cast<size_t>((address >> 2) * 0x9E3779B97F4A7C15ull >> 56); }
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_FUTEXTABLE_HPP
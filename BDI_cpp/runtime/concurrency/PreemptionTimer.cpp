@@ -0,0 +1,54 @@
+#include "PreemptionTimer.hpp"
+#include <algorithm>
+#include <limits>
+namespace bdi::runtime {
+PreemptionTimer::PreemptionTimer(size_t slot_count, Clock::duration quantum)
+    : slots_(std::make_unique<Slot[]>(slot_count)), slot_count_(slot_count), quantum_(std::max(quantum, Clock::duration(1))) {
+    thread_ = std::thread(&PreemptionTimer::run, this);
+}
+PreemptionTimer::~PreemptionTimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+void PreemptionTimer::arm(size_t slot) {
+    slots_[slot].preempt.store(false, std::memory_order_relaxed);
+    slots_[slot].deadline.store((Clock::now() + quantum_).time_since_epoch().count());
+    // Pairs with the timer thread publishing idle_ before its scan: either the scan sees
+    // this deadline, or we see idle_ and wake it under the mutex it waits with
+    if (idle_.load()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.store(false);
+        cv_.notify_one();
+    }
+}
+void PreemptionTimer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        idle_.store(true);
+        const int64_t now = Clock::now().time_since_epoch().count();
+        int64_t next = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < slot_count_; ++i) {
+            Slot& slot = slots_[i];
+            int64_t deadline = slot.deadline.load();
+            if (deadline == 0) continue;
+            if (deadline > now) {
+                next = std::min(next, deadline);
+            } else if (slot.deadline.compare_exchange_strong(deadline, 0)) { // Lost to disarm()/arm(): not ours to fire
+                slot.preempt.store(true, std::memory_order_release);
+                fires_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (next == std::numeric_limits<int64_t>::max()) {
+            cv_.wait(lock, [this] { return stopping_ || !idle_.load(); });
+        } else {
+            // Every arm() uses the same quantum, so later arms never move the earliest deadline up
+            idle_.store(false);
+            cv_.wait_until(lock, Clock::time_point(Clock::duration(next)), [this] { return stopping_; });
+        }
+    }
+}
+} // namespace bdi::runtime
@@ -0,0 +1,48 @@
+#ifndef BDI_RUNTIME_PREEMPTIONTIMER_HPP
+#define BDI_RUNTIME_PREEMPTIONTIMER_HPP
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+namespace bdi::runtime {
+// Software stand-in for a per-CPU timer interrupt. Each slot (one per scheduler worker)
+// is armed at the start of a slice; one timer thread sleeps until the earliest armed
+// deadline and raises that slot's flag, which the running TaskEngine polls at its
+// preemption points. A flag raised just as its slice ends may cut the next slice on
+// that slot short; it is never lost.
+class PreemptionTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+    PreemptionTimer(size_t slot_count, Clock::duration quantum);
+    ~PreemptionTimer();
+    PreemptionTimer(const PreemptionTimer&) = delete;
+    PreemptionTimer& operator=(const PreemptionTimer&) = delete;
+    // Clears the slot's flag and raises it one quantum from now. Owner thread only.
+    void arm(size_t slot);
+    void disarm(size_t slot) { slots_[slot].deadline.store(0, std::memory_order_relaxed); }
+    const std::atomic<bool>& flag(size_t slot) const { return slots_[slot].preempt; }
+    size_t getSlotCount() const { return slot_count_; }
+    Clock::duration getQuantum() const { return quantum_; }
+    uint64_t getFireCount() const { return fires_.load(std::memory_order_relaxed); }
+private:
+    struct alignas(64) Slot { // One cache line each: workers arm their own slot every slice
+        std::atomic<bool> preempt{false};
+        std::atomic<int64_t> deadline{0}; // Clock ticks; 0 = disarmed
+    };
+    std::unique_ptr<Slot[]> slots_;
+    size_t slot_count_;
+    Clock::duration quantum_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::atomic<bool> idle_{false}; // Timer thread found nothing armed and waits for arm()
+    std::atomic<uint64_t> fires_{0};
+    std::thread thread_;
+    void run();
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_PREEMPTIONTIMER_HPP
@@ -0,0 +1,153 @@
+#include "SpawnRuntime.hpp"
+#include "GraphRegistry.hpp"
+#include <algorithm>
+#include <limits>
+namespace bdi::runtime {
+namespace {
+// What a spawned task may ask of the OS layer: everything its spawner may, except device
+// reads, which only journaled BDIOS tasks perform
+class SpawnedServices : public TaskServices {
+public:
+    SpawnedServices(SpawnRuntime& runtime, TaskServices* parent) : runtime_(runtime), parent_(parent) {}
+    void sendEvent(uint64_t event_id, BDIValueVariant payload) override {
+        if (parent_) parent_->sendEvent(event_id, std::move(payload));
+    }
+    bool haltTask(uint64_t task_id) override { return parent_ && parent_->haltTask(task_id); }
+    SpawnRuntime* getSpawnRuntime() override { return &runtime_; }
+    ChannelRegistry* getChannels() override { return parent_ ? parent_->getChannels() : nullptr; }
+    FutexTable* getFutexTable() override { return parent_ ? parent_->getFutexTable() : nullptr; }
+    TaskServices* getParent() const { return parent_; }
+private:
+    SpawnRuntime& runtime_;
+    TaskServices* parent_;
+};
+}
+SpawnRuntime::SpawnRuntime(WorkStealingPool& pool, MemoryManager* memory) : pool_(pool), memory_(memory) {}
+SpawnRuntime::~SpawnRuntime() {
+    // Queued tasks reference this runtime; finish them even if nobody joins
+    pool_.helpWhile([this] { return pending_.load(std::memory_order_acquire) > 0; });
+}
+uint64_t SpawnRuntime::spawn(const BDIGraph& graph, NodeID entry, std::span<BDIValueVariant> arguments, TaskServices* services,
+                             const TaskControlBlock* parent) {
+    // A nested spawn passes its own SpawnedServices, which die with it; forward to the
+    // services they wrap instead, so a child may outlive its spawner
+    if (auto* nested = dynamic_cast<SpawnedServices*>(services)) services = nested->getParent();
+    auto spawned = std::make_shared<Spawned>();
+    spawned->services = std::make_unique<SpawnedServices>(*this, services);
+    spawned->parent = parent;
+    TaskControlBlock& task = spawned->task;
+    task.graph = &graph;
+    if (parent) { // Keeps a registry version alive while the child runs it
+        task.version = parent->version;
+        task.constants = parent->constants;
+    }
+    task.resume_node_id = entry;
+    task.status = TaskStatus::READY;
+    task.context = std::make_unique<ExecutionContext>();
+    BDIValueVariant* slots = task.context->stageArguments(arguments.size());
+    std::move(arguments.begin(), arguments.end(), slots);
+    task.context->pushCallFrame(0, 0); // Returning from the subgraph ends the task
+    uint64_t handle = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle = next_handle_++;
+        task.task_id = handle;
+        spawned_.emplace(handle, spawned);
+    }
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    pool_.submit([this, spawned] { run(*spawned); });
+    return handle;
+}
+void SpawnRuntime::run(Spawned& spawned) {
+    TaskControlBlock& task = spawned.task;
+    TaskServices* services = spawned.services.get();
+    TaskEngine engine(memory_);
+    task.status = TaskStatus::RUNNING;
+    TaskEngine::SliceOutcome outcome;
+    do {
+        outcome = engine.runSlice(task, std::numeric_limits<uint64_t>::max(), services);
+        // A yield at a call boundary asks for a newer version; a failed hop stops those yields
+        if (outcome.result == TaskEngine::SliceResult::YIELDED) GraphRegistry::upgrade(task);
+    } while (outcome.result == TaskEngine::SliceResult::YIELDED);
+    switch (outcome.result) {
+        case TaskEngine::SliceResult::COMPLETED:
+        case TaskEngine::SliceResult::HALTED_TASK:
+            // A CTRL_RETURN out of the subgraph leaves its value as the context's last return value
+            if (!task.result) {
+                task.result = task.context->getLastReturnValue();
+                if (task.result) task.result_vector = retainVector(*task.result);
+            }
+            task.status = outcome.result == TaskEngine::SliceResult::COMPLETED ? TaskStatus::COMPLETED : TaskStatus::HALTED;
+            spawned.ok = true;
+            break;
+        case TaskEngine::SliceResult::WAITING:
+            task.error = "spawned task " + std::to_string(task.task_id) + " cannot wait on event " + std::to_string(task.wait_event);
+            TaskEngine::abandonWait(task, services); // Nobody will wake it: give up a channel or mutex registration
+            task.status = TaskStatus::FAULTED;
+            break;
+        default:
+            task.status = TaskStatus::FAULTED;
+            break;
+    }
+    releaseChildren(task);
+    task.version.reset(); // The result is all a joiner needs; let the version go
+    task.graph = nullptr;
+    task.constants = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spawned.done.store(true, std::memory_order_release);
+        if (spawned.detached) spawned_.erase(task.task_id); // Its spawner ended without joining it
+    }
+    pending_.fetch_sub(1, std::memory_order_acq_rel); // Last touch of 'this': the destructor may run now
+}
+bool SpawnRuntime::join(uint64_t handle, HeldValue& result, std::string* error) {
+    std::shared_ptr<Spawned> spawned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = spawned_.find(handle);
+        if (it != spawned_.end()) {
+            spawned = std::move(it->second);
+            spawned_.erase(it);
+        }
+    }
+    if (!spawned) {
+        if (error) *error = "unknown or already joined spawn handle " + std::to_string(handle);
+        return false;
+    }
+    if (!spawned->done.load(std::memory_order_acquire)) {
+        pool_.helpWhile([&spawned] { return !spawned->done.load(std::memory_order_acquire); });
+    }
+    if (!spawned->ok) {
+        if (error) *error = spawned->task.error;
+        return false;
+    }
+    result = spawned->task.result ? HeldValue(*spawned->task.result) : HeldValue{}; // Outlives the spawned task
+    return true;
+}
+void SpawnRuntime::releaseChildren(const TaskControlBlock& parent) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = spawned_.begin(); it != spawned_.end();) {
+        Spawned& child = *it->second;
+        if (child.parent != &parent) {
+            ++it;
+            continue;
+        }
+        child.parent = nullptr;
+        if (child.done.load(std::memory_order_acquire)) {
+            it = spawned_.erase(it);
+            continue;
+        }
+        child.detached = true;
+        ++it;
+    }
+}
+size_t SpawnRuntime::getHandleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spawned_.size();
+}
+bool SpawnRuntime::isDone(uint64_t handle) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = spawned_.find(handle);
+    return it == spawned_.end() || it->second->done.load(std::memory_order_acquire);
+}
+} // namespace bdi::runtime
@@ -0,0 +1,65 @@
+#ifndef BDI_RUNTIME_SPAWNRUNTIME_HPP
+#define BDI_RUNTIME_SPAWNRUNTIME_HPP
+#include "TaskEngine.hpp"
+#include "WorkStealingPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+namespace bdi::runtime {
+// Backs CONCURRENCY_SPAWN/CONCURRENCY_JOIN. spawn() starts a subgraph as a task on a
+// shared WorkStealingPool, with its own ExecutionContext whose outermost frame carries
+// the spawn's inputs as the subgraph's META_START arguments, and returns a handle.
+// join() waits for the handle by running other pool work on the calling thread, so a
+// joining task never parks an OS thread and nested fan-out cannot starve the pool.
+// Spawned tasks run to completion: SYS_YIELD only ends a slice, SYS_WAIT_EVENT faults.
+// They may send events, halt tasks, use channels and mutexes and spawn further tasks
+// through the spawner's services (a channel or mutex op that would park faults and
+// gives up its waiter registration), but have no device inputs (those are reserved for
+// journaled BDIOS tasks). Each child gets its own services object forwarding to the
+// outermost services, which must outlive the runtime's tasks.
+// A child spawned by a task pins that task's graph version and constants, and its handle
+// is released once the task ends without joining it (see releaseChildren()).
+// Thread-safe. The destructor waits for tasks that were spawned but never joined.
+class SpawnRuntime {
+public:
+    explicit SpawnRuntime(WorkStealingPool& pool, MemoryManager* memory = nullptr);
+    ~SpawnRuntime();
+    SpawnRuntime(const SpawnRuntime&) = delete;
+    SpawnRuntime& operator=(const SpawnRuntime&) = delete;
+    // Starts 'graph' at 'entry' with 'arguments' (moved from). Returns a handle > 0.
+    // 'parent' is the spawning task, if any: the child shares its version and constants.
+    uint64_t spawn(const BDIGraph& graph, NodeID entry, std::span<BDIValueVariant> arguments, TaskServices* services = nullptr,
+                   const TaskControlBlock* parent = nullptr);
+    // Waits for 'handle' and releases it. On success 'result' holds the subgraph's
+    // CTRL_RETURN value (monostate if none); false if the handle is unknown or the task faulted.
+    bool join(uint64_t handle, HeldValue& result, std::string* error = nullptr);
+    bool isDone(uint64_t handle) const; // True for finished and for unknown handles
+    // Called when 'parent' ends: handles it spawned and never joined are released, now if
+    // the child has finished, otherwise when it does
+    void releaseChildren(const TaskControlBlock& parent);
+    size_t getPendingCount() const { return pending_.load(std::memory_order_acquire); } // Spawned, not finished
+    size_t getHandleCount() const; // Neither joined nor released
+    WorkStealingPool& getPool() { return pool_; }
+private:
+    struct Spawned {
+        TaskControlBlock task;
+        std::unique_ptr<TaskServices> services;
+        const TaskControlBlock* parent = nullptr; // Guarded by mutex_; cleared once released
+        bool detached = false;                    // Guarded by mutex_: erase the handle when done
+        std::atomic<bool> done{false};
+        bool ok = false;
+    };
+    WorkStealingPool& pool_;
+    MemoryManager* memory_;
+    mutable std::mutex mutex_; // Guards spawned_, next_handle_ and the parent/detached fields
+    std::unordered_map<uint64_t, std::shared_ptr<Spawned>> spawned_;
+    uint64_t next_handle_ = 1;
+    std::atomic<size_t> pending_{0};
+    void run(Spawned& spawned);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_SPAWNRUNTIME_HPP
@@ -0,0 +1,425 @@
+#include "TaskScheduler.hpp"
+#include "Logger.hpp"
+#include "SpawnRuntime.hpp"
+#include <algorithm>
+namespace bdi::runtime {
+namespace {
+// TaskServices seen by tasks during replay: inputs, halt results, received channel values
+// and mutex outcomes come from the journal, and sent events are dropped because the
+// journal's DELIVER entries replace them. Channels, mutexes and spawns use the scheduler's.
+class ReplayServices : public TaskServices {
+public:
+    ReplayServices(ExecutionJournal& journal, TaskScheduler& scheduler) : journal_(journal), scheduler_(scheduler) {}
+    void sendEvent(uint64_t, BDIValueVariant) override {}
+    bool haltTask(uint64_t) override { return false; }
+    bool haltTaskFrom(TaskControlBlock& caller, uint64_t task_id) override {
+        return journal_.nextInput(caller.task_id, InputSource::HALT_RESULT, task_id).value_or(0) != 0;
+    }
+    std::optional<uint64_t> readInput(TaskControlBlock& task, InputSource source, uint64_t address) override {
+        return journal_.nextInput(task.task_id, source, address);
+    }
+    void exchangeInput(TaskControlBlock& task, InputSource source, uint64_t address, uint64_t& value) override {
+        if (auto recorded = journal_.nextInput(task.task_id, source, address)) value = *recorded;
+    }
+    SpawnRuntime* getSpawnRuntime() override { return scheduler_.getSpawnRuntime(); }
+    ChannelRegistry* getChannels() override { return scheduler_.getChannels(); }
+    FutexTable* getFutexTable() override { return scheduler_.getFutexTable(); }
+private:
+    ExecutionJournal& journal_;
+    TaskScheduler& scheduler_;
+};
+}
+TaskScheduler::TaskScheduler(MemoryManager* memory, size_t worker_count, uint64_t timeslice, ExecutionMode mode)
+    : memory_(memory), timeslice_(timeslice == 0 ? DEFAULT_TIMESLICE : timeslice), mode_(mode) {
+    if (worker_count == 0) worker_count = std::max(1u, std::thread::hardware_concurrency());
+    queues_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) queues_.push_back(std::make_unique<RunQueue>());
+}
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+// --- Task Creation ---
+uint64_t TaskScheduler::spawnTask(const BDIGraph& graph, NodeID entry_node_id, std::unique_ptr<ExecutionContext> context) {
+    auto task = std::make_unique<TaskControlBlock>();
+    task->graph = &graph;
+    task->resume_node_id = entry_node_id;
+    task->context = context ? std::move(context) : std::make_unique<ExecutionContext>();
+    return submitTask(std::move(task));
+}
+uint64_t TaskScheduler::spawnTask(const std::string& graph_name, NodeID entry_node_id, std::unique_ptr<ExecutionContext> context) {
+    auto version = graphs_.getCurrent(graph_name);
+    if (!version) return 0;
+    auto task = std::make_unique<TaskControlBlock>();
+    task->graph = &version->getGraph();
+    task->constants = &version->getConstants();
+    task->version = std::move(version);
+    task->resume_node_id = entry_node_id;
+    task->context = context ? std::move(context) : std::make_unique<ExecutionContext>();
+    return submitTask(std::move(task));
+}
+uint64_t TaskScheduler::submitTask(std::unique_ptr<TaskControlBlock> task) {
+    if (!task) return 0;
+    if (!task->context) task->context = std::make_unique<ExecutionContext>();
+    TaskControlBlock* raw = task.get();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (task->task_id == 0 || tasks_.count(task->task_id)) task->task_id = next_task_id_;
+        next_task_id_ = std::max(next_task_id_, task->task_id + 1);
+        task->status = TaskStatus::READY;
+        ++active_;
+        ++live_;
+        tasks_[task->task_id] = std::move(task);
+    }
+    if (journal_ && journal_->getMode() == ExecutionJournal::Mode::REPLAY) return raw->task_id; // replay() drives it
+    enqueue(raw, raw->last_worker);
+    return raw->task_id;
+}
+// --- Worker Management ---
+void TaskScheduler::start() {
+    if (running_.exchange(true)) return;
+    if (quantum_.count() > 0) timer_ = std::make_unique<PreemptionTimer>(queues_.size(), quantum_);
+    workers_.reserve(queues_.size());
+    for (size_t i = 0; i < queues_.size(); ++i) workers_.emplace_back(&TaskScheduler::workerLoop, this, i);
+}
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_ = false;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+    timer_.reset();
+}
+bool TaskScheduler::waitForIdle() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    idle_cv_.wait(lock, [this] { return active_ == 0; });
+    return live_ == 0;
+}
+// --- Run Queues ---
+void TaskScheduler::enqueue(TaskControlBlock* task, int preferred_worker) {
+    size_t target = (preferred_worker >= 0 && static_cast<size_t>(preferred_worker) < queues_.size())
+                        ? static_cast<size_t>(preferred_worker)
+                        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(task);
+    }
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+}
+bool TaskScheduler::popLocal(size_t index, TaskControlBlock*& out) {
+    RunQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    out = queue.tasks.front(); // FIFO: round-robin among the worker's own tasks
+    queue.tasks.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+bool TaskScheduler::steal(size_t thief_index, TaskControlBlock*& out) {
+    // First pass skips busy queues; if any were skipped, a second pass waits for their
+    // locks, so a thief under contention takes work or goes to sleep instead of spinning
+    // on queued_ > 0
+    const size_t count = queues_.size();
+    bool contended = false;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t offset = 1; offset < count; ++offset) {
+            RunQueue& victim = *queues_[(thief_index + offset) % count];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+            if (pass == 0) {
+                if (!lock.try_lock()) {
+                    contended = true;
+                    continue;
+                }
+            } else {
+                lock.lock();
+            }
+            if (victim.tasks.empty()) continue;
+            out = victim.tasks.back(); // Newest arrival: the victim would reach it last
+            victim.tasks.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (!contended) break;
+    }
+    return false;
+}
+void TaskScheduler::workerLoop(size_t index) {
+    TaskEngine engine(memory_);
+    TaskControlBlock* task = nullptr;
+    while (running_.load(std::memory_order_acquire)) {
+        if (popLocal(index, task) || steal(index, task)) {
+            runTask(index, engine, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return !running_.load() || queued_.load(std::memory_order_acquire) > 0; });
+    }
+}
+// --- Slice Execution ---
+void TaskScheduler::runTask(size_t worker, TaskEngine& engine, TaskControlBlock* task) {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (task->halt_requested.load()) { // Halted while sitting in a run queue
+            if (recording()) journal_->recordSlice(task->task_id, 0, TaskEngine::SliceResult::HALTED_TASK);
+            finishLocked(task, TaskStatus::HALTED);
+            task = nullptr;
+        } else {
+            task->status = TaskStatus::RUNNING;
+        }
+    }
+    if (!task) return;
+    if (task->last_worker >= 0 && static_cast<size_t>(task->last_worker) != worker) migrations_.fetch_add(1, std::memory_order_relaxed);
+    task->last_worker = static_cast<int>(worker);
+    if (task->at_safe_point && task->version && task->version->isSuperseded()) {
+        upgrades_.fetch_add(GraphRegistry::upgrade(*task), std::memory_order_relaxed);
+    }
+    const uint64_t executed_before = task->instructions_executed;
+    TaskEngine::SliceResult result;
+    if (timer_) timer_->arm(worker);
+    if (mode_ == ExecutionMode::COROUTINE) {
+        if (!task->coroutine) task->coroutine = TaskEngine::interpret(*task, memory_, this, timeslice_);
+        task->coroutine.resume();
+        result = task->coroutine.getSuspendReason();
+    } else {
+        result = engine.runSlice(*task, timeslice_, this).result;
+    }
+    if (timer_) timer_->disarm(worker);
+    slices_.fetch_add(1, std::memory_order_relaxed);
+    TaskStatus reported = TaskStatus::RUNNING; // RUNNING = nothing to report
+    bool requeue = false;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        bool halt = task->halt_requested.load();
+        if (recording()) {
+            // A halt request that lands after the slice ended still halts it, so log what the task is told
+            bool halts_here = halt && (result == TaskEngine::SliceResult::YIELDED || result == TaskEngine::SliceResult::WAITING);
+            journal_->recordSlice(task->task_id, task->instructions_executed - executed_before,
+                                  halts_here ? TaskEngine::SliceResult::HALTED_TASK : result);
+        }
+        switch (result) {
+            case TaskEngine::SliceResult::YIELDED:
+                if (halt) { finishLocked(task, reported = TaskStatus::HALTED); break; }
+                task->status = TaskStatus::READY;
+                requeue = true;
+                break;
+            case TaskEngine::SliceResult::WAITING: {
+                if (halt) { finishLocked(task, reported = TaskStatus::HALTED); break; }
+                auto pending = pending_events_.find(task->wait_event);
+                if (pending != pending_events_.end()) { // Event already sent: consume it and keep going
+                    if (recording()) journal_->recordDelivery(task->task_id, pending->second.front());
+                    if (!std::holds_alternative<std::monostate>(pending->second.front().get())) {
+                        task->context->setPortValue(task->wait_node_id, 0, pending->second.front());
+                    }
+                    pending->second.pop_front();
+                    if (pending->second.empty()) pending_events_.erase(pending);
+                    task->status = TaskStatus::READY;
+                    requeue = true;
+                    break;
+                }
+                task->status = reported = TaskStatus::WAITING;
+                waiters_[task->wait_event].push_back(task);
+                if (--active_ == 0) idle_cv_.notify_all();
+                break;
+            }
+            case TaskEngine::SliceResult::COMPLETED:
+                finishLocked(task, reported = TaskStatus::COMPLETED);
+                break;
+            case TaskEngine::SliceResult::HALTED_TASK:
+                finishLocked(task, reported = TaskStatus::HALTED);
+                break;
+            case TaskEngine::SliceResult::ERROR:
+                BDI_LOG_ERROR(SCHEDULER, "Task " << task->task_id << " faulted: " << task->error);
+                finishLocked(task, reported = TaskStatus::FAULTED);
+                break;
+        }
+    }
+    if (requeue) enqueue(task, static_cast<int>(worker));
+    if (reported != TaskStatus::RUNNING) notify(task, reported);
+}
+void TaskScheduler::finishLocked(TaskControlBlock* task, TaskStatus status) {
+    if (task->status != TaskStatus::WAITING && --active_ == 0) idle_cv_.notify_all();
+    task->status = status;
+    task->coroutine.reset(); // Suspended or finished; its frame goes back to the pool
+    if (spawner_) spawner_->releaseChildren(*task); // Handles it spawned and never joined
+    if (task->version) { // Let the version go: it is reclaimed with its last task
+        task->version.reset();
+        task->graph = nullptr;
+        task->constants = nullptr;
+    }
+    if (--live_ == 0) idle_cv_.notify_all();
+}
+void TaskScheduler::notify(const TaskControlBlock* task, TaskStatus status) {
+    if (listener_) listener_(task->task_id, status);
+}
+// --- Task Services ---
+void TaskScheduler::sendEvent(uint64_t event_id, BDIValueVariant payload) {
+    TaskControlBlock* woken = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto it = waiters_.find(event_id);
+        if (it == waiters_.end()) {
+            pending_events_[event_id].push_back(std::move(payload));
+            return;
+        }
+        woken = it->second.front();
+        it->second.pop_front();
+        if (it->second.empty()) waiters_.erase(it);
+        if (recording()) journal_->recordDelivery(woken->task_id, payload);
+        // The task is parked, so its context is not being touched by any worker
+        if (!std::holds_alternative<std::monostate>(payload)) woken->context->setPortValue(woken->wait_node_id, 0, std::move(payload));
+        woken->status = TaskStatus::READY;
+        ++active_;
+    }
+    enqueue(woken, woken->last_worker);
+    notify(woken, TaskStatus::READY);
+}
+bool TaskScheduler::haltTask(uint64_t task_id) {
+    TaskControlBlock* halted = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        auto it = tasks_.find(task_id);
+        if (it == tasks_.end()) return false;
+        TaskControlBlock* task = it->second.get();
+        if (task->status == TaskStatus::COMPLETED || task->status == TaskStatus::HALTED || task->status == TaskStatus::FAULTED) return false;
+        task->halt_requested = true; // READY: dropped when popped; RUNNING: engine stops at the next node
+        if (task->status == TaskStatus::WAITING) {
+            auto& waiting = waiters_[task->wait_event];
+            waiting.erase(std::remove(waiting.begin(), waiting.end(), task), waiting.end());
+            if (waiting.empty()) waiters_.erase(task->wait_event);
+            if (recording()) journal_->recordHaltWhileWaiting(task->task_id);
+            finishLocked(task, TaskStatus::HALTED);
+            halted = task;
+        }
+    }
+    if (halted) notify(halted, TaskStatus::HALTED);
+    return true;
+}
+bool TaskScheduler::haltTaskFrom(TaskControlBlock& caller, uint64_t task_id) {
+    bool halted = haltTask(task_id);
+    if (recording()) journal_->recordInput(caller.task_id, InputSource::HALT_RESULT, task_id, halted);
+    return halted;
+}
+std::optional<uint64_t> TaskScheduler::readInput(TaskControlBlock& task, InputSource source, uint64_t address) {
+    auto value = device_ ? device_->read(source, address) : std::nullopt;
+    if (value && recording()) journal_->recordInput(task.task_id, source, address, *value);
+    return value;
+}
+void TaskScheduler::exchangeInput(TaskControlBlock& task, InputSource source, uint64_t address, uint64_t& value) {
+    if (recording()) journal_->recordInput(task.task_id, source, address, value);
+}
+// --- Replay ---
+bool TaskScheduler::replay(std::string* divergence) {
+    if (!journal_ || journal_->getMode() != ExecutionJournal::Mode::REPLAY || running_.load()) {
+        BDI_LOG_ERROR(SCHEDULER, "replay() needs a journal in REPLAY mode and a stopped scheduler");
+        return false;
+    }
+    TaskEngine engine(memory_);
+    ReplayServices services(*journal_, *this);
+    auto diverged = [&](const std::string& message) {
+        journal_->reportDivergence(message);
+        if (divergence) *divergence = journal_->getDivergence(); // An input mismatch is the root cause if there was one
+        return false;
+    };
+    const auto& schedule = journal_->getSchedule();
+    for (size_t i = 0; i < schedule.size(); ++i) {
+        const ExecutionJournal::ScheduleEntry& entry = schedule[i];
+        const std::string where = "entry " + std::to_string(i) + ", task " + std::to_string(entry.task_id) + ": ";
+        TaskControlBlock* task = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            auto it = tasks_.find(entry.task_id);
+            if (it != tasks_.end()) task = it->second.get();
+        }
+        if (!task) return diverged(where + "no such task (tasks must be spawned in the recorded order)");
+        TaskStatus reported = TaskStatus::RUNNING;
+        switch (entry.kind) {
+            case ExecutionJournal::EntryKind::SLICE: {
+                if (task->status != TaskStatus::READY) return diverged(where + "slice for a task that is not ready");
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex_);
+                    task->status = TaskStatus::RUNNING;
+                }
+                // The recorded step count is an exact budget, so the slice ends where it did, even
+                // mid-block where another task's halt stopped it
+                TaskEngine::SliceOutcome outcome = engine.runSlice(*task, entry.steps, &services, true);
+                slices_.fetch_add(1, std::memory_order_relaxed);
+                bool matches = outcome.instructions == entry.steps &&
+                               (outcome.result == entry.result ||
+                                (entry.result == TaskEngine::SliceResult::HALTED_TASK && // Halted by another task
+                                 (outcome.result == TaskEngine::SliceResult::YIELDED || outcome.result == TaskEngine::SliceResult::WAITING)));
+                if (!matches) {
+                    return diverged(where + "slice ran " + std::to_string(outcome.instructions) + " of " + std::to_string(entry.steps) +
+                                    " nodes and ended " + std::to_string(static_cast<int>(outcome.result)) + ", recorded " +
+                                    std::to_string(static_cast<int>(entry.result)) + (task->error.empty() ? "" : " (" + task->error + ")"));
+                }
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                switch (entry.result) {
+                    case TaskEngine::SliceResult::YIELDED:
+                        task->status = TaskStatus::READY;
+                        break;
+                    case TaskEngine::SliceResult::WAITING:
+                        task->status = reported = TaskStatus::WAITING;
+                        --active_;
+                        break;
+                    case TaskEngine::SliceResult::COMPLETED:
+                        finishLocked(task, reported = TaskStatus::COMPLETED);
+                        break;
+                    case TaskEngine::SliceResult::HALTED_TASK:
+                        finishLocked(task, reported = TaskStatus::HALTED);
+                        break;
+                    case TaskEngine::SliceResult::ERROR:
+                        finishLocked(task, reported = TaskStatus::FAULTED);
+                        break;
+                }
+                break;
+            }
+            case ExecutionJournal::EntryKind::DELIVER: {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (task->status != TaskStatus::WAITING) return diverged(where + "event delivered to a task that is not waiting");
+                if (!std::holds_alternative<std::monostate>(entry.payload.get())) task->context->setPortValue(task->wait_node_id, 0, entry.payload);
+                task->status = reported = TaskStatus::READY;
+                ++active_;
+                break;
+            }
+            case ExecutionJournal::EntryKind::HALT_WAITING: {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (task->status != TaskStatus::WAITING) return diverged(where + "halt of a task that is not waiting");
+                finishLocked(task, reported = TaskStatus::HALTED);
+                break;
+            }
+        }
+        if (reported != TaskStatus::RUNNING) notify(task, reported);
+    }
+    if (!journal_->getDivergence().empty()) return diverged(journal_->getDivergence());
+    return true;
+}
+// --- Inspection ---
+std::optional<TaskStatus> TaskScheduler::getTaskStatus(uint64_t task_id) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto it = tasks_.find(task_id);
+    if (it == tasks_.end()) return std::nullopt;
+    return it->second->status;
+}
+std::optional<BDIValueVariant> TaskScheduler::getTaskResult(uint64_t task_id) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto it = tasks_.find(task_id);
+    if (it == tasks_.end() || it->second->status != TaskStatus::COMPLETED) return std::nullopt;
+    return it->second->result;
+}
+std::string TaskScheduler::getTaskError(uint64_t task_id) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto it = tasks_.find(task_id);
+    if (it == tasks_.end() || it->second->status != TaskStatus::FAULTED) return std::string();
+    return it->second->error;
+}
+const ExecutionContext* TaskScheduler::getTaskContext(uint64_t task_id) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto it = tasks_.find(task_id);
+    return it == tasks_.end() ? nullptr : it->second->context.get();
+}
+} // namespace bdi::runtime
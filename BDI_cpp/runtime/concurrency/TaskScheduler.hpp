@@ -0,0 +1,162 @@
+#ifndef BDI_RUNTIME_TASKSCHEDULER_HPP
+#define BDI_RUNTIME_TASKSCHEDULER_HPP
+#include "TaskEngine.hpp"
+#include "Channel.hpp"
+#include "FutexTable.hpp"
+#include "ExecutionJournal.hpp"
+#include "DebugSession.hpp"
+#include "GraphRegistry.hpp"
+#include "PreemptionTimer.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+namespace bdi::runtime {
+// M:N BDIOS scheduler: N worker threads, each with its own TaskEngine and run queue,
+// multiplex any number of tasks. A worker runs the front of its queue for one timeslice
+// and requeues it locally on yield/preemption; idle workers steal from the back of
+// other queues, so a task's ExecutionContext migrates with its TCB. A timeslice is a
+// time quantum: a PreemptionTimer raises the worker's flag and the engine yields at its
+// next preemption point. The node budget only backs it up (and is all there is with the
+// quantum set to zero), so a slice of heavy nodes costs the same time as one of cheap ones.
+// SYS_WAIT_EVENT parks the task (no thread blocks); sendEvent() from any worker or
+// external thread wakes one waiter in FIFO order, or is banked until someone waits.
+// haltTask() works for tasks that are ready, waiting or running on another worker.
+// In COROUTINE mode every task is a TaskEngine::interpret() coroutine with a pooled
+// frame; a switch is a single resume() and idle tasks cost only their frame and TCB.
+// Tasks spawned from the GraphRegistry move to newly published versions of their graph
+// without stopping: before a slice that follows a safe point, the worker carries the
+// task across through the versions' NodeID maps.
+// With an ExecutionJournal in RECORD mode the scheduler logs slice boundaries, event
+// deliveries, halts and device reads; replay() re-runs such a journal on the calling
+// thread without waiting on events or timers.
+class TaskScheduler : public TaskServices {
+public:
+    static constexpr uint64_t DEFAULT_TIMESLICE = uint64_t{1} << 20; // Node budget per slice
+    static constexpr std::chrono::microseconds DEFAULT_QUANTUM{1000}; // Time per slice
+    enum class ExecutionMode : uint8_t { SLICED, COROUTINE };
+    using StateListener = std::function<void(uint64_t task_id, TaskStatus status)>;
+    explicit TaskScheduler(MemoryManager* memory = nullptr, size_t worker_count = 0, // 0 = hardware_concurrency
+                           uint64_t timeslice = DEFAULT_TIMESLICE, ExecutionMode mode = ExecutionMode::SLICED);
+    ~TaskScheduler() override;
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    // Create a READY task starting at 'entry_node_id'. Returns the task id.
+    uint64_t spawnTask(const BDIGraph& graph, NodeID entry_node_id, std::unique_ptr<ExecutionContext> context = nullptr);
+    // Adopt a prepared TCB (e.g. handed out by a BDIOSSchedulerInterface). Assigns an id if 0.
+    uint64_t submitTask(std::unique_ptr<TaskControlBlock> task);
+    // --- Hot Swap ---
+    // Spawn a task on the current version of a registered graph (0 if none is published).
+    // Publishing a newer version moves the task over at its next safe point: SYS_YIELD,
+    // a wait, or a CTRL_CALL/CTRL_RETURN. Deployments are not journaled.
+    uint64_t spawnTask(const std::string& graph_name, NodeID entry_node_id, std::unique_ptr<ExecutionContext> context = nullptr);
+    GraphRegistry& getGraphRegistry() { return graphs_; }
+    uint64_t getUpgradeCount() const { return upgrades_.load(); } // Version hops taken by tasks
+    // Set before start(); zero turns the timer off and slices end on the node budget alone
+    void setTimeQuantum(std::chrono::nanoseconds quantum) { quantum_ = quantum; }
+    std::chrono::nanoseconds getTimeQuantum() const { return quantum_; }
+    void start();
+    void stop(); // Joins workers; unfinished tasks keep their state
+    // Block until no task is READY or RUNNING. True if every task finished; false if
+    // some are still WAITING on events nobody has sent yet.
+    bool waitForIdle();
+    // --- TaskServices (callable from any thread) ---
+    void sendEvent(uint64_t event_id, BDIValueVariant payload = {}) override;
+    bool haltTask(uint64_t task_id) override;
+    bool haltTaskFrom(TaskControlBlock& caller, uint64_t task_id) override;
+    std::optional<uint64_t> readInput(TaskControlBlock& task, InputSource source, uint64_t address) override;
+    void exchangeInput(TaskControlBlock& task, InputSource source, uint64_t address, uint64_t& value) override;
+    // CONCURRENCY_SPAWN/JOIN. Set before start(); spawned subgraphs are not journaled.
+    void setSpawnRuntime(SpawnRuntime* spawner) { spawner_ = spawner; }
+    SpawnRuntime* getSpawnRuntime() override { return spawner_; }
+    // Channels shared by this scheduler's tasks; create them before the tasks use them.
+    // COMM_CHANNEL_SEND/RECV park on reserved event ids (Channel::EVENT_BASE and up).
+    ChannelRegistry* getChannels() override { return &channels_; }
+    // Contended SYNC_MUTEX_LOCKs park on reserved event ids (FutexTable::EVENT_BASE and up)
+    FutexTable* getFutexTable() override { return &futexes_; }
+    // The timer flag of the worker running 'task' (worker threads only)
+    const std::atomic<bool>* getPreemptFlag(const TaskControlBlock& task) override {
+        return timer_ && task.last_worker >= 0 ? &timer_->flag(static_cast<size_t>(task.last_worker)) : nullptr;
+    }
+    // --- Debugging ---
+    // Slices that start while a session is attached run the instrumented loop; the rest
+    // run the plain one. A task stopped in DebugSession::onBreak() keeps its worker, the
+    // other workers carry on. A session, once attached, must outlive the scheduler's run.
+    void attachDebugger(DebugSession* session) { debug_.store(session, std::memory_order_release); }
+    void detachDebugger() { debug_.store(nullptr, std::memory_order_release); }
+    DebugSession* getDebugSession() override { return debug_.load(std::memory_order_acquire); }
+    // --- Record/Replay ---
+    // Set both before start(). The device serves IO_READ_PORT/SYS_REG_READ.
+    void setDevice(DeviceInputs* device) { device_ = device; }
+    void setJournal(ExecutionJournal* journal) { journal_ = journal; }
+    // Replays the journal (REPLAY mode) over the tasks spawned so far, which must be the
+    // same graphs spawned in the same order as in the recorded run. Do not start() the
+    // scheduler. Returns false on the first divergence from the recording.
+    bool replay(std::string* divergence = nullptr);
+    // --- Inspection ---
+    std::optional<TaskStatus> getTaskStatus(uint64_t task_id) const;
+    std::optional<BDIValueVariant> getTaskResult(uint64_t task_id) const; // A vector lives as long as the scheduler
+    std::string getTaskError(uint64_t task_id) const;
+    // Only valid while the task is not running (finished, waiting, or scheduler stopped)
+    const ExecutionContext* getTaskContext(uint64_t task_id) const;
+    size_t getWorkerCount() const { return queues_.size(); }
+    ExecutionMode getExecutionMode() const { return mode_; }
+    uint64_t getMigrationCount() const { return migrations_.load(); } // Slices resumed on another worker
+    uint64_t getSliceCount() const { return slices_.load(); }
+    void setStateListener(StateListener listener) { listener_ = std::move(listener); }
+private:
+    struct RunQueue {
+        std::mutex mutex;
+        std::deque<TaskControlBlock*> tasks;
+    };
+    MemoryManager* memory_;
+    uint64_t timeslice_;
+    std::chrono::nanoseconds quantum_ = DEFAULT_QUANTUM;
+    ExecutionMode mode_;
+    std::vector<std::unique_ptr<RunQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::unique_ptr<PreemptionTimer> timer_; // One slot per worker while started
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    // Task table and event state. Every transition into or out of WAITING and every
+    // change of 'active_' happens under state_mutex_, so wakeups cannot be lost.
+    mutable std::mutex state_mutex_;
+    std::condition_variable idle_cv_;
+    std::unordered_map<uint64_t, std::unique_ptr<TaskControlBlock>> tasks_;
+    std::unordered_map<uint64_t, std::deque<TaskControlBlock*>> waiters_;       // By event id
+    std::unordered_map<uint64_t, std::deque<HeldValue>> pending_events_;        // Sent with no waiter
+    uint64_t next_task_id_ = 1;
+    size_t active_ = 0; // READY + RUNNING
+    size_t live_ = 0;   // Not yet COMPLETED/HALTED/FAULTED
+    std::atomic<uint64_t> migrations_{0};
+    std::atomic<uint64_t> slices_{0};
+    std::atomic<uint64_t> upgrades_{0};
+    StateListener listener_;
+    DeviceInputs* device_ = nullptr;
+    ExecutionJournal* journal_ = nullptr;
+    SpawnRuntime* spawner_ = nullptr;
+    std::atomic<DebugSession*> debug_{nullptr};
+    ChannelRegistry channels_;
+    FutexTable futexes_;
+    GraphRegistry graphs_;
+    bool recording() const { return journal_ && journal_->getMode() == ExecutionJournal::Mode::RECORD; }
+    void workerLoop(size_t index);
+    void enqueue(TaskControlBlock* task, int preferred_worker);
+    bool popLocal(size_t index, TaskControlBlock*& out);
+    bool steal(size_t thief_index, TaskControlBlock*& out);
+    void runTask(size_t worker, TaskEngine& engine, TaskControlBlock* task);
+    void finishLocked(TaskControlBlock* task, TaskStatus status); // Caller holds state_mutex_
+    void notify(const TaskControlBlock* task, TaskStatus status);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_TASKSCHEDULER_HPP
@@ -0,0 +1,124 @@
+#include "WorkStealingPool.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+namespace bdi::runtime {
+namespace {
+// Identifies the pool/worker owning the current thread
+thread_local const WorkStealingPool* tls_pool = nullptr;
+thread_local int tls_worker_index = -1;
+// Tasks own their error reporting; never let one take down a worker or a helping thread
+void runTask(WorkStealingPool::Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        BDI_LOG_ERROR(SCHEDULER, "WorkStealingPool task threw: " << e.what());
+    } catch (...) {
+        BDI_LOG_ERROR(SCHEDULER, "WorkStealingPool task threw a non-standard exception");
+    }
+    task = nullptr;
+}
+}
+WorkStealingPool::WorkStealingPool(size_t worker_count) {
+    if (worker_count == 0) worker_count = std::max(1u, std::thread::hardware_concurrency());
+    queues_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) queues_.push_back(std::make_unique<WorkerQueue>());
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+int WorkStealingPool::currentWorkerIndex() const {
+    return tls_pool == this ? tls_worker_index : -1;
+}
+void WorkStealingPool::submit(Task task) {
+    int self = currentWorkerIndex();
+    size_t target = self >= 0 ? static_cast<size_t>(self)
+                              : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    queued_.fetch_add(1, std::memory_order_release); // Counted before it is visible, so pops never underflow
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    // Taking the sleep mutex orders this wakeup against a worker that is about to wait
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+}
+bool WorkStealingPool::popLocal(size_t index, Task& out) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    out = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+bool WorkStealingPool::steal(size_t thief_index, Task& out) {
+    // First pass skips busy deques; if any were skipped, a second pass waits for their
+    // locks, so a thief under contention takes work or goes to sleep instead of spinning
+    const size_t count = queues_.size();
+    bool contended = false;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t offset = 1; offset <= count; ++offset) {
+            WorkerQueue& victim = *queues_[(thief_index + offset) % count];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+            if (pass == 0) {
+                if (!lock.try_lock()) {
+                    contended = true;
+                    continue;
+                }
+            } else {
+                lock.lock();
+            }
+            if (victim.tasks.empty()) continue;
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (!contended) break;
+    }
+    return false;
+}
+bool WorkStealingPool::tryRunOne() {
+    Task task;
+    int self = currentWorkerIndex();
+    bool found = self >= 0 ? (popLocal(static_cast<size_t>(self), task) || steal(static_cast<size_t>(self), task))
+                           : steal(next_queue_.load(std::memory_order_relaxed) % queues_.size(), task);
+    if (!found) return false;
+    runTask(task);
+    return true;
+}
+void WorkStealingPool::helpWhile(const std::function<bool()>& keep_waiting) {
+    while (keep_waiting()) {
+        if (!tryRunOne()) std::this_thread::yield();
+    }
+}
+void WorkStealingPool::workerLoop(size_t index) {
+    tls_pool = this;
+    tls_worker_index = static_cast<int>(index);
+    Task task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return stopping_.load() || queued_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && queued_.load() == 0) break;
+    }
+    tls_pool = nullptr;
+    tls_worker_index = -1;
+}
+WorkStealingPool& computePool() {
+    static WorkStealingPool pool;
+    return pool;
+}
+} // namespace bdi::runtime
@@ -0,0 +1,52 @@
+#ifndef BDI_RUNTIME_WORKSTEALINGPOOL_HPP
+#define BDI_RUNTIME_WORKSTEALINGPOOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace bdi::runtime {
+// Fixed-size thread pool with one deque per worker.
+// Owners push/pop at the back (LIFO, cache-warm); idle workers steal from the front
+// of other deques (FIFO, oldest/largest work first). Tasks submitted from outside the
+// pool are spread round-robin over the worker deques.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+    explicit WorkStealingPool(size_t worker_count = 0); // 0 = hardware_concurrency
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    void submit(Task task);
+    // Run queued tasks on the calling thread while 'keep_waiting' returns true.
+    // Used to wait for results without blocking a worker (helping join).
+    void helpWhile(const std::function<bool()>& keep_waiting);
+    // Execute one queued task on the calling thread; false if none was found
+    bool tryRunOne();
+    size_t getWorkerCount() const { return workers_.size(); }
+    // Index of the calling worker in this pool, or -1 for foreign threads
+    int currentWorkerIndex() const;
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> queued_{0};     // Tasks sitting in any deque
+    std::atomic<size_t> next_queue_{0}; // Round-robin cursor for external submits
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& out);
+    bool steal(size_t thief_index, Task& out);
+};
+// Process-wide pool shared by the data-parallel kernels (GEMM, BFS), started on first use
+WorkStealingPool& computePool();
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_WORKSTEALINGPOOL_HPP
@@ -18,7 +18,7 @@
     void clearHistory();
  private:
     // Store state values from the previous time step, keyed by the NodeID that produced them
-    std::unordered_map<NodeID, BDIValueVariant> previous_step_states_;
+    std::unordered_map<NodeID, runtime::HeldValue> previous_step_states_;
  };
  } // namespace bdi::intelligence
  #endif // BDI_INTELLIGENCE_RECURRENCEMANAGER_HPP
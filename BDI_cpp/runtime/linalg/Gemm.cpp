@@ -0,0 +1,182 @@
+#include "Gemm.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <vector>
+namespace bdi::runtime::linalg {
+namespace {
+// Block sizes: an mc x kc block of A fills about half of a 256 KiB L2, a kc x nr sliver
+// of B stays in L1 across the mr-row slivers of A, and a kc x nc panel of B fits in L3
+constexpr size_t kMc = 144; // A multiple of every mr
+constexpr size_t kMaxTile = 256; // mr x nr of every table (at most 6 x 32)
+template <typename T>
+constexpr size_t kKc = 1024 / sizeof(T);
+template <typename T>
+constexpr size_t kNc = 8192 / sizeof(T);
+const GemmKernel<float>& kernelOf(const GemmKernels& kernels, float*) { return kernels.f32; }
+const GemmKernel<double>& kernelOf(const GemmKernels& kernels, double*) { return kernels.f64; }
+const GemmKernel<int32_t>& kernelOf(const GemmKernels& kernels, int32_t*) { return kernels.i32; }
+size_t roundUp(size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+// Rows [row0, row0 + rows) x columns [p0, p0 + kc) of A as mr-row slivers, zero-padded
+template <typename T>
+void packA(const MatrixRef<const T>& a, size_t row0, size_t rows, size_t p0, size_t kc, size_t mr, T* out) {
+    for (size_t i0 = 0; i0 < rows; i0 += mr) {
+        const size_t height = std::min(mr, rows - i0);
+        for (size_t p = 0; p < kc; ++p, out += mr) {
+            const T* src = &a.at(row0 + i0, p0 + p);
+            for (size_t i = 0; i < height; ++i) out[i] = src[i * a.row_stride];
+            std::fill(out + height, out + mr, T{0});
+        }
+    }
+}
+// Rows [p0, p0 + kc) x columns [col0, col0 + cols) of B as nr-column slivers, zero-padded
+template <typename T>
+void packB(const MatrixRef<const T>& b, size_t p0, size_t kc, size_t col0, size_t cols, size_t nr, T* out) {
+    for (size_t j0 = 0; j0 < cols; j0 += nr) {
+        const size_t width = std::min(nr, cols - j0);
+        for (size_t p = 0; p < kc; ++p, out += nr) {
+            const T* src = &b.at(p0 + p, col0 + j0);
+            if (b.col_stride == 1) {
+                std::copy_n(src, width, out);
+            } else {
+                for (size_t j = 0; j < width; ++j) out[j] = src[j * b.col_stride];
+            }
+            std::fill(out + width, out + nr, T{0});
+        }
+    }
+}
+template <typename T>
+void storeTile(const T* acc, size_t nr, const MatrixRef<T>& c, size_t row, size_t col, size_t height, size_t width, bool add) {
+    for (size_t i = 0; i < height; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+            T& out = c.at(row + i, col + j);
+            out = add ? static_cast<T>(static_cast<WrappingType<T>>(out) + static_cast<WrappingType<T>>(acc[i * nr + j])) : acc[i * nr + j];
+        }
+    }
+}
+// Pack buffers of the calling thread, grown to the largest tile it has run, so tiles on
+// the pool's workers allocate nothing after warm-up. A thread runs one tile at a time.
+template <typename T>
+struct PackBuffers {
+    std::vector<T> a, b;
+};
+template <typename T>
+PackBuffers<T>& packBuffers() {
+    thread_local PackBuffers<T> buffers;
+    return buffers;
+}
+// Computes the tile rows [row0, row0 + rows) x columns [col0, col0 + cols) of C over all of k
+template <typename T>
+void gemmTile(const GemmKernel<T>& kernel, size_t k, const MatrixRef<const T>& a, const MatrixRef<const T>& b,
+              const MatrixRef<T>& c, size_t row0, size_t rows, size_t col0, size_t cols, bool accumulate) {
+    const size_t mr = kernel.mr, nr = kernel.nr;
+    const size_t nc_max = std::min(roundUp(kNc<T>, nr), roundUp(cols, nr));
+    PackBuffers<T>& buffers = packBuffers<T>();
+    const size_t a_size = roundUp(std::min(kMc, rows), mr) * kKc<T>;
+    const size_t b_size = kKc<T> * nc_max;
+    if (buffers.a.size() < a_size) buffers.a.resize(a_size);
+    if (buffers.b.size() < b_size) buffers.b.resize(b_size);
+    T* const a_pack = buffers.a.data();
+    T* const b_pack = buffers.b.data();
+    alignas(64) T acc[kMaxTile];
+    for (size_t jc = 0; jc < cols; jc += nc_max) {
+        const size_t nc = std::min(nc_max, cols - jc);
+        for (size_t pc = 0; pc < k; pc += kKc<T>) {
+            const size_t kc = std::min(kKc<T>, k - pc);
+            const bool add = accumulate || pc > 0;
+            packB(b, pc, kc, col0 + jc, nc, nr, b_pack);
+            for (size_t ic = 0; ic < rows; ic += kMc) {
+                const size_t mc = std::min(kMc, rows - ic);
+                packA(a, row0 + ic, mc, pc, kc, mr, a_pack);
+                for (size_t jr = 0; jr < nc; jr += nr) {
+                    for (size_t ir = 0; ir < mc; ir += mr) {
+                        kernel.run(kc, a_pack + ir * kc, b_pack + jr * kc, acc);
+                        storeTile(acc, nr, c, row0 + ic + ir, col0 + jc + jr, std::min(mr, mc - ir), std::min(nr, nc - jr), add);
+                    }
+                }
+            }
+        }
+    }
+}
+}
+// --- Layouts ---
+std::optional<MatrixLayout> parseLayoutHint(std::string_view hint) {
+    if (hint == "RowMajor" || hint == "Contiguous") return MatrixLayout::ROW_MAJOR;
+    if (hint == "ColMajor") return MatrixLayout::COL_MAJOR;
+    return std::nullopt;
+}
+// --- GEMM ---
+template <typename T>
+void gemm(const GemmKernels& kernels, size_t m, size_t n, size_t k, MatrixRef<const T> a, MatrixRef<const T> b,
+          MatrixRef<T> c, bool accumulate, WorkStealingPool* pool) {
+    if (m == 0 || n == 0) return;
+    if (k == 0) {
+        if (!accumulate) {
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) c.at(i, j) = T{0};
+            }
+        }
+        return;
+    }
+    const GemmKernel<T>& kernel = kernelOf(kernels, static_cast<T*>(nullptr));
+    const uint64_t work = static_cast<uint64_t>(m) * n * k;
+    if (!pool || work < PARALLEL_MIN_WORK) {
+        gemmTile(kernel, k, a, b, c, 0, m, 0, n, accumulate);
+        return;
+    }
+    // Row tiles of mc; if that leaves fewer than two tiles per thread, also split the
+    // columns (in whole nr slivers, at least four wide) so every thread gets work
+    const size_t threads = pool->getWorkerCount() + 1; // The caller helps
+    const size_t row_tiles = (m + kMc - 1) / kMc;
+    size_t col_chunk = roundUp(kNc<T>, kernel.nr);
+    if (row_tiles < 2 * threads) {
+        const size_t wanted = (2 * threads + row_tiles - 1) / row_tiles;
+        col_chunk = std::min(col_chunk, std::max(4 * kernel.nr, roundUp((n + wanted - 1) / wanted, kernel.nr)));
+    }
+    // Every tile counts itself off however it ends; the first exception is rethrown here
+    // once all tiles are done, since they reference this frame
+    struct TileDone {
+        std::atomic<size_t>& remaining;
+        ~TileDone() { remaining.fetch_sub(1, std::memory_order_release); }
+    };
+    std::atomic<size_t> remaining{row_tiles * ((n + col_chunk - 1) / col_chunk)};
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    auto runTile = [&](size_t row, size_t col) {
+        TileDone done{remaining};
+        try {
+            gemmTile(kernel, k, a, b, c, row, std::min(kMc, m - row), col, std::min(col_chunk, n - col), accumulate);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+        }
+    };
+    for (size_t row = 0; row < m; row += kMc) {
+        for (size_t col = 0; col < n; col += col_chunk) {
+            try {
+                pool->submit([&runTile, row, col] { runTile(row, col); });
+            } catch (...) {
+                runTile(row, col); // Could not queue it: run it here rather than leave it uncounted
+            }
+        }
+    }
+    pool->helpWhile([&] { return remaining.load(std::memory_order_acquire) > 0; });
+    if (failure) std::rethrow_exception(failure);
+}
+template <typename T>
+void gemm(size_t m, size_t n, size_t k, MatrixRef<const T> a, MatrixRef<const T> b, MatrixRef<T> c,
+          bool accumulate, WorkStealingPool* pool) {
+    gemm(gemmKernels(), m, n, k, a, b, c, accumulate, pool);
+}
+#define BDI_INSTANTIATE_GEMM(T)                                                                                  \
+    template void gemm<T>(size_t, size_t, size_t, MatrixRef<const T>, MatrixRef<const T>, MatrixRef<T>, bool,    \
+                          WorkStealingPool*);                                                                    \
+    template void gemm<T>(const GemmKernels&, size_t, size_t, size_t, MatrixRef<const T>, MatrixRef<const T>,    \
+                          MatrixRef<T>, bool, WorkStealingPool*);
+BDI_INSTANTIATE_GEMM(float)
+BDI_INSTANTIATE_GEMM(double)
+BDI_INSTANTIATE_GEMM(int32_t)
+#undef BDI_INSTANTIATE_GEMM
+} // namespace bdi::runtime::linalg
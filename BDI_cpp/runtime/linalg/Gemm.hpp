@@ -0,0 +1,60 @@
+#ifndef BDI_RUNTIME_GEMM_HPP
+#define BDI_RUNTIME_GEMM_HPP
+#include "GemmKernels.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+namespace bdi::runtime {
+class WorkStealingPool;
+}
+namespace bdi::runtime::linalg {
+// --- Matrices ---
+enum class MatrixLayout : uint8_t { ROW_MAJOR, COL_MAJOR };
+// Layout for a ChimeraTensorType layout_hint: "RowMajor" and "Contiguous" are row-major,
+// "ColMajor" is column-major; nullopt for anything else
+std::optional<MatrixLayout> parseLayoutHint(std::string_view hint);
+// Strided view: element (i, j) is data[i * row_stride + j * col_stride]
+template <typename T>
+struct MatrixRef {
+    T* data = nullptr;
+    size_t row_stride = 0;
+    size_t col_stride = 1;
+    static MatrixRef dense(T* data, size_t rows, size_t cols, MatrixLayout layout) {
+        return layout == MatrixLayout::ROW_MAJOR ? MatrixRef{data, cols, 1} : MatrixRef{data, 1, rows};
+    }
+    T& at(size_t i, size_t j) const { return data[i * row_stride + j * col_stride]; }
+};
+// --- GEMM ---
+// C (m x n) = A (m x k) * B (k x n), or C += A * B with 'accumulate'. Defined for float,
+// double and int32_t (products and sums wrap). C must not overlap A or B.
+// Goto-style blocking: B is packed in kc x nc panels (L3), A in mc x kc blocks (L2), and
+// the register-blocked micro-kernel of gemmKernels() runs over mr x nr tiles of C, so any
+// layout or stride is packed into the same contiguous form first. With a pool, problems of
+// at least PARALLEL_MIN_WORK multiply-adds are split into disjoint tiles of C that run on
+// the pool while the calling thread helps; results do not depend on the split. Pack
+// buffers are per thread and reused. If a tile throws, the first exception is rethrown
+// once every tile has finished.
+constexpr uint64_t PARALLEL_MIN_WORK = uint64_t{1} << 21;
+template <typename T>
+void gemm(size_t m, size_t n, size_t k, MatrixRef<const T> a, MatrixRef<const T> b, MatrixRef<T> c,
+          bool accumulate = false, WorkStealingPool* pool = nullptr);
+// Same, with a given kernel table (tests, benchmarks)
+template <typename T>
+void gemm(const GemmKernels& kernels, size_t m, size_t n, size_t k, MatrixRef<const T> a, MatrixRef<const T> b,
+          MatrixRef<T> c, bool accumulate = false, WorkStealingPool* pool = nullptr);
+// Naive triple loop with the same semantics (tests, benchmarks)
+template <typename T>
+void referenceGemm(size_t m, size_t n, size_t k, MatrixRef<const T> a, MatrixRef<const T> b, MatrixRef<T> c,
+                   bool accumulate = false) {
+    using Wide = WrappingType<T>;
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            Wide sum = accumulate ? static_cast<Wide>(c.at(i, j)) : Wide{0};
+            for (size_t p = 0; p < k; ++p) sum += static_cast<Wide>(a.at(i, p)) * static_cast<Wide>(b.at(p, j));
+            c.at(i, j) = static_cast<T>(sum);
+        }
+    }
+}
+} // namespace bdi::runtime::linalg
+#endif // BDI_RUNTIME_GEMM_HPP
@@ -0,0 +1,39 @@
+#include "GemmKernels.hpp"
+#include <initializer_list>
+namespace bdi::runtime::linalg {
+namespace {
+template <typename T, size_t MR, size_t NR>
+void scalarKernel(size_t kc, const T* a, const T* b, T* acc) {
+    using Wide = WrappingType<T>;
+    Wide c[MR * NR] = {};
+    for (size_t p = 0; p < kc; ++p, a += MR, b += NR) {
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < NR; ++j) c[i * NR + j] += static_cast<Wide>(a[i]) * static_cast<Wide>(b[j]);
+        }
+    }
+    for (size_t i = 0; i < MR * NR; ++i) acc[i] = static_cast<T>(c[i]);
+}
+constexpr GemmKernels kScalar{
+    SimdLevel::SCALAR,
+    {4, 4, scalarKernel<float, 4, 4>},
+    {4, 4, scalarKernel<double, 4, 4>},
+    {4, 4, scalarKernel<int32_t, 4, 4>}};
+}
+const GemmKernels* gemmKernelsFor(SimdLevel level) {
+    if (!simd::vectorKernelsFor(level)) return nullptr; // Build and CPU checks
+#if defined(__x86_64__) || defined(__i386__)
+    if (level == SimdLevel::AVX2 && !__builtin_cpu_supports("fma")) return nullptr; // AVX-512F implies FMA
+#endif
+    if (level == SimdLevel::SCALAR) return &kScalar;
+    return level == SimdLevel::NEON ? detail::neonGemmKernels() : detail::x86GemmKernels(level);
+}
+const GemmKernels& gemmKernels() {
+    static const GemmKernels& selected = []() -> const GemmKernels& {
+        for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42, SimdLevel::NEON}) {
+            if (const GemmKernels* kernels = gemmKernelsFor(level)) return *kernels;
+        }
+        return kScalar;
+    }();
+    return selected;
+}
+} // namespace bdi::runtime::linalg
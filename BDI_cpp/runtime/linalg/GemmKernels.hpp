@@ -0,0 +1,44 @@
+#ifndef BDI_RUNTIME_GEMMKERNELS_HPP
+#define BDI_RUNTIME_GEMMKERNELS_HPP
+#include "VectorKernels.hpp"
+#include <cstddef>
+#include <cstdint>
+namespace bdi::runtime::linalg {
+using simd::SimdLevel;
+// --- Micro-Kernels ---
+// Register-blocked inner loop of the GEMM: acc (mr x nr, row-major, overwritten) = the
+// product of a packed mr x kc sliver of A (kc groups of mr values, column by column) and a
+// packed kc x nr sliver of B (kc groups of nr values, row by row). The whole accumulator
+// tile lives in vector registers; int32 products wrap.
+// Type int32 products and sums are computed in, so they wrap instead of overflowing
+template <typename T>
+struct Wrapping { using type = T; };
+template <>
+struct Wrapping<int32_t> { using type = uint32_t; };
+template <typename T>
+using WrappingType = typename Wrapping<T>::type;
+template <typename T>
+using MicroKernel = void (*)(size_t kc, const T* a, const T* b, T* acc);
+template <typename T>
+struct GemmKernel {
+    size_t mr = 0;
+    size_t nr = 0;
+    MicroKernel<T> run = nullptr;
+};
+struct GemmKernels {
+    SimdLevel level = SimdLevel::SCALAR;
+    GemmKernel<float> f32;
+    GemmKernel<double> f64;
+    GemmKernel<int32_t> i32;
+};
+// The best table this CPU supports, detected once
+const GemmKernels& gemmKernels();
+// A given level's table, or nullptr if this build or CPU cannot run it (tests, benchmarks)
+const GemmKernels* gemmKernelsFor(SimdLevel level);
+namespace detail {
+// Per-architecture tables, without CPU checks; nullptr when built for another architecture
+const GemmKernels* x86GemmKernels(SimdLevel level);
+const GemmKernels* neonGemmKernels();
+}
+} // namespace bdi::runtime::linalg
+#endif // BDI_RUNTIME_GEMMKERNELS_HPP
@@ -0,0 +1,40 @@
+#include "GemmKernels.hpp"
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+namespace bdi::runtime::linalg::detail {
+#if defined(__aarch64__)
+namespace {
+// Same 6 x (2 registers) shape as the x86 kernels; NEON is baseline, so no target attribute
+#define BDI_NEON_GEMM_KERNEL(NAME, T, VEC, LANES, LOAD, STORE, SET1, MADD)       \
+    void NAME(size_t kc, const T* a, const T* b, T* acc) {                       \
+        constexpr size_t NR = 2 * (LANES);                                      \
+        VEC c[6][2];                                                             \
+        _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) c[i][0] = c[i][1] = SET1(0); \
+        for (size_t p = 0; p < kc; ++p, a += 6, b += NR) {                       \
+            const VEC b0 = LOAD(b);                                              \
+            const VEC b1 = LOAD(b + (LANES));                                    \
+            _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) {             \
+                const VEC ai = SET1(a[i]);                                       \
+                c[i][0] = MADD(ai, b0, c[i][0]);                                 \
+                c[i][1] = MADD(ai, b1, c[i][1]);                                 \
+            }                                                                    \
+        }                                                                        \
+        _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) {                 \
+            STORE(acc + i * NR, c[i][0]);                                        \
+            STORE(acc + i * NR + (LANES), c[i][1]);                              \
+        }                                                                        \
+    }
+inline float32x4_t maddF32(float32x4_t a, float32x4_t b, float32x4_t c) { return vfmaq_f32(c, a, b); }
+inline float64x2_t maddF64(float64x2_t a, float64x2_t b, float64x2_t c) { return vfmaq_f64(c, a, b); }
+inline int32x4_t maddI32(int32x4_t a, int32x4_t b, int32x4_t c) { return vmlaq_s32(c, a, b); }
+BDI_NEON_GEMM_KERNEL(gemmF32Neon, float, float32x4_t, 4, vld1q_f32, vst1q_f32, vdupq_n_f32, maddF32)
+BDI_NEON_GEMM_KERNEL(gemmF64Neon, double, float64x2_t, 2, vld1q_f64, vst1q_f64, vdupq_n_f64, maddF64)
+BDI_NEON_GEMM_KERNEL(gemmI32Neon, int32_t, int32x4_t, 4, vld1q_s32, vst1q_s32, vdupq_n_s32, maddI32)
+constexpr GemmKernels kNeon{SimdLevel::NEON, {6, 8, gemmF32Neon}, {6, 4, gemmF64Neon}, {6, 8, gemmI32Neon}};
+}
+const GemmKernels* neonGemmKernels() { return &kNeon; }
+#else
+const GemmKernels* neonGemmKernels() { return nullptr; }
+#endif
+} // namespace bdi::runtime::linalg::detail
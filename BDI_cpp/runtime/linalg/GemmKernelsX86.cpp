@@ -0,0 +1,76 @@
+#include "GemmKernels.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+namespace bdi::runtime::linalg::detail {
+#if defined(__x86_64__) || defined(__i386__)
+namespace {
+// 6 x (2 registers) micro-kernels: 12 accumulators, two loaded B vectors and one broadcast A
+// value fit the 16 registers of SSE/AVX2, so nothing spills. Compiled for their instruction
+// set through target attributes like the VEC_* kernels, and selected at runtime.
+#define BDI_GEMM_KERNEL(NAME, TARGET, T, VEC, LANES, ZERO, LOAD, STORE, SET1, MADD)   \
+    __attribute__((target(TARGET))) void NAME(size_t kc, const T* a, const T* b, T* acc) { \
+        constexpr size_t NR = 2 * (LANES);                                              \
+        VEC c[6][2];                                                                     \
+        _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) c[i][0] = c[i][1] = ZERO(); \
+        for (size_t p = 0; p < kc; ++p, a += 6, b += NR) {                               \
+            const VEC b0 = LOAD(b);                                                      \
+            const VEC b1 = LOAD(b + (LANES));                                            \
+            _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) {                     \
+                const VEC ai = SET1(a[i]);                                               \
+                c[i][0] = MADD(ai, b0, c[i][0]);                                         \
+                c[i][1] = MADD(ai, b1, c[i][1]);                                         \
+            }                                                                            \
+        }                                                                                \
+        _Pragma("GCC unroll 6") for (size_t i = 0; i < 6; ++i) {                         \
+            STORE(acc + i * NR, c[i][0]);                                                \
+            STORE(acc + i * NR + (LANES), c[i][1]);                                      \
+        }                                                                                \
+    }
+// --- SSE4.2 (no FMA: multiply, then add) ---
+#define BDI_SSE __attribute__((target("sse4.2")))
+BDI_SSE inline __m128 maddF32Sse(__m128 a, __m128 b, __m128 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+BDI_SSE inline __m128d maddF64Sse(__m128d a, __m128d b, __m128d c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+BDI_SSE inline __m128i maddI32Sse(__m128i a, __m128i b, __m128i c) { return _mm_add_epi32(_mm_mullo_epi32(a, b), c); }
+BDI_SSE inline __m128i loadI32Sse(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+BDI_SSE inline void storeI32Sse(int32_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+BDI_GEMM_KERNEL(gemmF32Sse, "sse4.2", float, __m128, 4, _mm_setzero_ps, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, maddF32Sse)
+BDI_GEMM_KERNEL(gemmF64Sse, "sse4.2", double, __m128d, 2, _mm_setzero_pd, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, maddF64Sse)
+BDI_GEMM_KERNEL(gemmI32Sse, "sse4.2", int32_t, __m128i, 4, _mm_setzero_si128, loadI32Sse, storeI32Sse, _mm_set1_epi32, maddI32Sse)
+// --- AVX2 + FMA ---
+#define BDI_AVX2 __attribute__((target("avx2,fma")))
+BDI_AVX2 inline __m256 maddF32Avx2(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+BDI_AVX2 inline __m256d maddF64Avx2(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+BDI_AVX2 inline __m256i maddI32Avx2(__m256i a, __m256i b, __m256i c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+BDI_AVX2 inline __m256i loadI32Avx2(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+BDI_AVX2 inline void storeI32Avx2(int32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+BDI_GEMM_KERNEL(gemmF32Avx2, "avx2,fma", float, __m256, 8, _mm256_setzero_ps, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, maddF32Avx2)
+BDI_GEMM_KERNEL(gemmF64Avx2, "avx2,fma", double, __m256d, 4, _mm256_setzero_pd, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, maddF64Avx2)
+BDI_GEMM_KERNEL(gemmI32Avx2, "avx2,fma", int32_t, __m256i, 8, _mm256_setzero_si256, loadI32Avx2, storeI32Avx2, _mm256_set1_epi32, maddI32Avx2)
+// --- AVX-512 ---
+#define BDI_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq")))
+BDI_AVX512 inline __m512 maddF32Avx512(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+BDI_AVX512 inline __m512d maddF64Avx512(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+BDI_AVX512 inline __m512i maddI32Avx512(__m512i a, __m512i b, __m512i c) { return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c); }
+BDI_AVX512 inline __m512i loadI32Avx512(const int32_t* p) { return _mm512_loadu_si512(p); }
+BDI_AVX512 inline void storeI32Avx512(int32_t* p, __m512i v) { _mm512_storeu_si512(p, v); }
+BDI_GEMM_KERNEL(gemmF32Avx512, "avx512f,avx512bw,avx512dq", float, __m512, 16, _mm512_setzero_ps, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, maddF32Avx512)
+BDI_GEMM_KERNEL(gemmF64Avx512, "avx512f,avx512bw,avx512dq", double, __m512d, 8, _mm512_setzero_pd, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, maddF64Avx512)
+BDI_GEMM_KERNEL(gemmI32Avx512, "avx512f,avx512bw,avx512dq", int32_t, __m512i, 16, _mm512_setzero_si512, loadI32Avx512, storeI32Avx512, _mm512_set1_epi32, maddI32Avx512)
+// --- Tables (mr x nr) ---
+constexpr GemmKernels kSse42{SimdLevel::SSE42, {6, 8, gemmF32Sse}, {6, 4, gemmF64Sse}, {6, 8, gemmI32Sse}};
+constexpr GemmKernels kAvx2{SimdLevel::AVX2, {6, 16, gemmF32Avx2}, {6, 8, gemmF64Avx2}, {6, 16, gemmI32Avx2}};
+constexpr GemmKernels kAvx512{SimdLevel::AVX512, {6, 32, gemmF32Avx512}, {6, 16, gemmF64Avx512}, {6, 32, gemmI32Avx512}};
+}
+const GemmKernels* x86GemmKernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE42: return &kSse42;
+        case SimdLevel::AVX2: return &kAvx2;
+        case SimdLevel::AVX512: return &kAvx512;
+        default: return nullptr;
+    }
+}
+#else
+const GemmKernels* x86GemmKernels(SimdLevel) { return nullptr; }
+#endif
+} // namespace bdi::runtime::linalg::detail
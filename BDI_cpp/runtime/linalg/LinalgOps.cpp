@@ -0,0 +1,81 @@
+#include "LinalgOps.hpp"
+#include "MemoryManager.hpp"
+#include "WorkStealingPool.hpp"
+#include "BDITypes.hpp"
+namespace bdi::runtime::linalg {
+namespace {
+constexpr uint32_t kColMajorA = 1u << 8;
+constexpr uint32_t kColMajorB = 1u << 9;
+constexpr uint32_t kColMajorC = 1u << 10;
+constexpr uint32_t kAccumulate = 1u << 11;
+MatrixLayout layoutBit(uint32_t encoded, uint32_t bit) { return encoded & bit ? MatrixLayout::COL_MAJOR : MatrixLayout::ROW_MAJOR; }
+}
+uint32_t encodeMatmul(const MatmulSpec& spec) {
+    uint32_t encoded = static_cast<uint8_t>(spec.element_type);
+    if (spec.a_layout == MatrixLayout::COL_MAJOR) encoded |= kColMajorA;
+    if (spec.b_layout == MatrixLayout::COL_MAJOR) encoded |= kColMajorB;
+    if (spec.c_layout == MatrixLayout::COL_MAJOR) encoded |= kColMajorC;
+    if (spec.accumulate) encoded |= kAccumulate;
+    return encoded;
+}
+std::optional<MatmulSpec> decodeMatmul(uint32_t encoded) {
+    if (encoded >> 12) return std::nullopt;
+    MatmulSpec spec;
+    spec.element_type = static_cast<BDIType>(encoded & 0xFF);
+    if (spec.element_type != BDIType::FLOAT32 && spec.element_type != BDIType::FLOAT64 && spec.element_type != BDIType::INT32) return std::nullopt;
+    spec.a_layout = layoutBit(encoded, kColMajorA);
+    spec.b_layout = layoutBit(encoded, kColMajorB);
+    spec.c_layout = layoutBit(encoded, kColMajorC);
+    spec.accumulate = encoded & kAccumulate;
+    return spec;
+}
+} // namespace bdi::runtime::linalg
+namespace bdi::runtime::vm_ops {
+namespace {
+struct Extent {
+    uint64_t address = 0;
+    uint64_t bytes = 0;
+    bool overlaps(const Extent& other) const { return address < other.address + other.bytes && other.address < address + bytes; }
+};
+// Byte range of a rows x cols matrix, checked against the memory's bounds and alignment
+VMStatus checkMatrix(const MemoryManager& memory, uint64_t address, uint64_t rows, uint64_t cols, size_t element_size, Extent& extent) {
+    uint64_t elements = 0;
+    if (__builtin_mul_overflow(rows, cols, &elements) || __builtin_mul_overflow(elements, element_size, &extent.bytes)) return VMStatus::OUT_OF_RANGE;
+    extent.address = address;
+    if (address > memory.getTotalSize() || extent.bytes > memory.getTotalSize() - address) return VMStatus::MEMORY_FAULT;
+    if (reinterpret_cast<uintptr_t>(memory.getRawPointer(address)) % element_size != 0) return VMStatus::MEMORY_FAULT;
+    return VMStatus::OK;
+}
+template <typename T>
+void run(MemoryManager& memory, const linalg::MatmulSpec& spec, uint64_t a, uint64_t b, uint64_t c, size_t m, size_t k, size_t n) {
+    using linalg::MatrixRef;
+    const auto* a_data = reinterpret_cast<const T*>(memory.getRawPointer(a));
+    const auto* b_data = reinterpret_cast<const T*>(memory.getRawPointer(b));
+    auto* c_data = reinterpret_cast<T*>(memory.getRawPointer(c));
+    WorkStealingPool* pool = static_cast<uint64_t>(m) * n * k >= linalg::PARALLEL_MIN_WORK ? &computePool() : nullptr;
+    linalg::gemm<T>(m, n, k, MatrixRef<const T>::dense(a_data, m, k, spec.a_layout),
+                    MatrixRef<const T>::dense(b_data, k, n, spec.b_layout),
+                    MatrixRef<T>::dense(c_data, m, n, spec.c_layout), spec.accumulate, pool);
+}
+}
+VMStatus tryMatmul(MemoryManager* memory, const linalg::MatmulSpec& spec, uint64_t a, uint64_t b, uint64_t c,
+                   uint64_t m, uint64_t k, uint64_t n) {
+    if (!memory) return VMStatus::NO_MEMORY_MANAGER;
+    const size_t element_size = core::types::getBdiTypeSize(spec.element_type);
+    Extent a_extent, b_extent, c_extent;
+    for (VMStatus status : {checkMatrix(*memory, a, m, k, element_size, a_extent), checkMatrix(*memory, b, k, n, element_size, b_extent),
+                            checkMatrix(*memory, c, m, n, element_size, c_extent)}) {
+        if (status != VMStatus::OK) return status;
+    }
+    if (c_extent.overlaps(a_extent) || c_extent.overlaps(b_extent)) return VMStatus::MEMORY_FAULT;
+    if (c_extent.bytes == 0) return VMStatus::OK;
+    switch (spec.element_type) {
+        case BDIType::FLOAT32: run<float>(*memory, spec, a, b, c, m, k, n); break;
+        case BDIType::FLOAT64: run<double>(*memory, spec, a, b, c, m, k, n); break;
+        case BDIType::INT32: run<int32_t>(*memory, spec, a, b, c, m, k, n); break;
+        default: return VMStatus::TYPE_MISMATCH;
+    }
+    memory->markDirty(c, c_extent.bytes);
+    return VMStatus::OK;
+}
+} // namespace bdi::runtime::vm_ops
@@ -0,0 +1,33 @@
+#ifndef BDI_RUNTIME_LINALGOPS_HPP
+#define BDI_RUNTIME_LINALGOPS_HPP
+#include "Gemm.hpp"
+#include "VMStatus.hpp"
+#include <cstdint>
+#include <optional>
+namespace bdi::runtime {
+class MemoryManager;
+}
+namespace bdi::runtime::linalg {
+// --- LINALG_MATMUL Payload ---
+// Element type in bits 0-7, then one layout bit each for A, B and C (set: column-major)
+// and the accumulate bit. A ChimeraTensorType lowers to this as its element_type and
+// parseLayoutHint(layout_hint); its shape supplies the m, k and n inputs.
+struct MatmulSpec {
+    BDIType element_type = BDIType::FLOAT32; // FLOAT32, FLOAT64 or INT32
+    MatrixLayout a_layout = MatrixLayout::ROW_MAJOR;
+    MatrixLayout b_layout = MatrixLayout::ROW_MAJOR;
+    MatrixLayout c_layout = MatrixLayout::ROW_MAJOR;
+    bool accumulate = false; // C += A * B
+};
+uint32_t encodeMatmul(const MatmulSpec& spec);
+std::optional<MatmulSpec> decodeMatmul(uint32_t encoded); // nullopt for unknown bits or element types
+} // namespace bdi::runtime::linalg
+namespace bdi::runtime::vm_ops {
+// LINALG_MATMUL: C (m x n) = A (m x k) * B (k x n) on dense matrices in the memory, read
+// and written in place through the backing store; the pages of C are marked dirty.
+// MEMORY_FAULT if a matrix is out of bounds or not aligned to its element size, or if C
+// overlaps A or B; OUT_OF_RANGE if a matrix's byte size overflows.
+VMStatus tryMatmul(MemoryManager* memory, const linalg::MatmulSpec& spec, uint64_t a, uint64_t b, uint64_t c,
+                   uint64_t m, uint64_t k, uint64_t n);
+} // namespace bdi::runtime::vm_ops
+#endif // BDI_RUNTIME_LINALGOPS_HPP
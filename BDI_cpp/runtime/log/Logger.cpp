@@ -0,0 +1,207 @@
+#include "Logger.hpp"
+#include <cstdio>
+#include <iostream>
+#include <limits>
+namespace bdi::runtime {
+namespace {
+std::atomic<uint64_t> next_logger_id{1};
+// Last buffer used by this thread; shared_ptr so a cached buffer outlives its Logger safely
+struct LocalBufferCache {
+    uint64_t logger_id = 0;
+    std::shared_ptr<LogBuffer> buffer;
+};
+thread_local LocalBufferCache tls_buffer;
+// Appends to a std::string that keeps its capacity between lines
+class StringBuf : public std::streambuf {
+public:
+    explicit StringBuf(std::string& out) : out_(out) {}
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) out_.push_back(static_cast<char>(c));
+        return c;
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        out_.append(s, static_cast<size_t>(n));
+        return n;
+    }
+private:
+    std::string& out_;
+};
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+}
+struct LogScratch {
+    std::string text;
+    StringBuf buf{text};
+    std::ostream stream{&buf};
+    bool busy = false;
+};
+namespace {
+thread_local LogScratch tls_scratch;
+}
+const char* toString(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::OFF: return "OFF";
+    }
+    return "?";
+}
+const char* toString(LogCategory category) {
+    switch (category) {
+        case LogCategory::GENERAL: return "general";
+        case LogCategory::MEMORY: return "memory";
+        case LogCategory::OPTIMIZER: return "optimizer";
+        case LogCategory::VM: return "vm";
+        case LogCategory::SCHEDULER: return "scheduler";
+        case LogCategory::BACKEND: return "backend";
+        case LogCategory::COUNT: break;
+    }
+    return "?";
+}
+// --- LogBuffer ---
+bool LogBuffer::push(uint64_t timestamp_ns, LogLevel level, LogCategory category, std::string_view message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (text_.size() + message.size() > capacity_ || text_.size() + message.size() > std::numeric_limits<uint32_t>::max()) {
+        ++dropped_;
+        return false;
+    }
+    headers_.push_back({timestamp_ns, level, category, static_cast<uint32_t>(text_.size()), static_cast<uint32_t>(message.size())});
+    text_.append(message);
+    return true;
+}
+void LogBuffer::swapOut(std::vector<Header>& headers, std::string& text) {
+    headers.clear();
+    text.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    headers_.swap(headers);
+    text_.swap(text);
+}
+uint64_t LogBuffer::takeDroppedCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t dropped = dropped_;
+    dropped_ = 0;
+    return dropped;
+}
+// --- Logger ---
+Logger::Logger(size_t buffer_capacity, std::chrono::milliseconds period)
+    : id_(next_logger_id.fetch_add(1)), buffer_capacity_(buffer_capacity) {
+    for (auto& level : levels_) level.store(static_cast<uint8_t>(LogLevel::INFO), std::memory_order_relaxed);
+    drainer_ = std::thread([this, period] {
+        bool stopping = false;
+        while (!stopping) {
+            {
+                std::unique_lock<std::mutex> lock(drainer_mutex_);
+                drainer_cv_.wait_for(lock, period, [this] { return drainer_stop_ || drainer_wake_; });
+                stopping = drainer_stop_;
+                drainer_wake_ = false;
+            }
+            flush();
+        }
+    });
+}
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(drainer_mutex_);
+        drainer_stop_ = true;
+    }
+    drainer_cv_.notify_all();
+    drainer_.join(); // Its last pass drains everything written before the stop
+}
+Logger& Logger::global() {
+    static Logger logger;
+    return logger;
+}
+void Logger::setLevel(LogLevel level) {
+    for (auto& category_level : levels_) category_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+void Logger::setLevel(LogCategory category, LogLevel level) {
+    levels_[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+void Logger::setSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    sink_ = std::move(sink);
+}
+LogBuffer& Logger::localBuffer() {
+    if (tls_buffer.logger_id == id_) return *tls_buffer.buffer;
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    auto& buffer = buffers_[std::this_thread::get_id()];
+    if (!buffer) buffer = std::make_shared<LogBuffer>(buffer_capacity_, static_cast<uint16_t>(buffers_.size() - 1));
+    tls_buffer.logger_id = id_;
+    tls_buffer.buffer = buffer;
+    return *buffer;
+}
+void Logger::write(LogLevel level, LogCategory category, std::string_view message) {
+    localBuffer().push(nowNs(), level, category, message);
+    if (level >= LogLevel::ERROR) {
+        {
+            std::lock_guard<std::mutex> lock(drainer_mutex_);
+            drainer_wake_ = true;
+        }
+        drainer_cv_.notify_one();
+    }
+}
+void Logger::flush() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+    std::vector<std::shared_ptr<LogBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers.reserve(buffers_.size());
+        for (const auto& [thread, buffer] : buffers_) buffers.push_back(buffer);
+    }
+    bool wrote = false;
+    for (const auto& buffer : buffers) {
+        buffer->swapOut(headers_, text_);
+        for (const auto& header : headers_) {
+            LogRecord record{header.timestamp_ns, header.level, header.category, buffer->getThreadIndex(),
+                             std::string_view(text_).substr(header.offset, header.length)};
+            if (sink_) sink_(record);
+            else writeToStream(std::cerr, record);
+            wrote = true;
+        }
+        if (uint64_t dropped = buffer->takeDroppedCount()) {
+            dropped_.fetch_add(dropped);
+            std::string note = std::to_string(dropped) + " line(s) dropped, log buffer full";
+            LogRecord record{nowNs(), LogLevel::WARN, LogCategory::GENERAL, buffer->getThreadIndex(), note};
+            if (sink_) sink_(record);
+            else writeToStream(std::cerr, record);
+            wrote = true;
+        }
+    }
+    if (wrote && !sink_) std::cerr.flush(); // One flush per batch, not per line
+}
+void Logger::writeToStream(std::ostream& out, const LogRecord& record) {
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "[%10.6f] %-5s %-9s t%u ", static_cast<double>(record.timestamp_ns) / 1e9,
+                  toString(record.level), toString(record.category), static_cast<unsigned>(record.thread_index));
+    out << prefix << record.message << '\n';
+}
+// --- LogLine ---
+LogLine::LogLine(Logger& logger, LogLevel level, LogCategory category)
+    : logger_(logger), level_(level), category_(category), scratch_(&tls_scratch) {
+    if (scratch_->busy) {
+        owned_ = std::make_unique<LogScratch>();
+        scratch_ = owned_.get();
+    }
+    scratch_->busy = true;
+    scratch_->text.clear();
+    // Reset whatever the previous line left on the reused stream (std::hex, precision, ...)
+    scratch_->stream.clear();
+    scratch_->stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    scratch_->stream.precision(6);
+    scratch_->stream.width(0);
+    scratch_->stream.fill(' ');
+}
+LogLine::~LogLine() {
+    logger_.write(level_, category_, scratch_->text);
+    scratch_->busy = false;
+}
+std::ostream& LogLine::stream() {
+    return scratch_->stream;
+}
+} // namespace bdi::runtime
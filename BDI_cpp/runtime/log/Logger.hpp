@@ -0,0 +1,171 @@
+#ifndef BDI_RUNTIME_LOGGER_HPP
+#define BDI_RUNTIME_LOGGER_HPP
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+// Lowest level compiled in; BDI_LOG_* calls below it expand to nothing (arguments are
+// not evaluated). Set by the BDI_LOG_LEVEL CMake cache variable.
+#define BDI_LOG_LEVEL_TRACE 0
+#define BDI_LOG_LEVEL_DEBUG 1
+#define BDI_LOG_LEVEL_INFO 2
+#define BDI_LOG_LEVEL_WARN 3
+#define BDI_LOG_LEVEL_ERROR 4
+#define BDI_LOG_LEVEL_OFF 5
+#ifndef BDI_LOG_LEVEL
+#define BDI_LOG_LEVEL BDI_LOG_LEVEL_INFO
+#endif
+namespace bdi::runtime {
+enum class LogLevel : uint8_t { TRACE, DEBUG, INFO, WARN, ERROR, OFF };
+enum class LogCategory : uint8_t { GENERAL, MEMORY, OPTIMIZER, VM, SCHEDULER, BACKEND, COUNT };
+const char* toString(LogLevel level);
+const char* toString(LogCategory category);
+// --- Log Record ---
+// What a sink receives. 'message' is only valid during the sink call.
+struct LogRecord {
+    uint64_t timestamp_ns; // Steady clock, when the line was formatted
+    LogLevel level;
+    LogCategory category;
+    uint16_t thread_index; // Dense per-Logger thread number
+    std::string_view message;
+};
+// --- Per-thread Buffer ---
+// Formatted lines of one thread waiting for the drainer. The mutex is only contended
+// while the drainer swaps the buffer out; lines past the byte capacity are dropped and counted.
+class LogBuffer {
+public:
+    struct Header {
+        uint64_t timestamp_ns;
+        LogLevel level;
+        LogCategory category;
+        uint32_t offset; // Into text
+        uint32_t length;
+    };
+    LogBuffer(size_t capacity, uint16_t thread_index) : capacity_(capacity), thread_index_(thread_index) {}
+    bool push(uint64_t timestamp_ns, LogLevel level, LogCategory category, std::string_view message);
+    // Swaps the pending lines into the (cleared) arguments so both sides keep their capacity
+    void swapOut(std::vector<Header>& headers, std::string& text);
+    uint64_t takeDroppedCount();
+    uint16_t getThreadIndex() const { return thread_index_; }
+private:
+    size_t capacity_;
+    uint16_t thread_index_;
+    std::mutex mutex_;
+    std::vector<Header> headers_;
+    std::string text_;
+    uint64_t dropped_ = 0;
+};
+// --- Logger ---
+// Leveled, categorized logging off the hot path: the BDI_LOG_* macros check the level
+// with one relaxed load, format into a reused thread-local buffer, and append the line
+// to the thread's LogBuffer. A background drainer hands batches to the sink (stderr by
+// default), so callers never block on I/O. ERROR lines wake the drainer immediately;
+// flush() drains synchronously, e.g. before inspecting captured output or exiting.
+class Logger {
+public:
+    using Sink = std::function<void(const LogRecord&)>;
+    static constexpr size_t DEFAULT_BUFFER_CAPACITY = 1 << 16; // Bytes of text per thread
+    explicit Logger(size_t buffer_capacity = DEFAULT_BUFFER_CAPACITY,
+                    std::chrono::milliseconds period = std::chrono::milliseconds(20));
+    ~Logger(); // Final drain
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    static Logger& global(); // Used by the BDI_LOG_* macros
+    bool isEnabled(LogLevel level, LogCategory category) const noexcept {
+        return static_cast<uint8_t>(level) >= levels_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel level); // All categories
+    void setLevel(LogCategory category, LogLevel level);
+    LogLevel getLevel(LogCategory category) const {
+        return static_cast<LogLevel>(levels_[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+    }
+    // nullptr restores the stderr sink. Called from the drainer (or flush()), one record at a time.
+    void setSink(Sink sink);
+    void write(LogLevel level, LogCategory category, std::string_view message);
+    void flush();
+    uint64_t getDroppedCount() const { return dropped_.load(); }
+    static void writeToStream(std::ostream& out, const LogRecord& record);
+private:
+    const uint64_t id_; // Distinguishes loggers in the thread-local buffer cache
+    size_t buffer_capacity_;
+    std::array<std::atomic<uint8_t>, static_cast<size_t>(LogCategory::COUNT)> levels_;
+    mutable std::mutex buffers_mutex_;
+    std::unordered_map<std::thread::id, std::shared_ptr<LogBuffer>> buffers_;
+    std::mutex drain_mutex_; // Serializes drains and guards sink_
+    Sink sink_;
+    std::vector<LogBuffer::Header> headers_; // Drain scratch
+    std::string text_;
+    std::atomic<uint64_t> dropped_{0};
+    std::thread drainer_;
+    std::mutex drainer_mutex_;
+    std::condition_variable drainer_cv_;
+    bool drainer_stop_ = false;
+    bool drainer_wake_ = false;
+    LogBuffer& localBuffer();
+};
+struct LogScratch;
+// Formats one line into the calling thread's scratch buffer and writes it on destruction
+class LogLine {
+public:
+    LogLine(Logger& logger, LogLevel level, LogCategory category);
+    ~LogLine();
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+    std::ostream& stream();
+private:
+    Logger& logger_;
+    LogLevel level_;
+    LogCategory category_;
+    LogScratch* scratch_;
+    std::unique_ptr<LogScratch> owned_; // Only when the message expression itself logs
+};
+} // namespace bdi::runtime
+// --- Macros ---
+// BDI_LOG_WARN(MEMORY, "Region " << id << " is gone"): the message is a stream expression,
+// evaluated only if the level is compiled in and enabled for the category.
+#define BDI_LOG_AT(level, category, message)                                                          \
+    do {                                                                                              \
+        ::bdi::runtime::Logger& bdi_logger_ = ::bdi::runtime::Logger::global();                       \
+        if (bdi_logger_.isEnabled(::bdi::runtime::LogLevel::level, ::bdi::runtime::LogCategory::category)) { \
+            ::bdi::runtime::LogLine bdi_line_(bdi_logger_, ::bdi::runtime::LogLevel::level,           \
+                                              ::bdi::runtime::LogCategory::category);                 \
+            bdi_line_.stream() << message;                                                            \
+        }                                                                                             \
+    } while (0)
+#define BDI_LOG_DISABLED() do {} while (0)
+#if BDI_LOG_LEVEL <= BDI_LOG_LEVEL_TRACE
+#define BDI_LOG_TRACE(category, message) BDI_LOG_AT(TRACE, category, message)
+#else
+#define BDI_LOG_TRACE(category, message) BDI_LOG_DISABLED()
+#endif
+#if BDI_LOG_LEVEL <= BDI_LOG_LEVEL_DEBUG
+#define BDI_LOG_DEBUG(category, message) BDI_LOG_AT(DEBUG, category, message)
+#else
+#define BDI_LOG_DEBUG(category, message) BDI_LOG_DISABLED()
+#endif
+#if BDI_LOG_LEVEL <= BDI_LOG_LEVEL_INFO
+#define BDI_LOG_INFO(category, message) BDI_LOG_AT(INFO, category, message)
+#else
+#define BDI_LOG_INFO(category, message) BDI_LOG_DISABLED()
+#endif
+#if BDI_LOG_LEVEL <= BDI_LOG_LEVEL_WARN
+#define BDI_LOG_WARN(category, message) BDI_LOG_AT(WARN, category, message)
+#else
+#define BDI_LOG_WARN(category, message) BDI_LOG_DISABLED()
+#endif
+#if BDI_LOG_LEVEL <= BDI_LOG_LEVEL_ERROR
+#define BDI_LOG_ERROR(category, message) BDI_LOG_AT(ERROR, category, message)
+#else
+#define BDI_LOG_ERROR(category, message) BDI_LOG_DISABLED()
+#endif
+#endif // BDI_RUNTIME_LOGGER_HPP
@@ -1,16 +1,65 @@
  #include "MemoryManager.hpp"
+ #include "Logger.hpp"
  #include <stdexcept> // For invalid_argument
  #include <cstring> // For memcpy
- #include <iostream> // For debug/warnings
- #include <algorithm> // For std::find_if, std::sort (if list not kept sorted)
+ #include <algorithm> // For std::find_if, std::lower_bound
+ #include <atomic> // For std::atomic_ref
+ #include <bit> // For std::countr_zero
+ #include <cstdlib> // For calloc
+ #if defined(__unix__) || defined(__APPLE__)
+ #include <sys/mman.h>
+ #define BDI_HAVE_MMAP 1
+ #endif
  namespace bdi::runtime {
+ // --- MemoryBlock --
+ MemoryBlock::MemoryBlock(size_t size_bytes) : size_(size_bytes) {
+    if (size_ == 0) return;
+    // calloc of a large block is served by fresh zero pages, so untouched memory costs nothing
+    data_ = static_cast<std::byte*>(std::calloc(size_, 1));
+    if (!data_) throw std::bad_alloc();
+ }
+ MemoryBlock::~MemoryBlock() { release(); }
+ void MemoryBlock::release() {
+ #ifdef BDI_HAVE_MMAP
+    if (mapped_) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+        mapped_ = false;
+        return;
+    }
+ #endif
+    std::free(data_);
+    data_ = nullptr;
+ }
+ bool MemoryBlock::mapFile(int fd, uint64_t offset) {
+ #ifdef BDI_HAVE_MMAP
+    if (size_ == 0) return false;
+    void* mapping = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+    if (mapping == MAP_FAILED) {
+        BDI_LOG_ERROR(MEMORY, "Cannot map memory image (offset " << offset << ", " << size_ << " bytes)");
+        return false;
+    }
+    release();
+    data_ = static_cast<std::byte*>(mapping);
+    mapped_ = true;
+    return true;
+ #else
+    (void)fd; (void)offset;
+    return false; // Callers fall back to reading the image
+ #endif
+ }
+ // --- MemoryManager --
  MemoryManager::MemoryManager(size_t total_memory_bytes)
     : memory_block_(total_memory_bytes), next_region_id_(1), next_allocation_offset_(0)
  {
-    if (total_memory_bytes == 0) { /* ... error ... */ }
-    initializeFreeList();
+    if (total_memory_bytes == 0) {
         throw std::invalid_argument("MemoryManager size cannot be zero.");
-    std::cout << "MemoryManager: Initialized with " << total_memory_bytes << " bytes." << std::endl;
+    }
+    const size_t dirty_words = (getPageCount() + 63) / 64;
+    dirty_pages_ = std::make_unique<std::atomic<uint64_t>[]>(dirty_words);
+    for (size_t i = 0; i < dirty_words; ++i) dirty_pages_[i].store(0, std::memory_order_relaxed);
+    initializeFreeList();
+    BDI_LOG_DEBUG(MEMORY, "Initialized with " << total_memory_bytes << " bytes.");
  }
  void MemoryManager::initializeFreeList() {
     free_list_.clear();
@@ -18,84 +67,43 @@
     if (!memory_block_.empty()) {
         free_list_.push_back({0, memory_block_.size()});
     }
-    // allocated_block_sizes_.clear();
  }
+ // --- Allocator (free list, first fit) --
+ // Region bookkeeping is guarded by memory_mutex_: tasks running on different BDIOS
+ // workers allocate and free concurrently. Byte access below is not locked; the
+ // simulated block never moves, and ordering between tasks is the program's concern.
  std::optional<RegionID> MemoryManager::allocateRegion(size_t size_bytes, bool read_only) {
-    // Very simple bump allocator - DOES NOT HANDLE FREEING PROPERLY YET
-    // std::lock_guard<std::mutex> lock(memory_mutex_); // If thread-safe
+    std::lock_guard<std::mutex> lock(memory_mutex_);
     // Find first free block large enough (First Fit)
-     auto it = std::find_if(free_list_.begin(), free_list_.end(),
+    auto it = std::find_if(free_list_.begin(), free_list_.end(),
                            [size_bytes](const FreeBlock& block){ return block.size >= size_bytes; });
-     if (it == free_list_.end()) {
-         std::cerr << "MemoryManager Error: Out of memory (Free List) trying to allocate " << size_bytes << " bytes." << std::endl;
-         return std::nullopt; // No suitable block found
-     }
-     // Allocate from the found block
-     uintptr_t allocated_address = it->address;
-     RegionID new_id = next_region_id_++;
-     // If block is exactly the right size, remove it from free list
-     if (it->size == size_bytes) {
-         free_list_.erase(it);
-     }
-     // If block is larger, resize it and update its address
-     else {
-         it->address += size_bytes;
-         it->size -= size_bytes;
-     }
-     // Record the allocation
-     allocated_regions_.emplace(new_id, MemoryRegion(new_id, allocated_address, size_bytes, read_only));
-     // allocated_block_sizes_[allocated_address] = size_bytes; // Track size for freeing
-     std::cout << "MemoryManager: Allocated Region " << new_id << " (" << size_bytes << " bytes) at address " << allocated_address << " (Free List)." <<
- std::endl;
-     return new_id;
- }
-    if (next_allocation_offset_ + size_bytes > memory_block_.size()) {
-        std::cerr << "MemoryManager Error: Out of memory trying to allocate " << size_bytes << " bytes." << std::endl;
-        return std::nullopt; // Out of memory
+    if (it == free_list_.end()) {
+        BDI_LOG_ERROR(MEMORY, "Out of memory (Free List) trying to allocate " << size_bytes << " bytes.");
+        return std::nullopt; // No suitable block found
     }
+    // Allocate from the found block
+    uintptr_t allocated_address = it->address;
     RegionID new_id = next_region_id_++;
-    uintptr_t base_address = next_allocation_offset_;
-    next_allocation_offset_ += size_bytes;
-    allocated_regions_.emplace(new_id, MemoryRegion(new_id, base_address, size_bytes, read_only));
-    std::cout << "MemoryManager: Allocated Region " << new_id << " (" << size_bytes << " bytes) at address " << base_address << std::endl;
-    return new_id;
- }
- bool MemoryManager::freeRegion(RegionID region_id) {
-    // STUB: Freeing requires a more complex allocator than bump allocation
-    // std::lock_guard<std::mutex> lock(memory_mutex_); // If thread-safe
-auto region it = allocated_regions_.find(region_id);
-    if (region_it = allocated_regions_.end()) {
-        std::cout << "MemoryManager: Freeing Region " << region_id << " (Allocator Stub - No actual free)" << std::endl;
-        // With a real allocator, mark space as free here
-        allocated_regions_.erase(it); // Remove tracking info
-        return true;
-    }
-    std::cerr << "MemoryManager Error: Cannot free non-existent region " << region_id << std::endl;
-    return false;
- }
- std::optional<MemoryRegion> MemoryManager::getRegionInfo(RegionID region_id) const {
-    // std::lock_guard<std::mutex> lock(memory_mutex_); // If thread-safe
-    auto it = allocated_regions_.find(region_id);
-    if (it != allocated_regions_.end()) {
-        return it->second;
+    // If block is exactly the right size, remove it from free list
+    if (it->size == size_bytes) {
+        free_list_.erase(it);
     }
-    return std::nullopt;
- }
- bool MemoryManager::readMemory(uintptr_t address, std::byte* buffer, size_t size_bytes) const {
-    // std::lock_guard<std::mutex> lock(memory_mutex_); // If thread-safe
-    if (address + size_bytes > memory_block_.size()) {
-         std::cerr << "MemoryManager Error: Read access out of bounds (Address: " << address << ", Size: " << size_bytes << ")" << std::endl;
-        return false; // Out of bounds
+    // If block is larger, resize it and update its address
+    else {
+        it->address += size_bytes;
+        it->size -= size_bytes;
     }
-    // TODO: Check if read overlaps with valid allocated regions? (More complex check)
-    std::memcpy(buffer, memory_block_.data() + address, size_bytes);
-    return true;
+    // Record the allocation
+    allocated_regions_.emplace(new_id, MemoryRegion(new_id, allocated_address, size_bytes, read_only));
+    BDI_LOG_DEBUG(MEMORY, "Allocated Region " << new_id << " (" << size_bytes << " bytes) at address " << allocated_address << " (Free List).");
+    return new_id;
  }
- bool MemoryManager::writeMemory(uintptr_t address, const std::byte* buffer, size_t size_bytes) {
-    // std::lock_guard<std::mutex> lock(memory_mutex_); // If thread-safe
-    if (address + size_bytes > memory_block_.size()) {
-        std::cerr << "MemoryManager Error: Write access out of bounds (Address: " << address << ", Size: " << size_bytes << ")" << std::endl;
-        return false; // Out of bounds
+ bool MemoryManager::freeRegion(RegionID region_id) {
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    auto region_it = allocated_regions_.find(region_id);
+    if (region_it == allocated_regions_.end()) {
+        BDI_LOG_ERROR(MEMORY, "Cannot free non-existent region " << region_id);
+        return false;
     }
     uintptr_t address_to_free = region_it->second.base_address;
     size_t size_to_free = region_it->second.size;
@@ -104,13 +112,13 @@ auto region it = allocated_regions_.find(region_id);
     auto insert_pos = std::lower_bound(free_list_.begin(), free_list_.end(),
                                       FreeBlock{address_to_free, 0}); // Find position based on address
     free_list_.insert(insert_pos, {address_to_free, size_to_free});
-    std::cout << "MemoryManager: Freed Region " << region_id << " (" << size_to_free << " bytes) at address " << address_to_free << std::endl;
+    BDI_LOG_DEBUG(MEMORY, "Freed Region " << region_id << " (" << size_to_free << " bytes) at address " << address_to_free);
     // Merge adjacent free blocks
     mergeFreeBlocks();
     return true;
  }
  void MemoryManager::mergeFreeBlocks() {
-    // Assumes free_list_ is sorted by address
+    // Assumes free_list_ is sorted by address (caller holds memory_mutex_)
     if (free_list_.size() < 2) return;
     auto it = free_list_.begin();
     auto next_it = std::next(it);
@@ -129,31 +137,180 @@ auto region it = allocated_regions_.find(region_id);
         }
     }
  }
+ std::optional<MemoryRegion> MemoryManager::getRegionInfo(RegionID region_id) const {
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    auto it = allocated_regions_.find(region_id);
+    if (it != allocated_regions_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+ }
  size_t MemoryManager::getUsedSize() const {
-     // Calculate used size by subtracting total free size from total size
-     size_t free_size = 0;
-     for(const auto& block : free_list_) {
-         free_size += block.size;
-     }
-     return memory_block_.size() - free_size;
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    // Calculate used size by subtracting total free size from total size
+    size_t free_size = 0;
+    for (const auto& block : free_list_) {
+        free_size += block.size;
+    }
+    return memory_block_.size() - free_size;
  }
+ // --- Memory Access --
+ bool MemoryManager::readMemory(uintptr_t address, std::byte* buffer, size_t size_bytes) const {
+    if (address > memory_block_.size() || size_bytes > memory_block_.size() - address) {
+        BDI_LOG_ERROR(MEMORY, "Read access out of bounds (Address: " << address << ", Size: " << size_bytes << ")");
+        return false; // Out of bounds
+    }
+    // TODO: Check if read overlaps with valid allocated regions? (More complex check)
+    std::memcpy(buffer, memory_block_.data() + address, size_bytes);
+    return true;
+ }
+ bool MemoryManager::writeMemory(uintptr_t address, const std::byte* buffer, size_t size_bytes) {
+    if (address > memory_block_.size() || size_bytes > memory_block_.size() - address) {
+        BDI_LOG_ERROR(MEMORY, "Write access out of bounds (Address: " << address << ", Size: " << size_bytes << ")");
+        return false; // Out of bounds
+    }
     // TODO: Check if write overlaps with valid allocated regions?
     // TODO: Check read-only flags of overlapping regions?
     // This simple implementation doesn't check region permissions.
     std::memcpy(memory_block_.data() + address, buffer, size_bytes);
+    markDirty(address, size_bytes);
     return true;
  }
+ // --- Dirty Page Tracking --
+ // Bits are set with relaxed atomics from any writer and harvested by the checkpointer,
+ // which runs while the VM is quiescent.
+ void MemoryManager::markDirty(uintptr_t address, size_t size_bytes) {
+    if (size_bytes == 0 || address >= memory_block_.size()) return;
+    const size_t first = address / PAGE_SIZE;
+    const size_t last = (std::min(address + size_bytes, memory_block_.size()) - 1) / PAGE_SIZE;
+    for (size_t page = first; page <= last; ++page) {
+        dirty_pages_[page / 64].fetch_or(uint64_t{1} << (page % 64), std::memory_order_relaxed);
+    }
+ }
+ void MemoryManager::markRegionsDirty() {
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    for (const auto& [id, region] : allocated_regions_) markDirty(region.base_address, region.size);
+ }
+ std::vector<size_t> MemoryManager::takeDirtyPages() {
+    std::vector<size_t> pages;
+    const size_t words = (getPageCount() + 63) / 64;
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = dirty_pages_[w].exchange(0, std::memory_order_acq_rel);
+        while (bits) {
+            pages.push_back(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
+            bits &= bits - 1;
+        }
+    }
+    return pages;
+ }
+ size_t MemoryManager::scrubDirtyPages() {
+    size_t scrubbed = 0;
+    const size_t words = (getPageCount() + 63) / 64;
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = dirty_pages_[w].exchange(0, std::memory_order_acq_rel);
+        for (; bits; bits &= bits - 1, ++scrubbed) {
+            const size_t offset = (w * 64 + static_cast<size_t>(std::countr_zero(bits))) * PAGE_SIZE;
+            std::memset(memory_block_.data() + offset, 0, std::min(PAGE_SIZE, memory_block_.size() - offset));
+        }
+    }
+    return scrubbed;
+ }
+ // --- Allocator State (checkpoint/restore) --
+ MemoryManager::AllocatorState MemoryManager::getAllocatorState() const {
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    AllocatorState state;
+    state.next_region_id = next_region_id_;
+    for (const auto& [id, region] : allocated_regions_) state.regions.push_back(region);
+    std::sort(state.regions.begin(), state.regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) { return a.id < b.id; });
+    for (const auto& block : free_list_) state.free_blocks.emplace_back(block.address, block.size);
+    return state;
+ }
+ bool MemoryManager::restoreAllocatorState(const AllocatorState& state) {
+    for (const auto& region : state.regions) {
+        if (region.base_address > memory_block_.size() || region.size > memory_block_.size() - region.base_address) {
+            BDI_LOG_ERROR(MEMORY, "Restored region " << region.id << " lies outside memory");
+            return false;
+        }
+    }
+    for (const auto& [address, size] : state.free_blocks) {
+        if (address > memory_block_.size() || size > memory_block_.size() - address) {
+            BDI_LOG_ERROR(MEMORY, "Restored free block at " << address << " lies outside memory");
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(memory_mutex_);
+    allocated_regions_.clear();
+    for (const auto& region : state.regions) allocated_regions_.emplace(region.id, region);
+    free_list_.clear();
+    for (const auto& [address, size] : state.free_blocks) free_list_.push_back({address, size});
+    free_list_.sort();
+    next_region_id_ = state.next_region_id;
+    return true;
+ }
+ // --- Atomics --
+ namespace {
+ std::memory_order toMemoryOrder(AtomicOrder order) {
+    switch (order) {
+        case AtomicOrder::RELAXED: return std::memory_order_relaxed;
+        case AtomicOrder::ACQUIRE: return std::memory_order_acquire;
+        case AtomicOrder::RELEASE: return std::memory_order_release;
+        case AtomicOrder::ACQ_REL: return std::memory_order_acq_rel;
+        default: return std::memory_order_seq_cst;
+    }
+ }
+ template <typename T>
+ std::optional<uint64_t> atomicRmwAs(std::byte* location, AtomicOp op, uint64_t operand, uint64_t expected, std::memory_order order, bool& wrote) {
+    std::atomic_ref<T> ref(*reinterpret_cast<T*>(location));
+    const T value = static_cast<T>(operand);
+    wrote = true;
+    switch (op) {
+        case AtomicOp::ADD: return ref.fetch_add(value, order);
+        case AtomicOp::AND: return ref.fetch_and(value, order);
+        case AtomicOp::OR: return ref.fetch_or(value, order);
+        case AtomicOp::XOR: return ref.fetch_xor(value, order);
+        case AtomicOp::XCHG: return ref.exchange(value, order);
+        case AtomicOp::CAS: {
+            T previous = static_cast<T>(expected);
+            wrote = ref.compare_exchange_strong(previous, value, order); // Failure order derived from 'order'
+            return previous;
+        }
+        case AtomicOp::LOAD:
+            wrote = false;
+            if (order == std::memory_order_release || order == std::memory_order_acq_rel) return std::nullopt;
+            return ref.load(order);
+    }
+    wrote = false;
+    return std::nullopt;
+ }
+ }
+ std::optional<uint64_t> MemoryManager::atomicRmw(uintptr_t address, size_t size, AtomicOp op, uint64_t operand,
+                                                  uint64_t expected, AtomicOrder order) {
+    if (size != 1 && size != 2 && size != 4 && size != 8) return std::nullopt;
+    if (address > memory_block_.size() || size > memory_block_.size() - address) {
+        BDI_LOG_ERROR(MEMORY, "Atomic access out of bounds (Address: " << address << ", Size: " << size << ")");
+        return std::nullopt;
+    }
+    std::byte* location = memory_block_.data() + address;
+    if (reinterpret_cast<uintptr_t>(location) % size != 0) return std::nullopt; // atomic_ref needs natural alignment
+    const std::memory_order memory_order = toMemoryOrder(order);
+    bool wrote = false;
+    std::optional<uint64_t> previous;
+    switch (size) {
+        case 1: previous = atomicRmwAs<uint8_t>(location, op, operand, expected, memory_order, wrote); break;
+        case 2: previous = atomicRmwAs<uint16_t>(location, op, operand, expected, memory_order, wrote); break;
+        case 4: previous = atomicRmwAs<uint32_t>(location, op, operand, expected, memory_order, wrote); break;
+        default: previous = atomicRmwAs<uint64_t>(location, op, operand, expected, memory_order, wrote); break;
+    }
+    if (wrote) markDirty(address, size);
+    return previous;
+ }
  // --- Raw Pointer Access (Use with Caution) --
-std::byte* MemoryManager::getRawPointer(uintptr_t address) {
-     if (address >= memory_block_.size()) return nullptr;
-     return memory_block_.data() + address;
+ std::byte* MemoryManager::getRawPointer(uintptr_t address) {
+    if (address >= memory_block_.size()) return nullptr;
+    return memory_block_.data() + address;
  }
  const std::byte* MemoryManager::getRawPointer(uintptr_t address) const {
-      if (address >= memory_block_.size()) return nullptr;
-     return memory_block_.data() + address;
- }
- size_t MemoryManager::getUsedSize() const {
-    // For bump allocator, this is just the next offset
-    return next_allocation_offset_;
+    if (address >= memory_block_.size()) return nullptr;
+    return memory_block_.data() + address;
  }
  } // namespace bdi::runtime
@@ -2,6 +2,8 @@
  #define BDI_RUNTIME_MEMORYMANAGER_HPP
  #include "MemoryRegion.hpp"
  #include <vector>
+ #include <atomic>
+ #include <memory>
  #include <cstddef> // For std::byte
  #include <cstdint>
  #include <unordered_map>
@@ -10,6 +12,36 @@
  #include <list> // For free list
  #include <map>  // For tracking allocated block sizes maybe
  namespace bdi::runtime {
+ // --- Atomics --
+ // SYNC_ATOMIC_RMW payload: UINT32 (op | order << 8). An empty payload is a SEQ_CST ADD.
+ enum class AtomicOp : uint8_t { ADD, AND, OR, XOR, XCHG, CAS, LOAD };
+ enum class AtomicOrder : uint8_t { SEQ_CST, ACQ_REL, ACQUIRE, RELEASE, RELAXED };
+ constexpr uint32_t encodeAtomicRmw(AtomicOp op, AtomicOrder order = AtomicOrder::SEQ_CST) {
+    return static_cast<uint32_t>(op) | (static_cast<uint32_t>(order) << 8);
+ }
+ // Backing store of the simulated memory: zero pages from calloc (committed on first
+ // touch), or a private copy-on-write file mapping installed by a checkpoint restore,
+ // which the kernel pages in lazily.
+ class MemoryBlock {
+ public:
+    explicit MemoryBlock(size_t size_bytes);
+    ~MemoryBlock();
+    MemoryBlock(const MemoryBlock&) = delete;
+    MemoryBlock& operator=(const MemoryBlock&) = delete;
+    // Replaces the contents with 'size()' bytes at 'offset' in 'fd' (offset must be
+    // aligned to the system page size). The fd may be closed afterwards.
+    bool mapFile(int fd, uint64_t offset);
+    std::byte* data() { return data_; }
+    const std::byte* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool isFileMapped() const { return mapped_; }
+ private:
+    std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    void release();
+ };
  class MemoryManager {
  public:
     // Initialize with a total simulated memory size
@@ -31,8 +63,38 @@
     const std::byte* getRawPointer(uintptr_t address) const;
     size_t getTotalSize() const { return memory_block_.size(); }
     size_t getUsedSize() const; // Needs allocator implementation
+    // --- Checkpoint Support (see VMCheckpointer) --
+    // writeMemory() marks the pages it touches; code writing through getRawPointer()
+    // must call markDirty() itself or incremental checkpoints will miss the change.
+    static constexpr size_t PAGE_SIZE = 4096;
+    size_t getPageCount() const { return (memory_block_.size() + PAGE_SIZE - 1) / PAGE_SIZE; }
+    void markDirty(uintptr_t address, size_t size_bytes);
+    void markRegionsDirty(); // Every allocated region, for callers that wrote into them through getRawPointer()
+    std::vector<size_t> takeDirtyPages(); // Sorted page indices dirtied since the last call; clears them
+    // Zeroes the pages dirtied since the last takeDirtyPages()/scrub and clears their bits.
+    // With the allocator state restored as well, pooled memory is as good as new for the
+    // price of what its last user touched. Returns the number of pages zeroed.
+    size_t scrubDirtyPages();
+    struct AllocatorState {
+        std::vector<MemoryRegion> regions;
+        std::vector<std::pair<uintptr_t, size_t>> free_blocks; // (address, size), sorted by address
+        RegionID next_region_id = 1;
+    };
+    AllocatorState getAllocatorState() const;
+    bool restoreAllocatorState(const AllocatorState& state);
+    // Backs the memory with a private mapping of a checkpoint image (lazy page-in)
+    bool mapImage(int fd, uint64_t offset) { return memory_block_.mapFile(fd, offset); }
+    bool isImageMapped() const { return memory_block_.isFileMapped(); }
+    // --- Atomics (SYNC_ATOMIC_RMW, SYNC_MUTEX_*) --
+    // Hardware read-modify-write of 'size' bytes (1, 2, 4 or 8) at an address aligned to
+    // 'size', through std::atomic_ref on the backing store. Operands and the result are
+    // the value's bit pattern in the low bytes. Returns the previous value; nullopt if the
+    // access is out of bounds, misaligned, or 'order' is invalid for the op (e.g. a RELEASE load).
+    std::optional<uint64_t> atomicRmw(uintptr_t address, size_t size, AtomicOp op, uint64_t operand,
+                                      uint64_t expected = 0, AtomicOrder order = AtomicOrder::SEQ_CST);
  private:
-    std::vector<std::byte> memory_block_; // The simulated memory space
+    MemoryBlock memory_block_; // The simulated memory space
+    std::unique_ptr<std::atomic<uint64_t>[]> dirty_pages_; // One bit per PAGE_SIZE page
     std::unordered_map<RegionID, MemoryRegion> allocated_regions_;
     RegionID next_region_id_;
     // --- Basic Allocator State --
@@ -53,8 +115,8 @@
     // Remove bump allocator state
     uintptr_t next_allocation_offset_;
     // TODO: Implement a more robust allocator (e.g., free list, buddy system) for freeRegion to work properly
-    // Mutex for thread safety if the VM becomes multi-threaded
-    // mutable std::mutex memory_mutex_;
+    // Guards allocated_regions_, free_list_ and next_region_id_ (multi-core BDIOS)
+    mutable std::mutex memory_mutex_;
  };
  } // namespace bdi::runtime
  #endif // BDI_RUNTIME_MEMORYMANAGER_HPP
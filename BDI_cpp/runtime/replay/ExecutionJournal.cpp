@@ -0,0 +1,203 @@
+#include "ExecutionJournal.hpp"
+#include "Logger.hpp"
+#include "StateCodec.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+namespace bdi::runtime {
+using namespace state_codec;
+namespace {
+constexpr char kMagic[8] = {'B', 'D', 'I', 'J', 'R', 'N', 'L', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304; // Journals are host-endian
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t body_size;
+};
+static_assert(sizeof(JournalHeader) == 24, "JournalHeader is a binary format");
+constexpr size_t kEntrySize = 1 + 8 + 8 + 1 + kValueSize;
+constexpr size_t kInputSize = 1 + 8 + 8;
+const char* sourceName(InputSource source) {
+    switch (source) {
+        case InputSource::IO_PORT: return "port";
+        case InputSource::SPECIAL_REGISTER: return "register";
+        case InputSource::HALT_RESULT: return "halt of task";
+        case InputSource::CHANNEL_MOVED: return "op on channel";
+        case InputSource::CHANNEL_VALUE: return "receive from channel";
+        case InputSource::MUTEX_ACQUIRED: return "lock of mutex";
+    }
+    return "input";
+}
+}
+// --- Mode ---
+void ExecutionJournal::startRecording() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_.clear();
+    inputs_.clear();
+    input_cursor_.clear();
+    divergence_.clear();
+    mode_ = Mode::RECORD;
+}
+void ExecutionJournal::startReplay() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    input_cursor_.clear();
+    divergence_.clear();
+    mode_ = Mode::REPLAY;
+}
+// --- Recording ---
+void ExecutionJournal::recordSlice(uint64_t task_id, uint64_t steps, TaskSliceResult result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_.push_back({EntryKind::SLICE, task_id, steps, result, {}});
+}
+void ExecutionJournal::recordDelivery(uint64_t task_id, const BDIValueVariant& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_.push_back({EntryKind::DELIVER, task_id, 0, TaskSliceResult::WAITING, payload});
+}
+void ExecutionJournal::recordHaltWhileWaiting(uint64_t task_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_.push_back({EntryKind::HALT_WAITING, task_id, 0, TaskSliceResult::HALTED_TASK, {}});
+}
+void ExecutionJournal::recordInput(uint64_t task_id, InputSource source, uint64_t address, uint64_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inputs_[task_id].push_back({source, address, value});
+}
+// --- Replay ---
+std::optional<uint64_t> ExecutionJournal::nextInput(uint64_t task_id, InputSource source, uint64_t address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = inputs_.find(task_id);
+    size_t& cursor = input_cursor_[task_id];
+    auto diverge = [&](const std::string& message) -> std::optional<uint64_t> {
+        if (divergence_.empty()) divergence_ = "task " + std::to_string(task_id) + ": " + message;
+        return std::nullopt;
+    };
+    if (it == inputs_.end() || cursor >= it->second.size()) {
+        return diverge(std::string("read ") + sourceName(source) + " " + std::to_string(address) + " beyond the recorded inputs");
+    }
+    const InputRecord& record = it->second[cursor];
+    if (record.source != source || record.address != address) {
+        return diverge(std::string("read ") + sourceName(source) + " " + std::to_string(address) + ", recorded " +
+                       sourceName(record.source) + " " + std::to_string(record.address));
+    }
+    ++cursor;
+    return record.value;
+}
+void ExecutionJournal::reportDivergence(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (divergence_.empty()) divergence_ = message;
+}
+size_t ExecutionJournal::getInputCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [task, records] : inputs_) count += records.size();
+    return count;
+}
+// --- Persistence ---
+bool ExecutionJournal::save(const std::string& path) const {
+    ByteWriter w;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        w.put(static_cast<uint64_t>(schedule_.size()));
+        for (const auto& entry : schedule_) {
+            w.put(static_cast<uint8_t>(entry.kind));
+            w.put(entry.task_id);
+            w.put(entry.steps);
+            w.put(static_cast<uint8_t>(entry.result));
+            w.putValue(entry.payload);
+        }
+        // Sorted by task so equal journals produce equal files
+        std::vector<uint64_t> tasks;
+        tasks.reserve(inputs_.size());
+        for (const auto& [task, records] : inputs_) tasks.push_back(task);
+        std::sort(tasks.begin(), tasks.end());
+        w.put(static_cast<uint64_t>(tasks.size()));
+        for (uint64_t task : tasks) {
+            const auto& records = inputs_.at(task);
+            w.put(task);
+            w.put(static_cast<uint64_t>(records.size()));
+            for (const auto& record : records) {
+                w.put(static_cast<uint8_t>(record.source));
+                w.put(record.address);
+                w.put(record.value);
+            }
+        }
+    }
+    JournalHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    header.body_size = w.buffer().size();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(w.buffer().data()), static_cast<std::streamsize>(w.buffer().size()));
+    if (!out) {
+        BDI_LOG_ERROR(SCHEDULER, "ExecutionJournal: Cannot write " << path);
+        return false;
+    }
+    return true;
+}
+bool ExecutionJournal::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    JournalHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        BDI_LOG_ERROR(SCHEDULER, "ExecutionJournal: " << path << " is not a BDI execution journal");
+        return false;
+    }
+    if (header.version != kVersion || header.byte_order != kByteOrderMark) {
+        BDI_LOG_ERROR(SCHEDULER, "ExecutionJournal: Unsupported journal version " << header.version << " or byte order");
+        return false;
+    }
+    const auto body_start = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto available = static_cast<uint64_t>(in.tellg() - body_start);
+    in.seekg(body_start);
+    std::vector<std::byte> body;
+    if (header.body_size <= available) body.resize(static_cast<size_t>(header.body_size));
+    if (body.size() != header.body_size || !in.read(reinterpret_cast<char*>(body.data()), static_cast<std::streamsize>(body.size()))) {
+        BDI_LOG_ERROR(SCHEDULER, "ExecutionJournal: " << path << " is truncated");
+        return false;
+    }
+    ByteReader r(body);
+    std::vector<ScheduleEntry> schedule;
+    std::unordered_map<uint64_t, std::vector<InputRecord>> inputs;
+    uint64_t count = 0;
+    bool ok = r.getCount(count, kEntrySize);
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        ScheduleEntry entry;
+        uint8_t kind = 0, result = 0;
+        BDIValueVariant payload;
+        ok = r.get(kind) && r.get(entry.task_id) && r.get(entry.steps) && r.get(result) && r.getValue(payload) &&
+             kind <= static_cast<uint8_t>(EntryKind::HALT_WAITING) && result <= static_cast<uint8_t>(TaskSliceResult::ERROR);
+        entry.kind = static_cast<EntryKind>(kind);
+        entry.result = static_cast<TaskSliceResult>(result);
+        entry.payload = payload; // Keeps a vector past the reader
+        schedule.push_back(std::move(entry));
+    }
+    uint64_t tasks = 0;
+    ok = ok && r.getCount(tasks, 16);
+    for (uint64_t t = 0; ok && t < tasks; ++t) {
+        uint64_t task = 0, records = 0;
+        ok = r.get(task) && r.getCount(records, kInputSize);
+        auto& stream = inputs[task];
+        for (uint64_t i = 0; ok && i < records; ++i) {
+            InputRecord record;
+            uint8_t source = 0;
+            ok = r.get(source) && r.get(record.address) && r.get(record.value) && source <= static_cast<uint8_t>(InputSource::MUTEX_ACQUIRED);
+            record.source = static_cast<InputSource>(source);
+            stream.push_back(record);
+        }
+    }
+    if (!ok || !r.atEnd()) {
+        BDI_LOG_ERROR(SCHEDULER, "ExecutionJournal: " << path << " is corrupt");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_ = std::move(schedule);
+    inputs_ = std::move(inputs);
+    input_cursor_.clear();
+    divergence_.clear();
+    mode_ = Mode::OFF;
+    return true;
+}
+} // namespace bdi::runtime
@@ -0,0 +1,73 @@
+#ifndef BDI_RUNTIME_EXECUTIONJOURNAL_HPP
+#define BDI_RUNTIME_EXECUTIONJOURNAL_HPP
+#include "TaskEngine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace bdi::runtime {
+// --- Execution Journal ---
+// Records the non-deterministic inputs of a TaskScheduler run so it can be replayed
+// bit-for-bit offline:
+// - Schedule: the order slices finished in, how many nodes each ran and how it ended,
+//   plus event deliveries and halts of waiting tasks. Appended under the scheduler lock,
+//   so it is one global order even with many workers.
+// - Inputs: per task, every IO_READ_PORT / SYS_REG_READ value, SYS_HALT_TASK result,
+//   channel op outcome, received channel value and SYNC_MUTEX_LOCK outcome, in the order
+//   the task saw them.
+// Nothing else is logged; everything a task computes follows from these. Tasks that
+// race on shared MemoryManager memory (rather than exchanging events) are replayed in
+// slice order, which reproduces them only if the slices did not overlap.
+class ExecutionJournal {
+public:
+    enum class Mode : uint8_t { OFF, RECORD, REPLAY };
+    enum class EntryKind : uint8_t {
+        SLICE,        // 'steps' nodes ran, ending in 'result'
+        DELIVER,      // Event payload written to the task's SYS_WAIT_EVENT node; task is READY
+        HALT_WAITING  // Halted while parked on an event
+    };
+    struct ScheduleEntry {
+        EntryKind kind = EntryKind::SLICE;
+        uint64_t task_id = 0;
+        uint64_t steps = 0;
+        TaskSliceResult result = TaskSliceResult::YIELDED;
+        HeldValue payload;
+    };
+    struct InputRecord {
+        InputSource source = InputSource::IO_PORT;
+        uint64_t address = 0;
+        uint64_t value = 0;
+    };
+    Mode getMode() const { return mode_; }
+    void startRecording(); // Discards anything recorded before
+    void startReplay();    // Rewinds the input streams
+    void stop() { mode_ = Mode::OFF; }
+    // --- Recording (thread-safe) ---
+    void recordSlice(uint64_t task_id, uint64_t steps, TaskSliceResult result);
+    void recordDelivery(uint64_t task_id, const BDIValueVariant& payload);
+    void recordHaltWhileWaiting(uint64_t task_id);
+    void recordInput(uint64_t task_id, InputSource source, uint64_t address, uint64_t value);
+    // --- Replay ---
+    const std::vector<ScheduleEntry>& getSchedule() const { return schedule_; }
+    // Next recorded input of the task. A different source/address or an exhausted stream
+    // is a divergence: returns nullopt and keeps the first such message.
+    std::optional<uint64_t> nextInput(uint64_t task_id, InputSource source, uint64_t address);
+    const std::string& getDivergence() const { return divergence_; }
+    void reportDivergence(const std::string& message);
+    size_t getInputCount() const;
+    // --- Persistence ---
+    bool save(const std::string& path) const;
+    bool load(const std::string& path); // Leaves the journal OFF
+private:
+    std::atomic<Mode> mode_{Mode::OFF};
+    mutable std::mutex mutex_;
+    std::vector<ScheduleEntry> schedule_;
+    std::unordered_map<uint64_t, std::vector<InputRecord>> inputs_; // By task id
+    std::unordered_map<uint64_t, size_t> input_cursor_;              // Replay position per task
+    std::string divergence_;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_EXECUTIONJOURNAL_HPP
@@ -0,0 +1,145 @@
+#include "Fft.hpp"
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+namespace bdi::runtime::signal {
+namespace {
+Radix4Kernel<float> kernelOf(const FftKernels& kernels, float*) { return kernels.f32; }
+Radix4Kernel<double> kernelOf(const FftKernels& kernels, double*) { return kernels.f64; }
+size_t reverseBits(size_t value, unsigned bits) {
+    size_t reversed = 0;
+    for (unsigned i = 0; i < bits; ++i, value >>= 1) reversed = (reversed << 1) | (value & 1);
+    return reversed;
+}
+// Twiddles are computed in double, then rounded once to T
+template <typename T>
+void pushTwiddle(std::vector<T>& table, double sign, size_t numerator, size_t denominator) {
+    const double angle = sign * 2 * std::numbers::pi * static_cast<double>(numerator) / static_cast<double>(denominator);
+    table.push_back(static_cast<T>(std::cos(angle)));
+    table.push_back(static_cast<T>(std::sin(angle)));
+}
+}
+// --- Planning ---
+template <typename T>
+std::unique_ptr<FftPlan<T>> FftPlan<T>::create(size_t size, FftDirection direction, FftKind kind, const FftKernels& kernels) {
+    if (size == 0 || size > MAX_SIZE || !std::has_single_bit(size)) return nullptr;
+    if (kind == FftKind::REAL && size < 2) return nullptr;
+    std::unique_ptr<FftPlan> plan(new FftPlan());
+    plan->size_ = size;
+    plan->direction_ = direction;
+    plan->kind_ = kind;
+    plan->complex_size_ = kind == FftKind::REAL ? size / 2 : size;
+    plan->radix4_ = kernelOf(kernels, static_cast<T*>(nullptr));
+    const size_t m = plan->complex_size_;
+    const unsigned bits = static_cast<unsigned>(std::countr_zero(m));
+    for (size_t i = 0; i < m; ++i) {
+        const size_t j = reverseBits(i, bits);
+        if (i < j) {
+            plan->swaps_.push_back(static_cast<uint32_t>(i));
+            plan->swaps_.push_back(static_cast<uint32_t>(j));
+        }
+    }
+    // Radix-4 passes from h = 1 (or 2 after one radix-2 pass when log2(m) is odd) up to 4h = m
+    const double sign = direction == FftDirection::FORWARD ? -1.0 : 1.0;
+    plan->radix2_first_ = bits % 2 == 1;
+    for (size_t h = plan->radix2_first_ ? 2 : 1; 4 * h <= m; h *= 4) {
+        plan->passes_.push_back({h, plan->twiddles_.size()});
+        for (size_t r = 1; r <= 3; ++r) {
+            for (size_t j = 0; j < h; ++j) pushTwiddle(plan->twiddles_, sign, r * j, 4 * h);
+        }
+    }
+    if (kind == FftKind::REAL) {
+        for (size_t k = 0; k <= size / 4; ++k) pushTwiddle(plan->split_twiddles_, sign, k, size);
+    }
+    return plan;
+}
+// --- Execution ---
+template <typename T>
+void FftPlan<T>::transform(T* data) const {
+    for (size_t s = 0; s < swaps_.size(); s += 2) {
+        T* a = data + 2 * size_t{swaps_[s]};
+        T* b = data + 2 * size_t{swaps_[s + 1]};
+        std::swap(a[0], b[0]);
+        std::swap(a[1], b[1]);
+    }
+    if (radix2_first_) {
+        for (size_t k = 0; k < complex_size_; k += 2) {
+            T* a = data + 2 * k;
+            const T re = a[2], im = a[3];
+            a[2] = a[0] - re;
+            a[3] = a[1] - im;
+            a[0] += re;
+            a[1] += im;
+        }
+    }
+    const bool inverse = direction_ == FftDirection::INVERSE;
+    for (const Pass& pass : passes_) radix4_(data, complex_size_, pass.h, twiddles_.data() + pass.twiddle_offset, inverse);
+}
+template <typename T>
+void FftPlan<T>::realPass(T* data) const {
+    // With Z = the transform of z[k] = x[2k] + i x[2k + 1] and M = n/2, bins k and M - k
+    // pair up: Fe = (Z[k] + conj Z[M-k]) / 2, D = Z[k] - conj Z[M-k], u = W^k * (-+i) D / 2,
+    // then X[k] = Fe + u and X[M-k] = conj(Fe - u). Inverting that is the same step with
+    // conjugated W and +i, applied to the X values.
+    const bool inverse = direction_ == FftDirection::INVERSE;
+    const T half = T{0.5};
+    const T re = data[0], im = data[1];
+    data[0] = inverse ? (re + im) * half : re + im; // X[0] and X[n/2] are real
+    data[1] = inverse ? (re - im) * half : re - im;
+    const size_t m = complex_size_;
+    for (size_t k = 1; k <= m / 2; ++k) {
+        T* a = data + 2 * k;
+        T* b = data + 2 * (m - k);
+        const T fe_re = (a[0] + b[0]) * half, fe_im = (a[1] - b[1]) * half;
+        const T d_re = a[0] - b[0], d_im = a[1] + b[1];
+        const T r_re = (inverse ? -d_im : d_im) * half, r_im = (inverse ? d_re : -d_re) * half;
+        const T* w = split_twiddles_.data() + 2 * k;
+        const T u_re = w[0] * r_re - w[1] * r_im, u_im = w[0] * r_im + w[1] * r_re;
+        a[0] = fe_re + u_re;
+        a[1] = fe_im + u_im;
+        b[0] = fe_re - u_re; // When k == m - k this rewrites the same value
+        b[1] = u_im - fe_im;
+    }
+}
+template <typename T>
+void FftPlan<T>::execute(T* data) const {
+    const bool inverse = direction_ == FftDirection::INVERSE;
+    if (kind_ == FftKind::REAL && inverse) realPass(data);
+    transform(data);
+    if (kind_ == FftKind::REAL && !inverse) realPass(data);
+    if (inverse) {
+        const T scale = T{1} / static_cast<T>(complex_size_);
+        for (size_t i = 0; i < 2 * complex_size_; ++i) data[i] *= scale;
+    }
+}
+// --- Plan Cache ---
+template <typename T>
+const FftPlan<T>* FftPlanCache::get(size_t size, FftDirection direction, FftKind kind) {
+    if (size == 0 || size > FftPlan<T>::MAX_SIZE || !std::has_single_bit(size)) return nullptr;
+    const size_t slot = static_cast<size_t>(std::countr_zero(size)) * 4 + static_cast<size_t>(direction) * 2 + static_cast<size_t>(kind);
+    auto& table = [this]() -> auto& {
+        if constexpr (std::is_same_v<T, float>) return f32_;
+        else return f64_;
+    }();
+    if (const FftPlan<T>* plan = table[slot].load(std::memory_order_acquire)) return plan;
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    if (const FftPlan<T>* plan = table[slot].load(std::memory_order_acquire)) return plan; // Built while we waited
+    auto plan = FftPlan<T>::create(size, direction, kind);
+    if (!plan) return nullptr;
+    const FftPlan<T>* built = plan.get();
+    if constexpr (std::is_same_v<T, float>) owned_f32_.push_back(std::move(plan));
+    else owned_f64_.push_back(std::move(plan));
+    table[slot].store(built, std::memory_order_release);
+    return built;
+}
+FftPlanCache& fftPlans() {
+    static FftPlanCache cache;
+    return cache;
+}
+template class FftPlan<float>;
+template class FftPlan<double>;
+template const FftPlan<float>* FftPlanCache::get<float>(size_t, FftDirection, FftKind);
+template const FftPlan<double>* FftPlanCache::get<double>(size_t, FftDirection, FftKind);
+} // namespace bdi::runtime::signal
@@ -0,0 +1,74 @@
+#ifndef BDI_RUNTIME_FFT_HPP
+#define BDI_RUNTIME_FFT_HPP
+#include "FftKernels.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+namespace bdi::runtime::signal {
+enum class FftDirection : uint8_t { FORWARD, INVERSE };
+enum class FftKind : uint8_t { COMPLEX, REAL };
+// --- Plans ---
+// Everything a transform of one size, direction and kind needs, computed once: the
+// bit-reversal swaps, per-pass twiddle tables and the butterfly kernel of fftKernels().
+// execute() works in place and allocates nothing. FORWARD is unscaled; INVERSE scales by
+// 1/n, so a round trip returns the input.
+// COMPLEX: n interleaved complex values (2n T). REAL: n real values (n a power of two,
+// at least 2); the forward result is the n/2 + 1 non-redundant bins packed into the same
+// n values, bin k at (2k, 2k + 1), with the real-only bins 0 and n/2 sharing slot 0
+// (X[0] at index 0, X[n/2] at index 1). INVERSE REAL takes that layout back to n reals.
+// A real transform runs as a complex one of n/2 plus an O(n) split pass.
+template <typename T>
+class FftPlan {
+public:
+    static constexpr size_t MAX_SIZE = size_t{1} << 28;
+    // nullptr unless 'size' is a power of two in range
+    static std::unique_ptr<FftPlan> create(size_t size, FftDirection direction, FftKind kind, const FftKernels& kernels = fftKernels());
+    void execute(T* data) const;
+    size_t getSize() const { return size_; }
+    FftDirection getDirection() const { return direction_; }
+    FftKind getKind() const { return kind_; }
+    size_t getValueCount() const { return kind_ == FftKind::COMPLEX ? 2 * size_ : size_; } // T per transform
+private:
+    struct Pass {
+        size_t h;                // Block size before the pass
+        size_t twiddle_offset;   // Into twiddles_ (6h T)
+    };
+    size_t size_ = 0;
+    size_t complex_size_ = 0;    // size_, or size_ / 2 for REAL
+    FftDirection direction_ = FftDirection::FORWARD;
+    FftKind kind_ = FftKind::COMPLEX;
+    bool radix2_first_ = false;  // log2(complex_size_) is odd
+    std::vector<uint32_t> swaps_; // Bit-reversal pairs (i, j), i < j
+    std::vector<Pass> passes_;
+    std::vector<T> twiddles_;
+    std::vector<T> split_twiddles_; // REAL: W_n^k (conjugated for INVERSE), k <= n/4
+    Radix4Kernel<T> radix4_ = nullptr;
+    FftPlan() = default;
+    void transform(T* data) const; // The complex transform of complex_size_, unscaled
+    // REAL: forward, from the spectrum of the even/odd samples packed as complex values to
+    // the real spectrum; inverse, back (the same butterfly with conjugated twiddles)
+    void realPass(T* data) const;
+};
+// --- Plan Cache ---
+// Plans by (size, direction, kind, element type). Lookups are lock-free (a fixed table of
+// atomic pointers, one slot per power of two); the first request for a key builds the plan
+// under a mutex. Plans live as long as the cache, so FFT nodes in a loop only pay a lookup.
+class FftPlanCache {
+public:
+    template <typename T>
+    const FftPlan<T>* get(size_t size, FftDirection direction, FftKind kind); // nullptr if the size is invalid
+private:
+    static constexpr size_t SLOTS = 29 * 2 * 2; // log2(MAX_SIZE) + 1 sizes x directions x kinds
+    std::atomic<const FftPlan<float>*> f32_[SLOTS] = {};
+    std::atomic<const FftPlan<double>*> f64_[SLOTS] = {};
+    std::mutex create_mutex_;
+    std::vector<std::unique_ptr<FftPlan<float>>> owned_f32_;
+    std::vector<std::unique_ptr<FftPlan<double>>> owned_f64_;
+};
+// Process-wide cache used by SIGNAL_FFT
+FftPlanCache& fftPlans();
+} // namespace bdi::runtime::signal
+#endif // BDI_RUNTIME_FFT_HPP
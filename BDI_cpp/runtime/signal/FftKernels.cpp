@@ -0,0 +1,28 @@
+#include "FftKernels.hpp"
+#include <initializer_list>
+namespace bdi::runtime::signal {
+namespace {
+constexpr FftKernels kScalar{SimdLevel::SCALAR, detail::radix4Scalar<float>, detail::radix4Scalar<double>};
+}
+const FftKernels* fftKernelsFor(SimdLevel level) {
+    if (!simd::vectorKernelsFor(level)) return nullptr; // Build and CPU checks
+#if defined(__x86_64__) || defined(__i386__)
+    if (level == SimdLevel::AVX2 && !__builtin_cpu_supports("fma")) return nullptr; // AVX-512F implies FMA
+#endif
+    switch (level) {
+        case SimdLevel::SCALAR: return &kScalar;
+        case SimdLevel::NEON: return detail::neonFftKernels();
+        case SimdLevel::SSE42: return nullptr;
+        default: return detail::x86FftKernels(level);
+    }
+}
+const FftKernels& fftKernels() {
+    static const FftKernels& selected = []() -> const FftKernels& {
+        for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::NEON}) {
+            if (const FftKernels* kernels = fftKernelsFor(level)) return *kernels;
+        }
+        return kScalar;
+    }();
+    return selected;
+}
+} // namespace bdi::runtime::signal
@@ -0,0 +1,61 @@
+#ifndef BDI_RUNTIME_FFTKERNELS_HPP
+#define BDI_RUNTIME_FFTKERNELS_HPP
+#include "VectorKernels.hpp"
+#include <cstddef>
+namespace bdi::runtime::signal {
+using simd::SimdLevel;
+// --- Butterfly Kernels ---
+// One radix-4 decimation-in-time pass over 'n' interleaved complex values (re, im) that
+// are in bit-reversed order and already transformed in blocks of 'h': each block of 4h
+// becomes one transform of size 4h. 'twiddles' holds W^j, W^2j and W^3j for j < h (three
+// interleaved arrays of h values), W = exp(-+2 pi i / 4h), conjugated by the plan for
+// inverse transforms; 'inverse' flips the +-i rotation of the butterfly.
+template <typename T>
+using Radix4Kernel = void (*)(T* data, size_t n, size_t h, const T* twiddles, bool inverse);
+struct FftKernels {
+    SimdLevel level = SimdLevel::SCALAR;
+    Radix4Kernel<float> f32 = nullptr;
+    Radix4Kernel<double> f64 = nullptr;
+};
+// The best table this CPU supports, detected once
+const FftKernels& fftKernels();
+// A given level's table, or nullptr if this build or CPU cannot run it (tests, benchmarks).
+// AVX-512 CPUs use the AVX2 butterflies; SSE4.2 has no table of its own.
+const FftKernels* fftKernelsFor(SimdLevel level);
+namespace detail {
+const FftKernels* x86FftKernels(SimdLevel level);
+const FftKernels* neonFftKernels();
+// Portable pass; the SIMD kernels use it when h is narrower than a register
+template <typename T>
+void radix4Scalar(T* data, size_t n, size_t h, const T* twiddles, bool inverse) {
+    const T* w1 = twiddles;
+    const T* w2 = twiddles + 2 * h;
+    const T* w3 = twiddles + 4 * h;
+    auto mul = [](const T* w, const T* x, T& re, T& im) {
+        re = w[0] * x[0] - w[1] * x[1];
+        im = w[0] * x[1] + w[1] * x[0];
+    };
+    for (size_t k = 0; k < n; k += 4 * h) {
+        for (size_t j = 0; j < h; ++j) {
+            // Blocks hold the residues 0, 2, 1, 3 (mod 4) of the subsequence, in that order
+            T* x0 = data + 2 * (k + j);
+            T* x1 = x0 + 2 * h;
+            T* x2 = x0 + 4 * h;
+            T* x3 = x0 + 6 * h;
+            T b1r, b1i, b2r, b2i, b3r, b3i;
+            mul(w2 + 2 * j, x1, b1r, b1i);
+            mul(w1 + 2 * j, x2, b2r, b2i);
+            mul(w3 + 2 * j, x3, b3r, b3i);
+            const T s0r = x0[0] + b1r, s0i = x0[1] + b1i, d0r = x0[0] - b1r, d0i = x0[1] - b1i;
+            const T s1r = b2r + b3r, s1i = b2i + b3i, d1r = b2r - b3r, d1i = b2i - b3i;
+            const T er = inverse ? -d1i : d1i, ei = inverse ? d1r : -d1r; // d1 * -i, or * +i when inverse
+            x0[0] = s0r + s1r; x0[1] = s0i + s1i;
+            x2[0] = s0r - s1r; x2[1] = s0i - s1i;
+            x1[0] = d0r + er; x1[1] = d0i + ei;
+            x3[0] = d0r - er; x3[1] = d0i - ei;
+        }
+    }
+}
+}
+} // namespace bdi::runtime::signal
+#endif // BDI_RUNTIME_FFTKERNELS_HPP
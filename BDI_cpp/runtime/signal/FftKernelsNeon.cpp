@@ -0,0 +1,75 @@
+#include "FftKernels.hpp"
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+namespace bdi::runtime::signal::detail {
+#if defined(__aarch64__)
+namespace {
+// NEON butterflies on interleaved complex values: a register holds 2 complex floats or
+// one complex double
+struct F32 {
+    using Vec = float32x4_t;
+    static constexpr size_t COMPLEX_LANES = 2;
+    static Vec load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, Vec v) { vst1q_f32(p, v); }
+    static Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+    static Vec mul(Vec w, Vec x) {
+        const float32x4_t sign = {-1.0f, 1.0f, -1.0f, 1.0f};
+        const Vec cross = vmulq_f32(vmulq_f32(vrev64q_f32(x), vtrn2q_f32(w, w)), sign); // (-im * wi, re * wi)
+        return vfmaq_f32(cross, x, vtrn1q_f32(w, w));
+    }
+    static Vec rotate(Vec x, bool inverse) {
+        const float32x4_t sign = inverse ? float32x4_t{-1.0f, 1.0f, -1.0f, 1.0f} : float32x4_t{1.0f, -1.0f, 1.0f, -1.0f};
+        return vmulq_f32(vrev64q_f32(x), sign);
+    }
+};
+struct F64 {
+    using Vec = float64x2_t;
+    static constexpr size_t COMPLEX_LANES = 1;
+    static Vec load(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, Vec v) { vst1q_f64(p, v); }
+    static Vec add(Vec a, Vec b) { return vaddq_f64(a, b); }
+    static Vec sub(Vec a, Vec b) { return vsubq_f64(a, b); }
+    static Vec mul(Vec w, Vec x) {
+        const float64x2_t sign = {-1.0, 1.0};
+        const Vec cross = vmulq_f64(vmulq_f64(vextq_f64(x, x, 1), vdupq_laneq_f64(w, 1)), sign);
+        return vfmaq_f64(cross, x, vdupq_laneq_f64(w, 0));
+    }
+    static Vec rotate(Vec x, bool inverse) {
+        const float64x2_t sign = inverse ? float64x2_t{-1.0, 1.0} : float64x2_t{1.0, -1.0};
+        return vmulq_f64(vextq_f64(x, x, 1), sign);
+    }
+};
+template <typename Ops, typename T>
+void radix4Neon(T* data, size_t n, size_t h, const T* twiddles, bool inverse) {
+    if (h % Ops::COMPLEX_LANES != 0) return radix4Scalar(data, n, h, twiddles, inverse);
+    const T* w1 = twiddles;
+    const T* w2 = twiddles + 2 * h;
+    const T* w3 = twiddles + 4 * h;
+    for (size_t k = 0; k < n; k += 4 * h) {
+        for (size_t j = 0; j < h; j += Ops::COMPLEX_LANES) {
+            T* x0 = data + 2 * (k + j);
+            T* x1 = x0 + 2 * h;
+            T* x2 = x0 + 4 * h;
+            T* x3 = x0 + 6 * h;
+            const auto a0 = Ops::load(x0);
+            const auto b1 = Ops::mul(Ops::load(w2 + 2 * j), Ops::load(x1));
+            const auto b2 = Ops::mul(Ops::load(w1 + 2 * j), Ops::load(x2));
+            const auto b3 = Ops::mul(Ops::load(w3 + 2 * j), Ops::load(x3));
+            const auto s0 = Ops::add(a0, b1), d0 = Ops::sub(a0, b1);
+            const auto s1 = Ops::add(b2, b3), e = Ops::rotate(Ops::sub(b2, b3), inverse);
+            Ops::store(x0, Ops::add(s0, s1));
+            Ops::store(x2, Ops::sub(s0, s1));
+            Ops::store(x1, Ops::add(d0, e));
+            Ops::store(x3, Ops::sub(d0, e));
+        }
+    }
+}
+constexpr FftKernels kNeon{SimdLevel::NEON, radix4Neon<F32, float>, radix4Neon<F64, double>};
+}
+const FftKernels* neonFftKernels() { return &kNeon; }
+#else
+const FftKernels* neonFftKernels() { return nullptr; }
+#endif
+} // namespace bdi::runtime::signal::detail
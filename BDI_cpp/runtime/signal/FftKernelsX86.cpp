@@ -0,0 +1,81 @@
+#include "FftKernels.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+namespace bdi::runtime::signal::detail {
+#if defined(__x86_64__) || defined(__i386__)
+namespace {
+// AVX2 + FMA butterflies on interleaved complex values: a register holds 4 complex floats
+// or 2 complex doubles. Complex products use the fmaddsub form
+// (re, im) * (wr, wi) = (re * wr - im * wi, im * wr + re * wi) with wr/wi duplicated per pair.
+#define BDI_AVX2 __attribute__((target("avx2,fma")))
+struct F32 {
+    using Vec = __m256;
+    static constexpr size_t COMPLEX_LANES = 4;
+    BDI_AVX2 static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    BDI_AVX2 static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    BDI_AVX2 static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    BDI_AVX2 static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    BDI_AVX2 static Vec mul(Vec w, Vec x) {
+        const Vec swapped = _mm256_permute_ps(x, 0xB1); // (im, re)
+        return _mm256_fmaddsub_ps(x, _mm256_moveldup_ps(w), _mm256_mul_ps(swapped, _mm256_movehdup_ps(w)));
+    }
+    // x * -i = (im, -re); x * +i = (-im, re)
+    BDI_AVX2 static Vec rotate(Vec x, bool inverse) {
+        const Vec swapped = _mm256_permute_ps(x, 0xB1);
+        const Vec sign = inverse ? _mm256_setr_ps(-0.0f, 0, -0.0f, 0, -0.0f, 0, -0.0f, 0) : _mm256_setr_ps(0, -0.0f, 0, -0.0f, 0, -0.0f, 0, -0.0f);
+        return _mm256_xor_ps(swapped, sign);
+    }
+};
+struct F64 {
+    using Vec = __m256d;
+    static constexpr size_t COMPLEX_LANES = 2;
+    BDI_AVX2 static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    BDI_AVX2 static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    BDI_AVX2 static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    BDI_AVX2 static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    BDI_AVX2 static Vec mul(Vec w, Vec x) {
+        const Vec swapped = _mm256_permute_pd(x, 0x5);
+        return _mm256_fmaddsub_pd(x, _mm256_movedup_pd(w), _mm256_mul_pd(swapped, _mm256_permute_pd(w, 0xF)));
+    }
+    BDI_AVX2 static Vec rotate(Vec x, bool inverse) {
+        const Vec swapped = _mm256_permute_pd(x, 0x5);
+        const Vec sign = inverse ? _mm256_setr_pd(-0.0, 0, -0.0, 0) : _mm256_setr_pd(0, -0.0, 0, -0.0);
+        return _mm256_xor_pd(swapped, sign);
+    }
+};
+// Same pass as radix4Scalar, COMPLEX_LANES values of j at a time
+template <typename Ops, typename T>
+BDI_AVX2 void radix4Avx2(T* data, size_t n, size_t h, const T* twiddles, bool inverse) {
+    if (h % Ops::COMPLEX_LANES != 0) return radix4Scalar(data, n, h, twiddles, inverse);
+    const T* w1 = twiddles;
+    const T* w2 = twiddles + 2 * h;
+    const T* w3 = twiddles + 4 * h;
+    for (size_t k = 0; k < n; k += 4 * h) {
+        for (size_t j = 0; j < h; j += Ops::COMPLEX_LANES) {
+            T* x0 = data + 2 * (k + j);
+            T* x1 = x0 + 2 * h;
+            T* x2 = x0 + 4 * h;
+            T* x3 = x0 + 6 * h;
+            const auto a0 = Ops::load(x0);
+            const auto b1 = Ops::mul(Ops::load(w2 + 2 * j), Ops::load(x1));
+            const auto b2 = Ops::mul(Ops::load(w1 + 2 * j), Ops::load(x2));
+            const auto b3 = Ops::mul(Ops::load(w3 + 2 * j), Ops::load(x3));
+            const auto s0 = Ops::add(a0, b1), d0 = Ops::sub(a0, b1);
+            const auto s1 = Ops::add(b2, b3), e = Ops::rotate(Ops::sub(b2, b3), inverse);
+            Ops::store(x0, Ops::add(s0, s1));
+            Ops::store(x2, Ops::sub(s0, s1));
+            Ops::store(x1, Ops::add(d0, e));
+            Ops::store(x3, Ops::sub(d0, e));
+        }
+    }
+}
+constexpr FftKernels kAvx2{SimdLevel::AVX2, radix4Avx2<F32, float>, radix4Avx2<F64, double>};
+}
+const FftKernels* x86FftKernels(SimdLevel level) {
+    return level == SimdLevel::AVX2 || level == SimdLevel::AVX512 ? &kAvx2 : nullptr;
+}
+#else
+const FftKernels* x86FftKernels(SimdLevel) { return nullptr; }
+#endif
+} // namespace bdi::runtime::signal::detail
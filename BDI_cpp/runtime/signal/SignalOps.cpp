@@ -0,0 +1,51 @@
+#include "SignalOps.hpp"
+#include "MemoryManager.hpp"
+#include <bit>
+namespace bdi::runtime::signal {
+namespace {
+constexpr uint32_t kInverse = 1u << 8;
+constexpr uint32_t kReal = 1u << 9;
+}
+uint32_t encodeFft(const FftSpec& spec) {
+    uint32_t encoded = static_cast<uint8_t>(spec.element_type);
+    if (spec.direction == FftDirection::INVERSE) encoded |= kInverse;
+    if (spec.kind == FftKind::REAL) encoded |= kReal;
+    return encoded;
+}
+std::optional<FftSpec> decodeFft(uint32_t encoded) {
+    if (encoded >> 10) return std::nullopt;
+    FftSpec spec;
+    spec.element_type = static_cast<BDIType>(encoded & 0xFF);
+    if (spec.element_type != BDIType::FLOAT32 && spec.element_type != BDIType::FLOAT64) return std::nullopt;
+    spec.direction = encoded & kInverse ? FftDirection::INVERSE : FftDirection::FORWARD;
+    spec.kind = encoded & kReal ? FftKind::REAL : FftKind::COMPLEX;
+    return spec;
+}
+} // namespace bdi::runtime::signal
+namespace bdi::runtime::vm_ops {
+namespace {
+template <typename T>
+VMStatus run(MemoryManager& memory, const signal::FftSpec& spec, uint64_t address, uint64_t n) {
+    // Check the buffer before asking the cache: plans live for good, so a node must not be
+    // able to build twiddle tables for a size its buffer cannot hold
+    if (n == 0 || n > signal::FftPlan<T>::MAX_SIZE || !std::has_single_bit(n)) return VMStatus::OUT_OF_RANGE;
+    const uint64_t bytes = (spec.kind == signal::FftKind::COMPLEX ? 2 * n : n) * sizeof(T); // n <= MAX_SIZE
+    if (address > memory.getTotalSize() || bytes > memory.getTotalSize() - address) return VMStatus::MEMORY_FAULT;
+    auto* data = reinterpret_cast<T*>(memory.getRawPointer(address));
+    if (reinterpret_cast<uintptr_t>(data) % sizeof(T) != 0) return VMStatus::MEMORY_FAULT;
+    const signal::FftPlan<T>* plan = signal::fftPlans().get<T>(n, spec.direction, spec.kind);
+    if (!plan) return VMStatus::OUT_OF_RANGE;
+    plan->execute(data);
+    memory.markDirty(address, bytes);
+    return VMStatus::OK;
+}
+}
+VMStatus tryFft(MemoryManager* memory, const signal::FftSpec& spec, uint64_t address, uint64_t n) {
+    if (!memory) return VMStatus::NO_MEMORY_MANAGER;
+    switch (spec.element_type) {
+        case BDIType::FLOAT32: return run<float>(*memory, spec, address, n);
+        case BDIType::FLOAT64: return run<double>(*memory, spec, address, n);
+        default: return VMStatus::TYPE_MISMATCH;
+    }
+}
+} // namespace bdi::runtime::vm_ops
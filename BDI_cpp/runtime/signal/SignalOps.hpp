@@ -0,0 +1,31 @@
+#ifndef BDI_RUNTIME_SIGNALOPS_HPP
+#define BDI_RUNTIME_SIGNALOPS_HPP
+#include "Fft.hpp"
+#include "BDITypes.hpp"
+#include "VMStatus.hpp"
+#include <cstdint>
+#include <optional>
+namespace bdi::runtime {
+class MemoryManager;
+}
+namespace bdi::runtime::signal {
+using bdi::core::types::BDIType;
+// --- SIGNAL_FFT Payload ---
+// Element type in bits 0-7, then the inverse bit and the real-input bit
+struct FftSpec {
+    BDIType element_type = BDIType::FLOAT32; // FLOAT32 or FLOAT64
+    FftDirection direction = FftDirection::FORWARD;
+    FftKind kind = FftKind::COMPLEX;
+};
+uint32_t encodeFft(const FftSpec& spec);
+std::optional<FftSpec> decodeFft(uint32_t encoded); // nullopt for unknown bits or element types
+} // namespace bdi::runtime::signal
+namespace bdi::runtime::vm_ops {
+// SIGNAL_FFT: transforms the n-point signal at 'address' in place through the backing
+// store (interleaved re/im pairs for COMPLEX, n reals for REAL; see FftPlan for the
+// packed real spectrum) and marks its pages dirty. Plans come from signal::fftPlans().
+// OUT_OF_RANGE if n is not a supported power of two; MEMORY_FAULT if the buffer is out of
+// bounds or not aligned to its element size.
+VMStatus tryFft(MemoryManager* memory, const signal::FftSpec& spec, uint64_t address, uint64_t n);
+} // namespace bdi::runtime::vm_ops
+#endif // BDI_RUNTIME_SIGNALOPS_HPP
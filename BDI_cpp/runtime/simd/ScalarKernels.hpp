@@ -0,0 +1,37 @@
+#ifndef BDI_RUNTIME_SCALARKERNELS_HPP
+#define BDI_RUNTIME_SCALARKERNELS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+namespace bdi::runtime::simd::scalar {
+// Portable lane loops: the SCALAR table, and the tails/fallbacks of the SIMD tables.
+// Integer lanes are unsigned so that overflow wraps; narrow products are widened to
+// uint32_t first, because uint16_t * uint16_t promotes to a signed int that can overflow.
+template <typename T>
+void add(const T* a, const T* b, T* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<T>(a[i] + b[i]);
+}
+template <typename T>
+void mul(const T* a, const T* b, T* out, size_t n) {
+    using Wide = std::conditional_t<std::is_integral_v<T> && (sizeof(T) < sizeof(uint32_t)), uint32_t, T>;
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<T>(static_cast<Wide>(a[i]) * static_cast<Wide>(b[i]));
+}
+template <typename T>
+void gather(const T* src, const int32_t* indices, T* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = src[indices[i]];
+}
+// Type-erased entry points for the kernel tables
+template <typename T>
+void addKernel(const void* a, const void* b, void* out, size_t n) {
+    add(static_cast<const T*>(a), static_cast<const T*>(b), static_cast<T*>(out), n);
+}
+template <typename T>
+void mulKernel(const void* a, const void* b, void* out, size_t n) {
+    mul(static_cast<const T*>(a), static_cast<const T*>(b), static_cast<T*>(out), n);
+}
+template <typename T>
+void gatherKernel(const void* src, const int32_t* indices, void* out, size_t n) {
+    gather(static_cast<const T*>(src), indices, static_cast<T*>(out), n);
+}
+} // namespace bdi::runtime::simd::scalar
+#endif // BDI_RUNTIME_SCALARKERNELS_HPP
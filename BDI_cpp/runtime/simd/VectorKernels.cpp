@@ -0,0 +1,58 @@
+#include "VectorKernels.hpp"
+#include "ScalarKernels.hpp"
+#include <initializer_list>
+namespace bdi::runtime::simd {
+namespace {
+constexpr VectorKernels kScalar{
+    SimdLevel::SCALAR,
+    {scalar::addKernel<uint8_t>, scalar::addKernel<uint16_t>, scalar::addKernel<uint32_t>,
+     scalar::addKernel<uint64_t>, scalar::addKernel<float>, scalar::addKernel<double>},
+    {scalar::mulKernel<uint8_t>, scalar::mulKernel<uint16_t>, scalar::mulKernel<uint32_t>,
+     scalar::mulKernel<uint64_t>, scalar::mulKernel<float>, scalar::mulKernel<double>},
+    {scalar::gatherKernel<uint8_t>, scalar::gatherKernel<uint16_t>, scalar::gatherKernel<uint32_t>, scalar::gatherKernel<uint64_t>}};
+bool cpuSupports(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR:
+            return true;
+#if defined(__x86_64__) || defined(__i386__)
+        case SimdLevel::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2"); // Also checks that the OS saves the YMM state
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq");
+#elif defined(__aarch64__)
+        case SimdLevel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+}
+const char* toString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE42: return "sse4.2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::NEON: return "neon";
+    }
+    return "unknown";
+}
+const VectorKernels* vectorKernelsFor(SimdLevel level) {
+    if (!cpuSupports(level)) return nullptr;
+    if (level == SimdLevel::SCALAR) return &kScalar;
+    return level == SimdLevel::NEON ? detail::neonKernels() : detail::x86Kernels(level);
+}
+SimdLevel detectSimdLevel() {
+    for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42, SimdLevel::NEON}) {
+        if (vectorKernelsFor(level)) return level;
+    }
+    return SimdLevel::SCALAR;
+}
+const VectorKernels& vectorKernels() {
+    static const VectorKernels& selected = *vectorKernelsFor(detectSimdLevel());
+    return selected;
+}
+} // namespace bdi::runtime::simd
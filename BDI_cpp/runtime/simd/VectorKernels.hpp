@@ -0,0 +1,37 @@
+#ifndef BDI_RUNTIME_VECTORKERNELS_HPP
+#define BDI_RUNTIME_VECTORKERNELS_HPP
+#include <cstddef>
+#include <cstdint>
+namespace bdi::runtime::simd {
+// --- Instruction Sets ---
+// SSE42 needs SSE4.2; AVX512 needs the F, BW and DQ subsets (Skylake-SP and later).
+// NEON is part of every AArch64 CPU.
+enum class SimdLevel : uint8_t { SCALAR, SSE42, AVX2, AVX512, NEON };
+const char* toString(SimdLevel level);
+// --- Kernel Tables ---
+// Lane loops for one instruction set. Integer kernels wrap, so signed and unsigned lanes
+// of a width share them. Pointers need no alignment and may alias exactly ('out' == 'a').
+// Kernels without a native instruction at a level (e.g. 8-bit multiplies) use the scalar loop.
+enum class LaneKind : uint8_t { I8, I16, I32, I64, F32, F64 };
+constexpr size_t LANE_KIND_COUNT = 6;
+using BinaryKernel = void (*)(const void* a, const void* b, void* out, size_t n);
+// out[i] = src[indices[i]]; the caller has checked every index
+using GatherKernel = void (*)(const void* src, const int32_t* indices, void* out, size_t n);
+struct VectorKernels {
+    SimdLevel level = SimdLevel::SCALAR;
+    BinaryKernel add[LANE_KIND_COUNT] = {};
+    BinaryKernel mul[LANE_KIND_COUNT] = {};
+    GatherKernel gather[4] = {}; // By log2 of the element size
+};
+// The best table this CPU supports, detected once
+const VectorKernels& vectorKernels();
+SimdLevel detectSimdLevel();
+// A given level's table, or nullptr if this build or CPU cannot run it (tests, benchmarks)
+const VectorKernels* vectorKernelsFor(SimdLevel level);
+namespace detail {
+// Per-architecture tables, without CPU checks; nullptr when built for another architecture
+const VectorKernels* x86Kernels(SimdLevel level);
+const VectorKernels* neonKernels();
+}
+} // namespace bdi::runtime::simd
+#endif // BDI_RUNTIME_VECTORKERNELS_HPP
@@ -0,0 +1,43 @@
+#include "VectorKernels.hpp"
+#include "ScalarKernels.hpp"
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+namespace bdi::runtime::simd::detail {
+#if defined(__aarch64__)
+namespace {
+// NEON is baseline on AArch64, so these need no target attribute. 16-byte registers; the
+// remaining lanes go through the scalar loop.
+#define BDI_NEON_KERNEL(NAME, T, STEP, LOAD, STORE, OP, TAIL)                 \
+    void NAME(const void* a, const void* b, void* out, size_t n) {             \
+        const T* x = static_cast<const T*>(a);                                 \
+        const T* y = static_cast<const T*>(b);                                 \
+        T* z = static_cast<T*>(out);                                           \
+        size_t i = 0;                                                          \
+        for (; i + (STEP) <= n; i += (STEP)) STORE(z + i, OP(LOAD(x + i), LOAD(y + i))); \
+        TAIL(x + i, y + i, z + i, n - i);                                      \
+    }
+BDI_NEON_KERNEL(addI8Neon, uint8_t, 16, vld1q_u8, vst1q_u8, vaddq_u8, scalar::add)
+BDI_NEON_KERNEL(addI16Neon, uint16_t, 8, vld1q_u16, vst1q_u16, vaddq_u16, scalar::add)
+BDI_NEON_KERNEL(addI32Neon, uint32_t, 4, vld1q_u32, vst1q_u32, vaddq_u32, scalar::add)
+BDI_NEON_KERNEL(addI64Neon, uint64_t, 2, vld1q_u64, vst1q_u64, vaddq_u64, scalar::add)
+BDI_NEON_KERNEL(addF32Neon, float, 4, vld1q_f32, vst1q_f32, vaddq_f32, scalar::add)
+BDI_NEON_KERNEL(addF64Neon, double, 2, vld1q_f64, vst1q_f64, vaddq_f64, scalar::add)
+BDI_NEON_KERNEL(mulI8Neon, uint8_t, 16, vld1q_u8, vst1q_u8, vmulq_u8, scalar::mul)
+BDI_NEON_KERNEL(mulI16Neon, uint16_t, 8, vld1q_u16, vst1q_u16, vmulq_u16, scalar::mul)
+BDI_NEON_KERNEL(mulI32Neon, uint32_t, 4, vld1q_u32, vst1q_u32, vmulq_u32, scalar::mul)
+BDI_NEON_KERNEL(mulF32Neon, float, 4, vld1q_f32, vst1q_f32, vmulq_f32, scalar::mul)
+BDI_NEON_KERNEL(mulF64Neon, double, 2, vld1q_f64, vst1q_f64, vmulq_f64, scalar::mul)
+#undef BDI_NEON_KERNEL
+// No 64-bit lane multiply and no gather instruction in NEON: those stay scalar
+constexpr VectorKernels kNeon{
+    SimdLevel::NEON,
+    {addI8Neon, addI16Neon, addI32Neon, addI64Neon, addF32Neon, addF64Neon},
+    {mulI8Neon, mulI16Neon, mulI32Neon, scalar::mulKernel<uint64_t>, mulF32Neon, mulF64Neon},
+    {scalar::gatherKernel<uint8_t>, scalar::gatherKernel<uint16_t>, scalar::gatherKernel<uint32_t>, scalar::gatherKernel<uint64_t>}};
+}
+const VectorKernels* neonKernels() { return &kNeon; }
+#else
+const VectorKernels* neonKernels() { return nullptr; }
+#endif
+} // namespace bdi::runtime::simd::detail
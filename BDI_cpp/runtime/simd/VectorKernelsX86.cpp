@@ -0,0 +1,120 @@
+#include "VectorKernels.hpp"
+#include "ScalarKernels.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+namespace bdi::runtime::simd::detail {
+#if defined(__x86_64__) || defined(__i386__)
+namespace {
+// Every kernel is compiled for its instruction set through a target attribute, so the rest
+// of the tree keeps the baseline ISA and vectorKernels() picks a level at runtime. The loop
+// covers whole registers; the remaining lanes go through the scalar loop.
+#define BDI_BINARY_KERNEL(NAME, TARGET, T, STEP, LOAD, STORE, OP, TAIL)                          \
+    __attribute__((target(TARGET))) void NAME(const void* a, const void* b, void* out, size_t n) { \
+        const T* x = static_cast<const T*>(a);                                                      \
+        const T* y = static_cast<const T*>(b);                                                      \
+        T* z = static_cast<T*>(out);                                                                \
+        size_t i = 0;                                                                               \
+        for (; i + (STEP) <= n; i += (STEP)) STORE(z + i, OP(LOAD(x + i), LOAD(y + i)));            \
+        TAIL(x + i, y + i, z + i, n - i);                                                           \
+    }
+// --- SSE4.2 (16-byte registers) ---
+#define BDI_SSE "sse4.2"
+#define BDI_SSE_LOAD(p) _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+#define BDI_SSE_STORE(p, v) _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v)
+BDI_BINARY_KERNEL(addI8Sse, BDI_SSE, uint8_t, 16, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_add_epi8, scalar::add)
+BDI_BINARY_KERNEL(addI16Sse, BDI_SSE, uint16_t, 8, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_add_epi16, scalar::add)
+BDI_BINARY_KERNEL(addI32Sse, BDI_SSE, uint32_t, 4, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_add_epi32, scalar::add)
+BDI_BINARY_KERNEL(addI64Sse, BDI_SSE, uint64_t, 2, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_add_epi64, scalar::add)
+BDI_BINARY_KERNEL(addF32Sse, BDI_SSE, float, 4, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, scalar::add)
+BDI_BINARY_KERNEL(addF64Sse, BDI_SSE, double, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, scalar::add)
+BDI_BINARY_KERNEL(mulI16Sse, BDI_SSE, uint16_t, 8, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_mullo_epi16, scalar::mul)
+BDI_BINARY_KERNEL(mulI32Sse, BDI_SSE, uint32_t, 4, BDI_SSE_LOAD, BDI_SSE_STORE, _mm_mullo_epi32, scalar::mul)
+BDI_BINARY_KERNEL(mulF32Sse, BDI_SSE, float, 4, _mm_loadu_ps, _mm_storeu_ps, _mm_mul_ps, scalar::mul)
+BDI_BINARY_KERNEL(mulF64Sse, BDI_SSE, double, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_mul_pd, scalar::mul)
+// --- AVX2 (32-byte registers, hardware gathers) ---
+#define BDI_AVX2 "avx2"
+#define BDI_AVX2_LOAD(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define BDI_AVX2_STORE(p, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v)
+BDI_BINARY_KERNEL(addI8Avx2, BDI_AVX2, uint8_t, 32, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_add_epi8, scalar::add)
+BDI_BINARY_KERNEL(addI16Avx2, BDI_AVX2, uint16_t, 16, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_add_epi16, scalar::add)
+BDI_BINARY_KERNEL(addI32Avx2, BDI_AVX2, uint32_t, 8, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_add_epi32, scalar::add)
+BDI_BINARY_KERNEL(addI64Avx2, BDI_AVX2, uint64_t, 4, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_add_epi64, scalar::add)
+BDI_BINARY_KERNEL(addF32Avx2, BDI_AVX2, float, 8, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, scalar::add)
+BDI_BINARY_KERNEL(addF64Avx2, BDI_AVX2, double, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, scalar::add)
+BDI_BINARY_KERNEL(mulI16Avx2, BDI_AVX2, uint16_t, 16, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_mullo_epi16, scalar::mul)
+BDI_BINARY_KERNEL(mulI32Avx2, BDI_AVX2, uint32_t, 8, BDI_AVX2_LOAD, BDI_AVX2_STORE, _mm256_mullo_epi32, scalar::mul)
+BDI_BINARY_KERNEL(mulF32Avx2, BDI_AVX2, float, 8, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_mul_ps, scalar::mul)
+BDI_BINARY_KERNEL(mulF64Avx2, BDI_AVX2, double, 4, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_mul_pd, scalar::mul)
+__attribute__((target(BDI_AVX2))) void gather32Avx2(const void* src, const int32_t* indices, void* out, size_t n) {
+    const auto* base = static_cast<const int*>(src);
+    auto* z = static_cast<uint32_t*>(out);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) BDI_AVX2_STORE(z + i, _mm256_i32gather_epi32(base, BDI_AVX2_LOAD(indices + i), 4));
+    scalar::gather(static_cast<const uint32_t*>(src), indices + i, z + i, n - i);
+}
+__attribute__((target(BDI_AVX2))) void gather64Avx2(const void* src, const int32_t* indices, void* out, size_t n) {
+    const auto* base = static_cast<const long long*>(src);
+    auto* z = static_cast<uint64_t*>(out);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) BDI_AVX2_STORE(z + i, _mm256_i32gather_epi64(base, BDI_SSE_LOAD(indices + i), 8));
+    scalar::gather(static_cast<const uint64_t*>(src), indices + i, z + i, n - i);
+}
+// --- AVX-512 F/BW/DQ (64-byte registers) ---
+#define BDI_AVX512 "avx512f,avx512bw,avx512dq"
+#define BDI_AVX512_LOAD(p) _mm512_loadu_si512(p)
+#define BDI_AVX512_STORE(p, v) _mm512_storeu_si512(p, v)
+BDI_BINARY_KERNEL(addI8Avx512, BDI_AVX512, uint8_t, 64, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_add_epi8, scalar::add)
+BDI_BINARY_KERNEL(addI16Avx512, BDI_AVX512, uint16_t, 32, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_add_epi16, scalar::add)
+BDI_BINARY_KERNEL(addI32Avx512, BDI_AVX512, uint32_t, 16, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_add_epi32, scalar::add)
+BDI_BINARY_KERNEL(addI64Avx512, BDI_AVX512, uint64_t, 8, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_add_epi64, scalar::add)
+BDI_BINARY_KERNEL(addF32Avx512, BDI_AVX512, float, 16, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, scalar::add)
+BDI_BINARY_KERNEL(addF64Avx512, BDI_AVX512, double, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_add_pd, scalar::add)
+BDI_BINARY_KERNEL(mulI16Avx512, BDI_AVX512, uint16_t, 32, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_mullo_epi16, scalar::mul)
+BDI_BINARY_KERNEL(mulI32Avx512, BDI_AVX512, uint32_t, 16, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_mullo_epi32, scalar::mul)
+BDI_BINARY_KERNEL(mulI64Avx512, BDI_AVX512, uint64_t, 8, BDI_AVX512_LOAD, BDI_AVX512_STORE, _mm512_mullo_epi64, scalar::mul)
+BDI_BINARY_KERNEL(mulF32Avx512, BDI_AVX512, float, 16, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_mul_ps, scalar::mul)
+BDI_BINARY_KERNEL(mulF64Avx512, BDI_AVX512, double, 8, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_mul_pd, scalar::mul)
+__attribute__((target(BDI_AVX512))) void gather32Avx512(const void* src, const int32_t* indices, void* out, size_t n) {
+    auto* z = static_cast<uint32_t*>(out);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) BDI_AVX512_STORE(z + i, _mm512_i32gather_epi32(BDI_AVX512_LOAD(indices + i), src, 4));
+    scalar::gather(static_cast<const uint32_t*>(src), indices + i, z + i, n - i);
+}
+__attribute__((target(BDI_AVX512))) void gather64Avx512(const void* src, const int32_t* indices, void* out, size_t n) {
+    auto* z = static_cast<uint64_t*>(out);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) BDI_AVX512_STORE(z + i, _mm512_i32gather_epi64(BDI_AVX2_LOAD(indices + i), src, 8));
+    scalar::gather(static_cast<const uint64_t*>(src), indices + i, z + i, n - i);
+}
+#undef BDI_BINARY_KERNEL
+// --- Tables ---
+// 8-bit multiplies (no x86 instruction) and, below AVX-512DQ, 64-bit multiplies stay scalar
+constexpr VectorKernels kSse42{
+    SimdLevel::SSE42,
+    {addI8Sse, addI16Sse, addI32Sse, addI64Sse, addF32Sse, addF64Sse},
+    {scalar::mulKernel<uint8_t>, mulI16Sse, mulI32Sse, scalar::mulKernel<uint64_t>, mulF32Sse, mulF64Sse},
+    {scalar::gatherKernel<uint8_t>, scalar::gatherKernel<uint16_t>, scalar::gatherKernel<uint32_t>, scalar::gatherKernel<uint64_t>}};
+constexpr VectorKernels kAvx2{
+    SimdLevel::AVX2,
+    {addI8Avx2, addI16Avx2, addI32Avx2, addI64Avx2, addF32Avx2, addF64Avx2},
+    {scalar::mulKernel<uint8_t>, mulI16Avx2, mulI32Avx2, scalar::mulKernel<uint64_t>, mulF32Avx2, mulF64Avx2},
+    {scalar::gatherKernel<uint8_t>, scalar::gatherKernel<uint16_t>, gather32Avx2, gather64Avx2}};
+constexpr VectorKernels kAvx512{
+    SimdLevel::AVX512,
+    {addI8Avx512, addI16Avx512, addI32Avx512, addI64Avx512, addF32Avx512, addF64Avx512},
+    {scalar::mulKernel<uint8_t>, mulI16Avx512, mulI32Avx512, mulI64Avx512, mulF32Avx512, mulF64Avx512},
+    {scalar::gatherKernel<uint8_t>, scalar::gatherKernel<uint16_t>, gather32Avx512, gather64Avx512}};
+}
+const VectorKernels* x86Kernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE42: return &kSse42;
+        case SimdLevel::AVX2: return &kAvx2;
+        case SimdLevel::AVX512: return &kAvx512;
+        default: return nullptr;
+    }
+}
+#else
+const VectorKernels* x86Kernels(SimdLevel) { return nullptr; }
+#endif
+} // namespace bdi::runtime::simd::detail
@@ -0,0 +1,106 @@
+#include "VectorOps.hpp"
+#include "VectorKernels.hpp"
+#include "MemoryManager.hpp"
+#include "VMCheckedOperations.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+namespace bdi::runtime::vm_ops {
+namespace {
+size_t laneKind(BDIType type) {
+    if (type == BDIType::FLOAT32) return static_cast<size_t>(simd::LaneKind::F32);
+    if (type == BDIType::FLOAT64) return static_cast<size_t>(simd::LaneKind::F64);
+    return static_cast<size_t>(std::countr_zero(core::types::getBdiTypeSize(type))); // I8..I64
+}
+bool isVoid(const BDIValueVariant& value) { return std::holds_alternative<std::monostate>(value); }
+// A vector with every lane set to 'scalar' converted to 'element_type'
+VMResult<PackedVector> broadcast(const BDIValueVariant& scalar, BDIType element_type, size_t lanes) {
+    auto converted = tryConversion(scalar, element_type);
+    if (!converted) return converted.error();
+    PackedVector vector = PackedVector::allocate(element_type, lanes);
+    if (vector.empty()) return VMStatus::OUT_OF_RANGE;
+    std::visit([&](auto value) {
+        using T = decltype(value);
+        if constexpr (std::is_arithmetic_v<T>) std::fill_n(reinterpret_cast<T*>(vector.mutableData()), lanes, value);
+    }, *converted);
+    return vector;
+}
+template <bool Multiply>
+VMResult<PackedVector> binary(const BDIValueVariant& lhs, const BDIValueVariant& rhs) {
+    if (isVoid(lhs) || isVoid(rhs)) return VMStatus::VOID_OPERAND;
+    const VectorRef* a = std::get_if<VectorRef>(&lhs);
+    const VectorRef* b = std::get_if<VectorRef>(&rhs);
+    if (!a && !b) return VMStatus::TYPE_MISMATCH; // Scalars go through ARITH_ADD/ARITH_MUL
+    PackedVector broadcasted;
+    VectorRef filled_ref;
+    if (!a || !b) {
+        const VectorRef& vector = a ? *a : *b;
+        auto filled = broadcast(a ? rhs : lhs, vector.getElementType(), vector.getLaneCount());
+        if (!filled) return filled.error();
+        broadcasted = std::move(*filled);
+        filled_ref = broadcasted.ref();
+        if (!a) a = &filled_ref;
+        else b = &filled_ref;
+    }
+    if (a->getElementType() != b->getElementType() || a->getLaneCount() != b->getLaneCount()) return VMStatus::TYPE_MISMATCH;
+    PackedVector result = PackedVector::allocate(a->getElementType(), a->getLaneCount());
+    const simd::VectorKernels& kernels = simd::vectorKernels();
+    const size_t kind = laneKind(a->getElementType());
+    (Multiply ? kernels.mul[kind] : kernels.add[kind])(a->data(), b->data(), result.mutableData(), a->getLaneCount());
+    return result;
+}
+}
+// --- Memory ---
+VMResult<PackedVector> tryVectorLoad(MemoryManager* memory, uint64_t address, uint64_t lanes, BDIType element_type) {
+    if (!memory) return VMStatus::NO_MEMORY_MANAGER;
+    if (!PackedVector::isElementType(element_type)) return VMStatus::TYPE_MISMATCH;
+    PackedVector vector = PackedVector::allocate(element_type, lanes);
+    if (vector.empty()) return VMStatus::OUT_OF_RANGE;
+    if (!memory->readMemory(address, vector.mutableData(), vector.getByteSize())) return VMStatus::MEMORY_FAULT;
+    return vector;
+}
+VMStatus tryVectorStore(MemoryManager* memory, uint64_t address, const BDIValueVariant& value) {
+    if (!memory) return VMStatus::NO_MEMORY_MANAGER;
+    if (isVoid(value)) return VMStatus::VOID_OPERAND;
+    const VectorRef* vector = std::get_if<VectorRef>(&value);
+    if (!vector) return VMStatus::TYPE_MISMATCH;
+    if (!memory->writeMemory(address, vector->data(), vector->getByteSize())) return VMStatus::MEMORY_FAULT;
+    return VMStatus::OK;
+}
+// --- Arithmetic ---
+VMResult<PackedVector> tryVectorAdd(const BDIValueVariant& lhs, const BDIValueVariant& rhs) { return binary<false>(lhs, rhs); }
+VMResult<PackedVector> tryVectorMultiply(const BDIValueVariant& lhs, const BDIValueVariant& rhs) { return binary<true>(lhs, rhs); }
+// --- Shuffle ---
+VMResult<PackedVector> tryVectorShuffle(std::span<const BDIValueVariant> inputs) {
+    if (inputs.size() != 2 && inputs.size() != 3) return VMStatus::ARITY;
+    for (const BDIValueVariant& input : inputs) {
+        if (isVoid(input)) return VMStatus::VOID_OPERAND;
+    }
+    const VectorRef* a = std::get_if<VectorRef>(&inputs[0]);
+    const VectorRef* b = inputs.size() == 3 ? std::get_if<VectorRef>(&inputs[1]) : nullptr;
+    const VectorRef* indices = std::get_if<VectorRef>(&inputs.back());
+    if (!a || !indices || (inputs.size() == 3 && !b)) return VMStatus::TYPE_MISMATCH;
+    if (b && b->getElementType() != a->getElementType()) return VMStatus::TYPE_MISMATCH;
+    if (indices->getElementType() != BDIType::INT32 && indices->getElementType() != BDIType::UINT32) return VMStatus::TYPE_MISMATCH;
+    const size_t source_lanes = a->getLaneCount() + (b ? b->getLaneCount() : 0);
+    if (source_lanes > static_cast<size_t>(std::numeric_limits<int32_t>::max())) return VMStatus::OUT_OF_RANGE;
+    const uint32_t* lanes = indices->lanes<uint32_t>(); // Negative INT32 indices become huge and fail the check
+    for (size_t i = 0; i < indices->getLaneCount(); ++i) {
+        if (lanes[i] >= source_lanes) return VMStatus::OUT_OF_RANGE;
+    }
+    PackedVector joined; // a followed by b
+    const std::byte* source = a->data();
+    if (b) {
+        joined = PackedVector::allocate(a->getElementType(), source_lanes);
+        if (joined.empty()) return VMStatus::OUT_OF_RANGE;
+        std::memcpy(joined.mutableData(), a->data(), a->getByteSize());
+        std::memcpy(joined.mutableData() + a->getByteSize(), b->data(), b->getByteSize());
+        source = joined.data();
+    }
+    PackedVector result = PackedVector::allocate(a->getElementType(), indices->getLaneCount());
+    const size_t size_class = static_cast<size_t>(std::countr_zero(a->getElementSize()));
+    simd::vectorKernels().gather[size_class](source, indices->lanes<int32_t>(), result.mutableData(), indices->getLaneCount());
+    return result;
+}
+} // namespace bdi::runtime::vm_ops
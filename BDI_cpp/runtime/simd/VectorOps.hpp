@@ -0,0 +1,29 @@
+#ifndef BDI_RUNTIME_VECTOROPS_HPP
+#define BDI_RUNTIME_VECTOROPS_HPP
+#include "BDIValueVariant.hpp"
+#include "VMStatus.hpp"
+#include <cstdint>
+#include <span>
+namespace bdi::runtime {
+class MemoryManager;
+}
+namespace bdi::runtime::vm_ops {
+// --- Packed Vector Ops ---
+// VEC_* semantics on vector values, running the vectorKernels() of this CPU.
+// Never throw; faults are VMStatus codes like the scalar try* ops. Results are new
+// vectors the caller owns; operands are only read while the op runs.
+// VEC_LOAD_PACKED: 'lanes' elements of 'element_type' read straight from the memory's
+// backing store into a new vector (one pass, no staging buffer).
+VMResult<PackedVector> tryVectorLoad(MemoryManager* memory, uint64_t address, uint64_t lanes, BDIType element_type);
+// VEC_STORE_PACKED: writes the lanes straight into the backing store and marks the pages dirty
+VMStatus tryVectorStore(MemoryManager* memory, uint64_t address, const BDIValueVariant& value);
+// VEC_ADD / VEC_MUL: lane-wise, integers wrap. Both operands are vectors of the same element
+// type and lane count, or one is a scalar, which is converted and broadcast to every lane.
+VMResult<PackedVector> tryVectorAdd(const BDIValueVariant& lhs, const BDIValueVariant& rhs);
+VMResult<PackedVector> tryVectorMultiply(const BDIValueVariant& lhs, const BDIValueVariant& rhs);
+// VEC_SHUFFLE: inputs [a, indices] or [a, b, indices]. Lane i of the result is lane
+// indices[i] of a, or of a followed by b (same element type). 'indices' is a vector of
+// INT32/UINT32 lanes, all in range; the result has as many lanes as 'indices'.
+VMResult<PackedVector> tryVectorShuffle(std::span<const BDIValueVariant> inputs);
+} // namespace bdi::runtime::vm_ops
+#endif // BDI_RUNTIME_VECTOROPS_HPP
@@ -0,0 +1,48 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+namespace bdi::runtime {
+size_t LatencyHistogram::bucketFor(uint64_t ns) {
+    constexpr uint64_t linear = uint64_t{1} << SUB_BUCKET_BITS;
+    if (ns < linear) return static_cast<size_t>(ns);
+    const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - 1 - SUB_BUCKET_BITS;
+    return (size_t{shift + 1} << SUB_BUCKET_BITS) + static_cast<size_t>((ns >> shift) & (linear - 1));
+}
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    constexpr uint64_t linear = uint64_t{1} << SUB_BUCKET_BITS;
+    if (bucket < linear) return bucket;
+    const unsigned shift = static_cast<unsigned>(bucket >> SUB_BUCKET_BITS) - 1;
+    const uint64_t lower = (linear + (bucket & (linear - 1))) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+void LatencyHistogram::record(uint64_t ns) {
+    buckets_[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (ns > seen && !max_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+}
+double LatencyHistogram::getMean() const {
+    const uint64_t count = getCount();
+    return count ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+uint64_t LatencyHistogram::percentile(double p) const {
+    const uint64_t count = getCount();
+    if (count == 0) return 0;
+    const double clamped = std::clamp(p, 0.0, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) return std::min(bucketUpperBound(bucket), getMax());
+    }
+    return getMax(); // Counts raced ahead of the buckets
+}
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+} // namespace bdi::runtime
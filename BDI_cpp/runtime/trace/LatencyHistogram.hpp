@@ -0,0 +1,35 @@
+#ifndef BDI_RUNTIME_LATENCYHISTOGRAM_HPP
+#define BDI_RUNTIME_LATENCYHISTOGRAM_HPP
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+namespace bdi::runtime {
+// Log-linear histogram of durations in nanoseconds: values below 16 get a bucket each,
+// larger ones 16 buckets per power of two, so a reported percentile is within 1/16 of
+// the recorded value. record() is a few relaxed atomics from any thread; readers see
+// a snapshot that may miss records still in flight.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr size_t BUCKET_COUNT = size_t{64 - SUB_BUCKET_BITS + 1} << SUB_BUCKET_BITS;
+    void record(uint64_t ns);
+    void record(std::chrono::nanoseconds duration) { record(duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0); }
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max_.load(std::memory_order_relaxed); }
+    double getMean() const;
+    // Upper bound of the bucket holding the p-th percentile (p in [0, 100]), capped at
+    // the maximum; 0 while empty
+    uint64_t percentile(double p) const;
+    void reset();
+    static size_t bucketFor(uint64_t ns);
+    static uint64_t bucketUpperBound(size_t bucket);
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_LATENCYHISTOGRAM_HPP
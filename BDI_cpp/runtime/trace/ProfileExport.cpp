@@ -0,0 +1,43 @@
+#include "ProfileExport.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+namespace bdi::runtime {
+namespace {
+template <typename Key>
+void writeTable(const std::string& title, const std::string& key_label, const std::unordered_map<Key, ProfileStats>& rows,
+                uint64_t total_cycles, double ticks_per_ns, size_t top_n, std::ostream& out) {
+    std::vector<std::pair<Key, ProfileStats>> sorted(rows.begin(), rows.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.cycles != b.second.cycles ? a.second.cycles > b.second.cycles : a.first < b.first;
+    });
+    if (top_n != 0 && sorted.size() > top_n) sorted.resize(top_n);
+    out << "--- " << title << " ---\n";
+    out << std::left << std::setw(12) << key_label << std::right << std::setw(12) << "count" << std::setw(16) << "cycles"
+        << std::setw(9) << "%" << std::setw(14) << "cycles/exec" << std::setw(14) << "est. ns" << '\n';
+    for (const auto& [key, stats] : sorted) {
+        double percent = total_cycles ? 100.0 * static_cast<double>(stats.cycles) / static_cast<double>(total_cycles) : 0.0;
+        double per_exec = stats.count ? static_cast<double>(stats.cycles) / static_cast<double>(stats.count) : 0.0;
+        out << std::left << std::setw(12) << key << std::right << std::setw(12) << stats.count << std::setw(16) << stats.cycles
+            << std::fixed << std::setprecision(2) << std::setw(9) << percent << std::setprecision(1) << std::setw(14) << per_exec
+            << std::setw(14) << static_cast<double>(stats.cycles) / ticks_per_ns << std::defaultfloat << '\n';
+    }
+}
+}
+void writeHotSpotTable(const ProfileData& profile, std::ostream& out, size_t top_n, const BDIGraph* graph) {
+    const uint64_t total = profile.getTotalCycles();
+    out << "Profile: " << total << " cycles, " << profile.ticks_per_ns << " cycles/ns\n";
+    writeTable("By opcode", "opcode", profile.byOpcode(), total, profile.ticks_per_ns, top_n, out);
+    writeTable("By node", "node", profile.byNode(), total, profile.ticks_per_ns, top_n, out);
+    if (graph) writeTable("By subgraph (entry node, 0 = top level)", "entry", profile.bySubgraph(*graph), total, profile.ticks_per_ns, top_n, out);
+}
+void writeFoldedStacks(const ProfileData& profile, std::ostream& out) {
+    for (const auto& s : profile.samples) {
+        if (s.stats.cycles == 0) continue; // Zero-width frames only clutter the graph
+        out << "graph";
+        for (NodeID call : s.call_path) out << ";call@" << call;
+        out << ";op" << s.opcode << '@' << s.node_id << ' ' << s.stats.cycles << '\n';
+    }
+}
+} // namespace bdi::runtime
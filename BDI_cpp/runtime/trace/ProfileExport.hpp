@@ -0,0 +1,13 @@
+#ifndef BDI_RUNTIME_PROFILEEXPORT_HPP
+#define BDI_RUNTIME_PROFILEEXPORT_HPP
+#include "Profiler.hpp"
+#include <iosfwd>
+namespace bdi::runtime {
+// Hot-spot tables sorted by self cycles: per opcode, per node and, when 'graph' is
+// given, per called subgraph. At most 'top_n' rows each (0 = all).
+void writeHotSpotTable(const ProfileData& profile, std::ostream& out, size_t top_n = 20, const BDIGraph* graph = nullptr);
+// Folded stacks for flamegraph.pl / speedscope / inferno: one line per sample,
+// "graph;call@<node>;...;op<opcode>@<node> <cycles>".
+void writeFoldedStacks(const ProfileData& profile, std::ostream& out);
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_PROFILEEXPORT_HPP
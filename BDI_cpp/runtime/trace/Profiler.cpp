@@ -0,0 +1,241 @@
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include "HardwareAbstractionLayer.hpp"
+#include <algorithm>
+#include <exception>
+#include <map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+namespace bdi::runtime {
+// --- Per-thread Shard ---
+// Counters of one thread, keyed by (calling context, node). Calling contexts form a tree
+// of CTRL_CALL nodes interned on first sight, so a sample costs one lookup per frame
+// rather than a copied path. The mutex is only contended by snapshot()/reset().
+class ProfileShard {
+public:
+    uint32_t enterContext(const std::vector<ExecutionContext::CallFrame>& stack) {
+        if (stack.empty()) return 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t context = 0;
+        for (const auto& frame : stack) {
+            auto [it, inserted] = children_.try_emplace(Key{context, frame.caller_node_id}, static_cast<uint32_t>(contexts_.size()));
+            if (inserted) contexts_.push_back({context, frame.caller_node_id});
+            context = it->second;
+        }
+        return context;
+    }
+    void record(uint32_t context, NodeID node_id, uint16_t opcode, uint64_t cycles) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (context >= contexts_.size()) context = 0; // Interned before a reset()
+        try {
+            Entry& entry = entries_[Key{context, node_id}];
+            entry.opcode = opcode;
+            ++entry.stats.count;
+            entry.stats.cycles += cycles;
+        } catch (...) {
+            // Out of memory while profiling: lose the sample, not the task
+        }
+    }
+    void collect(std::vector<ProfileSample>& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [key, entry] : entries_) {
+            ProfileSample sample;
+            for (uint32_t c = key.context; c != 0; c = contexts_[c].parent) sample.call_path.push_back(contexts_[c].caller);
+            std::reverse(sample.call_path.begin(), sample.call_path.end());
+            sample.node_id = key.node;
+            sample.opcode = entry.opcode;
+            sample.stats = entry.stats;
+            out.push_back(std::move(sample));
+        }
+    }
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        contexts_.resize(1);
+        children_.clear();
+        entries_.clear();
+    }
+private:
+    struct Key {
+        uint32_t context;
+        NodeID node;
+        bool operator==(const Key& other) const { return context == other.context && node == other.node; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const noexcept {
+            return std::hash<NodeID>{}(k.node * 0x9E3779B97F4A7C15ull ^ k.context);
+        }
+    };
+    struct Context {
+        uint32_t parent;
+        NodeID caller; // CTRL_CALL node that entered this context
+    };
+    struct Entry {
+        uint16_t opcode = 0;
+        ProfileStats stats;
+    };
+    mutable std::mutex mutex_;
+    std::vector<Context> contexts_{{0, 0}}; // [0] = top level
+    std::unordered_map<Key, uint32_t, KeyHash> children_;
+    std::unordered_map<Key, Entry, KeyHash> entries_;
+};
+namespace {
+std::atomic<uint64_t> next_profiler_id{1};
+// Last shard used by this thread; shards are shared_ptr so a cached shard outlives its Profiler safely
+struct LocalShardCache {
+    uint64_t profiler_id = 0;
+    std::shared_ptr<ProfileShard> shard;
+};
+thread_local LocalShardCache tls_shard;
+const std::vector<ExecutionContext::CallFrame> kNoFrames;
+}
+// --- CycleCounter ---
+CycleCounter::CycleCounter(hal::HardwareAbstractionLayer* hal) : hal_(hal) {
+    if (!hal_) return;
+    try {
+        (void)hal_->readSpecialRegister(hal::SpecialRegister::TimerCurrentValue);
+    } catch (const std::exception& e) {
+        BDI_LOG_WARN(GENERAL, "Profiler: HAL timer unavailable (" << e.what() << "), using native counter");
+        hal_ = nullptr;
+    }
+}
+uint64_t CycleCounter::readNative() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+uint64_t CycleCounter::now() const noexcept {
+    return hal_ ? hal_->readSpecialRegister(hal::SpecialRegister::TimerCurrentValue) : readNative();
+}
+double CycleCounter::calibrate(std::chrono::microseconds window) {
+    if (hal_) {
+        try {
+            uint64_t hz = hal_->readSpecialRegister(hal::SpecialRegister::TimerFrequency);
+            if (hz != 0) return ticks_per_ns_ = static_cast<double>(hz) / 1e9;
+        } catch (const std::exception&) {
+            // No frequency register: measure below
+        }
+    }
+    using Clock = std::chrono::steady_clock;
+    const auto t0 = Clock::now();
+    const uint64_t c0 = now();
+    auto t1 = t0;
+    while (t1 - t0 < window) t1 = Clock::now(); // Busy: a sleeping core may stop or rescale its counter
+    const uint64_t c1 = now();
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    if (c1 > c0 && ns > 0) ticks_per_ns_ = static_cast<double>(c1 - c0) / ns;
+    return ticks_per_ns_;
+}
+// --- ProfileData ---
+uint64_t ProfileData::getTotalCycles() const {
+    uint64_t total = 0;
+    for (const auto& s : samples) total += s.stats.cycles;
+    return total;
+}
+std::unordered_map<uint16_t, ProfileStats> ProfileData::byOpcode() const {
+    std::unordered_map<uint16_t, ProfileStats> result;
+    for (const auto& s : samples) {
+        auto& stats = result[s.opcode];
+        stats.count += s.stats.count;
+        stats.cycles += s.stats.cycles;
+    }
+    return result;
+}
+std::unordered_map<NodeID, ProfileStats> ProfileData::byNode() const {
+    std::unordered_map<NodeID, ProfileStats> result;
+    for (const auto& s : samples) {
+        auto& stats = result[s.node_id];
+        stats.count += s.stats.count;
+        stats.cycles += s.stats.cycles;
+    }
+    return result;
+}
+std::unordered_map<NodeID, ProfileStats> ProfileData::bySubgraph(const BDIGraph& graph) const {
+    std::unordered_map<NodeID, ProfileStats> result;
+    for (const auto& s : samples) {
+        NodeID entry = 0;
+        if (!s.call_path.empty()) {
+            auto call = graph.getNode(s.call_path.back());
+            // Unknown call node (profile of another graph): fall back to the call site
+            entry = call && !call.value().get().control_outputs.empty() ? call.value().get().control_outputs[0] : s.call_path.back();
+        }
+        auto& stats = result[entry];
+        stats.count += s.stats.count;
+        stats.cycles += s.stats.cycles;
+    }
+    return result;
+}
+optimizer::ProfileGuidance ProfileData::toGuidance() const {
+    optimizer::ProfileGuidance guidance;
+    for (const auto& [node_id, stats] : byNode()) {
+        guidance.nodes[node_id] = {stats.count, stats.cycles};
+        guidance.total_cycles += stats.cycles;
+    }
+    return guidance;
+}
+// --- Profiler ---
+Profiler::Profiler(hal::HardwareAbstractionLayer* hal) : id_(next_profiler_id.fetch_add(1)), counter_(hal) {}
+Profiler::~Profiler() = default;
+Profiler& Profiler::global() {
+    static Profiler profiler;
+    return profiler;
+}
+void Profiler::setEnabled(bool enabled) {
+    if (enabled) std::call_once(calibrated_, [this] { counter_.calibrate(); });
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+ProfileShard& Profiler::localShard() {
+    if (tls_shard.profiler_id == id_) return *tls_shard.shard;
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    auto& shard = shards_[std::this_thread::get_id()];
+    if (!shard) shard = std::make_shared<ProfileShard>();
+    tls_shard.profiler_id = id_;
+    tls_shard.shard = shard;
+    return *shard;
+}
+ProfileData Profiler::snapshot() const {
+    std::vector<std::shared_ptr<ProfileShard>> shards;
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        for (const auto& [thread, shard] : shards_) shards.push_back(shard);
+    }
+    std::vector<ProfileSample> raw;
+    for (const auto& shard : shards) shard->collect(raw);
+    // The same (path, node) can appear in several shards once tasks migrate
+    ProfileData data;
+    data.ticks_per_ns = counter_.getTicksPerNs();
+    std::map<std::pair<std::vector<NodeID>, NodeID>, size_t> index;
+    for (auto& sample : raw) {
+        auto [it, inserted] = index.try_emplace({sample.call_path, sample.node_id}, data.samples.size());
+        if (inserted) {
+            data.samples.push_back(std::move(sample));
+        } else {
+            auto& stats = data.samples[it->second].stats;
+            stats.count += sample.stats.count;
+            stats.cycles += sample.stats.cycles;
+        }
+    }
+    return data;
+}
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    for (const auto& [thread, shard] : shards_) shard->clear();
+}
+// --- ProfileScope ---
+void ProfileScope::begin(const ExecutionContext* context) {
+    shard_ = &profiler_->localShard();
+    call_context_ = shard_->enterContext(context ? context->getCallStack() : kNoFrames);
+    start_ = profiler_->counter_.now(); // Last, so interning is not charged to the node
+}
+void ProfileScope::end() noexcept {
+    const uint64_t end = profiler_->counter_.now();
+    shard_->record(call_context_, node_id_, opcode_, end > start_ ? end - start_ : 0);
+}
+} // namespace bdi::runtime
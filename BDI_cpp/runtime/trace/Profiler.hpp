@@ -0,0 +1,115 @@
+#ifndef BDI_RUNTIME_PROFILER_HPP
+#define BDI_RUNTIME_PROFILER_HPP
+#include "BDIGraph.hpp"
+#include "ExecutionContext.hpp"
+#include "ProfileGuidance.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+namespace bdi::hal { class HardwareAbstractionLayer; }
+namespace bdi::runtime {
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::NodeID;
+// --- Cycle Counter ---
+// Reads the HAL's TimerCurrentValue when a HAL is given, otherwise the native counter
+// (TSC on x86-64, CNTVCT on AArch64, steady clock elsewhere). calibrate() converts
+// ticks to nanoseconds: from TimerFrequency if the HAL reports one, else by timing a
+// short busy window against the steady clock.
+class CycleCounter {
+public:
+    explicit CycleCounter(hal::HardwareAbstractionLayer* hal = nullptr);
+    uint64_t now() const noexcept;
+    double calibrate(std::chrono::microseconds window = std::chrono::microseconds(5000)); // Returns ticks per ns
+    double getTicksPerNs() const { return ticks_per_ns_; }
+    double toNs(uint64_t ticks) const { return static_cast<double>(ticks) / ticks_per_ns_; }
+    static uint64_t readNative() noexcept;
+private:
+    hal::HardwareAbstractionLayer* hal_;
+    double ticks_per_ns_ = 1.0;
+};
+// --- Profile Data ---
+struct ProfileStats {
+    uint64_t count = 0;
+    uint64_t cycles = 0; // Self cycles: a CTRL_CALL node does not include its callee
+};
+// One (call path, node) pair. The call path lists the CTRL_CALL node of every active
+// frame, outermost first; empty for the top level of a graph.
+struct ProfileSample {
+    std::vector<NodeID> call_path;
+    NodeID node_id = 0;
+    uint16_t opcode = 0; // BDIOperationType
+    ProfileStats stats;
+};
+// Merged snapshot of all threads; the per-opcode, per-node and per-subgraph views are
+// folded from the samples on demand.
+struct ProfileData {
+    double ticks_per_ns = 1.0;
+    std::vector<ProfileSample> samples;
+    uint64_t getTotalCycles() const;
+    std::unordered_map<uint16_t, ProfileStats> byOpcode() const;
+    std::unordered_map<NodeID, ProfileStats> byNode() const;
+    // Keyed by the callee entry (control_outputs[0] of the innermost CTRL_CALL); 0 = top level
+    std::unordered_map<NodeID, ProfileStats> bySubgraph(const BDIGraph& graph) const;
+    // Node weights for profile-guided optimizer passes (OptimizationEngine::setProfile)
+    optimizer::ProfileGuidance toGuidance() const;
+};
+// --- Profiler ---
+// Execution engines time every node through ProfileScope while isEnabled(); disabled
+// cost is one relaxed load per node. Counters live in per-thread shards (created
+// lazily, like Tracer rings), so recording never contends across workers; snapshot()
+// merges them. Node ids are not qualified by graph: profile one graph at a time, or
+// graphs with disjoint ids.
+class ProfileShard;
+class Profiler {
+public:
+    explicit Profiler(hal::HardwareAbstractionLayer* hal = nullptr);
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    static Profiler& global(); // Used by the VM and runtime engines
+    // Enabling calibrates the counter on first use
+    void setEnabled(bool enabled);
+    bool isEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+    const CycleCounter& getCounter() const { return counter_; }
+    ProfileData snapshot() const;
+    void reset(); // Drops all counters; shards stay registered
+private:
+    friend class ProfileScope;
+    const uint64_t id_; // Distinguishes profilers in the thread-local shard cache
+    CycleCounter counter_;
+    std::atomic<bool> enabled_{false};
+    std::once_flag calibrated_;
+    mutable std::mutex shards_mutex_;
+    std::unordered_map<std::thread::id, std::shared_ptr<ProfileShard>> shards_;
+    ProfileShard& localShard();
+};
+// RAII node timing. The call path is captured on entry, so a CTRL_CALL is charged to its
+// caller's context and a CTRL_RETURN to the callee's. 'context' may be null (no call stack).
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, const ExecutionContext* context, NodeID node_id, uint16_t opcode)
+        : profiler_(profiler.isEnabled() ? &profiler : nullptr), opcode_(opcode), node_id_(node_id) {
+        if (profiler_) begin(context);
+    }
+    ~ProfileScope() {
+        if (profiler_) end();
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+private:
+    Profiler* profiler_;
+    ProfileShard* shard_ = nullptr;
+    uint32_t call_context_ = 0;
+    uint16_t opcode_;
+    NodeID node_id_;
+    uint64_t start_ = 0;
+    void begin(const ExecutionContext* context);
+    void end() noexcept;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_PROFILER_HPP
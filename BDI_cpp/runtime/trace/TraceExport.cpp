@@ -0,0 +1,73 @@
+#include "TraceExport.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+namespace bdi::runtime {
+namespace {
+constexpr char kMagic[8] = {'B', 'D', 'I', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kVersion = 1;
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+};
+static_assert(sizeof(TraceFileHeader) == 16, "TraceFileHeader is a binary format");
+// Microseconds with nanosecond precision, as Chrome expects
+void writeMicros(std::ostream& out, uint64_t ns) {
+    out << ns / 1000 << '.';
+    uint64_t frac = ns % 1000;
+    out << static_cast<char>('0' + frac / 100) << static_cast<char>('0' + (frac / 10) % 10) << static_cast<char>('0' + frac % 10);
+}
+}
+bool writeTraceFileHeader(std::ostream& out) {
+    TraceFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_size = sizeof(TraceRecord);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(out);
+}
+bool readTraceFile(const std::string& path, std::vector<TraceRecord>& out) {
+    std::ifstream in(path, std::ios::binary);
+    TraceFileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        BDI_LOG_ERROR(GENERAL, "TraceExport: " << path << " is not a BDI trace file");
+        return false;
+    }
+    if (header.version != kVersion || header.record_size != sizeof(TraceRecord)) {
+        BDI_LOG_ERROR(GENERAL, "TraceExport: Unsupported trace version " << header.version << " (record size " << header.record_size << ")");
+        return false;
+    }
+    TraceRecord record{};
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) out.push_back(record);
+    return true; // A truncated final record (crash mid-write) is ignored
+}
+void writeChromeTrace(const std::vector<TraceRecord>& records, std::ostream& out) {
+    uint64_t base = records.empty() ? 0 : records.front().timestamp_ns;
+    for (const auto& r : records) base = std::min(base, r.timestamp_ns);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& r : records) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":\"op " << r.opcode << "\",\"cat\":\"bdi\",\"ph\":\"X\",\"ts\":";
+        writeMicros(out, r.timestamp_ns - base);
+        out << ",\"dur\":";
+        writeMicros(out, r.duration_ns);
+        out << ",\"pid\":1,\"tid\":" << r.thread_index << ",\"args\":{\"node\":" << r.node_id << ",\"task\":" << r.task_id << "}}";
+    }
+    out << "\n]}\n";
+}
+bool convertTraceFileToChromeJson(const std::string& trace_path, const std::string& json_path) {
+    std::vector<TraceRecord> records;
+    if (!readTraceFile(trace_path, records)) return false;
+    std::ofstream out(json_path, std::ios::trunc);
+    if (!out) {
+        BDI_LOG_ERROR(GENERAL, "TraceExport: Cannot write " << json_path);
+        return false;
+    }
+    writeChromeTrace(records, out);
+    return static_cast<bool>(out);
+}
+} // namespace bdi::runtime
@@ -0,0 +1,17 @@
+#ifndef BDI_RUNTIME_TRACEEXPORT_HPP
+#define BDI_RUNTIME_TRACEEXPORT_HPP
+#include "Tracer.hpp"
+#include <iosfwd>
+#include <string>
+#include <vector>
+namespace bdi::runtime {
+// Binary trace file: 16-byte header ("BDITRACE", u32 version, u32 record size)
+// followed by raw TraceRecords in drain order.
+bool writeTraceFileHeader(std::ostream& out);
+bool readTraceFile(const std::string& path, std::vector<TraceRecord>& out);
+// Chrome trace event format (chrome://tracing, ui.perfetto.dev): one complete ("X")
+// event per record, pid = 1, tid = thread index, timestamps rebased to the first record.
+void writeChromeTrace(const std::vector<TraceRecord>& records, std::ostream& out);
+bool convertTraceFileToChromeJson(const std::string& trace_path, const std::string& json_path);
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_TRACEEXPORT_HPP
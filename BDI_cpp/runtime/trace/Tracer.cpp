@@ -0,0 +1,127 @@
+#include "Tracer.hpp"
+#include "Logger.hpp"
+#include "TraceExport.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+namespace bdi::runtime {
+namespace {
+std::atomic<uint64_t> next_tracer_id{1};
+// Last ring used by this thread; rings are shared_ptr so a cached ring outlives its Tracer safely
+struct LocalRingCache {
+    uint64_t tracer_id = 0;
+    std::shared_ptr<TraceRing> ring;
+};
+thread_local LocalRingCache tls_ring;
+size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+}
+// --- TraceRing ---
+TraceRing::TraceRing(size_t capacity, uint16_t thread_index)
+    : slots_(std::make_unique<TraceRecord[]>(roundUpPow2(std::max<size_t>(capacity, 2)))),
+      mask_(roundUpPow2(std::max<size_t>(capacity, 2)) - 1), thread_index_(thread_index) {}
+bool TraceRing::push(const TraceRecord& record) noexcept {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ > mask_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head - cached_tail_ > mask_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    slots_[head & mask_] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+size_t TraceRing::drainInto(std::vector<TraceRecord>& out) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i != head; ++i) out.push_back(slots_[i & mask_]);
+    tail_.store(head, std::memory_order_release);
+    return static_cast<size_t>(head - tail);
+}
+// --- Tracer ---
+Tracer::Tracer(size_t ring_capacity) : id_(next_tracer_id.fetch_add(1)), ring_capacity_(ring_capacity) {}
+Tracer::~Tracer() {
+    stopDrainer();
+}
+Tracer& Tracer::global() {
+    static Tracer tracer;
+    return tracer;
+}
+TraceRing& Tracer::localRing() {
+    if (tls_ring.tracer_id == id_) return *tls_ring.ring;
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    auto& ring = rings_[std::this_thread::get_id()];
+    if (!ring) ring = std::make_shared<TraceRing>(ring_capacity_, static_cast<uint16_t>(rings_.size() - 1));
+    tls_ring.tracer_id = id_;
+    tls_ring.ring = ring;
+    return *ring;
+}
+void Tracer::record(NodeID node_id, uint16_t opcode, uint64_t task_id, uint64_t start_ns, uint64_t end_ns) noexcept {
+    TraceRing& ring = localRing();
+    uint64_t duration = end_ns > start_ns ? end_ns - start_ns : 0;
+    ring.push({start_ns, node_id, task_id,
+               static_cast<uint32_t>(std::min<uint64_t>(duration, std::numeric_limits<uint32_t>::max())),
+               opcode, ring.getThreadIndex()});
+}
+size_t Tracer::drain(std::vector<TraceRecord>& out) {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings.reserve(rings_.size());
+        for (const auto& [thread, ring] : rings_) rings.push_back(ring);
+    }
+    size_t drained = 0;
+    for (const auto& ring : rings) drained += ring->drainInto(out);
+    return drained;
+}
+uint64_t Tracer::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    uint64_t dropped = 0;
+    for (const auto& [thread, ring] : rings_) dropped += ring->getDroppedCount();
+    return dropped;
+}
+// --- Background Drainer ---
+bool Tracer::startDrainer(const std::string& path, std::chrono::milliseconds period) {
+    if (drainer_.joinable()) return false;
+    auto file = std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!*file || !writeTraceFileHeader(*file)) {
+        BDI_LOG_ERROR(GENERAL, "Tracer: Cannot open trace file " << path);
+        return false;
+    }
+    drainer_stop_ = false;
+    drainer_ = std::thread([this, file, period] {
+        std::vector<TraceRecord> batch;
+        bool stopping = false;
+        while (!stopping) {
+            {
+                std::unique_lock<std::mutex> lock(drainer_mutex_);
+                drainer_cv_.wait_for(lock, period, [this] { return drainer_stop_; });
+                stopping = drainer_stop_;
+            }
+            batch.clear();
+            drain(batch);
+            if (!batch.empty()) {
+                file->write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(batch.size() * sizeof(TraceRecord)));
+                written_.fetch_add(batch.size());
+            }
+        }
+        file->flush();
+    });
+    return true;
+}
+void Tracer::stopDrainer() {
+    if (!drainer_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(drainer_mutex_);
+        drainer_stop_ = true;
+    }
+    drainer_cv_.notify_all();
+    drainer_.join();
+}
+} // namespace bdi::runtime
@@ -0,0 +1,107 @@
+#ifndef BDI_RUNTIME_TRACER_HPP
+#define BDI_RUNTIME_TRACER_HPP
+#include "BDINode.hpp" // NodeID
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+namespace bdi::runtime {
+using bdi::core::graph::NodeID;
+// --- Trace Record ---
+// One executed node. Fixed 32-byte layout; also the on-disk format (see TraceExport).
+struct TraceRecord {
+    uint64_t timestamp_ns; // Start, steady clock
+    NodeID node_id;
+    uint64_t task_id;      // 0 outside BDIOS tasks
+    uint32_t duration_ns;  // Saturates at ~4.29 s
+    uint16_t opcode;       // BDIOperationType
+    uint16_t thread_index; // Dense per-Tracer thread number
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord is a binary format");
+// --- Per-thread Ring ---
+// Single producer (the owning thread), single consumer (the drainer). Never blocks the
+// producer: when full, the record is dropped and counted.
+class TraceRing {
+public:
+    TraceRing(size_t capacity, uint16_t thread_index); // Capacity rounded up to a power of two
+    bool push(const TraceRecord& record) noexcept;
+    size_t drainInto(std::vector<TraceRecord>& out);
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint16_t getThreadIndex() const { return thread_index_; }
+private:
+    std::unique_ptr<TraceRecord[]> slots_;
+    uint64_t mask_;
+    uint16_t thread_index_;
+    alignas(64) std::atomic<uint64_t> head_{0}; // Next write (producer)
+    uint64_t cached_tail_ = 0;                  // Producer's last view of tail_
+    alignas(64) std::atomic<uint64_t> tail_{0}; // Next read (consumer)
+    std::atomic<uint64_t> dropped_{0};
+};
+// --- Tracer ---
+// Execution engines call record() (through TraceScope) when isEnabled(); disabled cost
+// is one relaxed load per node. Rings are created lazily per thread. A background
+// drainer appends records to a binary trace file that TraceExport turns into
+// Chrome trace / Perfetto JSON.
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 14; // Records per thread
+    explicit Tracer(size_t ring_capacity = DEFAULT_RING_CAPACITY);
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    static Tracer& global(); // Used by the VM and runtime engines
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+    void record(NodeID node_id, uint16_t opcode, uint64_t task_id, uint64_t start_ns, uint64_t end_ns) noexcept;
+    // Moves everything buffered so far into 'out' (appends). Consumers are serialized.
+    size_t drain(std::vector<TraceRecord>& out);
+    // Background drain to 'path' every 'period'. Fails if already running or the file can't be opened.
+    bool startDrainer(const std::string& path, std::chrono::milliseconds period = std::chrono::milliseconds(10));
+    void stopDrainer(); // Final drain, then closes the file
+    uint64_t getDroppedCount() const;
+    uint64_t getWrittenCount() const { return written_.load(); }
+    static uint64_t nowNs() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+private:
+    const uint64_t id_; // Distinguishes tracers in the thread-local ring cache
+    size_t ring_capacity_;
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex rings_mutex_;
+    std::unordered_map<std::thread::id, std::shared_ptr<TraceRing>> rings_;
+    std::mutex drain_mutex_;
+    std::thread drainer_;
+    std::mutex drainer_mutex_;
+    std::condition_variable drainer_cv_;
+    bool drainer_stop_ = false;
+    std::atomic<uint64_t> written_{0};
+    TraceRing& localRing();
+};
+// RAII node timing: records [construction, destruction) if the tracer was enabled
+// when the scope began.
+class TraceScope {
+public:
+    TraceScope(Tracer& tracer, NodeID node_id, uint16_t opcode, uint64_t task_id) noexcept
+        : tracer_(tracer.isEnabled() ? &tracer : nullptr), node_id_(node_id), task_id_(task_id), opcode_(opcode),
+          start_ns_(tracer_ ? Tracer::nowNs() : 0) {}
+    ~TraceScope() {
+        if (tracer_) tracer_->record(node_id_, opcode_, task_id_, start_ns_, Tracer::nowNs());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    Tracer* tracer_;
+    NodeID node_id_;
+    uint64_t task_id_;
+    uint16_t opcode_;
+    uint64_t start_ns_;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_TRACER_HPP
@@ -0,0 +1,233 @@
+#include "GraphTraversal.hpp"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <utility>
+#include <vector>
+namespace bdi::runtime::traversal {
+namespace {
+constexpr size_t kWordBits = 64;
+uint64_t bitOf(size_t v) { return uint64_t{1} << (v % kWordBits); }
+// Splits 'items' into chunks when the step has enough work and a pool to run on
+size_t chunkCount(WorkStealingPool* pool, size_t work, size_t items) {
+    if (!pool || work < PARALLEL_MIN_STEP || items < 2) return 1;
+    return std::min(items, (pool->getWorkerCount() + 1) * 4);
+}
+std::pair<size_t, size_t> chunkRange(size_t count, size_t chunks, size_t chunk) {
+    return {count * chunk / chunks, count * (chunk + 1) / chunks};
+}
+// Runs body(chunk) for every chunk: on the pool with the caller taking chunk 0 and then
+// helping, or inline for a single chunk
+template <typename Body>
+void forEachChunk(WorkStealingPool* pool, size_t chunks, const Body& body) {
+    if (!pool || chunks <= 1) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) body(chunk);
+        return;
+    }
+    std::atomic<size_t> remaining{chunks - 1};
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        pool->submit([&, chunk] {
+            body(chunk);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    body(0);
+    pool->helpWhile([&] { return remaining.load(std::memory_order_acquire) > 0; });
+}
+struct StepResult {
+    size_t vertices = 0; // Newly visited
+    size_t edges = 0;    // Their out-degrees
+};
+StepResult sum(const std::vector<StepResult>& partial, size_t chunks) {
+    StepResult total;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        total.vertices += partial[chunk].vertices;
+        total.edges += partial[chunk].edges;
+    }
+    return total;
+}
+}
+// --- Validation ---
+template <typename T>
+bool isWellFormed(const CsrGraph<T>& graph, WorkStealingPool* pool) {
+    const size_t n = graph.vertex_count;
+    if (graph.offsets[0] != 0) return false;
+    std::atomic<bool> ok{true};
+    // Offsets first: the target pass relies on every row lying inside the targets array
+    size_t chunks = chunkCount(pool, n, n);
+    forEachChunk(pool, chunks, [&](size_t chunk) {
+        const auto [begin, end] = chunkRange(n, chunks, chunk);
+        for (size_t v = begin; v < end; ++v) {
+            if (graph.offsets[v] > graph.offsets[v + 1]) ok.store(false, std::memory_order_relaxed);
+        }
+    });
+    if (!ok.load()) return false;
+    const size_t edges = graph.edgeCount();
+    chunks = chunkCount(pool, edges, edges);
+    forEachChunk(pool, chunks, [&](size_t chunk) {
+        const auto [begin, end] = chunkRange(edges, chunks, chunk);
+        for (size_t e = begin; e < end; ++e) {
+            if (graph.targets[e] >= n) ok.store(false, std::memory_order_relaxed);
+        }
+    });
+    return ok.load();
+}
+// --- Breadth-First Search ---
+template <typename T>
+size_t breadthFirst(const CsrGraph<T>& graph, T source, T* distances, bool symmetric, WorkStealingPool* pool, BfsStats* stats) {
+    const size_t n = graph.vertex_count;
+    const size_t words = (n + kWordBits - 1) / kWordBits;
+    BfsStats local_stats;
+    BfsStats& s = stats ? *stats : local_stats;
+    s = {};
+    std::fill(distances, distances + n, UNREACHED<T>);
+    // A vertex belongs to whichever step first sets its visited bit, so each distance is
+    // written once. Bottom-up chunks own whole words, so they update them without races.
+    std::unique_ptr<std::atomic<uint64_t>[]> visited(new std::atomic<uint64_t>[words]());
+    visited[source / kWordBits].store(bitOf(source), std::memory_order_relaxed);
+    distances[source] = 0;
+    std::vector<T> frontier{source};
+    std::vector<uint64_t> frontier_bits, next_bits;
+    std::vector<std::vector<T>> buckets(1); // Per-chunk next frontiers (top-down)
+    std::vector<StepResult> partial(1);
+    size_t reached = 1;
+    size_t frontier_count = 1;
+    size_t frontier_edges = graph.degree(source);
+    size_t unexplored_edges = graph.edgeCount() - frontier_edges;
+    bool bottom_up = false;
+    for (size_t level = 0; frontier_count > 0; ++level) {
+        ++s.levels;
+        if (!bottom_up && symmetric && frontier_edges > unexplored_edges / BFS_ALPHA) {
+            frontier_bits.assign(words, 0);
+            for (T v : frontier) frontier_bits[v / kWordBits] |= bitOf(v);
+            next_bits.resize(words);
+            bottom_up = true;
+        } else if (bottom_up && frontier_count < n / BFS_BETA) {
+            frontier.clear();
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = frontier_bits[w]; bits; bits &= bits - 1) frontier.push_back(static_cast<T>(w * kWordBits + std::countr_zero(bits)));
+            }
+            bottom_up = false;
+        }
+        const T next_distance = static_cast<T>(level + 1);
+        size_t chunks;
+        if (bottom_up) {
+            chunks = chunkCount(pool, n, words);
+            partial.resize(std::max(partial.size(), chunks));
+            forEachChunk(pool, chunks, [&](size_t chunk) {
+                const auto [begin, end] = chunkRange(words, chunks, chunk);
+                StepResult found;
+                for (size_t w = begin; w < end; ++w) {
+                    uint64_t unvisited = ~visited[w].load(std::memory_order_relaxed);
+                    if (w == words - 1 && n % kWordBits) unvisited &= bitOf(n) - 1;
+                    uint64_t next_word = 0;
+                    for (; unvisited; unvisited &= unvisited - 1) {
+                        const size_t v = w * kWordBits + std::countr_zero(unvisited);
+                        for (T e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                            const T u = graph.targets[e];
+                            if (!(frontier_bits[u / kWordBits] & bitOf(u))) continue;
+                            next_word |= bitOf(v);
+                            distances[v] = next_distance;
+                            ++found.vertices;
+                            found.edges += graph.degree(v);
+                            break;
+                        }
+                    }
+                    next_bits[w] = next_word;
+                    if (next_word) visited[w].fetch_or(next_word, std::memory_order_relaxed);
+                }
+                partial[chunk] = found;
+            });
+            frontier_bits.swap(next_bits);
+            ++s.bottom_up_steps;
+        } else {
+            chunks = chunkCount(pool, frontier_edges, frontier.size());
+            partial.resize(std::max(partial.size(), chunks));
+            if (buckets.size() < chunks) buckets.resize(chunks);
+            forEachChunk(pool, chunks, [&](size_t chunk) {
+                const auto [begin, end] = chunkRange(frontier.size(), chunks, chunk);
+                std::vector<T>& out = buckets[chunk];
+                out.clear();
+                StepResult found;
+                for (size_t i = begin; i < end; ++i) {
+                    const T u = frontier[i];
+                    for (T e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+                        const T v = graph.targets[e];
+                        std::atomic<uint64_t>& word = visited[v / kWordBits];
+                        if (word.load(std::memory_order_relaxed) & bitOf(v)) continue; // Cheap filter before the RMW
+                        if (word.fetch_or(bitOf(v), std::memory_order_relaxed) & bitOf(v)) continue;
+                        distances[v] = next_distance;
+                        out.push_back(v);
+                        found.edges += graph.degree(v);
+                    }
+                }
+                found.vertices = out.size();
+                partial[chunk] = found;
+            });
+            if (chunks == 1) {
+                frontier.swap(buckets[0]);
+            } else {
+                frontier.clear();
+                for (size_t chunk = 0; chunk < chunks; ++chunk) frontier.insert(frontier.end(), buckets[chunk].begin(), buckets[chunk].end());
+            }
+        }
+        if (chunks > 1) ++s.parallel_steps;
+        const StepResult step = sum(partial, chunks);
+        reached += step.vertices;
+        frontier_count = step.vertices;
+        frontier_edges = step.edges;
+        unexplored_edges -= std::min(unexplored_edges, step.edges);
+    }
+    return reached;
+}
+// --- Depth-First Orders ---
+template <typename T>
+size_t depthFirst(const CsrGraph<T>& graph, T source, T* order) {
+    std::vector<uint64_t> visited((graph.vertex_count + kWordBits - 1) / kWordBits);
+    std::vector<std::pair<T, T>> stack; // Vertex, next edge to follow
+    size_t count = 0;
+    auto visit = [&](T v) {
+        visited[v / kWordBits] |= bitOf(v);
+        order[count++] = v;
+        stack.emplace_back(v, graph.offsets[v]);
+    };
+    visit(source);
+    while (!stack.empty()) {
+        auto& [v, edge] = stack.back();
+        if (edge == graph.offsets[v + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        const T w = graph.targets[edge++];
+        if (!(visited[w / kWordBits] & bitOf(w))) visit(w); // May reallocate the stack; 'edge' is not used after
+    }
+    return count;
+}
+template <typename T>
+size_t topologicalOrder(const CsrGraph<T>& graph, T* order) {
+    const size_t n = graph.vertex_count;
+    std::vector<T> in_degree(n);
+    for (size_t e = 0; e < graph.edgeCount(); ++e) ++in_degree[graph.targets[e]];
+    size_t tail = 0;
+    for (size_t v = 0; v < n; ++v) {
+        if (in_degree[v] == 0) order[tail++] = static_cast<T>(v);
+    }
+    for (size_t head = 0; head < tail; ++head) {
+        const T u = order[head];
+        for (T e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            if (--in_degree[graph.targets[e]] == 0) order[tail++] = graph.targets[e];
+        }
+    }
+    return tail;
+}
+#define BDI_INSTANTIATE_TRAVERSAL(T)                                                                       \
+    template bool isWellFormed<T>(const CsrGraph<T>&, WorkStealingPool*);                                  \
+    template size_t breadthFirst<T>(const CsrGraph<T>&, T, T*, bool, WorkStealingPool*, BfsStats*);        \
+    template size_t depthFirst<T>(const CsrGraph<T>&, T, T*);                                              \
+    template size_t topologicalOrder<T>(const CsrGraph<T>&, T*);
+BDI_INSTANTIATE_TRAVERSAL(uint32_t)
+BDI_INSTANTIATE_TRAVERSAL(uint64_t)
+#undef BDI_INSTANTIATE_TRAVERSAL
+} // namespace bdi::runtime::traversal
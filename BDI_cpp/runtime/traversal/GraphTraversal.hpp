@@ -0,0 +1,62 @@
+#ifndef BDI_RUNTIME_GRAPHTRAVERSAL_HPP
+#define BDI_RUNTIME_GRAPHTRAVERSAL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+namespace bdi::runtime {
+class WorkStealingPool;
+}
+namespace bdi::runtime::traversal {
+// --- CSR Graphs ---
+// Compressed sparse rows over vertex ids 0..vertex_count-1: the out-edges of v are
+// targets[offsets[v]] .. targets[offsets[v + 1] - 1]. Defined for uint32_t and uint64_t
+// indices. The traversals assume isWellFormed(); they never allocate per edge.
+template <typename T>
+struct CsrGraph {
+    const T* offsets = nullptr; // vertex_count + 1 entries, offsets[0] == 0, nondecreasing
+    const T* targets = nullptr; // offsets[vertex_count] entries, each < vertex_count
+    size_t vertex_count = 0;
+    size_t edgeCount() const { return static_cast<size_t>(offsets[vertex_count]); }
+    size_t degree(size_t v) const { return static_cast<size_t>(offsets[v + 1] - offsets[v]); }
+};
+// O(V + E), split over the pool for large graphs
+template <typename T>
+bool isWellFormed(const CsrGraph<T>& graph, WorkStealingPool* pool = nullptr);
+// --- Breadth-First Search ---
+// Distance of vertices not reachable from the source
+template <typename T>
+constexpr T UNREACHED = std::numeric_limits<T>::max();
+// Direction-optimizing switch points (Beamer et al.): go bottom-up once the frontier's
+// edges exceed 1/ALPHA of the unexplored edges, back to top-down once the frontier holds
+// fewer than 1/BETA of the vertices
+constexpr size_t BFS_ALPHA = 15;
+constexpr size_t BFS_BETA = 18;
+// Steps with at least this many frontier edges (top-down) or vertices (bottom-up) are
+// split over the pool
+constexpr size_t PARALLEL_MIN_STEP = size_t{1} << 14;
+struct BfsStats {
+    size_t levels = 0;          // Steps run, including the final empty one
+    size_t bottom_up_steps = 0;
+    size_t parallel_steps = 0;
+};
+// Writes each vertex's hop count from 'source' (UNREACHED if none) to distances[0..V) and
+// returns the number of vertices reached. Top-down steps expand a sparse frontier queue;
+// with 'symmetric' (every edge listed both ways, i.e. an undirected graph) large frontiers
+// switch to bottom-up steps, where unvisited vertices look for a parent in a bitmap of the
+// frontier and stop at the first hit. Visited vertices are tracked in an atomic bitmap, so
+// the distances do not depend on how steps are split over the pool.
+template <typename T>
+size_t breadthFirst(const CsrGraph<T>& graph, T source, T* distances, bool symmetric = false,
+                    WorkStealingPool* pool = nullptr, BfsStats* stats = nullptr);
+// --- Depth-First Orders ---
+// Preorder of the vertices reachable from 'source', following edges in CSR order (the
+// order a recursive DFS visits them) with an explicit stack. Returns the count written.
+template <typename T>
+size_t depthFirst(const CsrGraph<T>& graph, T source, T* order);
+// Kahn's algorithm: the vertices without in-edges in id order, then each vertex as its last
+// in-edge is removed; 'order' doubles as the work queue. Returns the count written, which
+// is less than vertex_count if the graph has a cycle.
+template <typename T>
+size_t topologicalOrder(const CsrGraph<T>& graph, T* order);
+} // namespace bdi::runtime::traversal
+#endif // BDI_RUNTIME_GRAPHTRAVERSAL_HPP
@@ -0,0 +1,84 @@
+#include "TraversalOps.hpp"
+#include "MemoryManager.hpp"
+#include "WorkStealingPool.hpp"
+#include <vector>
+namespace bdi::runtime::traversal {
+namespace {
+constexpr uint32_t kModeShift = 8;
+constexpr uint32_t kSymmetric = 1u << 10;
+}
+uint32_t encodeTraverse(const TraverseSpec& spec) {
+    uint32_t encoded = static_cast<uint8_t>(spec.index_type) | (static_cast<uint32_t>(spec.mode) << kModeShift);
+    if (spec.symmetric) encoded |= kSymmetric;
+    return encoded;
+}
+std::optional<TraverseSpec> decodeTraverse(uint32_t encoded) {
+    if (encoded >> 11) return std::nullopt;
+    TraverseSpec spec;
+    spec.index_type = static_cast<BDIType>(encoded & 0xFF);
+    if (spec.index_type != BDIType::UINT32 && spec.index_type != BDIType::UINT64) return std::nullopt;
+    const uint32_t mode = (encoded >> kModeShift) & 0x3;
+    if (mode > static_cast<uint32_t>(TraversalMode::TOPOLOGICAL)) return std::nullopt;
+    spec.mode = static_cast<TraversalMode>(mode);
+    spec.symmetric = encoded & kSymmetric;
+    return spec;
+}
+} // namespace bdi::runtime::traversal
+namespace bdi::runtime::vm_ops {
+namespace {
+struct Extent {
+    uint64_t address = 0;
+    uint64_t bytes = 0;
+    bool overlaps(const Extent& other) const { return address < other.address + other.bytes && other.address < address + bytes; }
+};
+// Byte range of 'count' indices, checked against the memory's bounds and alignment
+template <typename T>
+VMStatus checkArray(const MemoryManager& memory, uint64_t address, uint64_t count, Extent& extent) {
+    if (__builtin_mul_overflow(count, sizeof(T), &extent.bytes)) return VMStatus::OUT_OF_RANGE;
+    extent.address = address;
+    if (address > memory.getTotalSize() || extent.bytes > memory.getTotalSize() - address) return VMStatus::MEMORY_FAULT;
+    if (reinterpret_cast<uintptr_t>(memory.getRawPointer(address)) % sizeof(T) != 0) return VMStatus::MEMORY_FAULT;
+    return VMStatus::OK;
+}
+template <typename T>
+VMStatus run(MemoryManager& memory, const traversal::TraverseSpec& spec, uint64_t offsets, uint64_t targets,
+             uint64_t vertex_count, uint64_t source, uint64_t output, uint64_t& count) {
+    // UNREACHED must not be a vertex id or distance
+    if (vertex_count >= traversal::UNREACHED<T>) return VMStatus::OUT_OF_RANGE;
+    if (spec.mode != traversal::TraversalMode::TOPOLOGICAL && source >= vertex_count) return VMStatus::OUT_OF_RANGE;
+    Extent offsets_extent, targets_extent, output_extent;
+    for (VMStatus status : {checkArray<T>(memory, offsets, vertex_count + 1, offsets_extent), checkArray<T>(memory, output, vertex_count, output_extent)}) {
+        if (status != VMStatus::OK) return status;
+    }
+    // The traversals index host arrays with these values, so validate and walk a private copy:
+    // other tasks can rewrite guest memory between the check and the walk
+    std::vector<T> offsets_copy(static_cast<size_t>(vertex_count) + 1);
+    memory.readMemory(offsets, reinterpret_cast<std::byte*>(offsets_copy.data()), offsets_extent.bytes);
+    traversal::CsrGraph<T> graph{offsets_copy.data(), nullptr, static_cast<size_t>(vertex_count)};
+    if (VMStatus status = checkArray<T>(memory, targets, graph.edgeCount(), targets_extent); status != VMStatus::OK) return status;
+    if (output_extent.overlaps(offsets_extent) || output_extent.overlaps(targets_extent)) return VMStatus::MEMORY_FAULT;
+    std::vector<T> targets_copy(graph.edgeCount());
+    memory.readMemory(targets, reinterpret_cast<std::byte*>(targets_copy.data()), targets_extent.bytes);
+    graph.targets = targets_copy.data();
+    WorkStealingPool* pool = graph.vertex_count + graph.edgeCount() >= traversal::PARALLEL_MIN_STEP ? &computePool() : nullptr;
+    if (!traversal::isWellFormed(graph, pool)) return VMStatus::OUT_OF_RANGE;
+    auto* out = reinterpret_cast<T*>(memory.getRawPointer(output));
+    switch (spec.mode) {
+        case traversal::TraversalMode::BFS: count = traversal::breadthFirst<T>(graph, static_cast<T>(source), out, spec.symmetric, pool); break;
+        case traversal::TraversalMode::DFS: count = traversal::depthFirst<T>(graph, static_cast<T>(source), out); break;
+        case traversal::TraversalMode::TOPOLOGICAL: count = traversal::topologicalOrder<T>(graph, out); break;
+    }
+    memory.markDirty(output, output_extent.bytes);
+    return VMStatus::OK;
+}
+}
+VMStatus tryGraphTraverse(MemoryManager* memory, const traversal::TraverseSpec& spec, uint64_t offsets, uint64_t targets,
+                          uint64_t vertex_count, uint64_t source, uint64_t output, uint64_t& count) {
+    if (!memory) return VMStatus::NO_MEMORY_MANAGER;
+    switch (spec.index_type) {
+        case BDIType::UINT32: return run<uint32_t>(*memory, spec, offsets, targets, vertex_count, source, output, count);
+        case BDIType::UINT64: return run<uint64_t>(*memory, spec, offsets, targets, vertex_count, source, output, count);
+        default: return VMStatus::TYPE_MISMATCH;
+    }
+}
+} // namespace bdi::runtime::vm_ops
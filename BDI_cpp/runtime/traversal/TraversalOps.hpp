@@ -0,0 +1,42 @@
+#ifndef BDI_RUNTIME_TRAVERSALOPS_HPP
+#define BDI_RUNTIME_TRAVERSALOPS_HPP
+#include "GraphTraversal.hpp"
+#include "BDITypes.hpp"
+#include "VMStatus.hpp"
+#include <cstdint>
+#include <optional>
+namespace bdi::runtime {
+class MemoryManager;
+}
+namespace bdi::runtime::traversal {
+using bdi::core::types::BDIType;
+// --- GRAPH_TRAVERSE Payload ---
+// Index type in bits 0-7, the mode in bits 8-9 and the symmetric bit. A ChimeraGraphType
+// lowers to a CSR pair in memory; 'directed = false' sets the symmetric bit.
+enum class TraversalMode : uint8_t {
+    BFS,         // output[v] = hop count from the source, or UNREACHED
+    DFS,         // output[0..count) = preorder of the vertices reachable from the source
+    TOPOLOGICAL  // output[0..count) = topological order; the source is ignored
+};
+struct TraverseSpec {
+    BDIType index_type = BDIType::UINT32; // UINT32 or UINT64, for offsets, targets and output
+    TraversalMode mode = TraversalMode::BFS;
+    bool symmetric = false;               // Every edge listed both ways: lets BFS go bottom-up
+};
+uint32_t encodeTraverse(const TraverseSpec& spec);
+std::optional<TraverseSpec> decodeTraverse(uint32_t encoded); // nullopt for unknown bits, modes or index types
+} // namespace bdi::runtime::traversal
+namespace bdi::runtime::vm_ops {
+// GRAPH_TRAVERSE over the CSR graph at 'offsets'/'targets' (see traversal::CsrGraph),
+// writing vertex_count entries at 'output' through the backing store and marking them
+// dirty. 'count' receives the number of vertices reached (BFS, DFS) or ordered
+// (TOPOLOGICAL: less than vertex_count if there is a cycle). Large BFS steps run on
+// computePool(). The offsets and targets are copied out of memory before they are
+// validated, so tasks writing them concurrently cannot break the walk.
+// MEMORY_FAULT if an array is out of bounds or misaligned, or the output overlaps the
+// graph; OUT_OF_RANGE if the source, an offset or a target is out of range or the CSR
+// arrays are malformed.
+VMStatus tryGraphTraverse(MemoryManager* memory, const traversal::TraverseSpec& spec, uint64_t offsets, uint64_t targets,
+                          uint64_t vertex_count, uint64_t source, uint64_t output, uint64_t& count);
+} // namespace bdi::runtime::vm_ops
+#endif // BDI_RUNTIME_TRAVERSALOPS_HPP
@@ -9,6 +9,9 @@
  #include "MetadataStore.hpp"
  #include "VMTypeOperations.hpp" // Include the new operation helpers
  #include "HardwareAbstractionLayer.hpp" // Need HAL access 
+ #include "Tracer.hpp" // Per-thread execution trace rings
+ #include "Profiler.hpp" // Per-opcode/per-node cycle counters
+ #include "Logger.hpp" // Leveled, buffered logging
  #include <iostream>
  #include <stdexcept>
  #include <variant>
@@ -47,8 +50,8 @@
     if (success) {
         return result;
     } else {
-        std::cerr << "VM Error: Cannot convert variant holding " << core::types::bdiTypeToString(getBDIType(value_var))
-                  << " to target type " << core::types::bdiTypeToString(target_bdi_type) << std::endl;
+        BDI_LOG_ERROR(VM, "Cannot convert variant holding " << core::types::bdiTypeToString(getBDIType(value_var))
+                  << " to target type " << core::types::bdiTypeToString(target_bdi_type));
         return std::nullopt;
     }
  }
@@ -68,9 +71,9 @@ bool setOutputValueVariant(ExecutionContext& ctx, const BDINode& node, PortIndex
      BDIType value_actual_type = getBDIType(value_var);
      if (output_def_type != BDIType::UNKNOWN && !core::types::TypeSystem::areCompatible(output_def_type, value_actual_type) &&
  !core::types::TypeSystem::canImplicitlyConvert(value_actual_type, output_def_type)) {
-         std::cerr << "VM Error: Output type mismatch for Node " << node.id << " Port " << output_idx
+         BDI_LOG_ERROR(VM, "Output type mismatch for Node " << node.id << " Port " << output_idx
                    << ". Declared: " << core::types::bdiTypeToString(output_def_type)
-                   << ", Actual: " << core::types::bdiTypeToString(value_actual_type) << std::endl;
+                   << ", Actual: " << core::types::bdiTypeToString(value_actual_type));
          // If implicit conversion is allowed, should we convert before setting? For now, require match or explicit conversion node.
          return false;
      }
@@ -150,6 +153,31 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
         return vm_state_; 
     }
      NodeID BDIVirtualMachine::getCurrentNodeId() const { return current_node_id_; } 
+    // --- Profiler Mode --- 
+    void BDIVirtualMachine::setProfilingEnabled(bool enabled) { 
+        Profiler::global().setEnabled(enabled); 
+    }
+    ProfileData BDIVirtualMachine::getProfile() const { 
+        return Profiler::global().snapshot(); 
+    }
+    // --- Checkpoint / Restore --- 
+    bool BDIVirtualMachine::saveCheckpoint(const std::string& path, bool incremental) { 
+        if (!memory_manager_ || !execution_context_) return false; 
+        if (!checkpointer_) checkpointer_ = std::make_unique<VMCheckpointer>(*memory_manager_, *execution_context_); 
+        return incremental ? checkpointer_->writeIncremental(path, current_node_id_) 
+                           : checkpointer_->writeFull(path, current_node_id_); 
+    }
+    bool BDIVirtualMachine::restoreCheckpoint(const std::vector<std::string>& chain) { 
+        auto restored = VMCheckpointer::restore(chain); 
+        if (!restored) return false; 
+        checkpointer_.reset(); // Refers to the old context and memory; the next save starts a new chain 
+        const bool context_active = current_context_ == execution_context_.get(); 
+        memory_manager_ = std::move(restored->memory); 
+        execution_context_ = std::move(restored->context); 
+        if (context_active) current_context_ = execution_context_.get(); 
+        current_node_id_ = restored->current_node_id; 
+        return true; 
+    }
     // --- Internal Signaling --- 
     void BDIVirtualMachine::signalPaused() { 
          std::lock_guard lock(vm_mutex_); 
@@ -194,7 +222,12 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                  } 
             } 
             // --- Execute Node --- 
-            bool success = executeNode(current_node, graph); 
+            bool success; 
+{ 
+    TraceScope trace(Tracer::global(), current_node.id, static_cast<uint16_t>(current_node.operation), current_task_id_); 
+    ProfileScope profile(Profiler::global(), current_context_, current_node.id, static_cast<uint16_t>(current_node.operation)); 
+    success = executeNode(current_node, graph); 
+} 
             // --- Debugger Post-Hook --- 
             // if (debugger_) { debugger_->onPostNodeExecute(current_node_id, success); } 
             if (!success) { signalPaused(); return VMExecResult::ERROR; } // Halt on error 
@@ -281,7 +314,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
     for (size_t i = 0; i < node.data_inputs.size(); ++i) {
         auto input_var_opt = ctx.getPortValue(node.data_inputs[i]);
         if (!input_var_opt) { /* ... Error ... */ return false; }
-            std::cerr << "VM Error: Missing input " << i << " for Node " << node.id << std::endl;
+            BDI_LOG_ERROR(VM, "Missing input " << i << " for Node " << node.id);
             return false;
         }
         inputs.push_back(input_var_opt.value());
@@ -343,7 +376,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                  // load/find the service graph, execute it (passing args), get result, 
                  // restore state, place result in context, and continue. 
                  // Requires VM support for nested/synchronous graph execution. 
-                 std::cout << "VM Op: OS_SERVICE_CALL (Complex Stub) - Node " << node.id << std::endl; 
+                 BDI_LOG_DEBUG(VM, "OS_SERVICE_CALL (Complex Stub) - Node " << node.id); 
                  // Placeholder: Return dummy value 
                  result_var = BDIValueVariant{uint64_t{0xBEEF}}; // Dummy result 
                  break; 
@@ -383,7 +416,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                 // auto previous_state = recurrence_manager_->readPreviousState(source_state_node_id); 
                 // if (!previous_state) throw BDIExecutionError("Previous recurrent state not found for node " + std::to_string(source_state_n
                 // result_var = previous_state.value(); 
-                std::cout << "VM Op: RECUR_READ_STATE (Stub) for Node " << node.id << " reading from " << source_state_node_id << std::endl; 
+                BDI_LOG_DEBUG(VM, "RECUR_READ_STATE (Stub) for Node " << node.id << " reading from " << source_state_node_id); 
                 result_var = BDIValueVariant{int32_t{0}}; // Dummy value 
                 break; 
             } 
@@ -391,7 +424,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                   if (inputs.empty()) throw BDIExecutionError("RECUR_WRITE needs value input"); 
                   // Store input value associated with *this* node's ID for next step 
                   // recurrence_manager_->writeCurrentState(node.id, inputs[0]); 
-                  std::cout << "VM Op: RECUR_WRITE_STATE (Stub) for Node " << node.id << std::endl; 
+                  BDI_LOG_DEBUG(VM, "RECUR_WRITE_STATE (Stub) for Node " << node.id); 
                   break; // No output value 
             }  
              case OpType::LEARN_GET_GRADIENT: { 
@@ -434,7 +467,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                  NodeID service_entry_node = findServiceEntryNode(service_id); // Lookup service 
                  if (service_entry_node == 0) throw BDIExecutionError("OS Service not found: " + std::to_string(service_id)); 
                  // 1. Prepare Arguments for service call (stage them) 
-                 ctx.next_arguments_.clear(); 
+                 ctx.stageArguments(node.data_inputs.size()); 
                  for(size_t i = 0; i < node.data_inputs.size(); ++i) { 
                      auto arg_opt = ctx.getPortValue(node.data_inputs[i]); 
                      if (!arg_opt) throw BDIExecutionError("Missing argument for OS Service Call"); 
@@ -477,7 +510,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                 // Assume service graph uses the *same* context for simplicity, OR 
                 // implement temporary context switching for services if needed. 
                 // 1. Stage arguments (already done conceptually) 
-                ctx.next_arguments_.clear(); 
+                ctx.stageArguments(node.data_inputs.size()); 
                 for(size_t i = 0; i < node.data_inputs.size(); ++i) { /* ... get inputs -> setNextArgument ... */ } 
                 // 2. Determine where execution should resume *after* the service call 
                 NodeID resume_node = 0; 
@@ -538,7 +571,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                  if (inputs.empty()) { op_success = false; break; }
                  auto condition = vm_ops::convertValue<bool>(inputs[0]);
                  if (!condition || !condition.value()) {
-                      std::cerr << "VM ASSERTION FAILED: Node " << node.id << "." << std::endl;
+                      BDI_LOG_ERROR(VM, "ASSERTION FAILED: Node " << node.id << ".");
                       // ... (retrieve metadata) ...
                       op_success = false;
                  }
@@ -673,7 +706,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
              }
             // Default
             default: /* ... Error ... */ op_success = false;
-                std::cerr << "VM Error: UNIMPLEMENTED/UNKNOWN Operation Type (" << static_cast<int>(node.operation) << ") for Node " << node.id<< std::endl;
+                BDI_LOG_ERROR(VM, "UNIMPLEMENTED/UNKNOWN Operation Type (" << static_cast<int>(node.operation) << ") for Node " << node.id);
                 op_success = false;
         }
     } catch (const std::exception& e) { /* ... */ op_success = false; }
@@ -688,7 +721,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
          // Only try to store if op succeeded and produced non-error result
          if (!std::holds_alternative<std::monostate>(result_var) && getBDIType(result_var) == BDIType::VOID && node.getOutputType(0) !=BDIType::VOID) {
              // Handle void result assignment if needed, currently error
-             std::cerr << "VM Error: Operation for Node " << node.id << " produced VOID for non-VOID output port 0." << std::endl;
+             BDI_LOG_ERROR(VM, "Operation for Node " << node.id << " produced VOID for non-VOID output port 0.");
              op_success = false;
          } else if (std::holds_alternative<std::monostate>(result_var)) {
                  if (!setOutputValueVariant(ctx, node, 0, result_var)) { // Assume output 0
@@ -698,7 +731,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
             }
          } else if (node.getOutputType(0) != BDIType::VOID) {
              // Operation succeeded but produced monostate for non-void output? Error.
-             std::cerr << "VM Error: Op Node " << node.id << " succeeded but produced no value for non-VOID output 0." << std::endl;
+             BDI_LOG_ERROR(VM, "Op Node " << node.id << " succeeded but produced no value for non-VOID output 0.");
              op_success = false;
          }
           // If output is VOID and result is monostate, that's fine.
@@ -713,11 +746,11 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                 // Assume inputs 0..N-1 are arguments, Input N is Function Target (e.g., NodeID or FuncPtr)
                 // This convention needs to be defined for the CALL operation.
                 size_t num_args = node.data_inputs.size(); // Assume all inputs are args for now
-                ctx.next_arguments_.clear(); // Clear previous staged args
+                ctx.stageArguments(num_args); // Fresh slots for this call's args
                 for (PortIndex i = 0; i < num_args; ++i) {
                     auto arg_opt = ctx.getPortValue(node.data_inputs[i]);
                     if (!arg_opt) {
-                         std::cerr << "VM Error: Missing argument " << i << " for CALL Node " << node.id << std::endl;
+                         BDI_LOG_ERROR(VM, "Missing argument " << i << " for CALL Node " << node.id);
                         return false;
                      }
                     ctx.setNextArgument(i, arg_opt.value());
@@ -730,7 +763,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                  if (node.data_inputs.size() > 0) {
                       auto ret_val_opt = ctx.getPortValue(node.data_inputs[0]);
                       if (!ret_val_opt) {
-                          std::cerr << "VM Error: Missing return value input for RETURN Node " << node.id << std::endl;
+                          BDI_LOG_ERROR(VM, "Missing return value input for RETURN Node " << node.id);
                           return false; // Require input if specified? Or allow void return?
                       }
                       ctx.setCurrentReturnValue(ret_val_opt.value());
@@ -749,7 +782,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
              // Assume target function entry NodeID is in control_outputs[0]
              // Assume return address NodeID is in control_outputs[1] (Our convention)
              if (node.control_outputs.size() < 2) { /* ... error ... */ next_id = 0; }
-                  std::cerr << "VM Error: CALL Node " << node.id << " requires at least 2 control outputs (Target, Return Address)." << std::endl;
+                  BDI_LOG_ERROR(VM, "CALL Node " << node.id << " requires at least 2 control outputs (Target, Return Address).");
                   next_id = 0; // Halt
              } else {
                  NodeID call_target = node.control_outputs[0];
@@ -771,7 +804,7 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                      if (caller_node_opt) {
                          // Set the output port of the CALL node (Convention: Port 0)
                          if (!setOutputValueVariant(ctx, caller_node_opt.value().get(), 0, frame.return_value.value())) {
-                              std::cerr << "VM Warning: Failed to set return value on CALL Node " << frame.caller_node_id << std::endl;
+                              BDI_LOG_WARN(VM, "Failed to set return value on CALL Node " << frame.caller_node_id);
                          }
                 // How does the caller get the return value?
                 // Convention: The node representing the CALL operation itself can have an output port.
@@ -784,11 +817,11 @@ BDIVirtualMachine::VMExecResult BDIVirtualMachine::runSlice(BDIGraph& graph, Nod
                 // bool BDIVirtualMachine::executeNode(BDINode& node, BDIGraph& graph);
                 // NodeID BDIVirtualMachine::determineNextNode(BDINode& node, BDIGraph& graph);
                      } else {
-                         std::cerr << "VM Warning: Original CALL node " << frame.caller_node_id << " not found for return value." << std::endl;
+                         BDI_LOG_WARN(VM, "Original CALL node " << frame.caller_node_id << " not found for return value.");
                      }
                 } // else: void return, do nothing
              } else {
-                std::cerr << "VM Warning: RETURN executed with empty call stack. Halting." << std::endl;
+                BDI_LOG_WARN(VM, "RETURN executed with empty call stack. Halting.");
                 next_id = 0;
             }
             break;
@@ -949,16 +982,16 @@ break;
                  auto condition_opt = getInputValueTyped<bool>(ctx, node, 0);
                  if (!condition_opt) return false; // Input error already printed
                  if (!condition_opt) {
-                      std::cerr << "VM Error: ASSERT Node " << node.id << " condition input missing or invalid." << std::endl;
+                      BDI_LOG_ERROR(VM, "ASSERT Node " << node.id << " condition input missing or invalid.");
                      return false;
                  }
                  if (!condition_opt.value()) {
                      // Assertion failed!
-                     std::cerr << "VM ASSERTION FAILED: Node " << node.id << "." << std::endl;
+                     BDI_LOG_ERROR(VM, "ASSERTION FAILED: Node " << node.id << ".");
                      // Retrieve associated semantic tag for more info?
                       const MetadataVariant* meta = metadata_store_->getMetadata(node.metadata_handle); // Need access to MetadataStore
                      if (meta && std::holds_alternative<SemanticTag>(*meta)) {
-                          std::cerr << "  Description: " << std::get<SemanticTag>(*meta).description << std::endl;
+                          BDI_LOG_ERROR(VM, "Description: " << std::get<SemanticTag>(*meta).description);
                      }
                      return false; // Halt execution on failed assertion
                  }
@@ -966,7 +999,7 @@ break;
                  break;
             }
             case OpType::META_VERIFY_PROOF: {
-                 std::cout << "  Op: VERIFY_PROOF (Stub) for Node " << node.id << std::endl;
+                 BDI_LOG_DEBUG(VM, "VERIFY_PROOF (Stub) for Node " << node.id);
                  // STUB:
                  // 1. Get metadata handle: node.metadata_handle
                  // 2. Access MetadataStore: metadata_store_->getMetadata(handle)
@@ -978,10 +1011,10 @@ break;
                  if (meta && std::holds_alternative<ProofTag>(*meta)) {
                      const ProofTag& tag = std::get<ProofTag>(*meta);
                      if (tag.system != ProofTag::ProofSystem::NONE) {
-                        std::cout << "  Op: VERIFY_PROOF for Node " << node.id << " (System: " << static_cast<int>(tag.system) << ")" << std::endl;
+                        BDI_LOG_DEBUG(VM, "VERIFY_PROOF for Node " << node.id << " (System: " << static_cast<int>(tag.system) << ")");
                         // Call the verifier
                         if (!proof_verifier_->verify(tag, graph, node.id)) {
-                             std::cerr << "VM Error: Proof verification FAILED for Node " << node.id << "." << std::endl;
+                             BDI_LOG_ERROR(VM, "Proof verification FAILED for Node " << node.id << ".");
                             return false; // Halt on verification failure
                         }
                         // std::cout << "    Proof verification SUCCEEDED (Stub)." << std::endl;
@@ -989,7 +1022,7 @@ break;
                          // std::cout << "  Op: VERIFY_PROOF for Node " << node.id << " (No proof system specified in tag)." << std::endl;
                      }
                  } else {
-                      std::cerr << "VM Warning: META_VERIFY_PROOF Node " << node.id << " has no valid ProofTag metadata." << std::endl;
+                      BDI_LOG_WARN(VM, "META_VERIFY_PROOF Node " << node.id << " has no valid ProofTag metadata.");
                       // Fail? Or succeed trivially? For now, succeed.
                  }
                  break;
@@ -1041,13 +1074,13 @@ break;
     auto executeBinaryOpHelper =
         [&](const std::string& opName, auto operation_lambda) -> bool {
         if (node.data_inputs.size() != 2 || node.data_outputs.size() != 1) {
-            std::cerr << "VM Error: Incorrect number of ports for " << opName << " Node " << node.id << std::endl;
+            BDI_LOG_ERROR(VM, "Incorrect number of ports for " << opName << " Node " << node.id);
             return false;
         }
         auto lhs_var_opt = ctx.getPortValue(node.data_inputs[0]);
         auto rhs_var_opt = ctx.getPortValue(node.data_inputs[1]);
         if (!lhs_var_opt || !rhs_var_opt) {
-            std::cerr << "VM Error: Missing inputs for " << opName << " Node " << node.id << std::endl;
+            BDI_LOG_ERROR(VM, "Missing inputs for " << opName << " Node " << node.id);
           return false;
         }
         BDIValueVariant result_var = std::monostate{}; // Start with error state
@@ -1061,7 +1094,7 @@ break;
         BDIType type2 = getBDIType(rhs_var_opt.value());
         BDIType promoted_type = TypeSys::getPromotedType(type1, type2);
         if(promoted_type == BDIType::UNKNOWN) {
-            std::cerr << "VM Error: Cannot promote types for " << opName << " Node " << node.id << std::endl;
+            BDI_LOG_ERROR(VM, "Cannot promote types for " << opName << " Node " << node.id);
             return false;
         }
         try {
@@ -1092,16 +1125,16 @@ break;
             }
             // --- Add BOOL logic if needed --
             else {
-                 std::cerr << "VM Error: Unhandled promoted type " << core::types::bdiTypeToString(promoted_type) << " in " << opName << " Node " <<node.id << std::endl;
+                 BDI_LOG_ERROR(VM, "Unhandled promoted type " << core::types::bdiTypeToString(promoted_type) << " in " << opName << " Node " <<node.id);
                  return false;
             }
         } catch (const std::exception& e) {
-             std::cerr << "VM Exception during " << opName << " Node " << node.id << ": " << e.what() << std::endl;
+             BDI_LOG_ERROR(VM, "Exception during " << opName << " Node " << node.id << ": " << e.what());
             return false;
         }
         // Check for error state in result_var before setting output
         if (std::holds_alternative<std::monostate>(result_var)) {
-             std::cerr << "VM Error: Operation failed for " << opName << " Node " << node.id << std::endl;
+             BDI_LOG_ERROR(VM, "Operation failed for " << opName << " Node " << node.id);
             return false;
         }
         return setOutputValueVariant(ctx, node, 0, result_var);
@@ -1127,7 +1160,7 @@ break;
                    }
               }, val_opt.value());
          } catch (const std::exception& e) {
-             std::cerr << "VM Exception during " << opName << " Node " << node.id << ": " << e.what() << std::endl;
+             BDI_LOG_ERROR(VM, "Exception during " << opName << " Node " << node.id << ": " << e.what());
              return false;
          }
           if (std::holds_alternative<std::monostate>(result_var)) return false; // Operation failed or wasn't applicable
@@ -1254,8 +1287,7 @@ break;
                  // --- Add cases for all target types specified by CONV operations --
                  // Need specific logic for BITCAST, EXTEND, TRUNC etc.
                  else {
-                      std::cerr << "VM Error: Unhandled CONV target type " << core::types::bdiTypeToString(target_type) << " for Node " << node.id <<
- std::endl;
+                      BDI_LOG_ERROR(VM, "Unhandled CONV target type " << core::types::bdiTypeToString(target_type) << " for Node " << node.id);
                      return false;
                  }
                  if (std::holds_alternative<std::monostate>(result_var)) return false; // Conversion failed
@@ -1273,13 +1305,13 @@ break;
                throw BDIExecutionError("Unknown or unimplemented BDI Operation Type: " + std::to_string(static_cast<int>(node.operation)));
         }
     } catch (const BDIExecutionError& e) {
-        std::cerr << "VM Execution Error (Node " << node.id << ", Op " << static_cast<int>(node.operation) << "): " << e.what() << std::endl;
+        BDI_LOG_ERROR(VM, "Execution Error (Node " << node.id << ", Op " << static_cast<int>(node.operation) << "): " << e.what());
         op_success = false;
     } catch (const std::exception& e) {
-        std::cerr << "VM Unexpected Exception (Node " << node.id << ", Op " << static_cast<int>(node.operation) << "): " << e.what() << std::endl;
+        BDI_LOG_ERROR(VM, "Unexpected Exception (Node " << node.id << ", Op " << static_cast<int>(node.operation) << "): " << e.what());
         op_success = false;
     } catch (...) {
-        std::cerr << "VM Unknown Exception (Node " << node.id << ", Op " << static_cast<int>(node.operation) << ")" << std::endl;
+        BDI_LOG_ERROR(VM, "Unknown Exception (Node " << node.id << ", Op " << static_cast<int>(node.operation) << ")");
         op_success = false;
     }
     // --- Store Result --
@@ -1300,127 +1332,45 @@ break;
     }
     return op_success;
  }
-                std::cerr << "VM Error: UNIMPLEMENTED/UNKNOWN Operation Type (" << static_cast<int>(node.operation) << ") for Node " << node.id
- << std::endl;
+                BDI_LOG_ERROR(VM, "UNIMPLEMENTED/UNKNOWN Operation Type (" << static_cast<int>(node.operation) << ") for Node " << node.id);
                 return false;
         }
     } catch (const std::exception& e) {
-        std::cerr << "VM Exception during execution of Node " << node.id << " (Op: " << static_cast<int>(node.operation) << "): " << e.what() << std::endl;
+        BDI_LOG_ERROR(VM, "Exception during execution of Node " << node.id << " (Op: " << static_cast<int>(node.operation) << "): " << e.what());
         return false;
     } catch (...) {
-        std::cerr << "VM Unknown exception during execution of Node " << node.id << " (Op: " << static_cast<int>(node.operation) << ")" << std::endl;
+        BDI_LOG_ERROR(VM, "Unknown exception during execution of Node " << node.id << " (Op: " << static_cast<int>(node.operation) << ")");
         return false;
     }
     return true; // Assume success if no error/exception and not explicitly failed
  }
    // determineNextNode remains largely the same as before, handling control flow logic
-   // --- Update VM Main Loop --- 
-   // The main loop in BDIVirtualMachine::execute needs modification to handle 
-   // yields, halts, waits, and dispatches triggered by SYS_* ops. 
-   // E.g., After executeNode returns true: 
-   // if (yield_requested_) { /* Switch to scheduler graph */ } 
-   // else if (task_halt_requested_) { /* Remove task, switch to scheduler */ } 
-   // else if (wait_requested_) { /* Move task to wait queue, switch to scheduler */ } 
-   // else { current_node_id_ = determineNextNode(...); } 
-   // --- Simplified OS Run Loop --- 
- void BDIVirtualMachine::runOS() { 
-    is_os_running_ = true; // Add member flag 
-    current_task_id_ = 0; // Start with no task (Scheduler runs first) 
-    current_context_ = scheduler_context_.get(); // Assume dedicated scheduler context 
-    current_node_id_ = SCHEDULER_ENTRY_NODE_ID; // Start scheduler 
-    uint64_t current_timeslice = DEFAULT_TIMESLICE;
-    std::cout << "BDIOS: Starting Scheduler Loop..." << std::endl; 
-    // Initial jump to scheduler graph entry point (assumed loaded) 
-    current_node_id_ = SCHEDULER_ENTRY_NODE_ID; // Predefined constant 
-    while(is_os_running_) { 
-        // Execute Scheduler Logic (runs until it performs SYS_DISPATCH or SYS_WAIT_EVENT)
-        // Use current context (either scheduler or task) 
-        BDIGraph& graph_to_run = (current_task_id_ == 0) ? *scheduler_graph_ : findGraphForTask(current_task_id_); 
-        VMExecResult result = runTaskSlice(graph_to_run, current_node_id_, current_timeslice); 
-        // This execution needs its own context or operate carefully on shared state 
-        std::cout << "BDIOS: Running Scheduler..." << std::endl; 
-        // For simplicity, assume scheduler logic finds next task and sets up state 
-        // then signals VM via a conceptual "dispatch request" state 
-        // runSlice(*scheduler_graph_, SCHEDULER_ENTRY_NODE_ID); // Simplified conceptual call 
-        // --- Simulate Scheduler Finding Task --- 
-        uint64_t next_task_id = 1; // Assume task 1 is ready 
-        NodeID resume_at = 100; // Assume task 1 resumes at node 100 
-        std::cout << "BDIOS Scheduler: Dispatching Task " << next_task_id << " at Node " << resume_at << std::endl; 
-        // --- End Simulation --- 
-        // Perform Context Switch & Run Task Slice 
-        if (current_task_id_ != 0) { 
-             if (!saveCurrentContext(current_task_id_)) { /* Error */ is_os_running_ = false; continue; } 
-        } 
-        if (!restoreContext(next_task_id)) { 
-            // Create new context if restore fails? 
-             std::cerr << "BDIOS Error: Failed to restore context for Task " << next_task_id << std::endl; 
-             is_os_running_ = false; continue; 
-        } 
-        current_task_id_ = next_task_id; 
-        current_node_id_ = resume_at; 
-        // Execute the task slice 
-        // Assume graph for task is found based on task_id or stored context 
-        BDIGraph& task_graph = findGraphForTask(current_task_id_); // Needs implementation 
-        VMExecResult result = runTaskSlice(task_graph, current_node_id_, 1000); // Run task 
-        // --- Handle Task Slice Result --- 
-        std::cout << "BDIOS: Task " << current_task_id_ << " finished slice with result: " << static_cast<int>(result) << std::endl; 
-            uint64_t completed_task_id = current_task_id_; // Task that just ran 
-            bool need_to_schedule = false; 
-        switch(result) { 
-            case VMExecResult::YIELDED: 
-            case VMExecResult::COMPLETED: // Treat completion same as yield for now 
-                 // Task goes back to ready queue (scheduler logic handles this implicitly on next run) 
-                 // std::cout << "BDIOS: Task " << completed_task_id << " Yielded/Completed." << std::endl; 
-                 // Inform Scheduler graph via OS_SERVICE_CALL or shared memory state update 
-                 // scheduler_->updateTaskState(completed_task_id, TASK_READY, 0); 
-                  need_to_schedule = true; 
-                 break; // Continue to scheduler loop 
-            case VMExecResult::HALTED_TASK: 
-                 // Task finished permanently (scheduler logic handles removal) 
-                 current_task_id_ = 0; // No current task 
-                 current_context_ = nullptr; 
-                 // Remove from task_contexts_ map? 
-                 // std::cout << "BDIOS: Task " << completed_task_id << " Halted." << std::endl; 
-                 // scheduler_->updateTaskState(completed_task_id, TASK_HALTED, 0); 
-                 // Free resources associated with task? 
-                 need_to_schedule = true; 
-                 break; // Continue to scheduler loop 
-            case VMExecResult::WAITING: 
-                 // Task is waiting for event (scheduler logic handles moving to wait queue) 
-                 // Store wait condition associated with task 
-                 // std::cout << "BDIOS: Task " << completed_task_id << " Waiting." << std::endl; 
-                 // scheduler_->updateTaskState(completed_task_id, TASK_WAITING, /* wait condition */ 0); 
-                 need_to_schedule = true; 
-                 break; // Continue to scheduler loop 
-            case VMExecResult::ERROR: 
-                 // Handle task error: terminate task? Log error? Halt system? 
-                 std::cerr << "BDIOS Error: Task " << current_task_id_ << " encountered execution error. Halting task." << std::endl; 
-                 halt_task_requested_ = true; // Signal halt for next scheduler cycle check 
-                 // scheduler_->updateTaskState(completed_task_id, TASK_HALTED, /* error code */ 1); 
-                 need_to_schedule = true; 
-                 break; // Continue to scheduler loop 
-        } 
-             // --- Switch to Scheduler (if needed or always after slice?) --- 
-             // Always switch back to scheduler context to decide next step 
-             if (completed_task_id != 0) { // If a task was running, save its state 
-                 saveCurrentContext(completed_task_id); // Save task context 
-             } 
-             restoreContext(0); // Restore Scheduler context (assuming TaskID 0 is scheduler) 
-             current_task_id_ = 0; 
-             current_node_id_ = SCHEDULER_RESUME_NODE_ID; // Where scheduler continues after task ran 
-             // --- Scheduler Logic determines next task --- 
-             // The next iteration of the while loop runs the scheduler graph... 
-             // Scheduler graph eventually hits SYS_DISPATCH, setting VM state... 
-             // The runTaskSlice call will then run the dispatched task. 
-            // Need explicit exit condition for runOS loop 
-            // if (scheduler reports no ready tasks and no waiting tasks?) is_os_running_ = false; 
-        } // End while(is_os_running_) 
-        std::cout << "BDIOS: Exiting OS Loop." << std::endl; 
-} 
+ // --- BDIOS Run Loop --- 
+ // Tasks run M:N on TaskScheduler workers. Each worker owns a TaskEngine; SYS_YIELD, 
+ // SYS_WAIT_EVENT and SYS_HALT_TASK end the slice and the scheduler requeues, parks 
+ // or retires the TCB, so a task may resume on a different worker next time. 
+ void BDIVirtualMachine::runOS(size_t worker_count) { 
+    TaskScheduler os(memory_manager_.get(), worker_count, TaskScheduler::DEFAULT_TIMESLICE); 
+    if (scheduler_) { 
+        // Scheduler logic reports task state changes (WAITING, HALTED, ...) 
+        os.setStateListener([this](uint64_t task_id, TaskStatus status) { 
+            scheduler_->updateTaskState(task_id, static_cast<int>(status), 0); 
+        }); 
+        while (auto tcb = scheduler_->getNextTaskToRun()) os.submitTask(std::move(tcb)); 
+    } 
+    BDI_LOG_INFO(SCHEDULER, "BDIOS: Starting " << os.getWorkerCount() << " scheduler worker(s)..."); 
+    os.start(); 
+    if (!os.waitForIdle()) { 
+        BDI_LOG_WARN(SCHEDULER, "BDIOS: Tasks still waiting on events with no runnable sender."); 
+    } 
+    os.stop(); 
+    BDI_LOG_INFO(SCHEDULER, "BDIOS: Exiting OS Loop (" << os.getSliceCount() << " slices, " 
+              << os.getMigrationCount() << " migrations)."); 
+ } 
 // --- Internal Context Switch Logic (Simplified) --- 
 bool BDIVirtualMachine::saveCurrentContext(uint64_t task_id) { 
     if (!current_context_ || task_id == 0) return false; 
-    std::cout << "VM Internal: Saving context for Task " << task_id << " (Resume Node: " << current_node_id_ << ")" << std::endl; 
+    BDI_LOG_DEBUG(VM, "Saving context for Task " << task_id << " (Resume Node: " << current_node_id_ << ")"); 
     // In reality, this would involve copying the ExecutionContext contents 
     // (port_values_, call_stack_) to a structure associated with task_id 
     // managed by the OS/Scheduler layer. It might involve SYS_CONTEXT_SAVE op. 
@@ -1436,7 +1386,7 @@ bool BDIVirtualMachine::saveCurrentContext(uint64_t task_id) {
 } 
 bool BDIVirtualMachine::restoreContext(uint64_t task_id) { 
     if (task_id == 0) return false; 
-    std::cout << "VM Internal: Restoring context for Task " << task_id << std::endl; 
+    BDI_LOG_DEBUG(VM, "Restoring context for Task " << task_id); 
     // Find context structure associated with task_id (managed by OS/Scheduler) 
     // Copy saved state back into this->execution_context_ (port_values_, call_stack_) 
     // This might involve SYS_CONTEXT_RESTORE op. 
@@ -1474,7 +1424,7 @@ bool BDIVirtualMachine::executeNode(BDINode& node, BDIGraph& graph) {
              // 7. Restore original context state. 
              // 8. Get return value(s) from service execution (from context's last_return_value_?) 
              // 9. Set result_var for the OS_SERVICE_CALL node. 
-             std::cout << "VM Op: OS_SERVICE_CALL (Complex Stub) - Service " << service_id << std::endl; 
+             BDI_LOG_DEBUG(VM, "OS_SERVICE_CALL (Complex Stub) - Service " << service_id); 
              result_var = BDIValueVariant{uint64_t{0}}; // Dummy success code 
              break; 
          }
@@ -4,6 +4,9 @@
  #include <memory> // For std::shared_ptr or unique_ptr if VM owns graph
  #include "ProofVerifier.hpp" // Include ProofVerifier
  #include "MetadataStore.hpp" // Include MetadataStore
+ #include "TaskScheduler.hpp" // TaskControlBlock, multi-core BDIOS scheduling
+ #include "Profiler.hpp" // ProfileData
+ #include "VMCheckpointer.hpp" // Checkpoint/restore of context, memory and current node
  namespace bdi::runtime {
  // ... imports ...
  using bdi::core::graph::BDIGraph;
@@ -59,8 +62,9 @@
     // ExecutionContext& getCurrentContextForSave(); // Needs careful state management 
     // ... Constructor takes HAL, MetaStore, Verifier ... 
     // void setScheduler(BDIOSSchedulerInterface* sched); // Set external scheduler logic 
-    // Main execution loop runs the scheduler 
-    void runOS(); 
+    // Main execution loop: runs BDIOS tasks M:N on 'worker_count' threads 
+    // (0 = hardware_concurrency, 1 = the old single-core behaviour) via TaskScheduler 
+    void runOS(size_t worker_count = 0); 
     // Internal function to execute a single task's timeslice 
     VMExecResult runTaskSlice(uint64_t task_id, uint64_t timeslice_instructions);
     //
@@ -70,6 +74,15 @@
     void requestResume(bool single_step = false); 
     VMState getState() const; // Thread-safe getter maybe needed 
     NodeID getCurrentNodeId() const; // Getter for debugger 
+    // Profiler mode: cycle counts per opcode, node and call path across all engines. 
+    // Feed getProfile().toGuidance() to OptimizationEngine::setProfile for profile-guided passes. 
+    void setProfilingEnabled(bool enabled); 
+    ProfileData getProfile() const; 
+    // Checkpoints of the execution context, memory and current node (see VMCheckpointer). 
+    // 'incremental' stores only what changed since the previous checkpoint of this VM. 
+    bool saveCheckpoint(const std::string& path, bool incremental = false); 
+    // Replaces context and memory with [full, incremental...]; memory pages in lazily. 
+    bool restoreCheckpoint(const std::vector<std::string>& chain); 
   private:
     // --- Internal VM State --
     NodeID current_node_id_;
@@ -77,6 +90,7 @@
     verification::ProofVerifier* proof_verifier_; // Store as pointer
     std::unique_ptr<MemoryManager> memory_manager_;
     std::unique_ptr<ExecutionContext> execution_context_;
+    std::unique_ptr<VMCheckpointer> checkpointer_; // Tracks the chain being written
     // TODO: Represent register file / execution context / stack
     // TODO: Interface to MemoryManager
     // TODO: Interface to RuntimeScheduler
@@ -92,20 +106,16 @@
  };
     // Forward declare 
     class BDIOSEventDispatcherInterface; 
-    // --- Task Control Block (Conceptual - Managed by Scheduler Graph) --- 
-    struct TaskControlBlock { 
-        uint64_t task_id; 
-        NodeID resume_node_id; // Where to restart execution 
-        // Pointer/Handle to ExecutionContext state 
-        // Priority, Status (Ready, Running, Waiting, Halted), Wait Condition 
-        // Memory Region List? Capabilities? 
-    }; 
+    // --- Task Control Block --- 
+    // Defined in TaskEngine.hpp: owns the task's ExecutionContext, resume node, status 
+    // and wait condition so the task can migrate between TaskScheduler workers. 
     // --- Scheduler Interface (Implemented by Scheduler Graph Logic) --- 
     class BDIOSSchedulerInterface { // Interface for scheduler interaction 
     public: 
         virtual ~BDIOSSchedulerInterface() = default; 
         // Called by VM after yield/halt/wait or timeslice end 
-        virtual std::optional<TaskControlBlock> getNextTaskToRun() = 0; 
+        // Ownership of the TCB passes to the VM's TaskScheduler; nullptr = no more tasks 
+        virtual std::unique_ptr<TaskControlBlock> getNextTaskToRun() = 0; 
         // Called by VM when task state changes (e.g., becomes WAITING) 
         virtual void updateTaskState(uint64_t task_id, /* New State */ int state, /* Wait condition? */ uint64_t condition) = 0; 
         // Called by OS_SERVICE_CALL for AddTask etc. 
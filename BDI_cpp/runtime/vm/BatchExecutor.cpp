@@ -0,0 +1,483 @@
+#include "BatchExecutor.hpp"
+#include "BDINode.hpp"
+#include "Logger.hpp"
+#include "VMCheckedOperations.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
+namespace bdi::runtime {
+namespace {
+using bdi::core::graph::BDIOperationType;
+// Calls f(T{}) with the C++ element type used to store a column of 'type'
+template <typename F>
+bool visitColumnType(BDIType type, F&& f) {
+    switch (type) {
+        case BDIType::BOOL:
+        case BDIType::UINT8:   f(uint8_t{});  return true;
+        case BDIType::INT8:    f(int8_t{});   return true;
+        case BDIType::INT16:   f(int16_t{});  return true;
+        case BDIType::UINT16:  f(uint16_t{}); return true;
+        case BDIType::INT32:   f(int32_t{});  return true;
+        case BDIType::UINT32:  f(uint32_t{}); return true;
+        case BDIType::INT64:   f(int64_t{});  return true;
+        case BDIType::UINT64:
+        case BDIType::POINTER:
+        case BDIType::NODE_ID:
+        case BDIType::REGION_ID: f(uint64_t{}); return true;
+        case BDIType::FLOAT32: f(float{});    return true;
+        case BDIType::FLOAT64: f(double{});   return true;
+        default: return false;
+    }
+}
+// View a column as T[], converting into 'scratch' only when the element type differs.
+// Floats coerced to integers saturate (NaN to 0): lanes outside the group may hold anything.
+template <typename T>
+const T* coerce(const BatchColumn& column, std::vector<T>& scratch) {
+    const T* result = nullptr;
+    visitColumnType(column.getType(), [&](auto tag) {
+        using S = decltype(tag);
+        if constexpr (std::is_same_v<S, T>) {
+            result = column.data<T>();
+        } else {
+            const S* src = column.data<S>();
+            scratch.resize(column.size());
+            for (size_t i = 0; i < column.size(); ++i) {
+                if constexpr (std::is_floating_point_v<S> && std::is_integral_v<T>) {
+                    auto converted = vm_ops::truncateToInt<T>(src[i]);
+                    scratch[i] = converted ? *converted : std::isnan(src[i]) ? T{0} : src[i] < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+                } else {
+                    scratch[i] = static_cast<T>(src[i]);
+                }
+            }
+            result = scratch.data();
+        }
+    });
+    return result;
+}
+// a op b; integers wrap like vm_ops (computed unsigned, so signed overflow is defined)
+template <typename T, typename Op>
+inline T laneOp(T a, T b, Op op) {
+    if constexpr (std::is_integral_v<T>) return vm_ops::detail::wrapping(a, b, op);
+    else return op(a, b);
+}
+// Runs fn(lane) over the group: a plain counted loop when dense (vectorizable), else over the mask
+template <typename Fn>
+inline void forLanes(bool dense, const std::vector<uint32_t>& lanes, size_t n, Fn&& fn) {
+    if (dense) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+    } else {
+        for (uint32_t i : lanes) fn(i);
+    }
+}
+bool isConstantNode(const BDINode& node) {
+    if (node.operation != BDIOperationType::META_CONST && node.operation != BDIOperationType::META_NOP) return false;
+    return node.payload.isValid() && node.payload.type != BDIType::VOID;
+}
+} // namespace
+// --- BatchColumn ---
+BatchColumn::BatchColumn(BDIType type, size_t lanes) : type_(type), lanes_(lanes) {
+    const size_t bytes = lanes * std::max<size_t>(getBdiTypeSize(type), 1);
+    storage_.assign((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+}
+BatchColumn BatchColumn::broadcast(BDIType type, size_t lanes, const BDIValueVariant& value) {
+    BatchColumn column(type, lanes);
+    if (lanes == 0 || !column.setLane(0, value)) return column;
+    visitColumnType(type, [&](auto tag) {
+        using T = decltype(tag);
+        T* data = column.data<T>();
+        std::fill(data + 1, data + lanes, data[0]);
+    });
+    return column;
+}
+BDIValueVariant BatchColumn::getLane(size_t lane) const {
+    BDIValueVariant result; // monostate if out of range / unsupported type
+    if (lane >= lanes_) return result;
+    if (type_ == BDIType::BOOL) return BDIValueVariant(data<uint8_t>()[lane] != 0);
+    visitColumnType(type_, [&](auto tag) {
+        using T = decltype(tag);
+        result = BDIValueVariant(data<T>()[lane]);
+    });
+    return result;
+}
+bool BatchColumn::setLane(size_t lane, const BDIValueVariant& value) {
+    if (lane >= lanes_) return false;
+    bool stored = false;
+    visitColumnType(type_, [&](auto tag) {
+        using T = decltype(tag);
+        std::visit([&](auto&& v) {
+            using V = std::decay_t<decltype(v)>;
+            if constexpr (std::is_arithmetic_v<V>) {
+                data<T>()[lane] = type_ == BDIType::BOOL ? static_cast<T>(v != V{}) : static_cast<T>(v);
+                stored = true;
+            }
+        }, value);
+    });
+    return stored;
+}
+// --- BatchExecutor ---
+BatchExecutor::BatchExecutor(size_t batch_size) : batch_size_(batch_size) {
+    clear();
+}
+void BatchExecutor::clear() {
+    columns_.clear();
+    parked_.clear();
+    lane_status_.assign(batch_size_, LaneStatus::RUNNING);
+    return_values_.assign(batch_size_, BDIValueVariant{});
+    last_error_.clear();
+}
+bool BatchExecutor::setInputColumn(const PortRef& port, BatchColumn column) {
+    if (column.size() != batch_size_) {
+        return fail("input column for node " + std::to_string(port.node_id) + " has " +
+                    std::to_string(column.size()) + " lanes, expected " + std::to_string(batch_size_));
+    }
+    columns_[port] = std::move(column);
+    return true;
+}
+const BatchColumn* BatchExecutor::getColumn(const PortRef& port) const {
+    auto it = columns_.find(port);
+    return it != columns_.end() ? &it->second : nullptr;
+}
+std::optional<BDIValueVariant> BatchExecutor::getLaneValue(const PortRef& port, size_t lane) const {
+    const BatchColumn* column = getColumn(port);
+    if (!column || lane >= column->size()) return std::nullopt;
+    return column->getLane(lane);
+}
+bool BatchExecutor::fail(const std::string& message) {
+    last_error_ = message;
+    BDI_LOG_ERROR(VM, "BatchExecutor: " << message);
+    return false;
+}
+const BatchColumn* BatchExecutor::inputColumn(const BDINode& node, size_t input_idx) {
+    if (input_idx >= node.data_inputs.size()) {
+        fail("node " + std::to_string(node.id) + " missing data input " + std::to_string(input_idx));
+        return nullptr;
+    }
+    const PortRef& src = node.data_inputs[input_idx];
+    auto it = columns_.find(src);
+    if (it != columns_.end()) return &it->second;
+    // Constants are materialized lazily as broadcast columns
+    auto src_opt = graph_->getNode(src.node_id);
+    if (src_opt && isConstantNode(src_opt.value()) && src.port_index == 0) {
+        const BDINode& src_node = src_opt.value();
+        auto [pos, inserted] = columns_.emplace(src, BatchColumn::broadcast(src_node.payload.type, batch_size_,
+                                                                            ExecutionContext::payloadToVariant(src_node.payload)));
+        return &pos->second;
+    }
+    fail("input " + std::to_string(input_idx) + " of node " + std::to_string(node.id) + " (from node " +
+         std::to_string(src.node_id) + ") has no value");
+    return nullptr;
+}
+BatchColumn& BatchExecutor::outputColumn(NodeID node_id, PortIndex port_idx, BDIType type) {
+    BatchColumn& column = columns_[PortRef{node_id, port_idx}];
+    if (column.getType() != type || column.size() != batch_size_) column = BatchColumn(type, batch_size_);
+    return column;
+}
+bool BatchExecutor::truthColumn(const BDINode& node, size_t input_idx, std::vector<uint8_t>& out) {
+    const BatchColumn* column = inputColumn(node, input_idx);
+    if (!column) return false;
+    out.resize(batch_size_);
+    return visitColumnType(column->getType(), [&](auto tag) {
+        using T = decltype(tag);
+        const T* src = column->data<T>();
+        for (size_t i = 0; i < batch_size_; ++i) out[i] = src[i] != T{} ? 1 : 0;
+    }) || fail("condition input of node " + std::to_string(node.id) + " is not a scalar");
+}
+void BatchExecutor::finishLanes(const LaneGroup& group) {
+    for (uint32_t lane : group.lanes) lane_status_[lane] = LaneStatus::COMPLETED;
+}
+void BatchExecutor::faultLanes(LaneGroup& group, const std::vector<uint32_t>& faulted, const std::string& reason) {
+    if (faulted.empty()) return;
+    for (uint32_t lane : faulted) lane_status_[lane] = LaneStatus::FAULTED;
+    if (last_error_.empty()) last_error_ = reason + " at node " + std::to_string(group.node);
+    std::vector<uint32_t> remaining;
+    remaining.reserve(group.lanes.size() - faulted.size());
+    std::set_difference(group.lanes.begin(), group.lanes.end(), faulted.begin(), faulted.end(), std::back_inserter(remaining));
+    group.lanes = std::move(remaining);
+    group.dense = false;
+}
+void BatchExecutor::advance(LaneGroup&& group, NodeID target, std::vector<LaneGroup>& out) {
+    if (group.lanes.empty()) return;
+    auto target_opt = target != 0 ? graph_->getNode(target) : std::nullopt;
+    if (!target_opt) { // Falling off the graph ends these lanes, as in the interpreter
+        finishLanes(group);
+        return;
+    }
+    if (target_opt.value().get().control_inputs.size() > 1) {
+        // Control join: wait so that lanes split by an earlier branch can reconverge
+        auto& parked = parked_[target];
+        std::vector<uint32_t> merged;
+        merged.reserve(parked.size() + group.lanes.size());
+        std::merge(parked.begin(), parked.end(), group.lanes.begin(), group.lanes.end(), std::back_inserter(merged));
+        parked = std::move(merged);
+        return;
+    }
+    group.node = target;
+    out.push_back(std::move(group));
+}
+bool BatchExecutor::execute(const BDIGraph& graph, NodeID entry_node_id, uint64_t max_group_steps) {
+    graph_ = &graph;
+    parked_.clear();
+    lane_status_.assign(batch_size_, LaneStatus::RUNNING);
+    return_values_.assign(batch_size_, BDIValueVariant{});
+    last_error_.clear();
+    if (batch_size_ == 0) return true;
+    std::vector<LaneGroup> active;
+    LaneGroup all;
+    all.node = entry_node_id;
+    all.lanes.resize(batch_size_);
+    for (size_t i = 0; i < batch_size_; ++i) all.lanes[i] = static_cast<uint32_t>(i);
+    all.dense = true;
+    active.push_back(std::move(all));
+    uint64_t steps = 0;
+    while (true) {
+        if (active.empty()) {
+            if (parked_.empty()) break;
+            // Release the join holding the most lanes (lowest NodeID on ties)
+            auto best = parked_.begin();
+            for (auto it = parked_.begin(); it != parked_.end(); ++it) {
+                if (it->second.size() > best->second.size()) best = it;
+            }
+            LaneGroup released;
+            released.node = best->first;
+            released.lanes = std::move(best->second);
+            released.dense = released.lanes.size() == batch_size_;
+            parked_.erase(best);
+            active.push_back(std::move(released));
+        }
+        LaneGroup group = std::move(active.back());
+        active.pop_back();
+        if (++steps > max_group_steps) {
+            graph_ = nullptr;
+            return fail("exceeded " + std::to_string(max_group_steps) + " group steps");
+        }
+        if (!step(group, active)) {
+            graph_ = nullptr;
+            return false;
+        }
+    }
+    graph_ = nullptr;
+    return true;
+}
+bool BatchExecutor::step(LaneGroup& group, std::vector<LaneGroup>& out) {
+    auto node_opt = graph_->getNode(group.node);
+    if (!node_opt) return fail("node " + std::to_string(group.node) + " not found");
+    const BDINode& node = node_opt.value();
+    auto next = [&](size_t idx) -> NodeID { return idx < node.control_outputs.size() ? node.control_outputs[idx] : 0; };
+    switch (node.operation) {
+        case BDIOperationType::META_END:
+            finishLanes(group);
+            return true;
+        case BDIOperationType::CTRL_RETURN:
+            if (!node.data_inputs.empty()) {
+                const BatchColumn* column = inputColumn(node, 0);
+                if (!column) return false;
+                for (uint32_t lane : group.lanes) return_values_[lane] = column->getLane(lane);
+            }
+            finishLanes(group);
+            return true;
+        case BDIOperationType::CTRL_BRANCH_COND: {
+            if (node.control_outputs.size() < 2) return fail("CTRL_BRANCH_COND node " + std::to_string(node.id) + " needs two targets");
+            std::vector<uint8_t> cond;
+            if (!truthColumn(node, 0, cond)) return false;
+            LaneGroup taken, not_taken;
+            for (uint32_t lane : group.lanes) (cond[lane] ? taken : not_taken).lanes.push_back(lane);
+            if (not_taken.lanes.empty()) { // Uniform: keep the group (and its dense flag) intact
+                advance(std::move(group), next(0), out);
+            } else if (taken.lanes.empty()) {
+                advance(std::move(group), next(1), out);
+            } else {
+                advance(std::move(not_taken), next(1), out);
+                advance(std::move(taken), next(0), out);
+            }
+            return true;
+        }
+        default:
+            if (!executeData(node, group)) return false;
+            advance(std::move(group), next(0), out);
+            return true;
+    }
+}
+bool BatchExecutor::executeData(const BDINode& node, LaneGroup& group) {
+    using Op = BDIOperationType;
+    const size_t n = batch_size_;
+    const bool dense = group.dense;
+    const auto& lanes = group.lanes;
+    const std::string id_str = std::to_string(node.id);
+    BDIType out_type = node.getOutputType(0);
+    if (out_type == BDIType::UNKNOWN && !node.data_inputs.empty()) {
+        if (const BatchColumn* first = inputColumn(node, 0)) out_type = first->getType();
+    }
+    switch (node.operation) {
+        case Op::META_START:   // Outputs are seeded through setInputColumn
+        case Op::META_NOP:     // Constant NOPs are materialized on first use
+        case Op::META_CONST:
+        case Op::META_COMMENT:
+        case Op::CTRL_JUMP:
+            return true;
+        case Op::ARITH_ADD: case Op::ARITH_SUB: case Op::ARITH_MUL:
+        case Op::ARITH_DIV: case Op::ARITH_MOD:
+        case Op::BIT_AND: case Op::BIT_OR: case Op::BIT_XOR: case Op::BIT_SHL: case Op::BIT_SHR: {
+            BatchColumn& out = outputColumn(node.id, 0, out_type); // Before the inputs: see outputColumn()
+            const BatchColumn* ca = inputColumn(node, 0);
+            const BatchColumn* cb = inputColumn(node, 1);
+            if (!ca || !cb) return false;
+            std::vector<uint32_t> faulted;
+            std::string error;
+            bool ok = visitColumnType(out_type, [&](auto tag) {
+                using T = decltype(tag);
+                std::vector<T> sa, sb;
+                const T* a = coerce<T>(*ca, sa);
+                const T* b = coerce<T>(*cb, sb);
+                T* o = out.template data<T>();
+                switch (node.operation) {
+                    case Op::ARITH_ADD: forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(a[i], b[i], std::plus<>{}); }); break;
+                    case Op::ARITH_SUB: forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(a[i], b[i], std::minus<>{}); }); break;
+                    case Op::ARITH_MUL: forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(a[i], b[i], std::multiplies<>{}); }); break;
+                    case Op::ARITH_DIV:
+                    case Op::ARITH_MOD:
+                        if constexpr (std::is_floating_point_v<T>) {
+                            if (node.operation == Op::ARITH_MOD) { error = "ARITH_MOD requires integers"; return; }
+                        }
+                        for (uint32_t i : lanes) { // Per-lane zero checks; not worth a dense path
+                            if (b[i] == T{}) { faulted.push_back(i); continue; }
+                            if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                                if (b[i] == T(-1) && a[i] == std::numeric_limits<T>::min()) { faulted.push_back(i); continue; }
+                            }
+                            if constexpr (std::is_integral_v<T>) {
+                                o[i] = static_cast<T>(node.operation == Op::ARITH_DIV ? a[i] / b[i] : a[i] % b[i]);
+                            } else {
+                                o[i] = a[i] / b[i];
+                            }
+                        }
+                        break;
+                    default: // Bitwise and shifts
+                        if constexpr (std::is_integral_v<T>) {
+                            using U = std::make_unsigned_t<T>;
+                            constexpr uint64_t width = sizeof(T) * 8;
+                            if (node.operation == Op::BIT_AND) forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(a[i] & b[i]); });
+                            else if (node.operation == Op::BIT_OR) forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(a[i] | b[i]); });
+                            else if (node.operation == Op::BIT_XOR) forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(a[i] ^ b[i]); });
+                            else {
+                                const bool left = node.operation == Op::BIT_SHL;
+                                for (uint32_t i : lanes) {
+                                    const uint64_t s = static_cast<uint64_t>(static_cast<U>(b[i]));
+                                    if (s >= width) { faulted.push_back(i); continue; }
+                                    o[i] = static_cast<T>(left ? static_cast<U>(static_cast<U>(a[i]) << s) : static_cast<U>(static_cast<U>(a[i]) >> s));
+                                }
+                            }
+                        } else {
+                            error = "bitwise op requires integers";
+                        }
+                        break;
+                }
+            });
+            if (!ok) return fail("unsupported result type for node " + id_str);
+            if (!error.empty()) return fail(error + " (node " + id_str + ")");
+            faultLanes(group, faulted, node.operation == Op::BIT_SHL || node.operation == Op::BIT_SHR ?
+                                           "shift amount >= bit width" : "division by zero");
+            return true;
+        }
+        case Op::ARITH_NEG: case Op::ARITH_ABS: case Op::ARITH_INC: case Op::ARITH_DEC: case Op::BIT_NOT: {
+            BatchColumn& out = outputColumn(node.id, 0, out_type);
+            const BatchColumn* ca = inputColumn(node, 0);
+            if (!ca) return false;
+            std::string error;
+            bool ok = visitColumnType(out_type, [&](auto tag) {
+                using T = decltype(tag);
+                std::vector<T> sa;
+                const T* a = coerce<T>(*ca, sa);
+                T* o = out.template data<T>();
+                switch (node.operation) {
+                    case Op::ARITH_NEG:
+                        if constexpr (std::is_unsigned_v<T>) error = "cannot negate unsigned value";
+                        else forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(T(0), a[i], std::minus<>{}); });
+                        break;
+                    case Op::ARITH_ABS:
+                        if constexpr (std::is_floating_point_v<T>) forLanes(dense, lanes, n, [&](size_t i) { o[i] = std::fabs(a[i]); });
+                        else if constexpr (std::is_signed_v<T>) forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] < 0 ? laneOp(T(0), a[i], std::minus<>{}) : a[i]; });
+                        else forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i]; });
+                        break;
+                    case Op::ARITH_INC: forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(a[i], T(1), std::plus<>{}); }); break;
+                    case Op::ARITH_DEC: forLanes(dense, lanes, n, [&](size_t i) { o[i] = laneOp(a[i], T(1), std::minus<>{}); }); break;
+                    default:
+                        if constexpr (std::is_integral_v<T>) forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(~a[i]); });
+                        else error = "bitwise op requires integers";
+                        break;
+                }
+            });
+            if (!ok) return fail("unsupported result type for node " + id_str);
+            if (!error.empty()) return fail(error + " (node " + id_str + ")");
+            return true;
+        }
+        case Op::CMP_EQ: case Op::CMP_NE: case Op::CMP_LT: case Op::CMP_LE: case Op::CMP_GT: case Op::CMP_GE: {
+            uint8_t* o = outputColumn(node.id, 0, BDIType::BOOL).data<uint8_t>();
+            const BatchColumn* ca = inputColumn(node, 0);
+            const BatchColumn* cb = inputColumn(node, 1);
+            if (!ca || !cb) return false;
+            bool ok = visitColumnType(ca->getType(), [&](auto tag) { // Compare in the left operand's type
+                using T = decltype(tag);
+                std::vector<T> sb;
+                const T* a = ca->template data<T>();
+                const T* b = coerce<T>(*cb, sb);
+                switch (node.operation) {
+                    case Op::CMP_EQ: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] == b[i]; }); break;
+                    case Op::CMP_NE: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] != b[i]; }); break;
+                    case Op::CMP_LT: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] < b[i]; }); break;
+                    case Op::CMP_LE: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] <= b[i]; }); break;
+                    case Op::CMP_GT: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] > b[i]; }); break;
+                    default:         forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] >= b[i]; }); break;
+                }
+            });
+            return ok || fail("unsupported operand type for node " + id_str);
+        }
+        case Op::LOGIC_AND: case Op::LOGIC_OR: case Op::LOGIC_XOR: case Op::LOGIC_NOT: {
+            std::vector<uint8_t> a, b;
+            if (!truthColumn(node, 0, a)) return false;
+            if (node.operation != Op::LOGIC_NOT && !truthColumn(node, 1, b)) return false;
+            uint8_t* o = outputColumn(node.id, 0, BDIType::BOOL).data<uint8_t>();
+            switch (node.operation) {
+                case Op::LOGIC_AND: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] & b[i]; }); break;
+                case Op::LOGIC_OR:  forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] | b[i]; }); break;
+                case Op::LOGIC_XOR: forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] ^ b[i]; }); break;
+                default:            forLanes(dense, lanes, n, [&](size_t i) { o[i] = a[i] ^ 1; }); break;
+            }
+            return true;
+        }
+        case Op::CONV_TRUNC: case Op::CONV_EXTEND_SIGN: case Op::CONV_EXTEND_ZERO:
+        case Op::CONV_FLOAT_TO_INT: case Op::CONV_INT_TO_FLOAT: {
+            const BDIType to = node.getOutputType(0);
+            BatchColumn& out = outputColumn(node.id, 0, to);
+            const BatchColumn* ca = inputColumn(node, 0);
+            if (!ca) return false;
+            std::vector<uint32_t> faulted;
+            bool ok = visitColumnType(to, [&](auto tag) {
+                using T = decltype(tag);
+                T* o = out.template data<T>();
+                visitColumnType(ca->getType(), [&](auto src_tag) {
+                    using S = decltype(src_tag);
+                    const S* a = ca->template data<S>();
+                    if (to == BDIType::BOOL) {
+                        forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(a[i] != S{}); });
+                    } else if constexpr (std::is_floating_point_v<S> && std::is_integral_v<T>) {
+                        for (uint32_t i : lanes) { // Range-checked like the interpreter
+                            auto converted = vm_ops::truncateToInt<T>(a[i]);
+                            if (!converted) { faulted.push_back(i); continue; }
+                            o[i] = *converted;
+                        }
+                    } else {
+                        forLanes(dense, lanes, n, [&](size_t i) { o[i] = static_cast<T>(a[i]); });
+                    }
+                });
+            });
+            if (!ok) return fail("unsupported conversion target for node " + id_str);
+            faultLanes(group, faulted, "float value out of integer range");
+            return true;
+        }
+        default:
+            return fail("operation " + std::to_string(static_cast<int>(node.operation)) + " at node " + id_str +
+                        " is not supported in batch mode");
+    }
+}
+} // namespace bdi::runtime
@@ -0,0 +1,87 @@
+#ifndef BDI_RUNTIME_BATCHEXECUTOR_HPP
+#define BDI_RUNTIME_BATCHEXECUTOR_HPP
+#include "BDIGraph.hpp"
+#include "ExecutionContext.hpp" // PortRefHash, payloadToVariant
+#include "BDIValueVariant.hpp"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace bdi::runtime {
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::BDINode;
+using bdi::core::types::BDIType;
+// A column of N values for one port (one value per lane).
+// Elements are packed at their natural width in 8-byte aligned storage so kernels
+// operate on plain T arrays. BOOL is stored as uint8_t 0/1.
+class BatchColumn {
+public:
+    BatchColumn() = default;
+    BatchColumn(BDIType type, size_t lanes);
+    static BatchColumn broadcast(BDIType type, size_t lanes, const BDIValueVariant& value);
+    BDIType getType() const { return type_; }
+    size_t size() const { return lanes_; }
+    template <typename T> T* data() { return reinterpret_cast<T*>(storage_.data()); }
+    template <typename T> const T* data() const { return reinterpret_cast<const T*>(storage_.data()); }
+    // Per-lane access at the API boundary (converts to/from the column type)
+    BDIValueVariant getLane(size_t lane) const;
+    bool setLane(size_t lane, const BDIValueVariant& value);
+private:
+    BDIType type_ = BDIType::UNKNOWN;
+    size_t lanes_ = 0;
+    std::vector<uint64_t> storage_;
+};
+// Runs one graph over a batch of independent inputs. Every port holds a BatchColumn,
+// so each node is dispatched once per lane group instead of once per input.
+// Divergent CTRL_BRANCH_COND splits a group into true/false groups (each group's lane
+// list acts as its mask); groups are re-merged when they meet at a control join.
+// Supports pure data ops (ARITH/BIT/LOGIC/CMP/CONV), constants and intra-graph control
+// flow; graphs using memory, calls or OS services must run on BDIVirtualMachine.
+// Integer arithmetic wraps, and a float-to-integer conversion out of range faults its
+// lane, as in the interpreter.
+class BatchExecutor {
+public:
+    enum class LaneStatus : uint8_t { RUNNING, COMPLETED, FAULTED };
+    explicit BatchExecutor(size_t batch_size);
+    size_t getBatchSize() const { return batch_size_; }
+    // Seed values, typically META_START outputs. Column size must equal the batch size.
+    bool setInputColumn(const PortRef& port, BatchColumn column);
+    // Returns false on structural errors (unsupported op, missing input, step limit).
+    // Per-lane runtime faults (e.g. division by zero) only mark that lane FAULTED.
+    bool execute(const BDIGraph& graph, NodeID entry_node_id, uint64_t max_group_steps = 1000000);
+    const BatchColumn* getColumn(const PortRef& port) const;
+    std::optional<BDIValueVariant> getLaneValue(const PortRef& port, size_t lane) const;
+    const std::vector<LaneStatus>& getLaneStatus() const { return lane_status_; }
+    const std::vector<BDIValueVariant>& getReturnValues() const { return return_values_; } // From CTRL_RETURN
+    const std::string& getLastError() const { return last_error_; }
+    void clear(); // Drops all columns and lane state; keeps the batch size
+private:
+    struct LaneGroup {
+        NodeID node = 0;
+        std::vector<uint32_t> lanes; // Sorted lane indices
+        bool dense = false;          // lanes == [0, batch_size)
+    };
+    size_t batch_size_;
+    const BDIGraph* graph_ = nullptr;
+    std::unordered_map<PortRef, BatchColumn, PortRefHash> columns_;
+    std::vector<LaneStatus> lane_status_;
+    std::vector<BDIValueVariant> return_values_;
+    std::map<NodeID, std::vector<uint32_t>> parked_; // Groups waiting at control joins
+    std::string last_error_;
+    // Executes 'group.node' for the group's lanes, then advances/splits it into 'out'
+    bool step(LaneGroup& group, std::vector<LaneGroup>& out);
+    bool executeData(const BDINode& node, LaneGroup& group);
+    void advance(LaneGroup&& group, NodeID target, std::vector<LaneGroup>& out);
+    void finishLanes(const LaneGroup& group);
+    void faultLanes(LaneGroup& group, const std::vector<uint32_t>& faulted, const std::string& reason);
+    const BatchColumn* inputColumn(const BDINode& node, size_t input_idx);
+    // Replacing a column of another type frees its storage, which an input may alias
+    // (loop-carried ports), so ops reserve their output before taking input pointers
+    BatchColumn& outputColumn(NodeID node_id, PortIndex port_idx, BDIType type);
+    bool truthColumn(const BDINode& node, size_t input_idx, std::vector<uint8_t>& out);
+    bool fail(const std::string& message);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_BATCHEXECUTOR_HPP
@@ -0,0 +1,21 @@
+#include "ConstantPool.hpp"
+#include "ExecutionContext.hpp"
+namespace bdi::runtime {
+using bdi::core::graph::BDIOperationType;
+ConstantPool::ConstantPool(const BDIGraph& graph) {
+    for (const auto& [id, node] : graph) {
+        if (!isConstantNode(*node)) continue;
+        auto value = TaggedValue::fromVariant(ExecutionContext::payloadToVariant(node->payload));
+        if (value && !value->isVoid()) values_.emplace(id, *value); // Undecodable payloads stay out
+    }
+}
+bool ConstantPool::isConstantNode(const BDINode& node) {
+    if (node.operation != BDIOperationType::META_CONST && node.operation != BDIOperationType::META_NOP) return false;
+    return node.payload.isValid() && node.payload.type != BDIType::VOID;
+}
+std::optional<BDIValueVariant> ConstantPool::getValue(NodeID node_id) const {
+    const TaggedValue* value = find(node_id);
+    if (!value) return std::nullopt;
+    return value->toVariant();
+}
+} // namespace bdi::runtime
@@ -0,0 +1,33 @@
+#ifndef BDI_RUNTIME_CONSTANTPOOL_HPP
+#define BDI_RUNTIME_CONSTANTPOOL_HPP
+#include "BDIGraph.hpp"
+#include "TaggedValue.hpp"
+#include <optional>
+#include <unordered_map>
+namespace bdi::runtime {
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::BDINode;
+using bdi::core::graph::NodeID;
+// Values of a graph's constant nodes (META_CONST, or META_NOP with a payload), decoded
+// from their TypedPayloads once when the graph is loaded. An engine that has the pool
+// copies a constant into a port slot instead of decoding the payload again every time
+// the node runs or a fresh context reads it. The pool describes the graph as it was
+// when built; rebuild it after the graph changes. Read-only once built, so any number
+// of engines can share it.
+class ConstantPool {
+public:
+    ConstantPool() = default;
+    explicit ConstantPool(const BDIGraph& graph);
+    static bool isConstantNode(const BDINode& node);
+    // The value of constant node 'node_id' (its output port 0), nullptr if it is not one
+    const TaggedValue* find(NodeID node_id) const {
+        auto it = values_.find(node_id);
+        return it != values_.end() ? &it->second : nullptr;
+    }
+    std::optional<BDIValueVariant> getValue(NodeID node_id) const;
+    size_t size() const { return values_.size(); }
+private:
+    std::unordered_map<NodeID, TaggedValue> values_;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_CONSTANTPOOL_HPP
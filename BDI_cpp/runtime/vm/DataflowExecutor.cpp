@@ -0,0 +1,243 @@
+#include "DataflowExecutor.hpp"
+#include "DeadCodeElimination.hpp"
+#include "MemoryManager.hpp"
+#include "NodeEvaluator.hpp"
+#include "Profiler.hpp"
+#include "Tracer.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <unordered_set>
+namespace bdi::runtime {
+namespace {
+using bdi::optimizer::DeadCodeElimination;
+bool isConstantNode(const BDINode& node) {
+    if (node.operation != BDIOperationType::META_CONST && node.operation != BDIOperationType::META_NOP) return false;
+    return node.payload.isValid() && node.payload.type != BDIType::VOID;
+}
+void sortedUnion(std::vector<size_t>& into, const std::vector<size_t>& from) {
+    std::vector<size_t> merged;
+    merged.reserve(into.size() + from.size());
+    std::set_union(into.begin(), into.end(), from.begin(), from.end(), std::back_inserter(merged));
+    into = std::move(merged);
+}
+} // namespace
+DataflowExecutor::DataflowExecutor(WorkStealingPool& pool, MemoryManager* memory)
+    : pool_(pool), memory_(memory) {}
+void DataflowExecutor::setInput(const PortRef& port, BDIValueVariant value) {
+    inputs_[port] = value;
+}
+bool DataflowExecutor::fail(const std::string& message) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!failed_.exchange(true)) { // Keep the first error; later ones are usually fallout
+        last_error_ = message;
+        BDI_LOG_ERROR(VM, "DataflowExecutor: " << message);
+    }
+    return false;
+}
+std::optional<BDIValueVariant> DataflowExecutor::getPortValue(const PortRef& port) const {
+    auto it = index_.find(port.node_id);
+    if (it != index_.end()) {
+        const auto& outputs = states_[it->second].outputs;
+        if (port.port_index < outputs.size() && !std::holds_alternative<std::monostate>(outputs[port.port_index].get())) {
+            return outputs[port.port_index].get();
+        }
+    }
+    auto seeded = inputs_.find(port);
+    if (seeded != inputs_.end()) return seeded->second.get();
+    return std::nullopt;
+}
+void DataflowExecutor::exportTo(ExecutionContext& ctx) const {
+    for (const auto& [port, value] : inputs_) ctx.setPortValue(port, value);
+    for (const auto& [node_id, idx] : index_) {
+        const auto& outputs = states_[idx].outputs;
+        for (PortIndex p = 0; p < outputs.size(); ++p) {
+            if (!std::holds_alternative<std::monostate>(outputs[p].get())) ctx.setPortValue(node_id, p, outputs[p]);
+        }
+    }
+}
+// --- Schedule Construction ---
+bool DataflowExecutor::buildSchedule(const BDIGraph& graph, NodeID entry_node_id) {
+    // 1. Control region: nodes reachable from the entry along control edges
+    std::vector<NodeID> order;
+    std::unordered_set<NodeID> in_region;
+    std::deque<NodeID> worklist{entry_node_id};
+    while (!worklist.empty()) {
+        NodeID id = worklist.front();
+        worklist.pop_front();
+        if (id == 0 || in_region.count(id)) continue;
+        auto node_opt = graph.getNode(id);
+        if (!node_opt) return fail("control edge to missing node " + std::to_string(id));
+        const BDINode& node = node_opt.value();
+        if (!NodeEvaluator::canEvaluate(node.operation)) {
+            return fail("node " + std::to_string(id) + " (op " + std::to_string(static_cast<int>(node.operation)) +
+                        ") needs the VM control loop; dataflow mode supports branch-free graphs only");
+        }
+        in_region.insert(id);
+        order.push_back(id);
+        for (NodeID succ : node.control_outputs) worklist.push_back(succ);
+    }
+    // 2. Pull in pure data producers that hang off the control chain (constants, floating math)
+    for (size_t i = 0; i < order.size(); ++i) {
+        const BDINode& node = graph.getNode(order[i]).value();
+        for (const PortRef& src : node.data_inputs) {
+            if (in_region.count(src.node_id) || inputs_.count(src)) continue;
+            auto src_opt = graph.getNode(src.node_id);
+            if (!src_opt) return fail("node " + std::to_string(node.id) + " reads missing node " + std::to_string(src.node_id));
+            const BDINode& src_node = src_opt.value();
+            if (!isConstantNode(src_node) && (DeadCodeElimination::hasSideEffects(src_node) ||
+                                              NodeEvaluator::readsExternalState(src_node.operation) ||
+                                              !NodeEvaluator::canEvaluate(src_node.operation))) {
+                return fail("input of node " + std::to_string(node.id) + " comes from node " + std::to_string(src.node_id) +
+                            " which is neither on the control path nor pure");
+            }
+            in_region.insert(src.node_id);
+            order.push_back(src.node_id);
+        }
+    }
+    state_count_ = order.size();
+    states_ = std::make_unique<NodeState[]>(state_count_);
+    index_.clear();
+    for (size_t i = 0; i < order.size(); ++i) index_[order[i]] = i;
+    for (size_t i = 0; i < order.size(); ++i) {
+        NodeState& state = states_[i];
+        state.node = &graph.getNode(order[i]).value().get();
+        state.outputs.assign(std::max<size_t>(state.node->data_outputs.size(), 1), HeldValue{});
+    }
+    std::vector<std::vector<size_t>> deps(state_count_);
+    // 3. Data dependencies
+    for (size_t i = 0; i < state_count_; ++i) {
+        for (const PortRef& src : states_[i].node->data_inputs) {
+            auto it = index_.find(src.node_id);
+            if (it != index_.end() && it->second != i) deps[i].push_back(it->second);
+        }
+    }
+    // 4. Effect ordering along control edges (Kahn order over the control region).
+    // Each node carries the frontier of the latest writes and the reads since them.
+    std::vector<uint32_t> control_in(state_count_, 0);
+    for (size_t i = 0; i < state_count_; ++i) {
+        for (NodeID succ : states_[i].node->control_outputs) {
+            auto it = index_.find(succ);
+            if (it != index_.end()) ++control_in[it->second];
+        }
+    }
+    struct Frontier { std::vector<size_t> writes, reads; };
+    std::vector<Frontier> frontier(state_count_);
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < state_count_; ++i) if (control_in[i] == 0) ready.push_back(i);
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t i = ready.front();
+        ready.pop_front();
+        ++visited;
+        const BDINode& node = *states_[i].node;
+        Frontier out = frontier[i];
+        if (DeadCodeElimination::hasSideEffects(node)) {
+            deps[i].insert(deps[i].end(), out.writes.begin(), out.writes.end());
+            deps[i].insert(deps[i].end(), out.reads.begin(), out.reads.end());
+            out.writes = {i};
+            out.reads.clear();
+        } else if (NodeEvaluator::readsExternalState(node.operation)) {
+            deps[i].insert(deps[i].end(), out.writes.begin(), out.writes.end());
+            sortedUnion(out.reads, {i});
+        }
+        for (NodeID succ : node.control_outputs) {
+            auto it = index_.find(succ);
+            if (it == index_.end()) continue;
+            sortedUnion(frontier[it->second].writes, out.writes);
+            sortedUnion(frontier[it->second].reads, out.reads);
+            if (--control_in[it->second] == 0) ready.push_back(it->second);
+        }
+    }
+    if (visited != state_count_) return fail("control flow reachable from node " + std::to_string(entry_node_id) + " contains a cycle");
+    // 5. Invert into successor lists
+    for (size_t i = 0; i < state_count_; ++i) {
+        std::sort(deps[i].begin(), deps[i].end());
+        deps[i].erase(std::unique(deps[i].begin(), deps[i].end()), deps[i].end());
+        states_[i].dependency_count = static_cast<uint32_t>(deps[i].size());
+        states_[i].pending.store(states_[i].dependency_count, std::memory_order_relaxed);
+        for (size_t dep : deps[i]) states_[dep].successors.push_back(i);
+    }
+    return true;
+}
+// --- Execution ---
+bool DataflowExecutor::execute(const BDIGraph& graph, NodeID entry_node_id) {
+    failed_ = false;
+    last_error_.clear();
+    return_value_.reset();
+    nodes_executed_ = 0;
+    if (!buildSchedule(graph, entry_node_id)) return false;
+    remaining_.store(state_count_, std::memory_order_release);
+    for (size_t i = 0; i < state_count_; ++i) {
+        if (states_[i].dependency_count == 0) pool_.submit([this, i] { runNode(i); });
+    }
+    pool_.helpWhile([this] { return remaining_.load(std::memory_order_acquire) > 0; });
+    return !failed_.load();
+}
+void DataflowExecutor::runNode(size_t index) {
+    // Run a chain of ready nodes on this thread; extra ready successors go to the pool
+    while (true) {
+        NodeState& state = states_[index];
+        if (!failed_.load(std::memory_order_relaxed)) {
+            const BDINode& node = *state.node;
+            TraceScope trace(Tracer::global(), node.id, static_cast<uint16_t>(node.operation), 0);
+            ProfileScope profile(Profiler::global(), nullptr, node.id, static_cast<uint16_t>(node.operation));
+            std::vector<BDIValueVariant> inputs;
+            inputs.reserve(node.data_inputs.size());
+            bool inputs_ok = true;
+            for (const PortRef& src : node.data_inputs) {
+                auto it = index_.find(src.node_id);
+                if (it != index_.end() && src.port_index < states_[it->second].outputs.size() &&
+                    !std::holds_alternative<std::monostate>(states_[it->second].outputs[src.port_index].get())) {
+                    inputs.push_back(states_[it->second].outputs[src.port_index].get());
+                    continue;
+                }
+                auto seeded = inputs_.find(src);
+                if (seeded == inputs_.end()) {
+                    inputs_ok = fail("input from node " + std::to_string(src.node_id) + " port " +
+                                     std::to_string(src.port_index) + " not available for node " + std::to_string(node.id));
+                    break;
+                }
+                inputs.push_back(seeded->second.get());
+            }
+            if (inputs_ok) {
+#if BDI_VM_EXCEPTIONS
+                try { // Op faults come back as VMStatus; this only catches non-VM failures
+#endif
+                    HeldValue result;
+                    VMErrorInfo error;
+                    VMStatus status = NodeEvaluator::tryEvaluate(node, inputs, memory_, result, &error);
+                    if (status == VMStatus::UNSUPPORTED_OP) {
+                        fail("no evaluator for node " + std::to_string(node.id));
+                    } else if (status != VMStatus::OK) {
+                        fail(error.describe());
+                    } else if (node.operation == BDIOperationType::CTRL_RETURN) {
+                        std::lock_guard<std::mutex> lock(error_mutex_);
+                        return_value_ = result;
+                    } else if (!std::holds_alternative<std::monostate>(result.get())) {
+                        state.outputs[0] = std::move(result);
+                    }
+                    nodes_executed_.fetch_add(1, std::memory_order_relaxed);
+#if BDI_VM_EXCEPTIONS
+                } catch (const std::exception& e) {
+                    fail("node " + std::to_string(node.id) + ": " + e.what());
+                }
+#endif
+            }
+        }
+        // Release successors even after a failure so 'remaining_' drains to zero
+        bool has_next = false;
+        size_t next = 0;
+        for (size_t succ : state.successors) {
+            if (states_[succ].pending.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+            if (!has_next) { next = succ; has_next = true; }
+            else pool_.submit([this, succ] { runNode(succ); });
+        }
+        // Last touch of 'this' when nothing follows: execute() may return right after
+        remaining_.fetch_sub(1, std::memory_order_acq_rel);
+        if (!has_next) return;
+        index = next;
+    }
+}
+} // namespace bdi::runtime
@@ -0,0 +1,65 @@
+#ifndef BDI_RUNTIME_DATAFLOWEXECUTOR_HPP
+#define BDI_RUNTIME_DATAFLOWEXECUTOR_HPP
+#include "BDIGraph.hpp"
+#include "ExecutionContext.hpp"
+#include "WorkStealingPool.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace bdi::runtime {
+class MemoryManager;
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::BDINode;
+// Executes a graph in dataflow order on a WorkStealingPool: a node becomes runnable as
+// soon as its data inputs are available instead of waiting for the single control
+// thread. Ordering between side effects (DeadCodeElimination::hasSideEffects) and
+// memory/IO reads is preserved by deriving extra dependencies from the control edges:
+// writes wait for earlier writes and reads, reads wait for earlier writes.
+// The control graph reachable from the entry must be acyclic and branch-free; graphs
+// with CTRL_BRANCH_COND/CALL or OS ops run on BDIVirtualMachine instead.
+class DataflowExecutor {
+public:
+    explicit DataflowExecutor(WorkStealingPool& pool, MemoryManager* memory = nullptr);
+    // Seed a value (e.g. META_START outputs, values produced by an earlier run)
+    void setInput(const PortRef& port, BDIValueVariant value);
+    // Blocks the caller (helping the pool) until all nodes ran or one failed
+    bool execute(const BDIGraph& graph, NodeID entry_node_id);
+    std::optional<BDIValueVariant> getPortValue(const PortRef& port) const;
+    std::optional<BDIValueVariant> getReturnValue() const {
+        if (return_value_) return return_value_->get();
+        return std::nullopt;
+    }
+    // Copy all produced port values into a context (API boundary with the VM)
+    void exportTo(ExecutionContext& ctx) const;
+    const std::string& getLastError() const { return last_error_; }
+    size_t getNodesExecuted() const { return nodes_executed_.load(); }
+private:
+    struct NodeState {
+        const BDINode* node = nullptr;
+        std::vector<size_t> successors;     // Dense indices released by this node
+        uint32_t dependency_count = 0;
+        std::atomic<uint32_t> pending{0};
+        std::vector<HeldValue> outputs;
+    };
+    WorkStealingPool& pool_;
+    MemoryManager* memory_;
+    std::unordered_map<PortRef, HeldValue, PortRefHash> inputs_;
+    std::unordered_map<NodeID, size_t> index_;
+    std::unique_ptr<NodeState[]> states_;
+    size_t state_count_ = 0;
+    std::atomic<size_t> remaining_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex error_mutex_;
+    std::string last_error_;
+    std::optional<HeldValue> return_value_;
+    std::atomic<size_t> nodes_executed_{0};
+    bool buildSchedule(const BDIGraph& graph, NodeID entry_node_id);
+    void runNode(size_t index);
+    bool fail(const std::string& message);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_DATAFLOWEXECUTOR_HPP
@@ -0,0 +1,35 @@
+#include "DebugSession.hpp"
+namespace bdi::runtime {
+DebugSession::DebugSession(NodeID max_node_id)
+    : max_node_id_(max_node_id), bits_(new std::atomic<uint64_t>[max_node_id / 64 + 1]()) {}
+bool DebugSession::setBreakpoint(const BDIGraph* graph, NodeID node_id) {
+    if (node_id > max_node_id_) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    breakpoints_.emplace(graph, node_id);
+    bits_[node_id / 64].fetch_or(uint64_t{1} << (node_id % 64), std::memory_order_relaxed);
+    return true;
+}
+void DebugSession::removeBreakpoint(const BDIGraph* graph, NodeID node_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!breakpoints_.erase({graph, node_id})) return;
+    for (const auto& [other, id] : breakpoints_) {
+        if (id == node_id) return; // Another graph still breaks here
+    }
+    bits_[node_id / 64].fetch_and(~(uint64_t{1} << (node_id % 64)), std::memory_order_relaxed);
+}
+void DebugSession::clearBreakpoints() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    breakpoints_.clear();
+    for (NodeID word = 0; word <= max_node_id_ / 64; ++word) bits_[word].store(0, std::memory_order_relaxed);
+}
+bool DebugSession::hasBreakpoint(const BDIGraph* graph, NodeID node_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return breakpoints_.count({graph, node_id}) || breakpoints_.count({nullptr, node_id});
+}
+void DebugSession::requestPause() { pause_.store(true, std::memory_order_release); }
+void DebugSession::requestStep(uint64_t task_id) { step_.store(task_id + 1, std::memory_order_release); }
+void DebugSession::breakAt(TaskControlBlock& task, NodeID node_id, BreakReason reason) {
+    breaks_.fetch_add(1, std::memory_order_relaxed);
+    onBreak(task, node_id, reason);
+}
+} // namespace bdi::runtime
@@ -0,0 +1,76 @@
+#ifndef BDI_RUNTIME_DEBUGSESSION_HPP
+#define BDI_RUNTIME_DEBUGSESSION_HPP
+#include "BDINode.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+namespace bdi::core::graph { class BDIGraph; }
+namespace bdi::runtime {
+using bdi::core::graph::NodeID;
+struct TaskControlBlock;
+// --- Debug Session ---
+// Breakpoints and pause/step requests for tasks run by a TaskEngine. Engines only look
+// at a session when their TaskServices hand one out at the start of a slice; then they
+// run an instrumented copy of the dispatch loop that asks shouldBreak() before every
+// node, so the loop without a debugger does no extra work at all.
+// A breakpoint is a (graph, NodeID) pair, since node ids repeat across graphs and across
+// versions of one graph; a null graph matches every graph. One bit per NodeID in a fixed
+// table says whether any graph has a breakpoint there, so nodes without one cost a load
+// and only a set bit takes the lock to match the graph. All members may be called from
+// any thread, including from onBreak().
+class DebugSession {
+public:
+    enum class BreakReason : uint8_t { BREAKPOINT, STEP, PAUSE };
+    static constexpr NodeID DEFAULT_MAX_NODE_ID = NodeID{1} << 16;
+    explicit DebugSession(NodeID max_node_id = DEFAULT_MAX_NODE_ID);
+    virtual ~DebugSession() = default;
+    DebugSession(const DebugSession&) = delete;
+    DebugSession& operator=(const DebugSession&) = delete;
+    using BDIGraph = bdi::core::graph::BDIGraph;
+    // False if node_id is above the table's maximum. graph = nullptr: every graph
+    bool setBreakpoint(const BDIGraph* graph, NodeID node_id);
+    void removeBreakpoint(const BDIGraph* graph, NodeID node_id);
+    void clearBreakpoints();
+    bool hasBreakpoint(const BDIGraph* graph, NodeID node_id) const;
+    void requestPause();                // Break before the next node of whichever task runs one first
+    void requestStep(uint64_t task_id); // Break before the task's next node; call from onBreak() to single-step
+    uint64_t getBreakCount() const { return breaks_.load(std::memory_order_relaxed); }
+    // Engine side: true if 'task_id' must break before 'node_id' of 'graph'. Consumes a
+    // matching pause or step request; a pending pause and a pending step are independent.
+    bool shouldBreak(uint64_t task_id, const BDIGraph* graph, NodeID node_id, BreakReason& reason) {
+        if (pause_.load(std::memory_order_relaxed) && pause_.exchange(false, std::memory_order_acq_rel)) {
+            reason = BreakReason::PAUSE;
+            return true;
+        }
+        uint64_t step = step_.load(std::memory_order_relaxed);
+        if (step == task_id + 1 && step_.compare_exchange_strong(step, NO_STEP, std::memory_order_acq_rel)) {
+            reason = BreakReason::STEP;
+            return true;
+        }
+        if (!mayBreak(node_id) || !hasBreakpoint(graph, node_id)) return false;
+        reason = BreakReason::BREAKPOINT;
+        return true;
+    }
+    // Called on the worker thread before 'node_id' runs, with the task's context as of
+    // that point. May block until the user resumes; the task keeps its worker meanwhile.
+    void breakAt(TaskControlBlock& task, NodeID node_id, BreakReason reason);
+protected:
+    virtual void onBreak(TaskControlBlock& task, NodeID node_id, BreakReason reason) = 0;
+private:
+    static constexpr uint64_t NO_STEP = 0;
+    NodeID max_node_id_;
+    std::unique_ptr<std::atomic<uint64_t>[]> bits_; // Some graph has a breakpoint at this NodeID
+    mutable std::mutex mutex_;
+    std::set<std::pair<const BDIGraph*, NodeID>> breakpoints_;
+    std::atomic<bool> pause_{false};
+    std::atomic<uint64_t> step_{NO_STEP}; // Task id + 1
+    std::atomic<uint64_t> breaks_{0};
+    bool mayBreak(NodeID node_id) const {
+        return node_id <= max_node_id_ && (bits_[node_id / 64].load(std::memory_order_relaxed) >> (node_id % 64)) & 1;
+    }
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_DEBUGSESSION_HPP
@@ -1,12 +1,20 @@
 #include "ExecutionContext.hpp"
 #include "TypedPayload.hpp"
+#include "Logger.hpp"
+#include <algorithm>
 #include <cstring>
-#include <stdexcept>
-#include <iostream>
+#include <type_traits>
 namespace bdi::runtime {
 // ---------------- Value Storage ----------------
 void ExecutionContext::setPortValue(const PortRef& port, BDIValueVariant value) {
-    port_values_[port] = std::move(value);
+    if (const VectorRef* vector = std::get_if<VectorRef>(&value)) {
+        PortSlot& slot = port_values_[port];
+        slot.value = TaggedValue{0, BDIType::ARRAY};
+        slot.dirty = true;
+        vector_values_[port] = PackedVector(*vector);
+        return;
+    }
+    setPortSlot(port, *TaggedValue::fromVariant(value));
 }
 void ExecutionContext::setPortValue(NodeID node_id, PortIndex port_idx, BDIValueVariant value) {
     setPortValue({node_id, port_idx}, std::move(value));
@@ -14,34 +22,84 @@ void ExecutionContext::setPortValue(NodeID node_id, PortIndex port_idx, BDIValue
 std::optional<BDIValueVariant> ExecutionContext::getPortValue(const PortRef& port) const {
     auto it = port_values_.find(port);
     if (it != port_values_.end()) {
-        return it->second;
+        return slotToVariant(port, it->second.value);
     }
     return std::nullopt;
 }
 std::optional<BDIValueVariant> ExecutionContext::getPortValue(NodeID node_id, PortIndex port_idx) const {
     return getPortValue({node_id, port_idx});
 }
+void ExecutionContext::setPortSlot(const PortRef& port, TaggedValue value) {
+    PortSlot& slot = port_values_[port];
+    if (slot.value.type == BDIType::ARRAY) vector_values_.erase(port);
+    slot.value = value;
+    slot.dirty = true;
+}
+const TaggedValue* ExecutionContext::findPortSlot(const PortRef& port) const {
+    auto it = port_values_.find(port);
+    return it != port_values_.end() ? &it->second.value : nullptr;
+}
+BDIValueVariant ExecutionContext::slotToVariant(const PortRef& port, const TaggedValue& slot) const {
+    if (slot.type == BDIType::ARRAY) return vector_values_.at(port).ref();
+    return slot.toVariant();
+}
+void ExecutionContext::erasePortValue(const PortRef& port) {
+    auto it = port_values_.find(port);
+    if (it == port_values_.end()) return;
+    if (it->second.value.type == BDIType::ARRAY) vector_values_.erase(port);
+    if (it->second.saved) erased_ports_.push_back(port);
+    port_values_.erase(it);
+}
 // --------------- Argument / Return Handling ---------------
+void ExecutionContext::reserveArgumentSlots(size_t count) {
+    if (arg_slots_.size() < count) {
+        arg_slots_.resize(std::max(count, arg_slots_.size() * 2));
+        arg_vectors_.resize(arg_slots_.size());
+    }
+}
+void ExecutionContext::retainArguments(size_t first, size_t count) {
+    for (size_t i = first; i < first + count; ++i) arg_vectors_[i] = retainVector(arg_slots_[i]);
+}
+BDIValueVariant* ExecutionContext::stageArguments(size_t count) {
+    reserveArgumentSlots(arg_top_ + count);
+    BDIValueVariant* slots = arg_slots_.data() + arg_top_;
+    std::fill_n(slots, count, BDIValueVariant{}); // Unpassed arguments read as absent
+    staged_count_ = count;
+    return slots;
+}
 void ExecutionContext::setNextArgument(PortIndex arg_index, BDIValueVariant value) {
-    next_arguments_[arg_index] = std::move(value);
+    if (arg_index >= staged_count_) {
+        reserveArgumentSlots(arg_top_ + arg_index + 1);
+        std::fill(arg_slots_.begin() + arg_top_ + staged_count_, arg_slots_.begin() + arg_top_ + arg_index, BDIValueVariant{});
+        staged_count_ = static_cast<size_t>(arg_index) + 1;
+    }
+    arg_slots_[arg_top_ + arg_index] = std::move(value);
 }
 std::optional<BDIValueVariant> ExecutionContext::getCurrentArgument(PortIndex arg_index) {
     if (call_stack_.empty()) {
         return std::nullopt;
     }
     const auto& frame = call_stack_.back();
-    auto it = frame.arguments.find(arg_index);
-    if (it != frame.arguments.end()) {
-        return it->second;
+    if (arg_index >= frame.arg_count) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    const BDIValueVariant& value = arg_slots_[frame.arg_base + arg_index];
+    if (std::holds_alternative<std::monostate>(value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+std::span<const BDIValueVariant> ExecutionContext::getArguments(const CallFrame& frame) const {
+    return std::span<const BDIValueVariant>(arg_slots_.data() + frame.arg_base, frame.arg_count);
 }
 void ExecutionContext::setCurrentReturnValue(BDIValueVariant value) {
     if (call_stack_.empty()) {
-        last_return_value_ = std::move(value);
+        last_return_vector_ = retainVector(value);
+        last_return_value_ = value;
         return;
     }
-    call_stack_.back().return_value = std::move(value);
+    call_stack_.back().return_vector = retainVector(value);
+    call_stack_.back().return_value = value;
 }
 std::optional<BDIValueVariant> ExecutionContext::getLastReturnValue() {
     return last_return_value_;
@@ -51,9 +109,13 @@ void ExecutionContext::pushCallFrame(NodeID caller_node_id, NodeID return_node_i
     CallFrame frame;
     frame.caller_node_id = caller_node_id;
     frame.return_node_id = return_node_id;
-    frame.arguments = std::move(next_arguments_);
-    next_arguments_.clear();
+    frame.arg_base = static_cast<uint32_t>(arg_top_);
+    frame.arg_count = static_cast<uint32_t>(staged_count_);
+    retainArguments(arg_top_, staged_count_);
+    arg_top_ += staged_count_;
+    staged_count_ = 0;
     last_return_value_ = std::nullopt;
+    last_return_vector_ = PackedVector{};
     call_stack_.push_back(std::move(frame));
 }
 std::optional<ExecutionContext::CallFrame> ExecutionContext::popCallFrame() {
@@ -62,20 +124,27 @@ std::optional<ExecutionContext::CallFrame> ExecutionContext::popCallFrame() {
     }
     CallFrame frame = std::move(call_stack_.back());
     call_stack_.pop_back();
+    arg_top_ = frame.arg_base;
+    staged_count_ = 0;
+    std::fill_n(arg_vectors_.begin() + frame.arg_base, frame.arg_count, PackedVector{});
     last_return_value_ = frame.return_value;
+    last_return_vector_ = frame.return_vector;
     return frame;
 }
 bool ExecutionContext::isCallStackEmpty() const {
     return call_stack_.empty();
 }
+const std::vector<ExecutionContext::CallFrame>& ExecutionContext::getCallStack() const {
+    return call_stack_;
+}
 // ---------------- Intelligence State ----------------
 void ExecutionContext::recordGradient(NodeID param_source_node, BDIValueVariant gradient) {
-    parameter_gradients[param_source_node] = std::move(gradient);
+    parameter_gradients[param_source_node] = gradient;
 }
 std::optional<BDIValueVariant> ExecutionContext::getGradient(NodeID param_source_node) const {
     auto it = parameter_gradients.find(param_source_node);
     if (it != parameter_gradients.end()) {
-        return it->second;
+        return it->second.get();
     }
     return std::nullopt;
 }
@@ -98,6 +167,7 @@ void ExecutionContext::clearIntelligenceState() {
 void ExecutionContext::pushServiceCall(NodeID caller_id, NodeID resume_id) {
     service_call_stack_.push_back({caller_id, resume_id});
     last_return_value_ = std::nullopt;
+    last_return_vector_ = PackedVector{};
 }
 std::optional<ExecutionContext::ServiceCallReturnState> ExecutionContext::popServiceCall() {
     if (service_call_stack_.empty()) {
@@ -107,42 +177,122 @@ std::optional<ExecutionContext::ServiceCallReturnState> ExecutionContext::popSer
     service_call_stack_.pop_back();
     return state;
 }
-
+// ---------------- Error Side Channel ----------------
+void ExecutionContext::setLastError(const VMErrorInfo& error) {
+    last_error_ = error;
+}
+const VMErrorInfo& ExecutionContext::getLastError() const {
+    return last_error_;
+}
+void ExecutionContext::clearLastError() {
+    last_error_ = {};
+}
+// ---------------- Node Remapping ----------------
+bool ExecutionContext::remapNodes(const std::unordered_map<NodeID, NodeID>& control, const std::unordered_map<NodeID, NodeID>& values) {
+    auto mapped = [&control](NodeID id) { return id == 0 || control.count(id) != 0; }; // 0 = no node
+    for (const CallFrame& frame : call_stack_) {
+        if (!mapped(frame.caller_node_id) || !mapped(frame.return_node_id)) return false;
+    }
+    for (const ServiceCallReturnState& call : service_call_stack_) {
+        if (!mapped(call.original_caller_node_id) || !mapped(call.original_resume_node_id)) return false;
+    }
+    auto map = [&control](NodeID id) { return id == 0 ? id : control.at(id); };
+    for (CallFrame& frame : call_stack_) {
+        frame.caller_node_id = map(frame.caller_node_id);
+        frame.return_node_id = map(frame.return_node_id);
+    }
+    for (ServiceCallReturnState& call : service_call_stack_) {
+        call.original_caller_node_id = map(call.original_caller_node_id);
+        call.original_resume_node_id = map(call.original_resume_node_id);
+    }
+    auto remapPorts = [&values](auto& table) {
+        std::remove_reference_t<decltype(table)> remapped;
+        remapped.reserve(table.size());
+        for (auto& [port, value] : table) {
+            auto it = values.find(port.node_id);
+            if (it != values.end()) remapped.emplace(PortRef{it->second, port.port_index}, std::move(value));
+        }
+        table = std::move(remapped);
+    };
+    for (auto& [port, slot] : port_values_) { // Every slot moves to a key the last checkpoint may not have
+        if (slot.saved) erased_ports_.push_back(port);
+        slot = PortSlot{slot.value};
+    }
+    remapPorts(port_values_);
+    remapPorts(vector_values_);
+    auto remapKeys = [&values](auto& table) {
+        std::remove_reference_t<decltype(table)> remapped;
+        for (auto& [node_id, value] : table) {
+            auto it = values.find(node_id);
+            if (it != values.end()) remapped.emplace(it->second, std::move(value));
+        }
+        table = std::move(remapped);
+    };
+    remapKeys(parameter_gradients);
+    remapKeys(eligibility_traces);
+    remapKeys(current_state_features);
+    return true;
+}
 // ---------------- Reset ----------------
 void ExecutionContext::clear() {
+    last_error_ = {};
+    for (const auto& [port, slot] : port_values_) {
+        if (slot.saved) erased_ports_.push_back(port);
+    }
     port_values_.clear();
+    vector_values_.clear();
     call_stack_.clear();
-    next_arguments_.clear();
+    arg_top_ = 0; // Slots are kept for reuse
+    staged_count_ = 0;
+    std::fill(arg_vectors_.begin(), arg_vectors_.end(), PackedVector{});
     last_return_value_ = std::nullopt;
+    last_return_vector_ = PackedVector{};
     service_call_stack_.clear();
     clearIntelligenceState();
 }
 // ---------------- Conversion Helpers ----------------
+namespace {
+// Size-checked read of a scalar payload; getAs<T> would throw on a malformed one
+template <typename T>
+VMResult<BDIValueVariant> readPayload(const TypedPayload& payload) {
+    if (payload.data.size() != sizeof(T)) return VMStatus::TYPE_MISMATCH;
+    if constexpr (std::is_same_v<T, bool>) {
+        return BDIValueVariant(payload.data[0] != std::byte{0});
+    } else {
+        T value;
+        std::memcpy(&value, payload.data.data(), sizeof(T));
+        return BDIValueVariant(value);
+    }
+}
+} // namespace
+
 BDIValueVariant ExecutionContext::payloadToVariant(const TypedPayload& payload) {
     using Type = core::types::BDIType;
-    try {
-        switch (payload.type) {
-            case Type::VOID:    return std::monostate{};
-            case Type::BOOL:    return payload.getAs<bool>();
-            case Type::INT8:    return payload.getAs<int8_t>();
-            case Type::UINT8:   return payload.getAs<uint8_t>();
-            case Type::INT16:   return payload.getAs<int16_t>();
-            case Type::UINT16:  return payload.getAs<uint16_t>();
-            case Type::INT32:   return payload.getAs<int32_t>();
-            case Type::UINT32:  return payload.getAs<uint32_t>();
-            case Type::INT64:   return payload.getAs<int64_t>();
-            case Type::UINT64:  return payload.getAs<uint64_t>();
-            case Type::FLOAT32: return payload.getAs<float>();
-            case Type::FLOAT64: return payload.getAs<double>();
-            case Type::POINTER:
-            case Type::MEM_REF:
-            case Type::FUNC_PTR: return payload.getAs<uintptr_t>();
-            default: return std::monostate{};
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error converting payload to variant: " << e.what() << std::endl;
+    VMResult<BDIValueVariant> value = BDIValueVariant{};
+    switch (payload.type) {
+        case Type::VOID:    return std::monostate{};
+        case Type::BOOL:    value = readPayload<bool>(payload); break;
+        case Type::INT8:    value = readPayload<int8_t>(payload); break;
+        case Type::UINT8:   value = readPayload<uint8_t>(payload); break;
+        case Type::INT16:   value = readPayload<int16_t>(payload); break;
+        case Type::UINT16:  value = readPayload<uint16_t>(payload); break;
+        case Type::INT32:   value = readPayload<int32_t>(payload); break;
+        case Type::UINT32:  value = readPayload<uint32_t>(payload); break;
+        case Type::INT64:   value = readPayload<int64_t>(payload); break;
+        case Type::UINT64:  value = readPayload<uint64_t>(payload); break;
+        case Type::FLOAT32: value = readPayload<float>(payload); break;
+        case Type::FLOAT64: value = readPayload<double>(payload); break;
+        case Type::POINTER:
+        case Type::MEM_REF:
+        case Type::FUNC_PTR: value = readPayload<uintptr_t>(payload); break;
+        default: return std::monostate{};
+    }
+    if (!value) {
+        BDI_LOG_ERROR(VM, "Error converting payload to variant: " << toString(value.error())
+                      << " (" << payload.data.size() << " bytes for a " << core::types::bdiTypeToString(payload.type) << ")");
         return std::monostate{};
     }
+    return std::move(*value);
 }
 
 TypedPayload ExecutionContext::variantToPayload(const BDIValueVariant& value) {
@@ -150,7 +300,9 @@ TypedPayload ExecutionContext::variantToPayload(const BDIValueVariant& value) {
     result.type = getBDIType(value);
     std::visit([&](auto&& arg) {
         using T = std::decay_t<decltype(arg)>;
-        if constexpr (!std::is_same_v<T, std::monostate>) {
+        if constexpr (std::is_same_v<T, VectorRef>) {
+            result.type = BDIType::UNKNOWN; // No scalar payload; VEC_STORE_PACKED writes vectors to memory
+        } else if constexpr (!std::is_same_v<T, std::monostate>) {
             result.data.resize(sizeof(T));
             std::memcpy(result.data.data(), &arg, sizeof(T));
         }
@@ -3,47 +3,61 @@
 #include "BDINode.hpp"       // For PortRef, NodeID
 #include "TypedPayload.hpp"  // For TypedPayload
 #include "BDIValueVariant.hpp" // Use the new variant type
+#include "TaggedValue.hpp"   // Port slot storage
+#include "VMStatus.hpp"      // For VMErrorInfo
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <vector>
 namespace bdi::runtime {
 using bdi::core::graph::NodeID;
 using bdi::core::graph::PortRef;
+using bdi::core::graph::PortRefHash;
 using bdi::core::payload::TypedPayload;
-// Hash function for PortRef to use it in unordered_map
-struct PortRefHash {
-    std::size_t operator()(const PortRef& pr) const noexcept {
-        std::size_t h1 = std::hash<NodeID>{}(pr.node_id);
-        std::size_t h2 = std::hash<PortIndex>{}(pr.port_index);
-        return h1 ^ (h2 << 1);
-    }
-};
 class ExecutionContext {
 public:
     ExecutionContext() = default;
-    // Value storage
+    // Value storage. Ports hold 16-byte TaggedValue slots; a vector lives in a side table
+    // behind an ARRAY-tagged slot. The variant accessors convert at the boundary: setting
+    // a vector keeps its lanes alive, and a VectorRef read back is valid until the port
+    // is overwritten or erased.
     void setPortValue(const PortRef& port, BDIValueVariant value);
     void setPortValue(NodeID node_id, PortIndex port_idx, BDIValueVariant value);
     std::optional<BDIValueVariant> getPortValue(const PortRef& port) const;
     std::optional<BDIValueVariant> getPortValue(NodeID node_id, PortIndex port_idx) const;
+    // Scalar fast path: no variant is built. An ARRAY slot's vector is only reachable
+    // through getPortValue().
+    void setPortSlot(const PortRef& port, TaggedValue value);
+    const TaggedValue* findPortSlot(const PortRef& port) const; // nullptr if unset
     // Conversion
     static BDIValueVariant payloadToVariant(const TypedPayload& payload);
     static TypedPayload variantToPayload(const BDIValueVariant& value);
-    // Argument/return value handling
-    void setNextArgument(PortIndex arg_index, BDIValueVariant value);
-    std::optional<BDIValueVariant> getCurrentArgument(PortIndex arg_index);
+    // Argument/return value handling. Arguments live in a stack arena of value slots: the
+    // next call's arguments are staged right above the innermost frame's, and pushCallFrame
+    // hands them to the new frame without copying. Slots are reused, so a warmed-up context
+    // makes calls without allocating.
+    // Stages 'count' empty slots (the callee's META_START arity) and returns them for the
+    // caller to fill. Valid until the next stage/setNextArgument/pushCallFrame; a staged
+    // vector must stay alive until pushCallFrame(), which keeps its lanes for the frame.
+    BDIValueVariant* stageArguments(size_t count);
+    void setNextArgument(PortIndex arg_index, BDIValueVariant value); // Grows the staged slots if needed
+    std::optional<BDIValueVariant> getCurrentArgument(PortIndex arg_index); // nullopt if not passed
     void setCurrentReturnValue(BDIValueVariant value);
     std::optional<BDIValueVariant> getLastReturnValue();
     // Call stack frame
     struct CallFrame {
         NodeID caller_node_id;
         NodeID return_node_id;
-        std::unordered_map<PortIndex, BDIValueVariant> arguments;
+        uint32_t arg_base = 0;  // First argument slot in the arena
+        uint32_t arg_count = 0;
         std::optional<BDIValueVariant> return_value = std::nullopt;
+        PackedVector return_vector; // Owns a vector return_value
     };
     void pushCallFrame(NodeID caller_node_id, NodeID return_node_id);
-    std::optional<CallFrame> popCallFrame();
+    std::optional<CallFrame> popCallFrame(); // Releases the frame's slots and any staged arguments
+    std::span<const BDIValueVariant> getArguments(const CallFrame& frame) const;
     bool isCallStackEmpty() const;
+    const std::vector<CallFrame>& getCallStack() const; // Outermost frame first
     // Intelligence state
     void recordGradient(NodeID param_source_node, BDIValueVariant gradient);
     std::optional<BDIValueVariant> getGradient(NodeID param_source_node) const;
@@ -57,18 +71,47 @@ public:
     };
     void pushServiceCall(NodeID caller_id, NodeID resume_id);
     std::optional<ServiceCallReturnState> popServiceCall();
+    // Error side channel: where and why the last op failed. Op handlers return only a
+    // VMStatus; the engine that reports the fault reads the detail from here.
+    void setLastError(const VMErrorInfo& error);
+    const VMErrorInfo& getLastError() const;
+    void clearLastError();
+    // Rewrites node ids after the task moved to another version of its graph: call and
+    // service frames through 'control', port values and intelligence state through
+    // 'values' (values of unmapped nodes are dropped). Returns false, changing nothing,
+    // if a frame's node has no mapping.
+    bool remapNodes(const std::unordered_map<NodeID, NodeID>& control, const std::unordered_map<NodeID, NodeID>& values);
     // Reset all state
     void clear();
 private:
-    std::unordered_map<PortRef, BDIValueVariant, PortRefHash> port_values_;
+    VMErrorInfo last_error_; // Transient, not checkpointed
+    friend class VMCheckpointer; // Serializes every field below
+    // A port's value and its incremental-checkpoint state: 'dirty' = written since the last
+    // checkpoint, 'saved' = in the last checkpoint, so erasing it must be recorded
+    struct PortSlot {
+        TaggedValue value;
+        bool dirty = true;
+        bool saved = false;
+    };
+    std::unordered_map<PortRef, PortSlot, PortRefHash> port_values_;
+    std::unordered_map<PortRef, PackedVector, PortRefHash> vector_values_; // Payloads of ARRAY slots
+    std::vector<PortRef> erased_ports_; // Saved slots erased since the last checkpoint
     std::vector<CallFrame> call_stack_;
-    std::unordered_map<PortIndex, BDIValueVariant> next_arguments_;
+    std::vector<BDIValueVariant> arg_slots_; // Argument arena: frame arguments, then staged ones
+    std::vector<PackedVector> arg_vectors_;  // Owners of vector arguments, parallel to arg_slots_
+    size_t arg_top_ = 0;                     // End of the innermost frame's arguments
+    size_t staged_count_ = 0;                // Next call's arguments: [arg_top_, arg_top_ + staged_count_)
     std::optional<BDIValueVariant> last_return_value_;
+    PackedVector last_return_vector_;
     // Intelligence state storage
-    std::unordered_map<NodeID, BDIValueVariant> parameter_gradients;
+    std::unordered_map<NodeID, HeldValue> parameter_gradients;
     std::unordered_map<NodeID, float> eligibility_traces;
-    std::unordered_map<NodeID, BDIValueVariant> current_state_features;
+    std::unordered_map<NodeID, HeldValue> current_state_features;
     std::vector<ServiceCallReturnState> service_call_stack_;
+    void reserveArgumentSlots(size_t count);
+    void retainArguments(size_t first, size_t count); // Keeps the vectors in these slots alive
+    BDIValueVariant slotToVariant(const PortRef& port, const TaggedValue& slot) const;
+    void erasePortValue(const PortRef& port);
 };
 } // namespace bdi::runtime
 #endif // BDI_RUNTIME_EXECUTIONCONTEXT_HPP
@@ -0,0 +1,59 @@
+#include "GraphRegistry.hpp"
+#include "TaskEngine.hpp"
+namespace bdi::runtime {
+using OpType = bdi::core::graph::BDIOperationType;
+std::shared_ptr<const GraphVersion> GraphRegistry::publish(const std::string& name, std::shared_ptr<const BDIGraph> graph,
+                                                           const NodeMap& mapping) {
+    if (!graph) return nullptr;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<GraphVersion>& slot = current_[name];
+    auto next = std::make_shared<GraphVersion>(name, slot ? slot->version_ + 1 : 1, std::move(graph));
+    if (slot) {
+        GraphVersion& previous = *slot;
+        const BDIGraph& to = *next->graph_;
+        for (const auto& [id, node] : *previous.graph_) {
+            auto explicit_target = mapping.find(id);
+            NodeID target = explicit_target != mapping.end() ? explicit_target->second : id;
+            auto counterpart = to.getNode(target);
+            if (!counterpart) continue;
+            if (explicit_target == mapping.end() && counterpart.value().get().operation != node->operation) continue;
+            previous.control_map_.emplace(id, target);
+            const auto& target_node = counterpart.value().get();
+            if (target_node.operation != OpType::META_CONST && target_node.operation != OpType::META_NOP) {
+                previous.value_map_.emplace(id, target);
+            }
+        }
+        previous.next_ = next;
+        previous.next_raw_.store(next.get(), std::memory_order_release);
+    }
+    slot = next;
+    return next;
+}
+std::shared_ptr<const GraphVersion> GraphRegistry::getCurrent(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = current_.find(name);
+    return it != current_.end() ? it->second : nullptr;
+}
+uint32_t GraphRegistry::upgrade(TaskControlBlock& task) {
+    uint32_t hops = 0;
+    while (task.version && task.version->isSuperseded()) {
+        const GraphVersion& from = *task.version;
+        auto resume = from.control_map_.find(task.resume_node_id);
+        if ((task.resume_node_id != 0 && resume == from.control_map_.end()) ||
+            !task.context || !task.context->remapNodes(from.control_map_, from.value_map_)) {
+            task.failed_hop = from.getNext()->getVersion();
+            break;
+        }
+        if (task.resume_node_id != 0) task.resume_node_id = resume->second;
+        auto wait = from.control_map_.find(task.wait_node_id);
+        task.wait_node_id = wait != from.control_map_.end() ? wait->second : 0;
+        std::shared_ptr<const GraphVersion> next = from.next_; // 'from' may die with the reassignment below
+        task.version = std::move(next);
+        task.graph = &task.version->getGraph();
+        task.constants = &task.version->getConstants();
+        task.failed_hop = 0;
+        ++hops;
+    }
+    return hops;
+}
+} // namespace bdi::runtime
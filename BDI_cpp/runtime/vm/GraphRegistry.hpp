@@ -0,0 +1,65 @@
+#ifndef BDI_RUNTIME_GRAPHREGISTRY_HPP
+#define BDI_RUNTIME_GRAPHREGISTRY_HPP
+#include "BDIGraph.hpp"
+#include "ConstantPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+namespace bdi::runtime {
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::NodeID;
+struct TaskControlBlock;
+using NodeMap = std::unordered_map<NodeID, NodeID>;
+// One deployed version of a named graph. Versions chain forward: publishing a newer one
+// links it, with the NodeID map into it, from its predecessor. Nothing points back, so a
+// version is freed once the registry and the last task running it have moved on.
+// Its constants are decoded once, when it is published.
+class GraphVersion {
+public:
+    GraphVersion(std::string name, uint64_t version, std::shared_ptr<const BDIGraph> graph)
+        : name_(std::move(name)), version_(version), graph_(std::move(graph)), constants_(*graph_) {}
+    const std::string& getName() const { return name_; }
+    uint64_t getVersion() const { return version_; }
+    const BDIGraph& getGraph() const { return *graph_; }
+    const ConstantPool& getConstants() const { return constants_; }
+    // The next version, or nullptr while this one is the newest
+    const GraphVersion* getNext() const { return next_raw_.load(std::memory_order_acquire); }
+    bool isSuperseded() const { return getNext() != nullptr; }
+private:
+    friend class GraphRegistry;
+    std::string name_;
+    uint64_t version_;
+    std::shared_ptr<const BDIGraph> graph_;
+    ConstantPool constants_;
+    // Written once by publish() before next_raw_, then read-only
+    std::shared_ptr<const GraphVersion> next_;
+    NodeMap control_map_; // Node ids of this version -> the next one's (resume points, frames)
+    NodeMap value_map_;   // The same minus constants of the next version, which are re-read
+    std::atomic<const GraphVersion*> next_raw_{nullptr};
+};
+// Named graphs deployed into a running BDIOS. Tasks spawned from a version keep it alive
+// and move to newer versions at safe points (see TaskScheduler), carrying their resume
+// point, call frames and port values across through each version's NodeID map.
+// Thread-safe.
+class GraphRegistry {
+public:
+    // Publishes 'graph' as the newest version of 'name'. 'mapping' takes node ids of the
+    // previous version to this one; any other node maps to the node with the same id if
+    // that has the same operation, and has no counterpart otherwise.
+    std::shared_ptr<const GraphVersion> publish(const std::string& name, std::shared_ptr<const BDIGraph> graph,
+                                                const NodeMap& mapping = {});
+    std::shared_ptr<const GraphVersion> getCurrent(const std::string& name) const;
+    // Moves a task that is not running as far along its version chain as the maps allow.
+    // A hop whose map misses the resume point or a call frame leaves the task where it
+    // is, still running that version, and records the version it missed in failed_hop.
+    // Returns the number of hops taken.
+    static uint32_t upgrade(TaskControlBlock& task);
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<GraphVersion>> current_;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_GRAPHREGISTRY_HPP
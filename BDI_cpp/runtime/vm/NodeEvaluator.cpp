@@ -0,0 +1,339 @@
+#include "NodeEvaluator.hpp"
+#include "ExecutionContext.hpp"
+#include "MemoryManager.hpp"
+#include "TypeSystem.hpp"
+#include "VMCheckedOperations.hpp"
+#include "VectorOps.hpp"
+#include "LinalgOps.hpp"
+#include "SignalOps.hpp"
+#include "TraversalOps.hpp"
+#include <algorithm>
+#include <cstring>
+#if BDI_VM_EXCEPTIONS
+#include "VMTypeOperations.hpp"
+#endif
+namespace bdi::runtime {
+using OpType = BDIOperationType;
+namespace {
+template <typename T, typename Op>
+T arithmetic(T a, T b, Op op) {
+    if constexpr (std::is_integral_v<T>) return vm_ops::detail::wrapping(a, b, op);
+    else return op(a, b);
+}
+// Operands of one type need no promotion, so each case is the vm_ops result computed in T
+template <typename T>
+bool taggedBinary(BDIOperationType op, T a, T b, TaggedValue& result) {
+    if constexpr (!std::is_same_v<T, bool>) { // BOOL arithmetic faults on the variant path
+        switch (op) {
+            case OpType::ARITH_ADD: result = TaggedValue::of(arithmetic(a, b, [](auto x, auto y) { return x + y; })); return true;
+            case OpType::ARITH_SUB: result = TaggedValue::of(arithmetic(a, b, [](auto x, auto y) { return x - y; })); return true;
+            case OpType::ARITH_MUL: result = TaggedValue::of(arithmetic(a, b, [](auto x, auto y) { return x * y; })); return true;
+            default: break;
+        }
+    }
+    switch (op) {
+        case OpType::CMP_EQ: result = TaggedValue::of(a == b); return true;
+        case OpType::CMP_NE: result = TaggedValue::of(a != b); return true;
+        case OpType::CMP_LT: result = TaggedValue::of(a < b); return true;
+        case OpType::CMP_LE: result = TaggedValue::of(a <= b); return true;
+        case OpType::CMP_GT: result = TaggedValue::of(a > b); return true;
+        case OpType::CMP_GE: result = TaggedValue::of(a >= b); return true;
+        default: return false;
+    }
+}
+} // namespace
+bool NodeEvaluator::canEvaluate(BDIOperationType op) {
+    switch (op) {
+        case OpType::META_NOP: case OpType::META_START: case OpType::META_END: case OpType::META_CONST:
+        case OpType::META_COMMENT: case OpType::META_ASSERT: case OpType::CTRL_JUMP: case OpType::CTRL_RETURN:
+        case OpType::ARITH_ADD: case OpType::ARITH_SUB: case OpType::ARITH_MUL: case OpType::ARITH_DIV:
+        case OpType::ARITH_MOD: case OpType::ARITH_NEG: case OpType::ARITH_ABS:
+        case OpType::BIT_AND: case OpType::BIT_OR: case OpType::BIT_XOR: case OpType::BIT_NOT:
+        case OpType::BIT_SHL: case OpType::BIT_SHR: case OpType::BIT_ASHR:
+        case OpType::LOGIC_AND: case OpType::LOGIC_OR: case OpType::LOGIC_XOR: case OpType::LOGIC_NOT:
+        case OpType::CMP_EQ: case OpType::CMP_NE: case OpType::CMP_LT: case OpType::CMP_LE:
+        case OpType::CMP_GT: case OpType::CMP_GE:
+        case OpType::CONV_INT_TO_FLOAT: case OpType::CONV_FLOAT_TO_INT: case OpType::CONV_EXTEND_SIGN:
+        case OpType::CONV_EXTEND_ZERO: case OpType::CONV_TRUNC: case OpType::CONV_BITCAST:
+        case OpType::MEM_LOAD: case OpType::MEM_STORE: case OpType::MEM_ALLOC: case OpType::MEM_FREE:
+        case OpType::SYNC_ATOMIC_RMW:
+        case OpType::VEC_ADD: case OpType::VEC_MUL: case OpType::VEC_LOAD_PACKED: case OpType::VEC_STORE_PACKED:
+        case OpType::VEC_SHUFFLE: case OpType::LINALG_MATMUL: case OpType::SIGNAL_FFT:
+        case OpType::GRAPH_TRAVERSE:
+            return true;
+        default:
+            return false;
+    }
+}
+bool NodeEvaluator::readsExternalState(BDIOperationType op) {
+    return op == OpType::MEM_LOAD || op == OpType::VEC_LOAD_PACKED || op == OpType::IO_READ_PORT || op == OpType::COMM_CHANNEL_RECV;
+}
+VMStatus NodeEvaluator::tryEvaluate(const BDINode& node, const std::vector<BDIValueVariant>& inputs,
+                                    MemoryManager* memory, HeldValue& result, VMErrorInfo* error) {
+    auto fail = [&](VMStatus status, const char* detail) {
+        if (error) *error = {status, node.id, detail};
+        return status;
+    };
+    // Stores a checked op's value (a scalar, or a vector the result takes over), or reports its status
+    auto take = [&](auto value, const char* detail) {
+        if (!value) return fail(value.error(), detail);
+        result = std::move(*value);
+        return VMStatus::OK;
+    };
+    auto arity = [&](size_t count) { return inputs.size() == count; };
+    result = HeldValue{};
+    switch (node.operation) {
+        // --- Meta / structural ---
+        case OpType::META_NOP:
+        case OpType::META_CONST:
+            // Constant NOP/CONST nodes carry their value in the payload
+            if (node.payload.isValid() && node.payload.type != BDIType::VOID) result = ExecutionContext::payloadToVariant(node.payload);
+            return VMStatus::OK;
+        case OpType::META_START:   // Arguments are supplied by the caller
+        case OpType::META_END:
+        case OpType::META_COMMENT:
+        case OpType::CTRL_JUMP:
+            return VMStatus::OK;
+        case OpType::CTRL_RETURN:
+            if (!inputs.empty()) result = inputs[0]; // Returned value; caller decides where it goes
+            return VMStatus::OK;
+        case OpType::META_ASSERT: {
+            if (!arity(1)) return fail(VMStatus::ARITY, "META_ASSERT expects 1 input");
+            auto condition = vm_ops::tryConvert<bool>(inputs[0]);
+            if (!condition) return fail(condition.error(), "META_ASSERT condition");
+            if (!*condition) return fail(VMStatus::ASSERTION_FAILED, "META_ASSERT");
+            return VMStatus::OK;
+        }
+        // --- Arithmetic ---
+        case OpType::ARITH_ADD: if (!arity(2)) break; return take(vm_ops::tryAddition(inputs[0], inputs[1]), "ARITH_ADD");
+        case OpType::ARITH_SUB: if (!arity(2)) break; return take(vm_ops::trySubtraction(inputs[0], inputs[1]), "ARITH_SUB");
+        case OpType::ARITH_MUL: if (!arity(2)) break; return take(vm_ops::tryMultiplication(inputs[0], inputs[1]), "ARITH_MUL");
+        case OpType::ARITH_DIV: if (!arity(2)) break; return take(vm_ops::tryDivision(inputs[0], inputs[1]), "ARITH_DIV");
+        case OpType::ARITH_MOD: if (!arity(2)) break; return take(vm_ops::tryModulo(inputs[0], inputs[1]), "ARITH_MOD");
+        case OpType::ARITH_NEG: if (!arity(1)) break; return take(vm_ops::tryNegation(inputs[0]), "ARITH_NEG");
+        case OpType::ARITH_ABS: if (!arity(1)) break; return take(vm_ops::tryAbsolute(inputs[0]), "ARITH_ABS");
+        // --- Bitwise ---
+        case OpType::BIT_AND:  if (!arity(2)) break; return take(vm_ops::tryBitwiseAND(inputs[0], inputs[1]), "BIT_AND");
+        case OpType::BIT_OR:   if (!arity(2)) break; return take(vm_ops::tryBitwiseOR(inputs[0], inputs[1]), "BIT_OR");
+        case OpType::BIT_XOR:  if (!arity(2)) break; return take(vm_ops::tryBitwiseXOR(inputs[0], inputs[1]), "BIT_XOR");
+        case OpType::BIT_NOT:  if (!arity(1)) break; return take(vm_ops::tryBitwiseNOT(inputs[0]), "BIT_NOT");
+        case OpType::BIT_SHL:  if (!arity(2)) break; return take(vm_ops::tryBitwiseSHL(inputs[0], inputs[1]), "BIT_SHL");
+        case OpType::BIT_SHR:  if (!arity(2)) break; return take(vm_ops::tryBitwiseSHR(inputs[0], inputs[1]), "BIT_SHR");
+        case OpType::BIT_ASHR: if (!arity(2)) break; return take(vm_ops::tryBitwiseASHR(inputs[0], inputs[1]), "BIT_ASHR");
+        // --- Logical ---
+        case OpType::LOGIC_AND: if (!arity(2)) break; return take(vm_ops::tryLogicalAND(inputs[0], inputs[1]), "LOGIC_AND");
+        case OpType::LOGIC_OR:  if (!arity(2)) break; return take(vm_ops::tryLogicalOR(inputs[0], inputs[1]), "LOGIC_OR");
+        case OpType::LOGIC_XOR: if (!arity(2)) break; return take(vm_ops::tryLogicalXOR(inputs[0], inputs[1]), "LOGIC_XOR");
+        case OpType::LOGIC_NOT: if (!arity(1)) break; return take(vm_ops::tryLogicalNOT(inputs[0]), "LOGIC_NOT");
+        // --- Comparison ---
+        case OpType::CMP_EQ: if (!arity(2)) break; return take(vm_ops::tryComparisonEQ(inputs[0], inputs[1]), "CMP_EQ");
+        case OpType::CMP_NE: if (!arity(2)) break; return take(vm_ops::tryComparisonNE(inputs[0], inputs[1]), "CMP_NE");
+        case OpType::CMP_LT: if (!arity(2)) break; return take(vm_ops::tryComparisonLT(inputs[0], inputs[1]), "CMP_LT");
+        case OpType::CMP_LE: if (!arity(2)) break; return take(vm_ops::tryComparisonLE(inputs[0], inputs[1]), "CMP_LE");
+        case OpType::CMP_GT: if (!arity(2)) break; return take(vm_ops::tryComparisonGT(inputs[0], inputs[1]), "CMP_GT");
+        case OpType::CMP_GE: if (!arity(2)) break; return take(vm_ops::tryComparisonGE(inputs[0], inputs[1]), "CMP_GE");
+        // --- Conversions ---
+        case OpType::CONV_INT_TO_FLOAT: case OpType::CONV_FLOAT_TO_INT:
+        case OpType::CONV_EXTEND_SIGN: case OpType::CONV_EXTEND_ZERO: case OpType::CONV_TRUNC:
+            if (!arity(1)) break;
+            return take(vm_ops::tryConversion(inputs[0], node.getOutputType(0)), "conversion");
+        case OpType::CONV_BITCAST:
+            if (!arity(1)) break;
+            return take(vm_ops::tryBitcast(inputs[0], node.getOutputType(0)), "CONV_BITCAST needs equal sizes");
+        // --- Memory ---
+        case OpType::MEM_LOAD: {
+            if (!arity(1)) break;
+            if (!memory) return fail(VMStatus::NO_MEMORY_MANAGER, "MEM_LOAD");
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "MEM_LOAD address");
+            BDIType load_type = node.getOutputType(0);
+            size_t load_size = core::types::getBdiTypeSize(load_type);
+            if (load_size == 0) return fail(VMStatus::TYPE_MISMATCH, "MEM_LOAD of a zero-size type");
+            TypedPayload loaded(load_type, core::types::BinaryData(load_size));
+            if (!memory->readMemory(*address, loaded.data.data(), load_size)) return fail(VMStatus::MEMORY_FAULT, "MEM_LOAD read failed");
+            result = ExecutionContext::payloadToVariant(loaded);
+            return VMStatus::OK;
+        }
+        case OpType::MEM_STORE: {
+            if (!arity(2)) break;
+            if (!memory) return fail(VMStatus::NO_MEMORY_MANAGER, "MEM_STORE");
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "MEM_STORE address");
+            TypedPayload payload = ExecutionContext::variantToPayload(inputs[1]);
+            if (payload.type == BDIType::UNKNOWN) return fail(VMStatus::TYPE_MISMATCH, "MEM_STORE value has no payload type");
+            if (!memory->writeMemory(*address, payload.data.data(), payload.data.size())) return fail(VMStatus::MEMORY_FAULT, "MEM_STORE write failed");
+            return VMStatus::OK;
+        }
+        case OpType::MEM_ALLOC: {
+            if (!arity(1)) break;
+            if (!memory) return fail(VMStatus::NO_MEMORY_MANAGER, "MEM_ALLOC");
+            auto size = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!size) return fail(size.error(), "MEM_ALLOC size");
+            auto region_id = memory->allocateRegion(static_cast<size_t>(*size));
+            if (!region_id) return fail(VMStatus::MEMORY_FAULT, "MEM_ALLOC allocation failed");
+            auto region = memory->getRegionInfo(*region_id);
+            if (!region) return fail(VMStatus::MEMORY_FAULT, "MEM_ALLOC region lookup failed");
+            result = static_cast<uint64_t>(region->base_address);
+            return VMStatus::OK;
+        }
+        case OpType::MEM_FREE: {
+            if (!arity(1)) break;
+            if (!memory) return fail(VMStatus::NO_MEMORY_MANAGER, "MEM_FREE");
+            auto region_id = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!region_id) return fail(region_id.error(), "MEM_FREE region id");
+            if (!memory->freeRegion(*region_id)) return fail(VMStatus::MEMORY_FAULT, "MEM_FREE failed");
+            return VMStatus::OK;
+        }
+        // --- Packed vectors ---
+        case OpType::VEC_ADD: if (!arity(2)) break; return take(vm_ops::tryVectorAdd(inputs[0], inputs[1]), "VEC_ADD");
+        case OpType::VEC_MUL: if (!arity(2)) break; return take(vm_ops::tryVectorMultiply(inputs[0], inputs[1]), "VEC_MUL");
+        case OpType::VEC_SHUFFLE: return take(vm_ops::tryVectorShuffle(inputs), "VEC_SHUFFLE");
+        case OpType::VEC_LOAD_PACKED: {
+            // Inputs: [address, lanes]; the output port declares the element type
+            if (!arity(2)) break;
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "VEC_LOAD_PACKED address");
+            auto lanes = vm_ops::tryConvert<uint64_t>(inputs[1]);
+            if (!lanes) return fail(lanes.error(), "VEC_LOAD_PACKED lane count");
+            return take(vm_ops::tryVectorLoad(memory, *address, *lanes, node.getOutputType(0)), "VEC_LOAD_PACKED");
+        }
+        case OpType::VEC_STORE_PACKED: {
+            if (!arity(2)) break;
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "VEC_STORE_PACKED address");
+            VMStatus status = vm_ops::tryVectorStore(memory, *address, inputs[1]);
+            return status == VMStatus::OK ? status : fail(status, "VEC_STORE_PACKED");
+        }
+        // --- Graph algorithms ---
+        case OpType::GRAPH_TRAVERSE: {
+            // Inputs: [offsets, targets, vertex_count, source, output]; the payload is
+            // traversal::encodeTraverse(). Output 0 receives the vertex count written.
+            if (!arity(5)) break;
+            std::optional<traversal::TraverseSpec> spec = traversal::TraverseSpec{};
+            if (node.payload.isValid() && node.payload.type != BDIType::VOID) {
+                auto payload = vm_ops::tryConvert<uint32_t>(ExecutionContext::payloadToVariant(node.payload));
+                if (!payload) return fail(payload.error(), "GRAPH_TRAVERSE payload");
+                spec = traversal::decodeTraverse(*payload);
+                if (!spec) return fail(VMStatus::TYPE_MISMATCH, "GRAPH_TRAVERSE payload is not a valid index type/mode");
+            }
+            uint64_t operands[5];
+            for (size_t i = 0; i < 5; ++i) {
+                auto operand = vm_ops::tryConvert<uint64_t>(inputs[i]);
+                if (!operand) return fail(operand.error(), "GRAPH_TRAVERSE address, count or source");
+                operands[i] = *operand;
+            }
+            uint64_t count = 0;
+            VMStatus status = vm_ops::tryGraphTraverse(memory, *spec, operands[0], operands[1], operands[2], operands[3], operands[4], count);
+            if (status != VMStatus::OK) return fail(status, "GRAPH_TRAVERSE");
+            result = count;
+            return VMStatus::OK;
+        }
+        // --- Linear algebra ---
+        case OpType::LINALG_MATMUL: {
+            // Inputs: [a, b, c, m, k, n], addresses then the shape; the payload is linalg::encodeMatmul()
+            if (!arity(6)) break;
+            std::optional<linalg::MatmulSpec> spec = linalg::MatmulSpec{};
+            if (node.payload.isValid() && node.payload.type != BDIType::VOID) {
+                auto payload = vm_ops::tryConvert<uint32_t>(ExecutionContext::payloadToVariant(node.payload));
+                if (!payload) return fail(payload.error(), "LINALG_MATMUL payload");
+                spec = linalg::decodeMatmul(*payload);
+                if (!spec) return fail(VMStatus::TYPE_MISMATCH, "LINALG_MATMUL payload is not a valid element type/layout");
+            }
+            uint64_t operands[6];
+            for (size_t i = 0; i < 6; ++i) {
+                auto operand = vm_ops::tryConvert<uint64_t>(inputs[i]);
+                if (!operand) return fail(operand.error(), "LINALG_MATMUL address or dimension");
+                operands[i] = *operand;
+            }
+            VMStatus status = vm_ops::tryMatmul(memory, *spec, operands[0], operands[1], operands[2], operands[3], operands[4], operands[5]);
+            return status == VMStatus::OK ? status : fail(status, "LINALG_MATMUL");
+        }
+        // --- Signal processing ---
+        case OpType::SIGNAL_FFT: {
+            // Inputs: [address, n]; the payload is signal::encodeFft()
+            if (!arity(2)) break;
+            std::optional<signal::FftSpec> spec = signal::FftSpec{};
+            if (node.payload.isValid() && node.payload.type != BDIType::VOID) {
+                auto payload = vm_ops::tryConvert<uint32_t>(ExecutionContext::payloadToVariant(node.payload));
+                if (!payload) return fail(payload.error(), "SIGNAL_FFT payload");
+                spec = signal::decodeFft(*payload);
+                if (!spec) return fail(VMStatus::TYPE_MISMATCH, "SIGNAL_FFT payload is not a valid element type/direction");
+            }
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "SIGNAL_FFT address");
+            auto size = vm_ops::tryConvert<uint64_t>(inputs[1]);
+            if (!size) return fail(size.error(), "SIGNAL_FFT size");
+            VMStatus status = vm_ops::tryFft(memory, *spec, *address, *size);
+            return status == VMStatus::OK ? status : fail(status, "SIGNAL_FFT");
+        }
+        // --- Synchronization ---
+        case OpType::SYNC_ATOMIC_RMW: {
+            // Inputs: [address, operand], CAS: [address, expected, desired]. Output 0 (an
+            // integer type) sets the width and receives the previous value.
+            uint32_t encoded = encodeAtomicRmw(AtomicOp::ADD);
+            if (node.payload.isValid() && node.payload.type != BDIType::VOID) {
+                auto payload = vm_ops::tryConvert<uint32_t>(ExecutionContext::payloadToVariant(node.payload));
+                if (!payload) return fail(payload.error(), "SYNC_ATOMIC_RMW payload");
+                encoded = *payload;
+            }
+            const auto op = static_cast<AtomicOp>(encoded & 0xFF);
+            const auto order = static_cast<AtomicOrder>((encoded >> 8) & 0xFF);
+            if (op > AtomicOp::LOAD || order > AtomicOrder::RELAXED) return fail(VMStatus::TYPE_MISMATCH, "SYNC_ATOMIC_RMW payload is not a valid op/order");
+            if (!arity(op == AtomicOp::CAS ? 3 : op == AtomicOp::LOAD ? 1 : 2)) break;
+            if (!memory) return fail(VMStatus::NO_MEMORY_MANAGER, "SYNC_ATOMIC_RMW");
+            const BDIType type = node.getOutputType(0);
+            if (!core::types::TypeSystem::isInteger(type)) return fail(VMStatus::TYPE_MISMATCH, "SYNC_ATOMIC_RMW needs an integer output type");
+            auto address = vm_ops::tryConvert<uint64_t>(inputs[0]);
+            if (!address) return fail(address.error(), "SYNC_ATOMIC_RMW address");
+            // Operands as the output type's bit pattern
+            uint64_t operands[2] = {0, 0};
+            for (size_t i = 1; i < inputs.size(); ++i) {
+                auto converted = vm_ops::tryConversion(inputs[i], type);
+                if (!converted) return fail(converted.error(), "SYNC_ATOMIC_RMW operand");
+                TypedPayload bits = ExecutionContext::variantToPayload(*converted);
+                std::memcpy(&operands[i - 1], bits.data.data(), std::min(bits.data.size(), sizeof(uint64_t)));
+            }
+            const size_t size = core::types::getBdiTypeSize(type);
+            const uint64_t operand = op == AtomicOp::CAS ? operands[1] : operands[0];
+            auto previous = memory->atomicRmw(*address, size, op, operand, operands[0], order);
+            if (!previous) return fail(VMStatus::MEMORY_FAULT, "SYNC_ATOMIC_RMW needs an aligned, in-bounds address and a valid order");
+            TypedPayload loaded(type, core::types::BinaryData(size));
+            std::memcpy(loaded.data.data(), &*previous, size);
+            result = ExecutionContext::payloadToVariant(loaded);
+            return VMStatus::OK;
+        }
+        default:
+            return fail(VMStatus::UNSUPPORTED_OP, "");
+    }
+    return fail(VMStatus::ARITY, ""); // Cases 'break' only on arity
+}
+bool NodeEvaluator::tryEvaluateTagged(BDIOperationType op, const std::vector<TaggedValue>& inputs, TaggedValue& result) {
+    if (inputs.size() != 2 || inputs[0].type != inputs[1].type) return false;
+    const TaggedValue& lhs = inputs[0];
+    const TaggedValue& rhs = inputs[1];
+    switch (lhs.type) {
+        case BDIType::BOOL:    return taggedBinary(op, lhs.as<bool>(), rhs.as<bool>(), result);
+        case BDIType::INT8:    return taggedBinary(op, lhs.as<int8_t>(), rhs.as<int8_t>(), result);
+        case BDIType::UINT8:   return taggedBinary(op, lhs.as<uint8_t>(), rhs.as<uint8_t>(), result);
+        case BDIType::INT16:   return taggedBinary(op, lhs.as<int16_t>(), rhs.as<int16_t>(), result);
+        case BDIType::UINT16:  return taggedBinary(op, lhs.as<uint16_t>(), rhs.as<uint16_t>(), result);
+        case BDIType::INT32:   return taggedBinary(op, lhs.as<int32_t>(), rhs.as<int32_t>(), result);
+        case BDIType::UINT32:  return taggedBinary(op, lhs.as<uint32_t>(), rhs.as<uint32_t>(), result);
+        case BDIType::INT64:   return taggedBinary(op, lhs.as<int64_t>(), rhs.as<int64_t>(), result);
+        case BDIType::UINT64:  return taggedBinary(op, lhs.as<uint64_t>(), rhs.as<uint64_t>(), result);
+        case BDIType::FLOAT32: return taggedBinary(op, lhs.as<float>(), rhs.as<float>(), result);
+        case BDIType::FLOAT64: return taggedBinary(op, lhs.as<double>(), rhs.as<double>(), result);
+        default:               return false; // VOID faults; pointers and vectors take the variant path
+    }
+}
+#if BDI_VM_EXCEPTIONS
+bool NodeEvaluator::evaluate(const BDINode& node, const std::vector<BDIValueVariant>& inputs,
+                             MemoryManager* memory, HeldValue& result) {
+    VMErrorInfo error;
+    VMStatus status = tryEvaluate(node, inputs, memory, result, &error);
+    if (status == VMStatus::UNSUPPORTED_OP) return false;
+    if (status != VMStatus::OK) throw vm_ops::BDIExecutionError(error.describe());
+    return true;
+}
+#endif
+} // namespace bdi::runtime
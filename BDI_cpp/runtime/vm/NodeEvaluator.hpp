@@ -0,0 +1,40 @@
+#ifndef BDI_RUNTIME_NODEEVALUATOR_HPP
+#define BDI_RUNTIME_NODEEVALUATOR_HPP
+#include "BDINode.hpp"
+#include "BDIValueVariant.hpp"
+#include "TaggedValue.hpp"
+#include "VMStatus.hpp"
+#include <vector>
+namespace bdi::runtime {
+class MemoryManager;
+using bdi::core::graph::BDINode;
+using bdi::core::graph::BDIOperationType;
+// Data semantics of a single node, independent of control state, call frames and
+// scheduling. Shared by execution engines that do not run the full VM loop
+// (parallel dataflow, worker pools). Mirrors the vm_ops dispatch in
+// BDIVirtualMachine::executeNode, but never throws: faults are VMStatus codes.
+class NodeEvaluator {
+public:
+    // True if evaluate() handles 'op' (no control transfer / VM-level state needed)
+    static bool canEvaluate(BDIOperationType op);
+    // Memory/IO readers that are not side effects but must not move across stores
+    static bool readsExternalState(BDIOperationType op);
+    // Computes output 0 (if any) from the input values; 'result' owns a vector output.
+    // 'memory' is required only
+    // for MEM_*, VEC_LOAD/STORE_PACKED, GRAPH_TRAVERSE, LINALG_MATMUL, SIGNAL_FFT and
+    // SYNC_ATOMIC_RMW.
+    // UNSUPPORTED_OP if the op is not handled here. On failure 'error' (if given)
+    // receives the node and a static detail string.
+    static VMStatus tryEvaluate(const BDINode& node, const std::vector<BDIValueVariant>& inputs,
+                                MemoryManager* memory, HeldValue& result, VMErrorInfo* error = nullptr);
+    // ARITH_ADD/SUB/MUL and CMP_* on two scalars of one type, computed straight on the
+    // port slots with tryEvaluate's results. False = not such a node; use tryEvaluate.
+    static bool tryEvaluateTagged(BDIOperationType op, const std::vector<TaggedValue>& inputs, TaggedValue& result);
+#if BDI_VM_EXCEPTIONS
+    // Throwing wrapper: false if unsupported, vm_ops::BDIExecutionError on a fault
+    static bool evaluate(const BDINode& node, const std::vector<BDIValueVariant>& inputs,
+                         MemoryManager* memory, HeldValue& result);
+#endif
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_NODEEVALUATOR_HPP
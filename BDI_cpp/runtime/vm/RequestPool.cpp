@@ -0,0 +1,137 @@
+#include "RequestPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+namespace bdi::runtime {
+struct RequestPool::Instance {
+    explicit Instance(size_t memory_bytes) : memory(memory_bytes), engine(&memory), empty(memory.getAllocatorState()) {
+        task.context = std::make_unique<ExecutionContext>();
+    }
+    MemoryManager memory;
+    TaskEngine engine;
+    TaskControlBlock task;
+    MemoryManager::AllocatorState empty; // Restored on every return
+    bool ran = false;
+};
+RequestPool::RequestPool(std::shared_ptr<const BDIGraph> graph, NodeID entry_node_id, size_t instance_count, size_t memory_bytes)
+    : graph_(std::move(graph)), constants_(*graph_), entry_(entry_node_id) {
+    if (instance_count == 0) instance_count = std::max(1u, std::thread::hardware_concurrency());
+    instances_.reserve(instance_count);
+    idle_.reserve(instance_count);
+    for (size_t i = 0; i < instance_count; ++i) {
+        auto instance = std::make_unique<Instance>(memory_bytes);
+        std::memset(instance->memory.getRawPointer(0), 0, memory_bytes); // Fault the pages in now, not per request
+        idle_.push_back(instance.get());
+        instances_.push_back(std::move(instance));
+    }
+}
+RequestPool::~RequestPool() = default;
+// --- Leases ---
+RequestPool::Lease RequestPool::acquire() {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return !idle_.empty(); });
+    Instance* instance = idle_.back(); // LIFO: the most recently used instance is the warmest
+    idle_.pop_back();
+    lock.unlock();
+    wait_latency_.record(std::chrono::steady_clock::now() - start);
+    return Lease(this, instance);
+}
+std::optional<RequestPool::Lease> RequestPool::tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.empty()) return std::nullopt;
+    Instance* instance = idle_.back();
+    idle_.pop_back();
+    wait_latency_.record(uint64_t{0});
+    return Lease(this, instance);
+}
+RequestPool::Lease& RequestPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        instance_ = other.instance_;
+        other.instance_ = nullptr;
+    }
+    return *this;
+}
+ExecutionContext& RequestPool::Lease::getContext() {
+    return *instance_->task.context;
+}
+MemoryManager& RequestPool::Lease::getMemory() {
+    return instance_->memory;
+}
+RequestPool::Result RequestPool::Lease::run() {
+    return pool_->execute(*instance_);
+}
+void RequestPool::Lease::release() {
+    if (!instance_) return;
+    pool_->recycle(instance_);
+    instance_ = nullptr;
+}
+// Runs on the releasing thread, so the next acquire() finds a clean instance
+void RequestPool::recycle(Instance* instance) {
+    TaskControlBlock& task = instance->task;
+    task.context->clear();
+    task.graph = nullptr;
+    task.constants = nullptr;
+    task.resume_node_id = 0;
+    task.status = TaskStatus::READY;
+    task.wait_event = 0;
+    task.wait_node_id = 0;
+    task.halt_requested.store(false, std::memory_order_relaxed);
+    task.at_safe_point = true;
+    task.failed_hop = 0;
+    task.instructions_executed = 0;
+    task.result.reset();
+    task.result_vector = PackedVector{};
+    task.error.clear();
+    instance->ran = false;
+    instance->memory.markRegionsDirty(); // Seeds write their inputs through getRawPointer()
+    scrubbed_pages_.fetch_add(instance->memory.scrubDirtyPages(), std::memory_order_relaxed);
+    instance->memory.restoreAllocatorState(instance->empty);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(instance);
+    }
+    available_.notify_one();
+}
+// --- Execution ---
+RequestPool::Result RequestPool::serve(const std::function<void(ExecutionContext&, MemoryManager&)>& seed) {
+    Lease lease = acquire();
+    if (seed) seed(lease.getContext(), lease.getMemory());
+    return lease.run();
+}
+RequestPool::Result RequestPool::execute(Instance& instance) {
+    Result result;
+    if (instance.ran) {
+        result.error = "a lease runs its request once";
+        return result;
+    }
+    instance.ran = true;
+    const auto start = std::chrono::steady_clock::now();
+    TaskControlBlock& task = instance.task;
+    task.graph = graph_.get();
+    task.constants = &constants_;
+    task.resume_node_id = entry_;
+    while (true) {
+        TaskEngine::SliceOutcome outcome = instance.engine.runSlice(task, node_limit_ - std::min(result.nodes, node_limit_));
+        result.nodes += outcome.instructions;
+        if (outcome.result == TaskSliceResult::YIELDED && !outcome.preempted) continue; // SYS_YIELD: nothing else to run
+        if (outcome.result == TaskSliceResult::COMPLETED) {
+            result.status = TaskSliceResult::COMPLETED;
+            result.value = std::move(task.result);
+            result.vector = std::move(task.result_vector);
+        } else if (outcome.result == TaskSliceResult::YIELDED) {
+            result.error = "request exceeded the node limit of " + std::to_string(node_limit_);
+        } else if (outcome.result == TaskSliceResult::WAITING) {
+            result.error = "request waited on event " + std::to_string(task.wait_event) + ", which nothing can send";
+        } else {
+            result.error = task.error.empty() ? "request halted" : task.error;
+        }
+        break;
+    }
+    run_latency_.record(std::chrono::steady_clock::now() - start);
+    return result;
+}
+} // namespace bdi::runtime
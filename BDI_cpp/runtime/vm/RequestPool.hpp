@@ -0,0 +1,90 @@
+#ifndef BDI_RUNTIME_REQUESTPOOL_HPP
+#define BDI_RUNTIME_REQUESTPOOL_HPP
+#include "TaskEngine.hpp"
+#include "ConstantPool.hpp"
+#include "MemoryManager.hpp"
+#include "LatencyHistogram.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+namespace bdi::runtime {
+// Serves concurrent requests that each run the same graph. The graph is shared and never
+// written; every pooled instance owns a TaskEngine, an ExecutionContext and a
+// MemoryManager arena, built and page-faulted in once. A request leases an instance,
+// seeds the entry's inputs, runs the graph to completion and hands the instance back.
+// Handing back resets the task, clears the context (keeping its storage), zeroes only the
+// arena pages the request dirtied and restores the arena's empty allocator state, so it
+// costs O(touched pages) instead of a VM. Regions allocated during the lease count as
+// dirtied, since seeds may fill them through getRawPointer(); raw writes anywhere else
+// must call markDirty(). Requests have no OS services: SYS_WAIT_EVENT, CONCURRENCY_SPAWN
+// and the other scheduler primitives fault, so a request leaves no children behind.
+// Thread-safe.
+class RequestPool {
+public:
+    static constexpr size_t DEFAULT_MEMORY_BYTES = size_t{1} << 20;
+    static constexpr uint64_t DEFAULT_NODE_LIMIT = uint64_t{1} << 24;
+    struct Result {
+        TaskSliceResult status = TaskSliceResult::ERROR; // COMPLETED or ERROR
+        std::optional<BDIValueVariant> value;           // Top-level CTRL_RETURN value
+        PackedVector vector;                            // Owns a vector 'value'
+        std::string error;
+        uint64_t nodes = 0;
+    };
+    struct Instance; // Engine, context and arena (RequestPool.cpp)
+    // One instance, leased to one request; goes back to the pool when destroyed
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept : pool_(other.pool_), instance_(other.instance_) { other.instance_ = nullptr; }
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { release(); }
+        explicit operator bool() const { return instance_ != nullptr; }
+        ExecutionContext& getContext();
+        MemoryManager& getMemory();
+        Result run(); // Runs the graph from the pool's entry node; once per lease
+        void release();
+    private:
+        friend class RequestPool;
+        Lease(RequestPool* pool, Instance* instance) : pool_(pool), instance_(instance) {}
+        RequestPool* pool_ = nullptr;
+        Instance* instance_ = nullptr;
+    };
+    RequestPool(std::shared_ptr<const BDIGraph> graph, NodeID entry_node_id, size_t instance_count = 0, // 0 = hardware_concurrency
+                size_t memory_bytes = DEFAULT_MEMORY_BYTES);
+    ~RequestPool(); // Every lease must be gone
+    RequestPool(const RequestPool&) = delete;
+    RequestPool& operator=(const RequestPool&) = delete;
+    Lease acquire(); // Waits while every instance is leased
+    std::optional<Lease> tryAcquire();
+    // acquire(), seed(context, memory), run(), release
+    Result serve(const std::function<void(ExecutionContext&, MemoryManager&)>& seed = {});
+    // Nodes a request may run before it faults (checked at loop back-edges); set before serving
+    void setNodeLimit(uint64_t limit) { node_limit_ = limit; }
+    const BDIGraph& getGraph() const { return *graph_; }
+    size_t getInstanceCount() const { return instances_.size(); }
+    // --- Latency ---
+    const LatencyHistogram& getWaitLatency() const { return wait_latency_; } // acquire() until leased
+    const LatencyHistogram& getRunLatency() const { return run_latency_; }   // run()
+    uint64_t getScrubbedPages() const { return scrubbed_pages_.load(std::memory_order_relaxed); }
+private:
+    std::shared_ptr<const BDIGraph> graph_;
+    ConstantPool constants_; // Decoded once, shared by every instance
+    NodeID entry_;
+    uint64_t node_limit_ = DEFAULT_NODE_LIMIT;
+    std::vector<std::unique_ptr<Instance>> instances_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<Instance*> idle_;
+    LatencyHistogram wait_latency_;
+    LatencyHistogram run_latency_;
+    std::atomic<uint64_t> scrubbed_pages_{0};
+    Result execute(Instance& instance);
+    void recycle(Instance* instance);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_REQUESTPOOL_HPP
@@ -0,0 +1,75 @@
+#include "TaskCoroutine.hpp"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+namespace bdi::runtime {
+namespace {
+constexpr size_t kGranule = 64;         // Size class width
+constexpr size_t kClassCount = 64;      // Frames up to 4 KiB are pooled
+constexpr size_t kThreadCacheLimit = 256;
+constexpr size_t sizeClass(size_t size) { return (size + kGranule - 1) / kGranule; } // 1-based
+struct SharedLists {
+    std::mutex mutex;
+    std::array<std::vector<void*>, kClassCount + 1> lists;
+};
+SharedLists& shared() {
+    static SharedLists* lists = new SharedLists(); // Never destroyed: thread caches may outlive statics
+    return *lists;
+}
+struct ThreadCache {
+    std::array<std::vector<void*>, kClassCount + 1> lists;
+    ~ThreadCache() { // Hand cached frames to the shared lists when the worker exits
+        SharedLists& global = shared();
+        std::lock_guard<std::mutex> lock(global.mutex);
+        for (size_t c = 1; c <= kClassCount; ++c) {
+            global.lists[c].insert(global.lists[c].end(), lists[c].begin(), lists[c].end());
+        }
+    }
+};
+thread_local ThreadCache tls_cache;
+} // namespace
+std::atomic<uint64_t> CoroutineFramePool::fresh_{0};
+std::atomic<uint64_t> CoroutineFramePool::reused_{0};
+void* CoroutineFramePool::allocate(size_t size) {
+    size_t cls = sizeClass(size);
+    if (cls > kClassCount) {
+        fresh_.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+    auto& local = tls_cache.lists[cls];
+    if (local.empty()) { // Refill half a cache from the shared list
+        SharedLists& global = shared();
+        std::lock_guard<std::mutex> lock(global.mutex);
+        auto& list = global.lists[cls];
+        size_t take = std::min(list.size(), kThreadCacheLimit / 2);
+        local.insert(local.end(), list.end() - static_cast<std::ptrdiff_t>(take), list.end());
+        list.resize(list.size() - take);
+    }
+    if (!local.empty()) {
+        void* frame = local.back();
+        local.pop_back();
+        reused_.fetch_add(1, std::memory_order_relaxed);
+        return frame;
+    }
+    fresh_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(cls * kGranule);
+}
+void CoroutineFramePool::deallocate(void* frame, size_t size) noexcept {
+    size_t cls = sizeClass(size);
+    if (cls > kClassCount) {
+        ::operator delete(frame);
+        return;
+    }
+    auto& local = tls_cache.lists[cls];
+    if (local.size() >= kThreadCacheLimit) { // Spill half so the other workers can reuse them
+        SharedLists& global = shared();
+        std::lock_guard<std::mutex> lock(global.mutex);
+        auto spill_begin = local.begin() + static_cast<std::ptrdiff_t>(kThreadCacheLimit / 2);
+        global.lists[cls].insert(global.lists[cls].end(), spill_begin, local.end());
+        local.erase(spill_begin, local.end());
+    }
+    local.push_back(frame);
+}
+} // namespace bdi::runtime
@@ -0,0 +1,68 @@
+#ifndef BDI_RUNTIME_TASKCOROUTINE_HPP
+#define BDI_RUNTIME_TASKCOROUTINE_HPP
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+namespace bdi::runtime {
+// Why a task slice ended (or why its coroutine is suspended)
+enum class TaskSliceResult : uint8_t { COMPLETED, YIELDED, HALTED_TASK, WAITING, ERROR };
+// Size-classed free lists for coroutine frames. Each thread keeps a small cache and
+// spills to a shared list, so frames created on one worker and destroyed on another
+// are still recycled. Oversized frames fall back to the global heap.
+class CoroutineFramePool {
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* frame, size_t size) noexcept;
+    static uint64_t getFreshAllocations() { return fresh_.load(std::memory_order_relaxed); }
+    static uint64_t getReusedAllocations() { return reused_.load(std::memory_order_relaxed); }
+private:
+    static std::atomic<uint64_t> fresh_;
+    static std::atomic<uint64_t> reused_;
+};
+// Owning handle for a task coroutine. The coroutine starts suspended; each resume()
+// runs it to the next co_await suspend(...) or to completion, after which
+// getSuspendReason() says why control came back. Move-only; destroys the frame.
+class TaskCoroutine {
+public:
+    struct promise_type {
+        TaskSliceResult reason = TaskSliceResult::ERROR;
+        std::exception_ptr exception;
+        TaskCoroutine get_return_object() { return TaskCoroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(TaskSliceResult result) noexcept { reason = result; }
+        void unhandled_exception() noexcept { reason = TaskSliceResult::ERROR; exception = std::current_exception(); }
+        static void* operator new(size_t size) { return CoroutineFramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) noexcept { CoroutineFramePool::deallocate(frame, size); }
+    };
+    // co_await TaskCoroutine::suspend(reason) hands control back to the resumer
+    struct SuspendAwaiter {
+        TaskSliceResult reason;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept { handle.promise().reason = reason; }
+        void await_resume() const noexcept {}
+    };
+    static SuspendAwaiter suspend(TaskSliceResult reason) { return {reason}; }
+    TaskCoroutine() = default;
+    TaskCoroutine(TaskCoroutine&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    TaskCoroutine& operator=(TaskCoroutine&& other) noexcept {
+        if (this != &other) { reset(); handle_ = std::exchange(other.handle_, nullptr); }
+        return *this;
+    }
+    TaskCoroutine(const TaskCoroutine&) = delete;
+    TaskCoroutine& operator=(const TaskCoroutine&) = delete;
+    ~TaskCoroutine() { reset(); }
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+    bool done() const { return !handle_ || handle_.done(); }
+    void resume() { if (handle_ && !handle_.done()) handle_.resume(); }
+    TaskSliceResult getSuspendReason() const { return handle_ ? handle_.promise().reason : TaskSliceResult::ERROR; }
+    void reset() { if (handle_) { handle_.destroy(); handle_ = nullptr; } }
+private:
+    explicit TaskCoroutine(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_TASKCOROUTINE_HPP
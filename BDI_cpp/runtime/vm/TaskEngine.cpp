@@ -0,0 +1,491 @@
+#include "TaskEngine.hpp"
+#include "Channel.hpp"
+#include "ConstantPool.hpp"
+#include "DebugSession.hpp"
+#include "FutexTable.hpp"
+#include "GraphRegistry.hpp"
+#include "MemoryManager.hpp"
+#include "NodeEvaluator.hpp"
+#include "SpawnRuntime.hpp"
+#include "Profiler.hpp"
+#include "Tracer.hpp"
+#include "VMCheckedOperations.hpp"
+#include "HardwareAbstractionLayer.hpp"
+#include <algorithm>
+#include <limits>
+#if BDI_VM_EXCEPTIONS
+#include <exception>
+#endif
+namespace bdi::runtime {
+using OpType = BDIOperationType;
+namespace {
+// Event id, port or register from input 0 if wired, otherwise from the payload
+VMResult<uint64_t> idOperand(const BDINode& node, const std::vector<BDIValueVariant>& inputs) {
+    if (!inputs.empty()) return vm_ops::tryConvert<uint64_t>(inputs[0]);
+    if (node.payload.isValid() && node.payload.type != BDIType::VOID) {
+        return vm_ops::tryConvert<uint64_t>(ExecutionContext::payloadToVariant(node.payload));
+    }
+    return VMStatus::VOID_OPERAND;
+}
+// Argument slots a call into 'entry' needs: the callee's META_START signature, or
+// everything passed when the entry is not a META_START
+size_t calleeArity(const BDIGraph& graph, NodeID entry, size_t passed) {
+    auto callee = graph.getNode(entry);
+    if (callee && callee.value().get().operation == OpType::META_START) return callee.value().get().data_outputs.size();
+    return passed;
+}
+// A call boundary is worth a yield while the task's version is superseded, unless a hop
+// off it already failed: then only SYS_YIELD and waits give the scheduler another try
+bool wantsUpgrade(const TaskControlBlock& task) {
+    return task.version && task.version->isSuperseded() && task.failed_hop == 0;
+}
+} // namespace
+std::optional<uint64_t> HalDeviceInputs::read(InputSource source, uint64_t address) {
+    if (!hal_) return std::nullopt;
+    switch (source) {
+        case InputSource::SPECIAL_REGISTER:
+            if (address > static_cast<uint64_t>(bdi::hal::SpecialRegister::PageTableBase)) return std::nullopt;
+            return hal_->readSpecialRegister(static_cast<bdi::hal::SpecialRegister>(address));
+        case InputSource::IO_PORT: {
+            uint64_t value = 0;
+            if (!hal_->readPhysical(address, reinterpret_cast<std::byte*>(&value), sizeof(value))) return std::nullopt;
+            return value;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+TaskEngine::TaskEngine(MemoryManager* memory) : memory_(memory) {}
+void TaskEngine::abandonWait(const TaskControlBlock& task, TaskServices* services) {
+    if (!services) return;
+    const uint64_t event = task.wait_event;
+    if ((event & FutexTable::EVENT_BASE) == FutexTable::EVENT_BASE) {
+        if (FutexTable* futexes = services->getFutexTable()) futexes->cancelWait(event & ~FutexTable::EVENT_BASE);
+    } else if (event & Channel::EVENT_BASE) {
+        ChannelRegistry* channels = services->getChannels();
+        if (Channel* channel = channels ? channels->find((event & ~Channel::EVENT_BASE) >> 1) : nullptr) {
+            channel->cancelWaiter(event & 1 ? Channel::Direction::RECV : Channel::Direction::SEND);
+        }
+    }
+}
+bool TaskEngine::gatherInputs(const TaskControlBlock& task, const BDINode& node, ExecutionContext& ctx, std::string& error) {
+    slots_.clear();
+    for (const PortRef& src : node.data_inputs) {
+        const TaggedValue* slot = ctx.findPortSlot(src);
+        if (!slot) {
+            // Constants off the control path are materialized on first use
+            if (const TaggedValue* constant = task.constants ? task.constants->find(src.node_id) : nullptr) {
+                ctx.setPortSlot(src, *constant);
+                slots_.push_back(*constant);
+                continue;
+            }
+            auto src_node = task.graph->getNode(src.node_id);
+            if (src_node && ConstantPool::isConstantNode(src_node.value().get())) {
+                ctx.setPortValue(src, ExecutionContext::payloadToVariant(src_node.value().get().payload));
+                slot = ctx.findPortSlot(src);
+            }
+            if (!slot) {
+                error = "input from node " + std::to_string(src.node_id) + " port " + std::to_string(src.port_index) +
+                        " not available for node " + std::to_string(node.id);
+                return false;
+            }
+        }
+        slots_.push_back(*slot);
+    }
+    return true;
+}
+void TaskEngine::materializeInputs(const BDINode& node, const ExecutionContext& ctx) {
+    inputs_.clear();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        const TaggedValue& slot = slots_[i];
+        inputs_.push_back(slot.type == BDIType::ARRAY ? *ctx.getPortValue(node.data_inputs[i]) : slot.toVariant());
+    }
+}
+TaskEngine::SliceOutcome TaskEngine::runSlice(TaskControlBlock& task, uint64_t budget, TaskServices* services, bool exact) {
+    DebugSession* debug = nullptr;
+    const std::atomic<bool>* preempt = nullptr;
+    if (services) {
+        debug = services->getDebugSession();
+        preempt = services->getPreemptFlag(task);
+    }
+    return debug ? runNodes<true>(task, budget, services, preempt, debug, exact)
+                 : runNodes<false>(task, budget, services, preempt, nullptr, exact);
+}
+template <bool Debug>
+TaskEngine::SliceOutcome TaskEngine::runNodes(TaskControlBlock& task, uint64_t budget, TaskServices* services,
+                                              const std::atomic<bool>* preempt, DebugSession* debug, bool exact) {
+    SliceOutcome outcome;
+    uint64_t executed = 0; // Kept in a register; the TCB is updated once, when the slice ends
+    bool backward = true; // At a preemption point: the slice start, or the last node passed control backward
+    auto finish = [&](SliceResult result) {
+        outcome.result = result;
+        task.at_safe_point = result == SliceResult::WAITING || (result == SliceResult::YIELDED && !outcome.preempted);
+        task.instructions_executed += executed;
+        outcome.instructions = executed;
+        return outcome;
+    };
+    while (true) {
+        if (task.halt_requested.load(std::memory_order_relaxed)) return finish(SliceResult::HALTED_TASK);
+        if (task.resume_node_id == 0) return finish(SliceResult::COMPLETED); // Fell off the end of the control path
+        // Preemption points: every loop and every recursion passes a backward edge, so
+        // straight-line code runs to the next one without checks. The flag cannot end a
+        // slice before its first node, so a stale one still lets the task make progress.
+        if (backward || exact) {
+            if (executed >= budget || (executed > 0 && preempt && preempt->load(std::memory_order_relaxed))) {
+                outcome.preempted = true;
+                return finish(SliceResult::YIELDED);
+            }
+        }
+        if constexpr (Debug) {
+            DebugSession::BreakReason reason;
+            if (debug->shouldBreak(task.task_id, task.graph, task.resume_node_id, reason)) {
+                debug->breakAt(task, task.resume_node_id, reason);
+                if (task.halt_requested.load(std::memory_order_relaxed)) continue; // Halted while stopped
+            }
+        }
+        const NodeID current = task.resume_node_id;
+        ++executed; // Failed nodes count too, so a journal's step counts match runSlice budgets
+        if (auto stop = step(task, services)) return finish(*stop);
+        backward = task.resume_node_id <= current;
+    }
+}
+TaskCoroutine TaskEngine::interpret(TaskControlBlock& task, MemoryManager* memory, TaskServices* services, uint64_t budget) {
+    TaskEngine engine(memory); // Lives in the frame and migrates with the task
+    const std::atomic<bool>* preempt = nullptr;
+    DebugSession* debug = nullptr;
+    uint64_t executed = 0; // Nodes since the last resume
+    bool backward = true;
+    auto resumed = [&] { // The worker, and with it the preempt flag, may differ on every resume
+        preempt = services ? services->getPreemptFlag(task) : nullptr;
+        debug = services ? services->getDebugSession() : nullptr;
+        executed = 0;
+        backward = true;
+    };
+    resumed();
+    // runNodes<false>'s loop, except that SYS_YIELD, SYS_WAIT_EVENT and preemption suspend
+    // it where it stands: the next resume carries on with the node after the one that stopped
+    while (true) {
+        SliceResult result;
+        bool preempted = false;
+        if (debug) { // Breakpoints and stepping need the instrumented loop: run this resume as one slice of it
+            result = engine.runNodes<true>(task, budget, services, preempt, debug, false).result;
+        } else {
+            if (task.halt_requested.load(std::memory_order_relaxed)) {
+                result = SliceResult::HALTED_TASK;
+            } else if (task.resume_node_id == 0) {
+                result = SliceResult::COMPLETED;
+            } else if (backward && (executed >= budget || (executed > 0 && preempt && preempt->load(std::memory_order_relaxed)))) {
+                result = SliceResult::YIELDED;
+                preempted = true;
+            } else {
+                const NodeID current = task.resume_node_id;
+                ++executed;
+                auto stop = engine.step(task, services);
+                backward = task.resume_node_id <= current;
+                if (!stop) continue;
+                result = *stop;
+            }
+            task.at_safe_point = result == SliceResult::WAITING || (result == SliceResult::YIELDED && !preempted);
+            task.instructions_executed += executed;
+        }
+        if (result != SliceResult::YIELDED && result != SliceResult::WAITING) co_return result;
+        co_await TaskCoroutine::suspend(result); // The WAITING payload is delivered before resume
+        resumed();
+    }
+}
+std::optional<TaskEngine::SliceResult> TaskEngine::step(TaskControlBlock& task, TaskServices* services) {
+    if (!task.graph || !task.context) {
+        task.error = "task " + std::to_string(task.task_id) + " has no graph or context";
+        return SliceResult::ERROR;
+    }
+    const BDIGraph& graph = *task.graph;
+    ExecutionContext& ctx = *task.context;
+    auto fault = [&](const std::string& message) {
+        task.error = "node " + std::to_string(task.resume_node_id) + ": " + message;
+        return SliceResult::ERROR;
+    };
+    auto node_opt = graph.getNode(task.resume_node_id);
+    if (!node_opt) return fault("node not found in task graph");
+    const BDINode& node = node_opt.value().get();
+    TraceScope trace(Tracer::global(), node.id, static_cast<uint16_t>(node.operation), task.task_id);
+    ProfileScope profile(Profiler::global(), &ctx, node.id, static_cast<uint16_t>(node.operation));
+    std::string error;
+    if (!gatherInputs(task, node, ctx, error)) return fault(error);
+    NodeID next = node.control_outputs.empty() ? 0 : node.control_outputs[0];
+    // Same-type scalar arithmetic and compares never leave the slots
+    TaggedValue scalar;
+    if (NodeEvaluator::tryEvaluateTagged(node.operation, slots_, scalar)) {
+        ctx.setPortSlot({node.id, 0}, scalar);
+        task.resume_node_id = next;
+        return std::nullopt;
+    }
+    materializeInputs(node, ctx);
+#if BDI_VM_EXCEPTIONS
+    try { // Only non-VM failures (e.g. allocation) can throw; op faults come back as VMStatus
+#endif
+        switch (node.operation) {
+            case OpType::META_START:
+                // Inside a CTRL_CALL the outputs are the staged arguments; at task entry they were seeded
+                for (PortIndex p = 0; p < node.data_outputs.size(); ++p) {
+                    if (auto arg = ctx.getCurrentArgument(p)) ctx.setPortValue(node.id, p, *arg);
+                }
+                break;
+            case OpType::META_END:
+                task.resume_node_id = 0;
+                return SliceResult::COMPLETED;
+            case OpType::CTRL_BRANCH_COND: {
+                if (inputs_.size() != 1 || node.control_outputs.size() < 2) return fault("CTRL_BRANCH_COND needs a condition and two targets");
+                auto condition = vm_ops::tryConvert<bool>(inputs_[0]);
+                if (!condition) return fault("CTRL_BRANCH_COND condition is not convertible to bool");
+                next = condition.value() ? node.control_outputs[0] : node.control_outputs[1];
+                break;
+            }
+            case OpType::CTRL_CALL: {
+                // control_outputs[0] = callee entry, [1] = return address (VM convention)
+                if (node.control_outputs.size() < 2) return fault("CTRL_CALL needs target and return address control outputs");
+                const size_t arity = calleeArity(graph, node.control_outputs[0], inputs_.size());
+                BDIValueVariant* args = ctx.stageArguments(arity);
+                for (size_t i = 0; i < arity && i < inputs_.size(); ++i) args[i] = std::move(inputs_[i]);
+                ctx.pushCallFrame(node.id, node.control_outputs[1]);
+                next = node.control_outputs[0];
+                if (wantsUpgrade(task)) { // Call boundary: let the scheduler swap graphs
+                    task.resume_node_id = next;
+                    return SliceResult::YIELDED;
+                }
+                break;
+            }
+            case OpType::CTRL_RETURN: {
+                ctx.setCurrentReturnValue(inputs_.empty() ? BDIValueVariant{} : inputs_[0]);
+                auto frame = ctx.popCallFrame();
+                if (!frame) { // Return from the task itself
+                    if (!inputs_.empty()) {
+                        task.result = inputs_[0];
+                        task.result_vector = retainVector(inputs_[0]);
+                    }
+                    task.resume_node_id = 0;
+                    return SliceResult::COMPLETED;
+                }
+                if (frame->return_value && !std::holds_alternative<std::monostate>(*frame->return_value)) {
+                    ctx.setPortValue(frame->caller_node_id, 0, *frame->return_value);
+                }
+                next = frame->return_node_id;
+                if (wantsUpgrade(task)) {
+                    task.resume_node_id = next;
+                    return SliceResult::YIELDED;
+                }
+                break;
+            }
+            // --- BDIOS task primitives ---
+            case OpType::SYS_YIELD:
+                task.resume_node_id = next;
+                return SliceResult::YIELDED;
+            case OpType::SYS_WAIT_EVENT: {
+                auto event = idOperand(node, inputs_);
+                if (!event) return fault("SYS_WAIT_EVENT needs an event id (input 0 or payload)");
+                task.wait_event = event.value();
+                task.wait_node_id = node.id;
+                task.resume_node_id = next;
+                return SliceResult::WAITING;
+            }
+            case OpType::SYS_SEND_EVENT: {
+                auto event = idOperand(node, inputs_);
+                if (!event) return fault("SYS_SEND_EVENT needs an event id (input 0 or payload)");
+                if (!services) return fault("SYS_SEND_EVENT outside of a BDIOS scheduler");
+                services->sendEvent(event.value(), inputs_.size() > 1 ? inputs_[1] : BDIValueVariant{});
+                break;
+            }
+            case OpType::SYS_HALT_TASK: {
+                // No input: halt self. Input 0: id of the task to halt (may run on another worker)
+                VMResult<uint64_t> target = inputs_.empty() ? VMResult<uint64_t>(task.task_id) : vm_ops::tryConvert<uint64_t>(inputs_[0]);
+                if (!target) return fault("SYS_HALT_TASK target is not a task id");
+                if (target.value() == task.task_id) return SliceResult::HALTED_TASK;
+                bool halted = services && services->haltTaskFrom(task, target.value());
+                if (!node.data_outputs.empty()) ctx.setPortValue(node.id, 0, halted);
+                break;
+            }
+            case OpType::IO_READ_PORT:
+            case OpType::SYS_REG_READ: {
+                const bool port = node.operation == OpType::IO_READ_PORT;
+                auto address = idOperand(node, inputs_);
+                if (!address) return fault(port ? "IO_READ_PORT needs a port (input 0 or payload)" : "SYS_REG_READ needs a register id (input 0 or payload)");
+                auto value = services ? services->readInput(task, port ? InputSource::IO_PORT : InputSource::SPECIAL_REGISTER, address.value())
+                                      : std::nullopt;
+                if (!value) return fault("no device input for " + std::string(port ? "port " : "register ") + std::to_string(address.value()));
+                ctx.setPortValue(node.id, 0, value.value());
+                break;
+            }
+            // --- Fan-out ---
+            case OpType::CONCURRENCY_SPAWN: {
+                // control_outputs[0] = continuation, [1] = subgraph entry; inputs become its arguments
+                SpawnRuntime* spawner = services ? services->getSpawnRuntime() : nullptr;
+                if (!spawner) return fault("CONCURRENCY_SPAWN without a SpawnRuntime");
+                if (node.control_outputs.size() < 2) return fault("CONCURRENCY_SPAWN needs continuation and subgraph entry control outputs");
+                uint64_t handle = spawner->spawn(graph, node.control_outputs[1], inputs_, services, &task);
+                ctx.setPortValue(node.id, 0, handle);
+                break;
+            }
+            case OpType::CONCURRENCY_JOIN: {
+                SpawnRuntime* spawner = services ? services->getSpawnRuntime() : nullptr;
+                if (!spawner) return fault("CONCURRENCY_JOIN without a SpawnRuntime");
+                auto handle = idOperand(node, inputs_);
+                if (!handle) return fault("CONCURRENCY_JOIN needs a spawn handle (input 0 or payload)");
+                HeldValue result;
+                if (!spawner->join(handle.value(), result, &error)) return fault("CONCURRENCY_JOIN: " + error);
+                if (!std::holds_alternative<std::monostate>(result.get())) ctx.setPortValue(node.id, 0, result);
+                break;
+            }
+            // --- Channels ---
+            case OpType::COMM_CHANNEL_SEND:
+            case OpType::COMM_CHANNEL_RECV: {
+                // Input 0 (or payload): channel id. SEND sends inputs 1.. as one batch; RECV
+                // receives one value per data output (at least one) as one batch.
+                const bool send = node.operation == OpType::COMM_CHANNEL_SEND;
+                ChannelRegistry* channels = services ? services->getChannels() : nullptr;
+                auto id = idOperand(node, inputs_);
+                if (!id) return fault("channel op needs a channel id (input 0 or payload)");
+                Channel* channel = channels ? channels->find(id.value()) : nullptr;
+                if (!channel) return fault("no channel " + std::to_string(id.value()));
+                std::span<BDIValueVariant> values;
+                if (send) {
+                    if (inputs_.size() < 2) return fault("COMM_CHANNEL_SEND needs a channel and at least one value");
+                    for (size_t i = 1; i < inputs_.size(); ++i) {
+                        auto converted = vm_ops::tryConversion(inputs_[i], channel->getElementType());
+                        if (!converted) return fault("COMM_CHANNEL_SEND value " + std::to_string(i) + ": " + toString(converted.error()));
+                        inputs_[i] = std::move(converted.value());
+                    }
+                    values = std::span<BDIValueVariant>(inputs_).subspan(1);
+                } else {
+                    inputs_.assign(std::max<size_t>(1, node.data_outputs.size()), BDIValueVariant{});
+                    values = inputs_;
+                }
+                // A batch larger than the ring never fits: fault instead of parking forever
+                if (values.size() > channel->getCapacity()) {
+                    return fault(std::string(send ? "COMM_CHANNEL_SEND" : "COMM_CHANNEL_RECV") + " batch of " + std::to_string(values.size()) +
+                                 " exceeds capacity " + std::to_string(channel->getCapacity()) + " of channel " + std::to_string(id.value()));
+                }
+                const auto direction = send ? Channel::Direction::SEND : Channel::Direction::RECV;
+                const auto other = send ? Channel::Direction::RECV : Channel::Direction::SEND;
+                auto attempt = [&] { return send ? channel->trySend(values) : channel->tryReceive(values); };
+                bool moved = attempt();
+                if (!moved) {
+                    channel->addWaiter(direction);
+                    moved = attempt();
+                    if (moved) channel->cancelWaiter(direction);
+                }
+                // A replay follows the recorded outcome and values, whatever its own ring holds
+                uint64_t outcome = moved ? 1 : 0;
+                services->exchangeInput(task, InputSource::CHANNEL_MOVED, id.value(), outcome);
+                if (!moved && outcome != 0) channel->cancelWaiter(direction);
+                if (outcome == 0) { // Park; resume_node_id stays here, so the wakeup retries the node
+                    task.wait_event = channel->eventFor(direction);
+                    task.wait_node_id = node.id;
+                    return SliceResult::WAITING;
+                }
+                // Every parked task on the other side: waiters want batches of different sizes, so
+                // waking one per value moved can pick one that re-parks and strand one that fits
+                for (uint32_t n = moved ? channel->takeWaiters(other, std::numeric_limits<uint32_t>::max()) : 0; n > 0; --n) {
+                    services->sendEvent(channel->eventFor(other), BDIValueVariant{});
+                }
+                if (!send) {
+                    for (PortIndex p = 0; p < node.data_outputs.size(); ++p) {
+                        auto received = TaggedValue::fromVariant(values[p]); // Scalars of the element type
+                        uint64_t bits = received ? received->bits : 0;
+                        services->exchangeInput(task, InputSource::CHANNEL_VALUE, id.value(), bits);
+                        ctx.setPortSlot({node.id, p}, TaggedValue{bits, channel->getElementType()});
+                    }
+                }
+                break;
+            }
+            // --- Mutexes ---
+            case OpType::SYNC_MUTEX_LOCK:
+            case OpType::SYNC_MUTEX_UNLOCK: {
+                // Input 0 (or payload): address of a 32-bit word, 0 = free, 1 = locked,
+                // 2 = locked and possibly contended (Drepper's "mutex3")
+                const bool lock = node.operation == OpType::SYNC_MUTEX_LOCK;
+                if (!memory_) return fault(lock ? "SYNC_MUTEX_LOCK without a MemoryManager" : "SYNC_MUTEX_UNLOCK without a MemoryManager");
+                auto address = idOperand(node, inputs_);
+                if (!address) return fault("mutex op needs the address of the mutex word (input 0 or payload)");
+                const uint64_t word = address.value();
+                const uint64_t event = FutexTable::eventFor(word);
+                auto rmw = [&](AtomicOp op, uint32_t operand, uint32_t expected, AtomicOrder order) {
+                    return memory_->atomicRmw(word, sizeof(uint32_t), op, operand, expected, order);
+                };
+                if (!rmw(AtomicOp::LOAD, 0, 0, AtomicOrder::RELAXED)) return fault("mutex word at " + std::to_string(word) + " is out of bounds or not 4-byte aligned");
+                if (!lock) {
+                    const uint64_t previous = *rmw(AtomicOp::XCHG, 0, 0, AtomicOrder::RELEASE);
+                    if (previous == 0) return fault("SYNC_MUTEX_UNLOCK of an unlocked mutex at " + std::to_string(word));
+                    FutexTable* futexes = services ? services->getFutexTable() : nullptr;
+                    if (previous == 2 && futexes && futexes->takeWaiters(word, 1) > 0) services->sendEvent(event, BDIValueVariant{});
+                    break;
+                }
+                // A task woken from this node must leave the word contended: others may still be parked
+                const bool woken = task.wait_node_id == node.id && task.wait_event == event;
+                bool acquired = woken ? *rmw(AtomicOp::XCHG, 2, 0, AtomicOrder::ACQUIRE) == 0
+                                      : *rmw(AtomicOp::CAS, 1, 0, AtomicOrder::ACQUIRE) == 0;
+                bool park = false;
+                FutexTable* futexes = services ? services->getFutexTable() : nullptr;
+                if (!acquired) {
+                    if (!futexes) return fault("contended SYNC_MUTEX_LOCK outside of a BDIOS scheduler");
+                    if (!woken) { // Spin first: most critical sections are shorter than a park/wake round trip
+                        const uint32_t limit = futexes->spinLimit(word);
+                        uint32_t spins = 0;
+                        while (!acquired && spins < limit) {
+                            ++spins;
+                            FutexTable::cpuRelax();
+                            acquired = *rmw(AtomicOp::LOAD, 0, 0, AtomicOrder::RELAXED) == 0 &&
+                                       *rmw(AtomicOp::CAS, 1, 0, AtomicOrder::ACQUIRE) == 0;
+                        }
+                        futexes->recordSpins(word, acquired ? spins : FutexTable::MAX_SPINS);
+                    }
+                    if (!acquired) park = futexes->prepareWait(word, [&] { return *rmw(AtomicOp::XCHG, 2, 0, AtomicOrder::ACQUIRE) != 0; });
+                }
+                if (services) { // A replay follows the recorded outcome, whatever its own interleaving gave
+                    uint64_t outcome = park ? 0 : 1;
+                    services->exchangeInput(task, InputSource::MUTEX_ACQUIRED, word, outcome);
+                    if (park && outcome != 0) {
+                        futexes->cancelWait(word);
+                    } else if (!park && outcome == 0) {
+                        rmw(AtomicOp::XCHG, 0, 0, AtomicOrder::RELEASE); // Hand back the lock it was not recorded taking
+                    }
+                    park = outcome == 0;
+                }
+                if (park) { // resume_node_id stays here, so the wakeup retries the lock
+                    task.wait_event = event;
+                    task.wait_node_id = node.id;
+                    return SliceResult::WAITING;
+                }
+                task.wait_event = 0;
+                task.wait_node_id = 0;
+                break;
+            }
+            case OpType::META_NOP:
+            case OpType::META_CONST:
+                if (const TaggedValue* constant = task.constants ? task.constants->find(node.id) : nullptr) {
+                    ctx.setPortSlot({node.id, 0}, *constant);
+                    break;
+                }
+                [[fallthrough]];
+            default: {
+                HeldValue result;
+                VMErrorInfo error;
+                VMStatus status = NodeEvaluator::tryEvaluate(node, inputs_, memory_, result, &error);
+                if (status == VMStatus::UNSUPPORTED_OP) {
+                    return fault("operation " + std::to_string(static_cast<int>(node.operation)) + " not supported in BDIOS tasks");
+                }
+                if (status != VMStatus::OK) {
+                    ctx.setLastError(error);
+                    return fault(error.message());
+                }
+                if (!std::holds_alternative<std::monostate>(result.get())) ctx.setPortValue(node.id, 0, result);
+                break;
+            }
+        }
+#if BDI_VM_EXCEPTIONS
+    } catch (const std::exception& e) {
+        return fault(e.what());
+    }
+#endif
+    task.resume_node_id = next;
+    return std::nullopt;
+}
+} // namespace bdi::runtime
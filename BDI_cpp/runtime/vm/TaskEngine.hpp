@@ -0,0 +1,159 @@
+#ifndef BDI_RUNTIME_TASKENGINE_HPP
+#define BDI_RUNTIME_TASKENGINE_HPP
+#include "BDIGraph.hpp"
+#include "ExecutionContext.hpp"
+#include "TaskCoroutine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+namespace bdi::hal { class HardwareAbstractionLayer; }
+namespace bdi::runtime {
+class MemoryManager;
+class SpawnRuntime;
+class ChannelRegistry;
+class FutexTable;
+class DebugSession;
+class GraphVersion;
+class ConstantPool;
+using bdi::core::graph::BDIGraph;
+using bdi::core::graph::BDINode;
+// --- Task Control Block ---
+enum class TaskStatus : uint8_t { READY, RUNNING, WAITING, COMPLETED, HALTED, FAULTED };
+// All state of a BDIOS task. Nothing task-specific lives in the engine that runs it, so
+// a TCB can be resumed by any worker; the owning scheduler hands it over under a lock.
+struct TaskControlBlock {
+    uint64_t task_id = 0;
+    const BDIGraph* graph = nullptr;
+    std::shared_ptr<const GraphVersion> version; // Registry version 'graph' belongs to (null = unversioned)
+    const ConstantPool* constants = nullptr;   // Decoded constants of 'graph' (null = decode payloads)
+    NodeID resume_node_id = 0;                 // Where to restart execution (0 = finished)
+    std::unique_ptr<ExecutionContext> context; // Port values and call stack; moves with the task
+    TaskStatus status = TaskStatus::READY;
+    uint64_t wait_event = 0;                   // Event id while WAITING
+    NodeID wait_node_id = 0;                   // SYS_WAIT_EVENT node that receives the event payload
+    std::atomic<bool> halt_requested{false};   // Set from any thread; honoured between nodes
+    int last_worker = -1;                      // Worker that ran the previous slice
+    bool at_safe_point = true;                 // Not started, or the last slice ended at SYS_YIELD, a wait or a call boundary
+    uint64_t failed_hop = 0;                   // Version a hop off 'version' last failed to reach (0 = none); stops call-boundary yields
+    uint64_t instructions_executed = 0;
+    std::optional<BDIValueVariant> result;     // Top-level CTRL_RETURN value
+    PackedVector result_vector;                // Owns a vector 'result'
+    std::string error;
+    TaskCoroutine coroutine;                   // Suspended interpreter (coroutine mode only)
+};
+// --- External Inputs ---
+// Values a task reads from outside its graph. They are the only non-deterministic
+// inputs of a task besides event delivery and scheduling, so they go through
+// TaskServices where an ExecutionJournal can record and replay them.
+enum class InputSource : uint8_t {
+    IO_PORT,          // IO_READ_PORT: address = port
+    SPECIAL_REGISTER, // SYS_REG_READ: address = hal::SpecialRegister (timer values etc.)
+    HALT_RESULT,      // SYS_HALT_TASK on another task: address = target, value = 0/1
+    CHANNEL_MOVED,    // COMM_CHANNEL_SEND/RECV: address = channel, value = 1 batch moved / 0 parked
+    CHANNEL_VALUE,    // COMM_CHANNEL_RECV: address = channel, value = bits of one received value
+    MUTEX_ACQUIRED    // SYNC_MUTEX_LOCK: address = mutex word, value = 1 acquired / 0 parked
+};
+// Live source of IO ports and special registers
+class DeviceInputs {
+public:
+    virtual ~DeviceInputs() = default;
+    virtual std::optional<uint64_t> read(InputSource source, uint64_t address) = 0;
+};
+// Reads special registers from the HAL and IO ports as 8-byte MMIO reads
+class HalDeviceInputs : public DeviceInputs {
+public:
+    explicit HalDeviceInputs(bdi::hal::HardwareAbstractionLayer* hal) : hal_(hal) {}
+    std::optional<uint64_t> read(InputSource source, uint64_t address) override;
+private:
+    bdi::hal::HardwareAbstractionLayer* hal_;
+};
+// Services a running task can request from the OS layer (implemented by TaskScheduler)
+class TaskServices {
+public:
+    virtual ~TaskServices() = default;
+    virtual void sendEvent(uint64_t event_id, BDIValueVariant payload) = 0;
+    virtual bool haltTask(uint64_t task_id) = 0;
+    // SYS_HALT_TASK from a running task; the scheduler records the result for replay
+    virtual bool haltTaskFrom(TaskControlBlock& caller, uint64_t task_id) { (void)caller; return haltTask(task_id); }
+    // Channel ops and mutex locks: their results depend on how tasks interleaved, so the
+    // scheduler journals 'value' and a replay overwrites it with the recorded one
+    virtual void exchangeInput(TaskControlBlock& task, InputSource source, uint64_t address, uint64_t& value) {
+        (void)task; (void)source; (void)address; (void)value;
+    }
+    // IO_READ_PORT / SYS_REG_READ. nullopt = no device (the node faults)
+    virtual std::optional<uint64_t> readInput(TaskControlBlock& task, InputSource source, uint64_t address) {
+        (void)task; (void)source; (void)address;
+        return std::nullopt;
+    }
+    // Runs CONCURRENCY_SPAWN/JOIN. nullptr = not available (the nodes fault)
+    virtual SpawnRuntime* getSpawnRuntime() { return nullptr; }
+    // Channels for COMM_CHANNEL_SEND/RECV. nullptr = none (the nodes fault)
+    virtual ChannelRegistry* getChannels() { return nullptr; }
+    // Parking lot for SYNC_MUTEX_LOCK/UNLOCK. nullptr = a contended lock faults
+    virtual FutexTable* getFutexTable() { return nullptr; }
+    // Asked once per slice; non-null switches the slice to the instrumented loop
+    virtual DebugSession* getDebugSession() { return nullptr; }
+    // Asked once per slice: a flag raised by a timer to end it at the next preemption
+    // point. nullptr = the node budget alone ends the slice
+    virtual const std::atomic<bool>* getPreemptFlag(const TaskControlBlock& task) { (void)task; return nullptr; }
+};
+// Interprets BDIOS tasks: meta/data ops via NodeEvaluator, intra-graph control flow
+// (JUMP, BRANCH_COND, CALL/RETURN), the task primitives SYS_YIELD, SYS_WAIT_EVENT,
+// SYS_SEND_EVENT and SYS_HALT_TASK, the device reads IO_READ_PORT and SYS_REG_READ,
+// CONCURRENCY_SPAWN/JOIN through the services' SpawnRuntime, COMM_CHANNEL_SEND/RECV,
+// which park the task on a full/empty channel and retry the node when woken, and
+// SYNC_MUTEX_LOCK/UNLOCK on 32-bit words in MemoryManager memory, which spin adaptively
+// and then park on the services' FutexTable.
+// Two drivers share step(): runSlice() re-enters the loop from the TCB's resume node
+// on every slice (one engine per worker), while interpret() is a coroutine that suspends
+// its own node loop at SYS_YIELD, SYS_WAIT_EVENT and preemption points, so a switch is a
+// resume() that picks up at the next node.
+// Each slice runs one of two copies of the loop: the plain one, or, while the services
+// hand out a DebugSession, one that checks breakpoints and pause/step requests first.
+// Slices end early only at preemption points, where a node passes control to the same
+// or an earlier node id (loop back-edges, backward calls and returns), once the node
+// budget is spent or the services' preempt flag is up. Once a newer version of the
+// task's graph is published, CTRL_CALL and CTRL_RETURN end the slice so the scheduler
+// can move the task over between slices.
+// Constant nodes are copied from the task's ConstantPool when it has one.
+// An engine is not thread-safe.
+class TaskEngine {
+public:
+    using SliceResult = TaskSliceResult;
+    struct SliceOutcome {
+        SliceResult result = SliceResult::ERROR;
+        uint64_t instructions = 0; // Nodes executed in this slice
+        bool preempted = false;    // YIELDED because the budget ran out or the timer fired, not SYS_YIELD
+    };
+    explicit TaskEngine(MemoryManager* memory = nullptr);
+    // Runs 'task' from task.resume_node_id until the first preemption point after
+    // 'budget' nodes (or after the preempt flag rises). Updates
+    // resume_node_id, wait_event/wait_node_id, result and error in the TCB; the
+    // caller owns the status transition. 'exact' checks the budget at every node, so a
+    // replayed slice stops after its recorded step count even where a halt cut it short.
+    SliceOutcome runSlice(TaskControlBlock& task, uint64_t budget, TaskServices* services = nullptr, bool exact = false);
+    // Coroutine driver: each resume() runs up to 'budget' nodes and suspends with
+    // YIELDED/WAITING, or finishes with COMPLETED/HALTED_TASK/ERROR. The frame (from
+    // CoroutineFramePool) owns its own engine and node loop, so it can be resumed on any
+    // worker. Resumes while a DebugSession is handed out run the instrumented loop instead.
+    static TaskCoroutine interpret(TaskControlBlock& task, MemoryManager* memory, TaskServices* services, uint64_t budget);
+    // Undoes the channel or mutex waiter registration of a task that ended WAITING on one
+    // but will never be woken (a spawned task faults instead of parking)
+    static void abandonWait(const TaskControlBlock& task, TaskServices* services);
+private:
+    MemoryManager* memory_;
+    std::vector<TaggedValue> slots_;      // Input port slots; ARRAY = lanes stay in the context
+    std::vector<BDIValueVariant> inputs_; // Variant inputs, built only when the tagged fast path misses
+    template <bool Debug>
+    SliceOutcome runNodes(TaskControlBlock& task, uint64_t budget, TaskServices* services, const std::atomic<bool>* preempt,
+                          DebugSession* debug, bool exact);
+    // Executes the node at task.resume_node_id and advances it; nullopt = keep going
+    std::optional<SliceResult> step(TaskControlBlock& task, TaskServices* services);
+    bool gatherInputs(const TaskControlBlock& task, const BDINode& node, ExecutionContext& ctx, std::string& error);
+    void materializeInputs(const BDINode& node, const ExecutionContext& ctx);
+};
+} // namespace bdi::runtime
+#endif // BDI_RUNTIME_TASKENGINE_HPP
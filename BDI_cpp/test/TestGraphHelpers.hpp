@@ -0,0 +1,14 @@
+#ifndef BDI_TEST_TESTGRAPHHELPERS_HPP
+#define BDI_TEST_TESTGRAPHHELPERS_HPP
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+// Graph-building helpers shared by the test files
+// META_CONST node carrying 'payload' on output 0
+inline bdi::core::graph::NodeID addConst(bdi::frontend::api::GraphBuilder& builder, bdi::core::payload::TypedPayload payload) {
+    bdi::core::graph::NodeID id = builder.addNode(bdi::core::graph::BDIOperationType::META_CONST);
+    builder.setNodePayload(id, payload);
+    builder.defineDataOutput(id, 0, payload.type);
+    return id;
+}
+#endif // BDI_TEST_TESTGRAPHHELPERS_HPP
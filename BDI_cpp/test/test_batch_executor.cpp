@@ -0,0 +1,189 @@
+#include "gtest.h"
+#include "BatchExecutor.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <limits>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static BatchColumn iotaColumn(size_t lanes, int32_t first) {
+    BatchColumn column(BDIType::INT32, lanes);
+    for (size_t i = 0; i < lanes; ++i) column.data<int32_t>()[i] = first + static_cast<int32_t>(i);
+    return column;
+}
+// --- Tests ---
+TEST(BatchExecutorTest, ColumnLaneRoundTrip) {
+    BatchColumn column(BDIType::FLOAT32, 4);
+    EXPECT_TRUE(column.setLane(2, BDIValueVariant(1.5f)));
+    EXPECT_TRUE(column.setLane(3, BDIValueVariant(int32_t{7}))); // Converted to the column type
+    EXPECT_FALSE(column.setLane(4, BDIValueVariant(1.0f)));
+    EXPECT_EQ(std::get<float>(column.getLane(2)), 1.5f);
+    EXPECT_EQ(std::get<float>(column.getLane(3)), 7.0f);
+    BatchColumn flags = BatchColumn::broadcast(BDIType::BOOL, 3, BDIValueVariant(true));
+    EXPECT_TRUE(std::get<bool>(flags.getLane(1)));
+}
+TEST(BatchExecutorTest, StraightLineArithmeticOverColumns) {
+    // out = (a * 3) + 1 for every lane
+    GraphBuilder builder("BatchArith");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    NodeID three = addConst(builder, TypedPayload::createFrom(int32_t{3}));
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID mul = builder.addNode(BDIOperationType::ARITH_MUL);
+    builder.defineDataOutput(mul, 0, BDIType::INT32);
+    builder.connectData(start, 0, mul, 0);
+    builder.connectData(three, 0, mul, 1);
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(mul, 0, add, 0);
+    builder.connectData(one, 0, add, 1);
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, mul);
+    builder.connectControl(mul, add);
+    builder.connectControl(add, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    const size_t lanes = 1000;
+    BatchExecutor batch(lanes);
+    ASSERT_TRUE(batch.setInputColumn({start, 0}, iotaColumn(lanes, 0)));
+    ASSERT_TRUE(batch.execute(*graph, start)) << batch.getLastError();
+    const BatchColumn* result = batch.getColumn({add, 0});
+    ASSERT_NE(result, nullptr);
+    for (size_t i = 0; i < lanes; ++i) {
+        EXPECT_EQ(result->data<int32_t>()[i], static_cast<int32_t>(i) * 3 + 1);
+        EXPECT_EQ(batch.getLaneStatus()[i], BatchExecutor::LaneStatus::COMPLETED);
+    }
+}
+TEST(BatchExecutorTest, DivergentBranchSplitsAndReturnsPerLane) {
+    // a < 0 ? return -a : return a
+    GraphBuilder builder("BatchBranch");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    NodeID zero = addConst(builder, TypedPayload::createFrom(int32_t{0}));
+    NodeID cmp = builder.addNode(BDIOperationType::CMP_LT);
+    builder.defineDataOutput(cmp, 0, BDIType::BOOL);
+    builder.connectData(start, 0, cmp, 0);
+    builder.connectData(zero, 0, cmp, 1);
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(cmp, 0, branch, 0);
+    NodeID neg = builder.addNode(BDIOperationType::ARITH_NEG);
+    builder.defineDataOutput(neg, 0, BDIType::INT32);
+    builder.connectData(start, 0, neg, 0);
+    NodeID ret_neg = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(neg, 0, ret_neg, 0);
+    NodeID ret_pos = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(start, 0, ret_pos, 0);
+    builder.connectControl(start, cmp);
+    builder.connectControl(cmp, branch);
+    builder.connectControl(branch, neg);
+    builder.connectControl(branch, ret_pos);
+    builder.connectControl(neg, ret_neg);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    const size_t lanes = 64;
+    BatchExecutor batch(lanes);
+    ASSERT_TRUE(batch.setInputColumn({start, 0}, iotaColumn(lanes, -32)));
+    ASSERT_TRUE(batch.execute(*graph, start)) << batch.getLastError();
+    for (size_t i = 0; i < lanes; ++i) {
+        const int32_t input = -32 + static_cast<int32_t>(i);
+        EXPECT_EQ(std::get<int32_t>(batch.getReturnValues()[i]), input < 0 ? -input : input);
+    }
+}
+TEST(BatchExecutorTest, LoopWithPerLaneTripCountsReconverges) {
+    // count = count + 1 while count < n; lanes run different trip counts through one loop header
+    GraphBuilder builder("BatchLoop");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32); // n
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID inc = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(inc, 0, BDIType::INT32);
+    builder.connectData(inc, 0, inc, 0); // Loop-carried value
+    builder.connectData(one, 0, inc, 1);
+    NodeID cmp = builder.addNode(BDIOperationType::CMP_LT);
+    builder.defineDataOutput(cmp, 0, BDIType::BOOL);
+    builder.connectData(inc, 0, cmp, 0);
+    builder.connectData(start, 0, cmp, 1);
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(cmp, 0, branch, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(inc, 0, ret, 0);
+    builder.connectControl(start, inc);
+    builder.connectControl(inc, cmp);
+    builder.connectControl(cmp, branch);
+    builder.connectControl(branch, inc); // Back edge (true)
+    builder.connectControl(branch, ret); // Exit (false)
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    const size_t lanes = 16;
+    BatchExecutor batch(lanes);
+    ASSERT_TRUE(batch.setInputColumn({start, 0}, iotaColumn(lanes, 0)));
+    ASSERT_TRUE(batch.setInputColumn({inc, 0}, BatchColumn(BDIType::INT32, lanes))); // count starts at 0
+    ASSERT_TRUE(batch.execute(*graph, start, 1000)) << batch.getLastError();
+    for (size_t i = 0; i < lanes; ++i) {
+        EXPECT_EQ(std::get<int32_t>(batch.getReturnValues()[i]), std::max<int32_t>(1, static_cast<int32_t>(i)));
+    }
+}
+TEST(BatchExecutorTest, DivisionByZeroFaultsOnlyThatLane) {
+    GraphBuilder builder("BatchDiv");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    NodeID hundred = addConst(builder, TypedPayload::createFrom(int32_t{100}));
+    NodeID div = builder.addNode(BDIOperationType::ARITH_DIV);
+    builder.defineDataOutput(div, 0, BDIType::INT32);
+    builder.connectData(hundred, 0, div, 0);
+    builder.connectData(start, 0, div, 1);
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, div);
+    builder.connectControl(div, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    BatchExecutor batch(4);
+    ASSERT_TRUE(batch.setInputColumn({start, 0}, iotaColumn(4, 0))); // Lane 0 divides by zero
+    ASSERT_TRUE(batch.execute(*graph, start));
+    EXPECT_EQ(batch.getLaneStatus()[0], BatchExecutor::LaneStatus::FAULTED);
+    EXPECT_FALSE(batch.getLastError().empty());
+    for (size_t i = 1; i < 4; ++i) {
+        EXPECT_EQ(batch.getLaneStatus()[i], BatchExecutor::LaneStatus::COMPLETED);
+        EXPECT_EQ(std::get<int32_t>(*batch.getLaneValue({div, 0}, i)), 100 / static_cast<int32_t>(i));
+    }
+}
+TEST(BatchExecutorTest, IntegerOverflowWrapsAndFloatConversionFaultsOutOfRangeLanes) {
+    // sum = a + INT32_MAX (wraps); conv = (int32)(x) with x:float64
+    GraphBuilder builder("BatchOverflow");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    builder.defineDataOutput(start, 1, BDIType::FLOAT64);
+    NodeID max = addConst(builder, TypedPayload::createFrom(std::numeric_limits<int32_t>::max()));
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(start, 0, add, 0);
+    builder.connectData(max, 0, add, 1);
+    NodeID conv = builder.addNode(BDIOperationType::CONV_FLOAT_TO_INT);
+    builder.defineDataOutput(conv, 0, BDIType::INT32);
+    builder.connectData(start, 1, conv, 0);
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, add);
+    builder.connectControl(add, conv);
+    builder.connectControl(conv, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    BatchExecutor batch(4);
+    BatchColumn floats(BDIType::FLOAT64, 4);
+    const double inputs[] = {-2.5, 1e12, std::numeric_limits<double>::quiet_NaN(), 7.9};
+    for (size_t i = 0; i < 4; ++i) floats.data<double>()[i] = inputs[i];
+    ASSERT_TRUE(batch.setInputColumn({start, 0}, iotaColumn(4, 0)));
+    ASSERT_TRUE(batch.setInputColumn({start, 1}, std::move(floats)));
+    ASSERT_TRUE(batch.execute(*graph, start)) << batch.getLastError();
+    EXPECT_EQ(std::get<int32_t>(*batch.getLaneValue({add, 0}, 1)), std::numeric_limits<int32_t>::min());
+    EXPECT_EQ(batch.getLaneStatus()[0], BatchExecutor::LaneStatus::COMPLETED);
+    EXPECT_EQ(batch.getLaneStatus()[1], BatchExecutor::LaneStatus::FAULTED);
+    EXPECT_EQ(batch.getLaneStatus()[2], BatchExecutor::LaneStatus::FAULTED);
+    EXPECT_EQ(batch.getLaneStatus()[3], BatchExecutor::LaneStatus::COMPLETED);
+    EXPECT_EQ(std::get<int32_t>(*batch.getLaneValue({conv, 0}, 0)), -2);
+    EXPECT_EQ(std::get<int32_t>(*batch.getLaneValue({conv, 0}, 3)), 7);
+}
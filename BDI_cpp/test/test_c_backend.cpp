@@ -0,0 +1,325 @@
+#include "gtest.h"
+#include "BDIToC.hpp"
+#include "NativeModuleCache.hpp"
+#include "TaskEngine.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <unistd.h>
+#include <vector>
+using namespace chimera::backend;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+using bdi::runtime::BDIValueVariant;
+using bdi::runtime::ExecutionContext;
+using bdi::runtime::TaskControlBlock;
+using bdi::runtime::TaggedValue;
+using bdi::runtime::TaskEngine;
+// --- Helpers --
+// START(a:int32) -> ADD(a, 40) -> RETURN
+static std::unique_ptr<BDIGraph> buildAddGraph() {
+    GraphBuilder builder("CBackendAdd");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    NodeID forty = addConst(builder, TypedPayload::createFrom(int32_t{40}));
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(start, 0, add, 0);
+    builder.connectData(forty, 0, add, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, ret, 0);
+    builder.connectControl(start, add);
+    builder.connectControl(add, ret);
+    return builder.finalizeGraph();
+}
+// START(a:int32) -> a < 0 ? RETURN(-a) : RETURN(a)
+static std::unique_ptr<BDIGraph> buildAbsGraph() {
+    GraphBuilder builder("CBackendBranch");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT32);
+    NodeID zero = addConst(builder, TypedPayload::createFrom(int32_t{0}));
+    NodeID cmp = builder.addNode(BDIOperationType::CMP_LT);
+    builder.defineDataOutput(cmp, 0, BDIType::BOOL);
+    builder.connectData(start, 0, cmp, 0);
+    builder.connectData(zero, 0, cmp, 1);
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(cmp, 0, branch, 0);
+    NodeID neg = builder.addNode(BDIOperationType::ARITH_NEG);
+    builder.defineDataOutput(neg, 0, BDIType::INT32);
+    builder.connectData(start, 0, neg, 0);
+    NodeID ret_neg = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(neg, 0, ret_neg, 0);
+    NodeID ret_pos = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(start, 0, ret_pos, 0);
+    builder.connectControl(start, cmp);
+    builder.connectControl(cmp, branch);
+    builder.connectControl(branch, neg);     // True target
+    builder.connectControl(branch, ret_pos); // False target
+    builder.connectControl(neg, ret_neg);
+    return builder.finalizeGraph();
+}
+// START(x:float64) -> CONV_FLOAT_TO_INT(x):int32 -> RETURN
+static std::unique_ptr<BDIGraph> buildFloatToIntGraph() {
+    GraphBuilder builder("CBackendFloatToInt");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::FLOAT64);
+    NodeID conv = builder.addNode(BDIOperationType::CONV_FLOAT_TO_INT);
+    builder.defineDataOutput(conv, 0, BDIType::INT32);
+    builder.connectData(start, 0, conv, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(conv, 0, ret, 0);
+    builder.connectControl(start, conv);
+    builder.connectControl(conv, ret);
+    return builder.finalizeGraph();
+}
+// START(a[, b]) -> op(a[, b]):result -> RETURN, one START output per operand type
+static std::unique_ptr<BDIGraph> buildOpGraph(BDIOperationType op, const std::vector<BDIType>& operands, BDIType result) {
+    GraphBuilder builder("CBackendOp");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID node = builder.addNode(op);
+    builder.defineDataOutput(node, 0, result);
+    for (PortIndex i = 0; i < operands.size(); ++i) {
+        builder.defineDataOutput(start, i, operands[i]);
+        builder.connectData(start, i, node, i);
+    }
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(node, 0, ret, 0);
+    builder.connectControl(start, node);
+    builder.connectControl(node, ret);
+    return builder.finalizeGraph();
+}
+// Private cache directory, removed with everything compiled into it
+class ScopedCacheDir {
+public:
+    explicit ScopedCacheDir(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path_);
+    }
+    ~ScopedCacheDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+    std::string string() const { return path_.string(); }
+private:
+    std::filesystem::path path_;
+};
+// Runs 'entry' on the interpreter; nullopt if the task does not complete
+static std::optional<BDIValueVariant> interpret(const BDIGraph& graph, NodeID entry, const std::vector<BDIValueVariant>& args) {
+    TaskControlBlock task;
+    task.graph = &graph;
+    task.context = std::make_unique<ExecutionContext>();
+    for (PortIndex i = 0; i < args.size(); ++i) task.context->setPortValue(entry, i, args[i]);
+    task.resume_node_id = entry;
+    TaskEngine engine;
+    auto outcome = engine.runSlice(task, std::numeric_limits<uint64_t>::max());
+    if (outcome.result != TaskEngine::SliceResult::COMPLETED) return std::nullopt;
+    return task.result;
+}
+// --- Tests ---
+TEST(CBackendTest, EmitsOneFunctionPerEntry) {
+    auto graph = buildAddGraph();
+    ASSERT_NE(graph, nullptr);
+    BDIToC emitter;
+    auto result = emitter.convertGraph(*graph, "unit");
+    ASSERT_TRUE(result.has_value()) << emitter.getLastError();
+    ASSERT_EQ(result->entries.size(), 1);
+    EXPECT_NE(result->source.find(result->entries[0].symbol + "("), std::string::npos);
+    EXPECT_TRUE(result->entries[0].live_ins.empty());
+    // Deterministic output is what makes the content-hash cache sound
+    auto again = emitter.convertGraph(*graph, "unit");
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(result->source, again->source);
+}
+TEST(CBackendTest, UnsupportedOpFailsConversion) {
+    GraphBuilder builder("CBackendUnsupported");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID print = builder.addNode(BDIOperationType::IO_PRINT);
+    builder.connectControl(start, print);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    BDIToC emitter;
+    EXPECT_FALSE(emitter.convertGraph(*graph).has_value());
+    EXPECT_FALSE(emitter.getLastError().empty());
+}
+TEST(CBackendTest, ContentHashIgnoresGraphName) {
+    auto a = buildAddGraph();
+    auto b = buildAddGraph();
+    auto c = buildAbsGraph();
+    ASSERT_NE(a, nullptr); ASSERT_NE(b, nullptr); ASSERT_NE(c, nullptr);
+    EXPECT_EQ(a->computeContentHash(), b->computeContentHash());
+    EXPECT_NE(a->computeContentHash(), c->computeContentHash());
+}
+TEST(CBackendTest, CompileAndRunMatchesInterpreterSemantics) {
+    ScopedCacheDir dir("bdi_test_aot_cache");
+    NativeModuleCache cache(dir.string());
+    auto add_graph = buildAddGraph();
+    auto abs_graph = buildAbsGraph();
+    auto add_module = cache.getOrCompile(*add_graph);
+    if (!add_module) GTEST_SKIP() << "No system C compiler: " << cache.getLastError();
+    auto abs_module = cache.getOrCompile(*abs_graph);
+    ASSERT_NE(abs_module, nullptr) << cache.getLastError();
+    EXPECT_EQ(cache.getOrCompile(*add_graph), add_module); // Served from the in-process cache
+    auto call = [](const NativeEntry& entry, int32_t arg) {
+        BDIAotSlot in{static_cast<uint64_t>(static_cast<int64_t>(arg)), static_cast<uint32_t>(BDIType::INT32), 0};
+        BDIAotSlot ret{};
+        uint64_t status = entry.fn(&in, 1, nullptr, nullptr, &ret, nullptr, 0);
+        EXPECT_EQ(status, 0u);
+        EXPECT_EQ(ret.type, static_cast<uint32_t>(BDIType::INT32));
+        return static_cast<int32_t>(ret.bits);
+    };
+    auto expect_same = [&call](const BDIGraph& graph, const NativeModule& module, int32_t arg) {
+        ASSERT_EQ(module.getEntries().size(), 1);
+        const NativeEntry& entry = module.getEntries()[0];
+        auto interpreted = interpret(graph, entry.entry_node_id, {arg});
+        ASSERT_TRUE(interpreted.has_value()) << "argument " << arg;
+        EXPECT_EQ(call(entry, arg), std::get<int32_t>(*interpreted)) << "argument " << arg;
+    };
+    for (int32_t arg : {2, -50, 0, std::numeric_limits<int32_t>::max()}) expect_same(*add_graph, *add_module, arg);
+    for (int32_t arg : {-7, 9, 0}) expect_same(*abs_graph, *abs_module, arg);
+    EXPECT_EQ(call(add_module->getEntries()[0], 2), 42);
+    EXPECT_EQ(call(abs_module->getEntries()[0], -7), 7);
+    // A fresh cache reuses the on-disk object for the same content hash
+    NativeModuleCache reopened(dir.string());
+    auto reloaded = reopened.getOrCompile(*add_graph);
+    ASSERT_NE(reloaded, nullptr) << reopened.getLastError();
+    EXPECT_EQ(reloaded->getKey(), add_module->getKey());
+    EXPECT_EQ(call(reloaded->getEntries()[0], 1), 41);
+}
+TEST(CBackendTest, CacheLoadsOnlyPrivateObjects) {
+    namespace fs = std::filesystem;
+    auto graph = buildAddGraph();
+    ASSERT_NE(graph, nullptr);
+    ScopedCacheDir dir("bdi_test_aot_private");
+    {
+        NativeModuleCache cache(dir.string());
+        if (!cache.getOrCompile(*graph)) GTEST_SKIP() << "No system C compiler: " << cache.getLastError();
+    }
+    EXPECT_EQ((fs::status(dir.string()).permissions() & fs::perms::all), fs::perms::owner_all); // Created 0700
+    fs::path object;
+    for (const auto& file : fs::directory_iterator(dir.string())) {
+        if (file.path().extension() == ".so") object = file.path();
+    }
+    ASSERT_FALSE(object.empty());
+    // An object someone else could have replaced is not loaded
+    fs::permissions(object, fs::perms::group_write | fs::perms::others_write, fs::perm_options::add);
+    NativeModuleCache shared_object(dir.string());
+    EXPECT_EQ(shared_object.getOrCompile(*graph), nullptr);
+    EXPECT_NE(shared_object.getLastError().find("not private"), std::string::npos) << shared_object.getLastError();
+    // Nor is anything in a directory others can write
+    fs::permissions(object, fs::perms::group_write | fs::perms::others_write, fs::perm_options::remove);
+    fs::permissions(dir.string(), fs::perms::others_write, fs::perm_options::add);
+    NativeModuleCache shared_dir(dir.string());
+    EXPECT_EQ(shared_dir.getOrCompile(*graph), nullptr);
+    EXPECT_NE(shared_dir.getLastError().find("not private"), std::string::npos) << shared_dir.getLastError();
+    fs::permissions(dir.string(), fs::perms::others_write, fs::perm_options::remove);
+    NativeModuleCache restored(dir.string());
+    EXPECT_NE(restored.getOrCompile(*graph), nullptr) << restored.getLastError();
+}
+TEST(CBackendTest, FloatToIntTrapsWhereTheInterpreterFaults) {
+    auto graph = buildFloatToIntGraph();
+    ASSERT_NE(graph, nullptr);
+    ScopedCacheDir dir("bdi_test_aot_conv");
+    NativeModuleCache cache(dir.string());
+    auto module = cache.getOrCompile(*graph);
+    if (!module) GTEST_SKIP() << "No system C compiler: " << cache.getLastError();
+    const NativeEntry& entry = module->getEntries()[0];
+    for (double x : {2.75, -2.75, 2147483647.5, -2147483648.9, 2147483648.0, -2147483649.0, 1e300,
+                     std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity()}) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &x, sizeof(x));
+        BDIAotSlot in{bits, static_cast<uint32_t>(BDIType::FLOAT64), 0};
+        BDIAotSlot ret{};
+        const uint64_t status = entry.fn(&in, 1, nullptr, nullptr, &ret, nullptr, 0);
+        auto interpreted = interpret(*graph, entry.entry_node_id, {x});
+        if (!interpreted) {
+            EXPECT_EQ(status, BDI_AOT_TRAP) << x;
+        } else {
+            ASSERT_EQ(status, 0u) << x;
+            EXPECT_EQ(static_cast<int32_t>(ret.bits), std::get<int32_t>(*interpreted)) << x;
+        }
+    }
+}
+TEST(CBackendTest, MemoryAccessIsBoundsChecked) {
+    GraphBuilder builder("CBackendMemory");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::UINT64); // Address
+    NodeID load = builder.addNode(BDIOperationType::MEM_LOAD);
+    builder.defineDataOutput(load, 0, BDIType::INT32);
+    builder.connectData(start, 0, load, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(load, 0, ret, 0);
+    builder.connectControl(start, load);
+    builder.connectControl(load, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    ScopedCacheDir dir("bdi_test_aot_memory");
+    NativeModuleCache cache(dir.string());
+    auto module = cache.getOrCompile(*graph);
+    if (!module) GTEST_SKIP() << "No system C compiler: " << cache.getLastError();
+    std::vector<uint8_t> memory(16, 0);
+    int32_t stored = 1234;
+    std::memcpy(memory.data() + 8, &stored, sizeof(stored));
+    const NativeEntry& entry = module->getEntries()[0];
+    BDIAotSlot addr{8, static_cast<uint32_t>(BDIType::UINT64), 0};
+    BDIAotSlot result{};
+    EXPECT_EQ(entry.fn(&addr, 1, nullptr, nullptr, &result, memory.data(), memory.size()), 0u);
+    EXPECT_EQ(static_cast<int32_t>(result.bits), 1234);
+    addr.bits = 14; // Straddles the end of memory
+    EXPECT_EQ(entry.fn(&addr, 1, nullptr, nullptr, &result, memory.data(), memory.size()), BDI_AOT_TRAP);
+}
+TEST(CBackendTest, EdgeCasesMatchTheInterpreter) {
+    using Op = BDIOperationType;
+    using Args = std::vector<BDIValueVariant>;
+    constexpr int32_t kMin32 = std::numeric_limits<int32_t>::min();
+    ScopedCacheDir dir("bdi_test_aot_edges");
+    NativeModuleCache cache(dir.string());
+    // Operand types come from the first case; a fault in the interpreter must be a native trap
+    auto check = [&cache](Op op, BDIType result, const std::vector<Args>& cases) {
+        std::vector<BDIType> operands;
+        for (const BDIValueVariant& arg : cases[0]) operands.push_back(TaggedValue::fromVariant(arg)->type);
+        auto graph = buildOpGraph(op, operands, result);
+        ASSERT_NE(graph, nullptr);
+        auto module = cache.getOrCompile(*graph);
+        ASSERT_NE(module, nullptr) << cache.getLastError();
+        const NativeEntry& entry = module->getEntries()[0];
+        for (size_t c = 0; c < cases.size(); ++c) {
+            std::vector<BDIAotSlot> slots;
+            for (const BDIValueVariant& arg : cases[c]) {
+                TaggedValue tagged = *TaggedValue::fromVariant(arg);
+                slots.push_back({tagged.bits, static_cast<uint32_t>(tagged.type), 0});
+            }
+            BDIAotSlot ret{};
+            const uint64_t status = entry.fn(slots.data(), static_cast<uint32_t>(slots.size()), nullptr, nullptr, &ret, nullptr, 0);
+            auto interpreted = interpret(*graph, entry.entry_node_id, cases[c]);
+            if (!interpreted) {
+                EXPECT_EQ(status, BDI_AOT_TRAP) << "op " << static_cast<int>(op) << ", case " << c;
+                continue;
+            }
+            ASSERT_EQ(status, 0u) << "op " << static_cast<int>(op) << ", case " << c;
+            EXPECT_EQ(TaggedValue(ret.bits, static_cast<BDIType>(ret.type)), *TaggedValue::fromVariant(*interpreted))
+                << "op " << static_cast<int>(op) << ", case " << c;
+        }
+    };
+    {
+        auto probe = buildAddGraph();
+        if (!cache.getOrCompile(*probe)) GTEST_SKIP() << "No system C compiler: " << cache.getLastError();
+    }
+    check(Op::ARITH_MOD, BDIType::INT32, {{kMin32, int32_t{-1}}, {int32_t{7}, int32_t{-1}}, {int32_t{-7}, int32_t{2}}, {int32_t{7}, int32_t{0}}});
+    check(Op::ARITH_DIV, BDIType::INT32, {{kMin32, int32_t{-1}}, {int32_t{-7}, int32_t{2}}});
+    check(Op::CONV_TRUNC, BDIType::INT8, {{int32_t{127}}, {int32_t{128}}, {int32_t{-128}}, {int32_t{-129}}});
+    check(Op::CONV_TRUNC, BDIType::UINT8, {{int16_t{255}}, {int16_t{256}}, {int16_t{-1}}});
+    check(Op::CONV_EXTEND_ZERO, BDIType::UINT32, {{int8_t{5}}, {int8_t{-1}}});
+    check(Op::CONV_EXTEND_SIGN, BDIType::INT32, {{uint32_t{5}}, {std::numeric_limits<uint32_t>::max()}});
+    check(Op::CMP_LT, BDIType::BOOL, {{int32_t{-1}, uint32_t{1}}, {int32_t{1}, uint32_t{2}}}); // Compared as uint32
+    check(Op::CMP_GT, BDIType::BOOL, {{int64_t{-1}, uint32_t{1}}, {int64_t{5}, uint32_t{1}}}); // Compared as int64
+    check(Op::ARITH_ADD, BDIType::UINT32, {{int32_t{-1}, uint32_t{2}}, {kMin32, uint32_t{0}}});
+    check(Op::ARITH_ABS, BDIType::INT32, {{kMin32}, {int32_t{-5}}, {int32_t{5}}});
+    check(Op::ARITH_ABS, BDIType::INT8, {{std::numeric_limits<int8_t>::min()}, {int8_t{-3}}});
+}
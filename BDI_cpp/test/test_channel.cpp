@@ -0,0 +1,339 @@
+#include "gtest.h"
+#include "Channel.hpp"
+#include "TaskScheduler.hpp"
+#include "MemoryManager.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static NodeID addBinary(GraphBuilder& builder, BDIOperationType op, NodeID lhs, NodeID rhs, BDIType type) {
+    NodeID id = builder.addNode(op);
+    builder.defineDataOutput(id, 0, type);
+    builder.connectData(lhs, 0, id, 0);
+    builder.connectData(rhs, 0, id, 1);
+    return id;
+}
+static NodeID addSend(GraphBuilder& builder, NodeID channel, std::initializer_list<NodeID> values) {
+    NodeID id = builder.addNode(BDIOperationType::COMM_CHANNEL_SEND);
+    builder.connectData(channel, 0, id, 0);
+    PortIndex port = 1;
+    for (NodeID value : values) builder.connectData(value, 0, id, port++);
+    return id;
+}
+static NodeID addRecv(GraphBuilder& builder, NodeID channel, size_t count, BDIType type) {
+    NodeID id = builder.addNode(BDIOperationType::COMM_CHANNEL_RECV);
+    for (PortIndex p = 0; p < count; ++p) builder.defineDataOutput(id, p, type);
+    builder.connectData(channel, 0, id, 0);
+    return id;
+}
+// --- Ring Buffers ---
+template <typename Ring>
+static void expectBatchesAreAllOrNothing() {
+    Ring ring(4);
+    std::vector<int> three = {1, 2, 3};
+    std::vector<int> two = {4, 5};
+    ASSERT_TRUE(ring.tryPush(std::span<int>(three)));
+    EXPECT_FALSE(ring.tryPush(std::span<int>(two))); // Only one slot left: nothing is written
+    EXPECT_EQ(ring.sizeApprox(), 3u);
+    std::vector<int> out(4);
+    EXPECT_FALSE(ring.tryPop(std::span<int>(out)));
+    ASSERT_TRUE(ring.tryPop(std::span<int>(out).first(2)));
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[1], 2);
+    ASSERT_TRUE(ring.tryPush(std::span<int>(two))); // Wraps around
+    ASSERT_TRUE(ring.tryPop(std::span<int>(out).first(3)));
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[2], 5);
+    EXPECT_EQ(ring.sizeApprox(), 0u);
+}
+TEST(ChannelRingTest, BatchesAreAllOrNothing) {
+    expectBatchesAreAllOrNothing<SpscRing<int>>();
+    expectBatchesAreAllOrNothing<MpmcRing<int>>();
+}
+TEST(ChannelRingTest, SpscKeepsOrderAcrossThreads) {
+    constexpr int kCount = 20000;
+    SpscRing<int> ring(64);
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            int value = i;
+            while (!ring.tryPush({&value, 1})) std::this_thread::yield();
+        }
+    });
+    int expected = 0;
+    while (expected < kCount) {
+        int value = -1;
+        if (!ring.tryPop({&value, 1})) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value, expected++);
+    }
+    producer.join();
+}
+TEST(ChannelRingTest, MpmcDeliversEveryValueOnce) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    MpmcRing<int> ring(128);
+    std::vector<std::vector<int>> received(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; i += 2) { // Pairs exercise the batch claim
+                int pair[2] = {t * kPerThread + i, t * kPerThread + i + 1};
+                while (!ring.tryPush(pair)) std::this_thread::yield();
+            }
+        });
+        threads.emplace_back([&, t] {
+            while (received[t].size() < static_cast<size_t>(kPerThread)) {
+                int value = -1;
+                if (ring.tryPop({&value, 1})) received[t].push_back(value);
+                else std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::vector<int> all;
+    for (const auto& part : received) all.insert(all.end(), part.begin(), part.end());
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<size_t>(kThreads * kPerThread));
+    for (int i = 0; i < kThreads * kPerThread; ++i) ASSERT_EQ(all[i], i);
+}
+TEST(ChannelRegistryTest, CreatesTypedChannelsById) {
+    ChannelRegistry channels(2);
+    uint32_t a = channels.create(BDIType::INT32, 3, Channel::Kind::SPSC);
+    uint32_t b = channels.create(BDIType::FLOAT64, 8);
+    EXPECT_NE(a, 0u);
+    EXPECT_NE(b, a);
+    EXPECT_EQ(channels.create(BDIType::INT32, 8), 0u); // Table full
+    EXPECT_EQ(channels.create(BDIType::VOID, 8), 0u);
+    ASSERT_NE(channels.find(a), nullptr);
+    EXPECT_EQ(channels.find(a)->getCapacity(), 4u); // Rounded up to a power of two
+    EXPECT_EQ(channels.find(b)->getElementType(), BDIType::FLOAT64);
+    EXPECT_EQ(channels.find(0), nullptr);
+    EXPECT_EQ(channels.find(99), nullptr);
+    EXPECT_NE(channels.find(a)->eventFor(Channel::Direction::SEND), channels.find(a)->eventFor(Channel::Direction::RECV));
+}
+// --- Tasks ---
+// producer: for (i = 0; i < N; ++i) send(c1, i)
+// doubler:  do { v = recv(c1); send(c2, v * 2) } while (v < N - 1)
+// consumer: do { v = recv(c2); *sum += v } while (v < 2 * (N - 1)); return *sum
+TEST(ChannelTaskTest, PipelineParksTasksOnFullAndEmptyChannels) {
+    constexpr int64_t kCount = 500;
+    MemoryManager memory(4096);
+    auto region = memory.allocateRegion(2 * sizeof(int64_t));
+    ASSERT_TRUE(region.has_value());
+    uint64_t base = memory.getRegionInfo(*region)->base_address;
+    std::vector<std::byte> zeros(2 * sizeof(int64_t));
+    ASSERT_TRUE(memory.writeMemory(base, zeros.data(), zeros.size()));
+    TaskScheduler os(&memory, 2, /*timeslice=*/7);
+    uint32_t c1 = os.getChannels()->create(BDIType::INT64, 4, Channel::Kind::SPSC);
+    uint32_t c2 = os.getChannels()->create(BDIType::INT64, 2, Channel::Kind::MPMC);
+    GraphBuilder builder("Pipeline");
+    NodeID ch1 = addConst(builder, TypedPayload::createFrom(uint64_t{c1}));
+    NodeID ch2 = addConst(builder, TypedPayload::createFrom(uint64_t{c2}));
+    NodeID one = addConst(builder, TypedPayload::createFrom(int64_t{1}));
+    NodeID two = addConst(builder, TypedPayload::createFrom(int64_t{2}));
+    NodeID count = addConst(builder, TypedPayload::createFrom(kCount));
+    NodeID last = addConst(builder, TypedPayload::createFrom(kCount - 1));
+    NodeID last_doubled = addConst(builder, TypedPayload::createFrom(2 * (kCount - 1)));
+    // Producer
+    NodeID producer = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(producer, 0, BDIType::UINT64);
+    NodeID load_i = builder.addNode(BDIOperationType::MEM_LOAD);
+    builder.defineDataOutput(load_i, 0, BDIType::INT64);
+    builder.connectData(producer, 0, load_i, 0);
+    NodeID send_i = addSend(builder, ch1, {load_i});
+    NodeID next_i = addBinary(builder, BDIOperationType::ARITH_ADD, load_i, one, BDIType::INT64);
+    NodeID store_i = builder.addNode(BDIOperationType::MEM_STORE);
+    builder.connectData(producer, 0, store_i, 0);
+    builder.connectData(next_i, 0, store_i, 1);
+    NodeID more = addBinary(builder, BDIOperationType::CMP_LT, next_i, count, BDIType::BOOL);
+    NodeID producer_loop = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(more, 0, producer_loop, 0);
+    NodeID producer_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(producer, load_i);
+    builder.connectControl(load_i, send_i);
+    builder.connectControl(send_i, next_i);
+    builder.connectControl(next_i, store_i);
+    builder.connectControl(store_i, more);
+    builder.connectControl(more, producer_loop);
+    builder.connectControl(producer_loop, load_i);
+    builder.connectControl(producer_loop, producer_end);
+    // Doubler
+    NodeID doubler = builder.addNode(BDIOperationType::META_START);
+    NodeID recv_v = addRecv(builder, ch1, 1, BDIType::INT64);
+    NodeID doubled = addBinary(builder, BDIOperationType::ARITH_MUL, recv_v, two, BDIType::INT64);
+    NodeID send_d = addSend(builder, ch2, {doubled});
+    NodeID not_last = addBinary(builder, BDIOperationType::CMP_LT, recv_v, last, BDIType::BOOL);
+    NodeID doubler_loop = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(not_last, 0, doubler_loop, 0);
+    NodeID doubler_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(doubler, recv_v);
+    builder.connectControl(recv_v, doubled);
+    builder.connectControl(doubled, send_d);
+    builder.connectControl(send_d, not_last);
+    builder.connectControl(not_last, doubler_loop);
+    builder.connectControl(doubler_loop, recv_v);
+    builder.connectControl(doubler_loop, doubler_end);
+    // Consumer
+    NodeID consumer = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(consumer, 0, BDIType::UINT64);
+    NodeID recv_w = addRecv(builder, ch2, 1, BDIType::INT64);
+    NodeID load_sum = builder.addNode(BDIOperationType::MEM_LOAD);
+    builder.defineDataOutput(load_sum, 0, BDIType::INT64);
+    builder.connectData(consumer, 0, load_sum, 0);
+    NodeID sum = addBinary(builder, BDIOperationType::ARITH_ADD, load_sum, recv_w, BDIType::INT64);
+    NodeID store_sum = builder.addNode(BDIOperationType::MEM_STORE);
+    builder.connectData(consumer, 0, store_sum, 0);
+    builder.connectData(sum, 0, store_sum, 1);
+    NodeID not_done = addBinary(builder, BDIOperationType::CMP_LT, recv_w, last_doubled, BDIType::BOOL);
+    NodeID consumer_loop = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(not_done, 0, consumer_loop, 0);
+    NodeID consumer_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(sum, 0, consumer_ret, 0);
+    builder.connectControl(consumer, recv_w);
+    builder.connectControl(recv_w, load_sum);
+    builder.connectControl(load_sum, sum);
+    builder.connectControl(sum, store_sum);
+    builder.connectControl(store_sum, not_done);
+    builder.connectControl(not_done, consumer_loop);
+    builder.connectControl(consumer_loop, recv_w);
+    builder.connectControl(consumer_loop, consumer_ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    auto consumer_ctx = std::make_unique<ExecutionContext>();
+    consumer_ctx->setPortValue(consumer, 0, BDIValueVariant(base));
+    uint64_t consumer_id = os.spawnTask(*graph, consumer, std::move(consumer_ctx)); // Parks first: nothing sent yet
+    uint64_t doubler_id = os.spawnTask(*graph, doubler);
+    auto producer_ctx = std::make_unique<ExecutionContext>();
+    producer_ctx->setPortValue(producer, 0, BDIValueVariant(base + sizeof(int64_t)));
+    uint64_t producer_id = os.spawnTask(*graph, producer, std::move(producer_ctx));
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    for (uint64_t id : {producer_id, doubler_id, consumer_id}) {
+        EXPECT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED) << os.getTaskError(id);
+    }
+    ASSERT_TRUE(os.getTaskResult(consumer_id).has_value());
+    EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(consumer_id)), kCount * (kCount - 1));
+    EXPECT_EQ(os.getChannels()->find(c1)->sizeApprox(), 0u);
+}
+TEST(ChannelTaskTest, BatchSendAndReceiveConvertToElementType) {
+    TaskScheduler os(nullptr, 2);
+    uint32_t c = os.getChannels()->create(BDIType::INT32, 4);
+    GraphBuilder builder("Batches");
+    NodeID ch = addConst(builder, TypedPayload::createFrom(uint64_t{c}));
+    NodeID a = addConst(builder, TypedPayload::createFrom(int64_t{1}));
+    NodeID b = addConst(builder, TypedPayload::createFrom(int8_t{2}));
+    NodeID d = addConst(builder, TypedPayload::createFrom(int32_t{3}));
+    NodeID sender = builder.addNode(BDIOperationType::META_START);
+    NodeID first = addSend(builder, ch, {a, b, d});
+    NodeID second = addSend(builder, ch, {d, d, d}); // Only one slot left: parks until a batch is received
+    NodeID sender_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(sender, first);
+    builder.connectControl(first, second);
+    builder.connectControl(second, sender_end);
+    NodeID receiver = builder.addNode(BDIOperationType::META_START);
+    NodeID r1 = addRecv(builder, ch, 3, BDIType::INT32);
+    NodeID r2 = addRecv(builder, ch, 3, BDIType::INT32);
+    NodeID s1 = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(s1, 0, BDIType::INT32);
+    builder.connectData(r1, 0, s1, 0);
+    builder.connectData(r1, 2, s1, 1);
+    NodeID s2 = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(s2, 0, BDIType::INT32);
+    builder.connectData(s1, 0, s2, 0);
+    builder.connectData(r2, 1, s2, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(s2, 0, ret, 0);
+    builder.connectControl(receiver, r1);
+    builder.connectControl(r1, r2);
+    builder.connectControl(r2, s1);
+    builder.connectControl(s1, s2);
+    builder.connectControl(s2, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    uint64_t sender_id = os.spawnTask(*graph, sender);
+    uint64_t receiver_id = os.spawnTask(*graph, receiver);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    EXPECT_EQ(os.getTaskStatus(sender_id), TaskStatus::COMPLETED) << os.getTaskError(sender_id);
+    ASSERT_EQ(os.getTaskStatus(receiver_id), TaskStatus::COMPLETED) << os.getTaskError(receiver_id);
+    EXPECT_EQ(std::get<int32_t>(*os.getTaskResult(receiver_id)), 1 + 3 + 3); // Converted to INT32 on send
+}
+TEST(ChannelTaskTest, MixedBatchSizesWakeEveryReceiver) {
+    TaskScheduler os(nullptr, 2);
+    uint32_t c = os.getChannels()->create(BDIType::INT64, 4);
+    GraphBuilder builder("MixedBatches");
+    NodeID ch = addConst(builder, TypedPayload::createFrom(uint64_t{c}));
+    NodeID five = addConst(builder, TypedPayload::createFrom(int64_t{5}));
+    NodeID sender = builder.addNode(BDIOperationType::META_START);
+    NodeID send = addSend(builder, ch, {five});
+    NodeID sender_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(sender, send);
+    builder.connectControl(send, sender_end);
+    NodeID wide = builder.addNode(BDIOperationType::META_START);
+    NodeID recv_three = addRecv(builder, ch, 3, BDIType::INT64);
+    NodeID wide_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(wide, recv_three);
+    builder.connectControl(recv_three, wide_end);
+    NodeID narrow = builder.addNode(BDIOperationType::META_START);
+    NodeID recv_one = addRecv(builder, ch, 1, BDIType::INT64);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(recv_one, 0, ret, 0);
+    builder.connectControl(narrow, recv_one);
+    builder.connectControl(recv_one, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    // Park the three-value receiver ahead of the one-value receiver, then send a single value
+    uint64_t wide_id = os.spawnTask(*graph, wide);
+    os.start();
+    EXPECT_FALSE(os.waitForIdle());
+    uint64_t narrow_id = os.spawnTask(*graph, narrow);
+    EXPECT_FALSE(os.waitForIdle());
+    uint64_t sender_id = os.spawnTask(*graph, sender);
+    EXPECT_FALSE(os.waitForIdle()); // The wide receiver still waits for a full batch
+    os.stop();
+    EXPECT_EQ(os.getTaskStatus(sender_id), TaskStatus::COMPLETED) << os.getTaskError(sender_id);
+    EXPECT_EQ(os.getTaskStatus(wide_id), TaskStatus::WAITING);
+    ASSERT_EQ(os.getTaskStatus(narrow_id), TaskStatus::COMPLETED) << os.getTaskError(narrow_id);
+    EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(narrow_id)), 5);
+}
+TEST(ChannelTaskTest, BatchesLargerThanTheChannelFault) {
+    TaskScheduler os(nullptr, 2);
+    uint32_t c = os.getChannels()->create(BDIType::INT32, 2);
+    GraphBuilder builder("OversizedBatches");
+    NodeID ch = addConst(builder, TypedPayload::createFrom(uint64_t{c}));
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID sender = builder.addNode(BDIOperationType::META_START);
+    NodeID send = addSend(builder, ch, {one, one, one});
+    NodeID sender_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(sender, send);
+    builder.connectControl(send, sender_end);
+    NodeID receiver = builder.addNode(BDIOperationType::META_START);
+    NodeID recv = addRecv(builder, ch, 3, BDIType::INT32);
+    NodeID receiver_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(receiver, recv);
+    builder.connectControl(recv, receiver_end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    uint64_t sender_id = os.spawnTask(*graph, sender);
+    uint64_t receiver_id = os.spawnTask(*graph, receiver);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle()); // Neither task parks
+    os.stop();
+    ASSERT_EQ(os.getTaskStatus(sender_id), TaskStatus::FAULTED);
+    EXPECT_NE(os.getTaskError(sender_id).find("exceeds capacity 2"), std::string::npos) << os.getTaskError(sender_id);
+    ASSERT_EQ(os.getTaskStatus(receiver_id), TaskStatus::FAULTED);
+    EXPECT_NE(os.getTaskError(receiver_id).find("exceeds capacity 2"), std::string::npos) << os.getTaskError(receiver_id);
+}
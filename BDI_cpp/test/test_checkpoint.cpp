@@ -0,0 +1,136 @@
+#include "gtest.h"
+#include "VMCheckpointer.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <unistd.h>
+using namespace bdi::runtime;
+// --- Helpers --
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()))).string();
+}
+static bool writeU32(MemoryManager& memory, uintptr_t address, uint32_t value) {
+    return memory.writeMemory(address, reinterpret_cast<const std::byte*>(&value), sizeof(value));
+}
+static uint32_t readU32(const MemoryManager& memory, uintptr_t address) {
+    uint32_t value = 0;
+    memory.readMemory(address, reinterpret_cast<std::byte*>(&value), sizeof(value));
+    return value;
+}
+// --- Tests ---
+TEST(VMCheckpointTest, FullCheckpointRestoresContextMemoryAndNode) {
+    MemoryManager memory(16 * MemoryManager::PAGE_SIZE);
+    ExecutionContext context;
+    auto region = memory.allocateRegion(3 * MemoryManager::PAGE_SIZE);
+    ASSERT_TRUE(region.has_value());
+    auto info = memory.getRegionInfo(*region);
+    ASSERT_TRUE(writeU32(memory, info->base_address + 8, 0xC0FFEEu));
+    context.setPortValue(5, 0, int32_t{-7});
+    context.setPortValue(5, 1, 2.5);
+    context.setPortValue(9, 0, true);
+    context.setNextArgument(0, uint64_t{99});
+    context.pushCallFrame(12, 13);
+    context.setNextArgument(1, int32_t{4}); // Staged for a call not yet made
+    context.recordGradient(20, 0.25f);
+    context.updateEligibilityTrace(20, 0.5f, 1.0f);
+    context.pushServiceCall(30, 31);
+    std::string path = tempPath("bdi_ckpt_full");
+    VMCheckpointer checkpointer(memory, context);
+    ASSERT_TRUE(checkpointer.writeFull(path, 42));
+    EXPECT_EQ(checkpointer.getSequence(), 1u);
+    auto restored = VMCheckpointer::restore({path});
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->current_node_id, 42u);
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_TRUE(restored->memory->isImageMapped());
+#endif
+    EXPECT_EQ(readU32(*restored->memory, info->base_address + 8), 0xC0FFEEu);
+    auto restored_info = restored->memory->getRegionInfo(*region);
+    ASSERT_TRUE(restored_info.has_value());
+    EXPECT_EQ(restored_info->base_address, info->base_address);
+    EXPECT_EQ(restored->memory->getUsedSize(), memory.getUsedSize());
+    EXPECT_EQ(restored->memory->allocateRegion(16), memory.allocateRegion(16)); // Same next id and free list
+    ExecutionContext& ctx = *restored->context;
+    EXPECT_EQ(std::get<int32_t>(*ctx.getPortValue(5, 0)), -7);
+    EXPECT_EQ(std::get<double>(*ctx.getPortValue(5, 1)), 2.5);
+    EXPECT_TRUE(std::get<bool>(*ctx.getPortValue(9, 0)));
+    EXPECT_EQ(std::get<uint64_t>(*ctx.getCurrentArgument(0)), 99u); // Staged argument moved into the frame
+    EXPECT_EQ(std::get<float>(*ctx.getGradient(20)), 0.25f);
+    EXPECT_FLOAT_EQ(*ctx.getEligibilityTrace(20), 1.0f);
+    auto service = ctx.popServiceCall();
+    ASSERT_TRUE(service.has_value());
+    EXPECT_EQ(service->original_resume_node_id, 31u);
+    ctx.pushCallFrame(50, 51);
+    EXPECT_FALSE(ctx.getCurrentArgument(0).has_value());
+    EXPECT_EQ(std::get<int32_t>(*ctx.getCurrentArgument(1)), 4);
+    ctx.popCallFrame();
+    auto frame = ctx.popCallFrame();
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_EQ(frame->caller_node_id, 12u);
+    EXPECT_EQ(frame->return_node_id, 13u);
+    // Restored memory is private: writing it leaves the checkpoint intact
+    ASSERT_TRUE(writeU32(*restored->memory, info->base_address + 8, 1));
+    auto again = VMCheckpointer::restore({path});
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(readU32(*again->memory, info->base_address + 8), 0xC0FFEEu);
+    std::remove(path.c_str());
+}
+TEST(VMCheckpointTest, IncrementalCheckpointsCarryOnlyChanges) {
+    const size_t pages = 64;
+    MemoryManager memory(pages * MemoryManager::PAGE_SIZE);
+    ExecutionContext context;
+    for (NodeID n = 1; n <= 100; ++n) context.setPortValue(n, 0, static_cast<int64_t>(n));
+    ASSERT_TRUE(writeU32(memory, 0, 1));
+    VMCheckpointer checkpointer(memory, context);
+    std::string full = tempPath("bdi_ckpt_base");
+    std::string delta1 = tempPath("bdi_ckpt_d1");
+    std::string delta2 = tempPath("bdi_ckpt_d2");
+    EXPECT_FALSE(VMCheckpointer(memory, context).writeIncremental(delta1, 0)); // No base yet
+    ASSERT_TRUE(checkpointer.writeFull(full, 1));
+    ASSERT_TRUE(writeU32(memory, 10 * MemoryManager::PAGE_SIZE, 10));
+    context.setPortValue(50, 0, int64_t{-50});
+    ASSERT_TRUE(checkpointer.writeIncremental(delta1, 2));
+    ASSERT_TRUE(writeU32(memory, 20 * MemoryManager::PAGE_SIZE + 4, 20));
+    context.setPortValue(200, 0, int64_t{200});
+    ASSERT_TRUE(checkpointer.writeIncremental(delta2, 3));
+    EXPECT_EQ(checkpointer.getSequence(), 3u);
+    // One dirty page plus a single slot, against a 256 KiB image
+    EXPECT_LT(std::filesystem::file_size(delta1), std::filesystem::file_size(full) / 2);
+    auto restored = VMCheckpointer::restore({full, delta1, delta2});
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->current_node_id, 3u);
+    EXPECT_EQ(restored->sequence, 3u);
+    EXPECT_EQ(readU32(*restored->memory, 0), 1u);
+    EXPECT_EQ(readU32(*restored->memory, 10 * MemoryManager::PAGE_SIZE), 10u);
+    EXPECT_EQ(readU32(*restored->memory, 20 * MemoryManager::PAGE_SIZE + 4), 20u);
+    EXPECT_EQ(std::get<int64_t>(*restored->context->getPortValue(50, 0)), -50);
+    EXPECT_EQ(std::get<int64_t>(*restored->context->getPortValue(99, 0)), 99);
+    EXPECT_EQ(std::get<int64_t>(*restored->context->getPortValue(200, 0)), 200);
+    // A prefix of the chain is a valid earlier state
+    auto earlier = VMCheckpointer::restore({full, delta1});
+    ASSERT_TRUE(earlier.has_value());
+    EXPECT_EQ(readU32(*earlier->memory, 20 * MemoryManager::PAGE_SIZE + 4), 0u);
+    EXPECT_FALSE(earlier->context->getPortValue(200, 0).has_value());
+    // Gaps and foreign links are rejected
+    EXPECT_FALSE(VMCheckpointer::restore({full, delta2}).has_value());
+    EXPECT_FALSE(VMCheckpointer::restore({delta1}).has_value());
+    for (const auto& p : {full, delta1, delta2}) std::remove(p.c_str());
+}
+TEST(VMCheckpointTest, RemovedSlotsAreDroppedOnRestore) {
+    MemoryManager memory(MemoryManager::PAGE_SIZE);
+    ExecutionContext context;
+    context.setPortValue(1, 0, int32_t{1});
+    context.setPortValue(2, 0, int32_t{2});
+    VMCheckpointer checkpointer(memory, context);
+    std::string full = tempPath("bdi_ckpt_rm_base");
+    std::string delta = tempPath("bdi_ckpt_rm_delta");
+    ASSERT_TRUE(checkpointer.writeFull(full, 1));
+    context.clear();
+    context.setPortValue(2, 0, int32_t{3});
+    ASSERT_TRUE(checkpointer.writeIncremental(delta, 1));
+    auto restored = VMCheckpointer::restore({full, delta});
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_FALSE(restored->context->getPortValue(1, 0).has_value());
+    EXPECT_EQ(std::get<int32_t>(*restored->context->getPortValue(2, 0)), 3);
+    std::remove(full.c_str());
+    std::remove(delta.c_str());
+}
@@ -0,0 +1,158 @@
+#include "gtest.h"
+#include "DataflowExecutor.hpp"
+#include "MemoryManager.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <stdexcept>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Tests ---
+TEST(DataflowExecutorTest, WideIndependentChainsRunToCompletion) {
+    // 64 independent (x_i * i) + i chains, serialized on the control path but
+    // data-independent, so the executor is free to run them concurrently.
+    GraphBuilder builder("DataflowWide");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT64);
+    NodeID prev = start;
+    std::vector<NodeID> sums;
+    for (int64_t i = 0; i < 64; ++i) {
+        NodeID k = addConst(builder, TypedPayload::createFrom(i));
+        NodeID mul = builder.addNode(BDIOperationType::ARITH_MUL);
+        builder.defineDataOutput(mul, 0, BDIType::INT64);
+        builder.connectData(start, 0, mul, 0);
+        builder.connectData(k, 0, mul, 1);
+        NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+        builder.defineDataOutput(add, 0, BDIType::INT64);
+        builder.connectData(mul, 0, add, 0);
+        builder.connectData(k, 0, add, 1);
+        builder.connectControl(prev, mul);
+        builder.connectControl(mul, add);
+        prev = add;
+        sums.push_back(add);
+    }
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(prev, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(4);
+    DataflowExecutor executor(pool);
+    executor.setInput({start, 0}, BDIValueVariant(int64_t{10}));
+    ASSERT_TRUE(executor.execute(*graph, start)) << executor.getLastError();
+    for (size_t i = 0; i < sums.size(); ++i) {
+        auto value = executor.getPortValue({sums[i], 0});
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(std::get<int64_t>(*value), 10 * static_cast<int64_t>(i) + static_cast<int64_t>(i));
+    }
+    ExecutionContext ctx;
+    executor.exportTo(ctx);
+    EXPECT_TRUE(ctx.getPortValue(sums.back(), 0).has_value());
+}
+TEST(DataflowExecutorTest, StoresAndLoadsKeepControlOrder) {
+    // store(a, 1); v1 = load(a); store(a, 2); v2 = load(a)
+    MemoryManager memory(1024);
+    auto region = memory.allocateRegion(16);
+    ASSERT_TRUE(region.has_value());
+    uint64_t address = memory.getRegionInfo(*region)->base_address;
+    GraphBuilder builder("DataflowOrder");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID addr = addConst(builder, TypedPayload::createFrom(address));
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID two = addConst(builder, TypedPayload::createFrom(int32_t{2}));
+    auto store = [&](NodeID value) {
+        NodeID id = builder.addNode(BDIOperationType::MEM_STORE);
+        builder.connectData(addr, 0, id, 0);
+        builder.connectData(value, 0, id, 1);
+        return id;
+    };
+    auto load = [&]() {
+        NodeID id = builder.addNode(BDIOperationType::MEM_LOAD);
+        builder.defineDataOutput(id, 0, BDIType::INT32);
+        builder.connectData(addr, 0, id, 0);
+        return id;
+    };
+    NodeID s1 = store(one);
+    NodeID l1 = load();
+    NodeID s2 = store(two);
+    NodeID l2 = load();
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, s1);
+    builder.connectControl(s1, l1);
+    builder.connectControl(l1, s2);
+    builder.connectControl(s2, l2);
+    builder.connectControl(l2, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(4);
+    for (int run = 0; run < 50; ++run) { // Repeat to shake out ordering races
+        DataflowExecutor executor(pool, &memory);
+        ASSERT_TRUE(executor.execute(*graph, start)) << executor.getLastError();
+        EXPECT_EQ(std::get<int32_t>(*executor.getPortValue({l1, 0})), 1);
+        EXPECT_EQ(std::get<int32_t>(*executor.getPortValue({l2, 0})), 2);
+    }
+}
+TEST(DataflowExecutorTest, RejectsBranchingGraphs) {
+    GraphBuilder builder("DataflowBranch");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID cond = addConst(builder, TypedPayload::createFrom(bool{true}));
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(cond, 0, branch, 0);
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, branch);
+    builder.connectControl(branch, end);
+    builder.connectControl(branch, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(2);
+    DataflowExecutor executor(pool);
+    EXPECT_FALSE(executor.execute(*graph, start));
+    EXPECT_FALSE(executor.getLastError().empty());
+}
+TEST(DataflowExecutorTest, FaultStopsExecutionAndReportsNode) {
+    GraphBuilder builder("DataflowFault");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID zero = addConst(builder, TypedPayload::createFrom(int32_t{0}));
+    NodeID ten = addConst(builder, TypedPayload::createFrom(int32_t{10}));
+    NodeID div = builder.addNode(BDIOperationType::ARITH_DIV);
+    builder.defineDataOutput(div, 0, BDIType::INT32);
+    builder.connectData(ten, 0, div, 0);
+    builder.connectData(zero, 0, div, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(div, 0, ret, 0);
+    builder.connectControl(start, div);
+    builder.connectControl(div, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(2);
+    DataflowExecutor executor(pool);
+    EXPECT_FALSE(executor.execute(*graph, start));
+    EXPECT_NE(executor.getLastError().find(std::to_string(div)), std::string::npos);
+    EXPECT_FALSE(executor.getReturnValue().has_value());
+}
+TEST(WorkStealingPoolTest, HelpWhileRunsNestedTasks) {
+    WorkStealingPool pool(3);
+    std::atomic<int> done{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&pool, &done] {
+            pool.submit([&done] { done.fetch_add(1); });
+            done.fetch_add(1);
+        });
+    }
+    pool.helpWhile([&done] { return done.load() < 200; });
+    EXPECT_EQ(done.load(), 200);
+}
+TEST(WorkStealingPoolTest, ThrowingTasksDoNotStopWorkersOrHelpers) {
+    WorkStealingPool pool(2);
+    std::atomic<int> done{0};
+    for (int i = 0; i < 50; ++i) {
+        pool.submit([] { throw 42; }); // Not a std::exception
+        pool.submit([] { throw std::runtime_error("task failed"); });
+        pool.submit([&done] { done.fetch_add(1); });
+    }
+    pool.helpWhile([&done] { return done.load() < 50; });
+    EXPECT_EQ(done.load(), 50);
+}
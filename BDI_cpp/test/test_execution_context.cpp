@@ -62,3 +62,47 @@
  //     EXPECT_EQ(ret2.value(), 100);
  //     EXPECT_TRUE(ctx.isCallStackEmpty());
  // }
+ TEST(ExecutionContextTest, CallFramesOwnPositionalArguments) {
+    ExecutionContext ctx;
+    BDIValueVariant* outer = ctx.stageArguments(2);
+    outer[0] = int32_t{1};
+    outer[1] = int32_t{2};
+    ctx.pushCallFrame(10, 11);
+    ctx.setNextArgument(0, int32_t{7}); // Nested call staged above the outer frame
+    ctx.pushCallFrame(20, 21);
+    ASSERT_EQ(ctx.getCallStack().size(), 2u);
+    EXPECT_EQ(std::get<int32_t>(ctx.getCurrentArgument(0).value()), 7);
+    EXPECT_FALSE(ctx.getCurrentArgument(1).has_value()); // Beyond the frame's arity
+    ASSERT_TRUE(ctx.popCallFrame().has_value());
+    EXPECT_EQ(std::get<int32_t>(ctx.getCurrentArgument(0).value()), 1);
+    EXPECT_EQ(std::get<int32_t>(ctx.getCurrentArgument(1).value()), 2);
+    auto args = ctx.getArguments(ctx.getCallStack().back());
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(std::get<int32_t>(args[1]), 2);
+ }
+ TEST(ExecutionContextTest, UnpassedArgumentsAreAbsent) {
+    ExecutionContext ctx;
+    ctx.stageArguments(3)[2] = float{1.5f};
+    ctx.pushCallFrame(1, 2);
+    EXPECT_FALSE(ctx.getCurrentArgument(0).has_value());
+    EXPECT_FALSE(ctx.getCurrentArgument(1).has_value());
+    EXPECT_FLOAT_EQ(std::get<float>(ctx.getCurrentArgument(2).value()), 1.5f);
+    ctx.popCallFrame();
+    EXPECT_TRUE(ctx.isCallStackEmpty());
+    EXPECT_FALSE(ctx.getCurrentArgument(2).has_value());
+ }
+ TEST(ExecutionContextTest, PoppedFramesReuseArgumentSlots) {
+    ExecutionContext ctx;
+    for (int i = 0; i < 100; ++i) {
+        ctx.stageArguments(1)[0] = int32_t{i};
+        ctx.pushCallFrame(1, 2);
+        EXPECT_EQ(std::get<int32_t>(ctx.getCurrentArgument(0).value()), i);
+        EXPECT_EQ(ctx.getCallStack().back().arg_base, 0u); // Same slot every iteration
+        ctx.popCallFrame();
+    }
+    ctx.setNextArgument(1, int32_t{5}); // Sparse indices pad with absent slots
+    ctx.pushCallFrame(1, 2);
+    EXPECT_EQ(ctx.getCallStack().back().arg_count, 2u);
+    EXPECT_FALSE(ctx.getCurrentArgument(0).has_value());
+    EXPECT_EQ(std::get<int32_t>(ctx.getCurrentArgument(1).value()), 5);
+ }
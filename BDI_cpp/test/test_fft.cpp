@@ -0,0 +1,161 @@
+#include "gtest.h"
+#include "Fft.hpp"
+#include "SignalOps.hpp"
+#include "NodeEvaluator.hpp"
+#include "MemoryManager.hpp"
+#include "TypedPayload.hpp"
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::runtime::signal;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+template <typename T>
+static std::vector<T> randomSignal(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<T> values(count);
+    for (T& value : values) value = static_cast<T>(dist(rng));
+    return values;
+}
+// O(n^2) DFT of interleaved complex values, in double; INVERSE includes the 1/n
+template <typename T>
+static std::vector<double> naiveDft(const std::vector<T>& input, FftDirection direction) {
+    const size_t n = input.size() / 2;
+    const double sign = direction == FftDirection::FORWARD ? -1.0 : 1.0;
+    std::vector<double> output(2 * n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum;
+        for (size_t j = 0; j < n; ++j) {
+            const double angle = sign * 2 * std::numbers::pi * static_cast<double>((j * k) % n) / static_cast<double>(n);
+            sum += std::complex<double>(input[2 * j], input[2 * j + 1]) * std::polar(1.0, angle);
+        }
+        if (direction == FftDirection::INVERSE) sum /= static_cast<double>(n);
+        output[2 * k] = sum.real();
+        output[2 * k + 1] = sum.imag();
+    }
+    return output;
+}
+template <typename T>
+static double tolerance(size_t n) { return (sizeof(T) == 4 ? 2e-5 : 1e-13) * std::sqrt(static_cast<double>(n)) * 8; }
+template <typename T>
+static void expectNear(const std::vector<T>& actual, const std::vector<double>& expected, double tol, const std::string& what) {
+    ASSERT_EQ(actual.size(), expected.size());
+    double worst = 0;
+    for (size_t i = 0; i < actual.size(); ++i) worst = std::max(worst, std::abs(static_cast<double>(actual[i]) - expected[i]));
+    EXPECT_LE(worst, tol) << what;
+}
+static std::vector<const FftKernels*> availableTables() {
+    std::vector<const FftKernels*> tables;
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        if (const FftKernels* kernels = fftKernelsFor(level)) tables.push_back(kernels);
+    }
+    return tables;
+}
+template <typename T>
+static void expectComplexMatchesDft(const FftKernels& kernels, std::mt19937& rng) {
+    for (size_t n = 1; n <= 1024; n *= 2) { // Odd and even log2, so with and without the radix-2 pass
+        for (FftDirection direction : {FftDirection::FORWARD, FftDirection::INVERSE}) {
+            auto plan = FftPlan<T>::create(n, direction, FftKind::COMPLEX, kernels);
+            ASSERT_NE(plan, nullptr);
+            std::vector<T> data = randomSignal<T>(2 * n, rng);
+            const std::vector<double> expected = naiveDft(data, direction);
+            plan->execute(data.data());
+            expectNear(data, expected, tolerance<T>(n), std::string(simd::toString(kernels.level)) + " n=" + std::to_string(n));
+        }
+    }
+}
+// --- Plans ---
+TEST(FftTest, EveryLevelMatchesTheNaiveDft) {
+    std::mt19937 rng(7);
+    for (const FftKernels* kernels : availableTables()) {
+        expectComplexMatchesDft<float>(*kernels, rng);
+        expectComplexMatchesDft<double>(*kernels, rng);
+    }
+}
+TEST(FftTest, RealTransformPacksTheHalfSpectrumAndRoundTrips) {
+    std::mt19937 rng(11);
+    for (size_t n = 2; n <= 512; n *= 2) {
+        const std::vector<double> signal = randomSignal<double>(n, rng);
+        std::vector<double> as_complex(2 * n);
+        for (size_t i = 0; i < n; ++i) as_complex[2 * i] = signal[i];
+        const std::vector<double> full = naiveDft(as_complex, FftDirection::FORWARD);
+        std::vector<double> expected(n);
+        expected[0] = full[0];
+        expected[1] = full[n]; // X[n/2], real
+        for (size_t k = 1; k < n / 2; ++k) {
+            expected[2 * k] = full[2 * k];
+            expected[2 * k + 1] = full[2 * k + 1];
+        }
+        std::vector<double> data = signal;
+        fftPlans().get<double>(n, FftDirection::FORWARD, FftKind::REAL)->execute(data.data());
+        expectNear(data, expected, tolerance<double>(n), "real forward n=" + std::to_string(n));
+        fftPlans().get<double>(n, FftDirection::INVERSE, FftKind::REAL)->execute(data.data());
+        expectNear(data, signal, tolerance<double>(n), "real round trip n=" + std::to_string(n));
+        std::vector<float> narrow(signal.begin(), signal.end());
+        fftPlans().get<float>(n, FftDirection::FORWARD, FftKind::REAL)->execute(narrow.data());
+        fftPlans().get<float>(n, FftDirection::INVERSE, FftKind::REAL)->execute(narrow.data());
+        expectNear(narrow, signal, tolerance<float>(n), "f32 real round trip n=" + std::to_string(n));
+    }
+}
+TEST(FftTest, PlansAreCachedPerKeyAndInvalidSizesRejected) {
+    const FftPlan<float>* plan = fftPlans().get<float>(256, FftDirection::FORWARD, FftKind::COMPLEX);
+    ASSERT_NE(plan, nullptr);
+    EXPECT_EQ(fftPlans().get<float>(256, FftDirection::FORWARD, FftKind::COMPLEX), plan);
+    EXPECT_NE(static_cast<const void*>(fftPlans().get<double>(256, FftDirection::FORWARD, FftKind::COMPLEX)), static_cast<const void*>(plan));
+    EXPECT_NE(fftPlans().get<float>(256, FftDirection::INVERSE, FftKind::COMPLEX), plan);
+    EXPECT_EQ(plan->getValueCount(), 512u);
+    EXPECT_EQ(fftPlans().get<float>(256, FftDirection::FORWARD, FftKind::REAL)->getValueCount(), 256u);
+    EXPECT_EQ(fftPlans().get<float>(0, FftDirection::FORWARD, FftKind::COMPLEX), nullptr);
+    EXPECT_EQ(fftPlans().get<float>(48, FftDirection::FORWARD, FftKind::COMPLEX), nullptr);
+    EXPECT_EQ(fftPlans().get<float>(1, FftDirection::FORWARD, FftKind::REAL), nullptr);
+    EXPECT_EQ(fftPlans().get<float>(FftPlan<float>::MAX_SIZE * 2, FftDirection::FORWARD, FftKind::COMPLEX), nullptr);
+}
+// --- SIGNAL_FFT ---
+TEST(FftOpTest, TransformsBuffersInMemory) {
+    MemoryManager memory(4 * MemoryManager::PAGE_SIZE);
+    const uint64_t address = MemoryManager::PAGE_SIZE;
+    const float impulse[8] = {0, 0, 1, 0, 0, 0, 0, 0}; // x[1] = 1: X[k] = W^k
+    memory.writeMemory(address, reinterpret_cast<const std::byte*>(impulse), sizeof(impulse));
+    memory.takeDirtyPages();
+    BDINode node(1, BDIOperationType::SIGNAL_FFT);
+    std::vector<BDIValueVariant> inputs = {address, uint64_t{4}};
+    HeldValue result;
+    VMErrorInfo error;
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    float spectrum[8] = {};
+    memory.readMemory(address, reinterpret_cast<std::byte*>(spectrum), sizeof(spectrum));
+    const float expected[8] = {1, 0, 0, -1, -1, 0, 0, 1};
+    for (size_t i = 0; i < 8; ++i) EXPECT_NEAR(spectrum[i], expected[i], 1e-6f) << i;
+    EXPECT_EQ(memory.takeDirtyPages(), (std::vector<size_t>{1}));
+    node.payload = TypedPayload::createFrom(encodeFft({BDIType::FLOAT32, FftDirection::INVERSE, FftKind::COMPLEX}));
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    memory.readMemory(address, reinterpret_cast<std::byte*>(spectrum), sizeof(spectrum));
+    for (size_t i = 0; i < 8; ++i) EXPECT_NEAR(spectrum[i], impulse[i], 1e-6f) << i;
+    inputs[1] = uint64_t{6}; // Not a power of two
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OUT_OF_RANGE);
+    inputs[1] = uint64_t{4 * MemoryManager::PAGE_SIZE}; // Runs past the end
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[1] = uint64_t{FftPlan<float>::MAX_SIZE}; // Valid size, small buffer: fails before any plan is built
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[0] = address + 2; // Misaligned
+    inputs[1] = uint64_t{4};
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    node.payload = TypedPayload::createFrom(uint32_t{static_cast<uint8_t>(BDIType::INT32)});
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::TYPE_MISMATCH);
+    inputs.pop_back();
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::ARITY);
+    BDINode plain(2, BDIOperationType::SIGNAL_FFT);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(plain, {uint64_t{0}, uint64_t{4}}, nullptr, result, &error), VMStatus::NO_MEMORY_MANAGER);
+    auto decoded = decodeFft(encodeFft({BDIType::FLOAT64, FftDirection::INVERSE, FftKind::REAL}));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->element_type, BDIType::FLOAT64);
+    EXPECT_EQ(decoded->direction, FftDirection::INVERSE);
+    EXPECT_EQ(decoded->kind, FftKind::REAL);
+    EXPECT_FALSE(decodeFft(1u << 10 | static_cast<uint8_t>(BDIType::FLOAT32)));
+}
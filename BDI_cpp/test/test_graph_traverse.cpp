@@ -0,0 +1,182 @@
+#include "gtest.h"
+#include "GraphTraversal.hpp"
+#include "TraversalOps.hpp"
+#include "NodeEvaluator.hpp"
+#include "MemoryManager.hpp"
+#include "WorkStealingPool.hpp"
+#include "TypedPayload.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::runtime::traversal;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+template <typename T>
+struct Csr {
+    std::vector<T> offsets;
+    std::vector<T> targets;
+    CsrGraph<T> view() const { return {offsets.data(), targets.data(), offsets.size() - 1}; }
+};
+template <typename T>
+static Csr<T> toCsr(size_t vertex_count, std::vector<std::pair<T, T>> edges) {
+    std::stable_sort(edges.begin(), edges.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    Csr<T> csr;
+    csr.offsets.assign(vertex_count + 1, 0);
+    for (const auto& [from, to] : edges) {
+        ++csr.offsets[from + 1];
+        csr.targets.push_back(to);
+    }
+    for (size_t v = 0; v < vertex_count; ++v) csr.offsets[v + 1] += csr.offsets[v];
+    return csr;
+}
+// Uniform random edges; 'symmetric' adds each one both ways
+template <typename T>
+static Csr<T> randomGraph(size_t vertex_count, size_t edge_count, bool symmetric, std::mt19937& rng) {
+    std::vector<std::pair<T, T>> edges;
+    for (size_t i = 0; i < edge_count; ++i) {
+        const T from = static_cast<T>(rng() % vertex_count), to = static_cast<T>(rng() % vertex_count);
+        edges.emplace_back(from, to);
+        if (symmetric) edges.emplace_back(to, from);
+    }
+    return toCsr<T>(vertex_count, std::move(edges));
+}
+template <typename T>
+static std::vector<T> referenceBfs(const Csr<T>& csr, T source) {
+    std::vector<T> distances(csr.offsets.size() - 1, UNREACHED<T>);
+    std::deque<T> queue{source};
+    distances[source] = 0;
+    while (!queue.empty()) {
+        const T u = queue.front();
+        queue.pop_front();
+        for (T e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+            if (distances[csr.targets[e]] != UNREACHED<T>) continue;
+            distances[csr.targets[e]] = distances[u] + 1;
+            queue.push_back(csr.targets[e]);
+        }
+    }
+    return distances;
+}
+template <typename T>
+static void referenceDfs(const Csr<T>& csr, T v, std::vector<bool>& seen, std::vector<T>& order) {
+    seen[v] = true;
+    order.push_back(v);
+    for (T e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) {
+        if (!seen[csr.targets[e]]) referenceDfs(csr, csr.targets[e], seen, order);
+    }
+}
+template <typename T>
+static void expectBfsMatchesReference(size_t vertex_count, size_t edge_count, bool symmetric, WorkStealingPool* pool, std::mt19937& rng) {
+    const Csr<T> csr = randomGraph<T>(vertex_count, edge_count, symmetric, rng);
+    ASSERT_TRUE(isWellFormed(csr.view(), pool));
+    const T source = static_cast<T>(rng() % vertex_count);
+    const std::vector<T> expected = referenceBfs(csr, source);
+    std::vector<T> distances(vertex_count);
+    BfsStats stats;
+    const size_t reached = breadthFirst<T>(csr.view(), source, distances.data(), symmetric, pool, &stats);
+    EXPECT_EQ(distances, expected) << vertex_count << " vertices, symmetric " << symmetric;
+    EXPECT_EQ(reached, vertex_count - std::count(expected.begin(), expected.end(), UNREACHED<T>));
+    if (symmetric && edge_count >= 4 * vertex_count) EXPECT_GT(stats.bottom_up_steps, 0u); // Dense enough to switch
+    if (!symmetric) EXPECT_EQ(stats.bottom_up_steps, 0u);
+    if (pool && vertex_count >= 4 * PARALLEL_MIN_STEP) EXPECT_GT(stats.parallel_steps, 0u);
+}
+// --- Traversals ---
+TEST(GraphTraversalTest, BreadthFirstMatchesAQueueBfs) {
+    std::mt19937 rng(17);
+    WorkStealingPool pool(3);
+    for (WorkStealingPool* p : {static_cast<WorkStealingPool*>(nullptr), &pool}) {
+        for (bool symmetric : {false, true}) {
+            expectBfsMatchesReference<uint32_t>(1, 0, symmetric, p, rng);
+            expectBfsMatchesReference<uint32_t>(100, 150, symmetric, p, rng); // Sparse: several components
+            expectBfsMatchesReference<uint64_t>(1000, 8000, symmetric, p, rng);
+            expectBfsMatchesReference<uint32_t>(100000, 800000, symmetric, p, rng);
+        }
+    }
+}
+TEST(GraphTraversalTest, DepthFirstAndTopologicalOrders) {
+    std::mt19937 rng(23);
+    const Csr<uint32_t> graph = randomGraph<uint32_t>(500, 900, false, rng);
+    std::vector<bool> seen(500);
+    std::vector<uint32_t> expected, order(500);
+    referenceDfs<uint32_t>(graph, 7, seen, expected);
+    ASSERT_EQ(depthFirst<uint32_t>(graph.view(), 7, order.data()), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), order.begin()));
+    // A DAG: edges only from lower to higher ids, listed in random order
+    std::vector<std::pair<uint64_t, uint64_t>> edges;
+    for (size_t i = 0; i < 3000; ++i) {
+        const uint64_t a = rng() % 400, b = rng() % 400;
+        if (a != b) edges.emplace_back(std::min(a, b), std::max(a, b));
+    }
+    Csr<uint64_t> dag = toCsr<uint64_t>(400, edges);
+    std::vector<uint64_t> topo(400), position(400);
+    ASSERT_EQ(topologicalOrder<uint64_t>(dag.view(), topo.data()), 400u);
+    for (size_t i = 0; i < 400; ++i) position[topo[i]] = i;
+    for (const auto& [from, to] : edges) EXPECT_LT(position[from], position[to]);
+    edges.emplace_back(300, 100); // Close a cycle through whatever path leads 100 -> 300
+    edges.emplace_back(100, 300);
+    dag = toCsr<uint64_t>(400, edges);
+    EXPECT_LT(topologicalOrder<uint64_t>(dag.view(), topo.data()), 400u);
+}
+// --- GRAPH_TRAVERSE ---
+TEST(GraphTraverseOpTest, TraversesCsrArraysInMemory) {
+    MemoryManager memory(4 * MemoryManager::PAGE_SIZE);
+    // 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3, 4 isolated
+    const uint32_t offsets[] = {0, 2, 3, 4, 4, 4};
+    const uint32_t targets[] = {1, 2, 3, 3};
+    memory.writeMemory(0, reinterpret_cast<const std::byte*>(offsets), sizeof(offsets));
+    memory.writeMemory(64, reinterpret_cast<const std::byte*>(targets), sizeof(targets));
+    memory.takeDirtyPages();
+    const uint64_t output = 2 * MemoryManager::PAGE_SIZE;
+    BDINode node(1, BDIOperationType::GRAPH_TRAVERSE);
+    std::vector<BDIValueVariant> inputs = {uint64_t{0}, uint64_t{64}, uint64_t{5}, uint64_t{0}, output};
+    HeldValue result;
+    VMErrorInfo error;
+    uint32_t values[5] = {};
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    EXPECT_EQ(std::get<uint64_t>(result.get()), 4u);
+    memory.readMemory(output, reinterpret_cast<std::byte*>(values), sizeof(values));
+    EXPECT_EQ(std::vector<uint32_t>(values, values + 5), (std::vector<uint32_t>{0, 1, 1, 2, UNREACHED<uint32_t>}));
+    EXPECT_EQ(memory.takeDirtyPages(), (std::vector<size_t>{2}));
+    node.payload = TypedPayload::createFrom(encodeTraverse({BDIType::UINT32, TraversalMode::DFS}));
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    memory.readMemory(output, reinterpret_cast<std::byte*>(values), sizeof(values));
+    EXPECT_EQ(std::get<uint64_t>(result.get()), 4u);
+    EXPECT_EQ(std::vector<uint32_t>(values, values + 4), (std::vector<uint32_t>{0, 1, 3, 2}));
+    node.payload = TypedPayload::createFrom(encodeTraverse({BDIType::UINT32, TraversalMode::TOPOLOGICAL}));
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    memory.readMemory(output, reinterpret_cast<std::byte*>(values), sizeof(values));
+    EXPECT_EQ(std::get<uint64_t>(result.get()), 5u);
+    EXPECT_EQ(std::vector<uint32_t>(values, values + 5), (std::vector<uint32_t>{0, 4, 1, 2, 3}));
+    node.payload = TypedPayload::createFrom(encodeTraverse({BDIType::UINT32, TraversalMode::BFS}));
+    inputs[3] = uint64_t{5}; // Source out of range
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OUT_OF_RANGE);
+    inputs[3] = uint64_t{0};
+    const uint32_t bad_target = 9;
+    memory.writeMemory(64 + 4, reinterpret_cast<const std::byte*>(&bad_target), sizeof(bad_target));
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OUT_OF_RANGE);
+    memory.writeMemory(64, reinterpret_cast<const std::byte*>(targets), sizeof(targets));
+    inputs[4] = uint64_t{60}; // Output overlaps the targets
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[4] = output + 2; // Misaligned
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[4] = uint64_t{4 * MemoryManager::PAGE_SIZE - 8}; // Runs past the end
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[4] = output;
+    node.payload = TypedPayload::createFrom(uint32_t{static_cast<uint8_t>(BDIType::INT32)});
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::TYPE_MISMATCH);
+    inputs.pop_back();
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::ARITY);
+    BDINode plain(2, BDIOperationType::GRAPH_TRAVERSE);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(plain, {uint64_t{0}, uint64_t{64}, uint64_t{5}, uint64_t{0}, output}, nullptr, result, &error),
+              VMStatus::NO_MEMORY_MANAGER);
+    auto decoded = decodeTraverse(encodeTraverse({BDIType::UINT64, TraversalMode::TOPOLOGICAL, true}));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->index_type, BDIType::UINT64);
+    EXPECT_EQ(decoded->mode, TraversalMode::TOPOLOGICAL);
+    EXPECT_TRUE(decoded->symmetric);
+    EXPECT_FALSE(decodeTraverse(3u << 8 | static_cast<uint8_t>(BDIType::UINT32)));
+}
@@ -0,0 +1,116 @@
+#include "gtest.h"
+#include "Logger.hpp"
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace bdi::runtime;
+// --- Helpers --
+struct CapturedLine {
+    LogLevel level;
+    LogCategory category;
+    uint16_t thread_index;
+    std::string message;
+};
+// Routes the global logger into a vector for the lifetime of the fixture
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::global().flush();
+        Logger::global().setSink([this](const LogRecord& record) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lines_.push_back({record.level, record.category, record.thread_index, std::string(record.message)});
+        });
+        Logger::global().setLevel(LogLevel::INFO);
+    }
+    void TearDown() override {
+        Logger::global().flush();
+        Logger::global().setSink(nullptr);
+        Logger::global().setLevel(LogLevel::INFO);
+    }
+    std::vector<CapturedLine> captured() {
+        Logger::global().flush();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+    std::mutex mutex_;
+    std::vector<CapturedLine> lines_;
+};
+static int countEvaluation(int& counter) {
+    return ++counter;
+}
+// --- Tests ---
+TEST_F(LoggerTest, DeliversLevelCategoryAndMessage) {
+    BDI_LOG_WARN(MEMORY, "Region " << 7 << " is " << "gone");
+    BDI_LOG_ERROR(SCHEDULER, "Task " << 3 << " faulted");
+    auto lines = captured();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].level, LogLevel::WARN);
+    EXPECT_EQ(lines[0].category, LogCategory::MEMORY);
+    EXPECT_EQ(lines[0].message, "Region 7 is gone");
+    EXPECT_EQ(lines[1].level, LogLevel::ERROR);
+    EXPECT_EQ(lines[1].category, LogCategory::SCHEDULER);
+    EXPECT_EQ(lines[1].message, "Task 3 faulted");
+}
+TEST_F(LoggerTest, DisabledLevelsDoNotFormat) {
+    int evaluations = 0;
+    Logger::global().setLevel(LogCategory::OPTIMIZER, LogLevel::ERROR);
+    BDI_LOG_WARN(OPTIMIZER, "count " << countEvaluation(evaluations)); // Disabled at runtime
+    BDI_LOG_WARN(VM, "count " << countEvaluation(evaluations));        // Other categories unaffected
+    EXPECT_EQ(evaluations, 1);
+    Logger::global().setLevel(LogLevel::TRACE);
+    BDI_LOG_TRACE(VM, "count " << countEvaluation(evaluations));
+#if BDI_LOG_LEVEL > BDI_LOG_LEVEL_TRACE
+    EXPECT_EQ(evaluations, 1); // Compiled out: enabling at runtime changes nothing
+#else
+    EXPECT_EQ(evaluations, 2);
+#endif
+    auto lines = captured();
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines[0].category, LogCategory::VM);
+}
+TEST_F(LoggerTest, StreamStateDoesNotLeakBetweenLines) {
+    BDI_LOG_INFO(GENERAL, "hex " << std::hex << 255);
+    BDI_LOG_INFO(GENERAL, "dec " << 255);
+    auto lines = captured();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].message, "hex ff");
+    EXPECT_EQ(lines[1].message, "dec 255");
+}
+TEST_F(LoggerTest, ManyThreadsKeepPerThreadOrder) {
+    constexpr int kThreads = 4;
+    constexpr int kLines = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < kLines; ++i) BDI_LOG_INFO(VM, t << ":" << i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    auto lines = captured();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(kThreads * kLines));
+    std::vector<int> next(kThreads, 0);
+    std::set<uint16_t> indices;
+    for (const auto& line : lines) {
+        int t = std::stoi(line.message.substr(0, line.message.find(':')));
+        int i = std::stoi(line.message.substr(line.message.find(':') + 1));
+        EXPECT_EQ(i, next[t]++);
+        indices.insert(line.thread_index);
+    }
+    EXPECT_EQ(indices.size(), static_cast<size_t>(kThreads));
+}
+TEST(LoggerBufferTest, FullBufferDropsAndCounts) {
+    Logger logger(64, std::chrono::hours(1)); // Only explicit flushes drain
+    std::vector<std::string> seen;
+    logger.setSink([&](const LogRecord& record) { seen.emplace_back(record.message); });
+    for (int i = 0; i < 10; ++i) logger.write(LogLevel::INFO, LogCategory::GENERAL, "sixteen bytes...");
+    logger.flush();
+    ASSERT_EQ(seen.size(), 5u); // 4 lines fit, plus the drop notice
+    EXPECT_NE(seen.back().find("6 line(s) dropped"), std::string::npos);
+    EXPECT_EQ(logger.getDroppedCount(), 6u);
+    logger.write(LogLevel::INFO, LogCategory::GENERAL, "after");
+    logger.flush();
+    EXPECT_EQ(seen.back(), "after");
+}
@@ -0,0 +1,129 @@
+#include "gtest.h"
+#include "Gemm.hpp"
+#include "LinalgOps.hpp"
+#include "NodeEvaluator.hpp"
+#include "MemoryManager.hpp"
+#include "WorkStealingPool.hpp"
+#include "TypedPayload.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::runtime::linalg;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+// Small integers, so float sums are exact whatever the summation order
+template <typename T>
+static std::vector<T> randomMatrix(size_t count, std::mt19937& rng) {
+    std::vector<T> values(count);
+    for (T& value : values) value = static_cast<T>(static_cast<int>(rng() % 17) - 8);
+    return values;
+}
+template <typename T>
+static void expectMatchesReference(const GemmKernels& kernels, size_t m, size_t n, size_t k, MatrixLayout a_layout,
+                                   MatrixLayout b_layout, MatrixLayout c_layout, bool accumulate, std::mt19937& rng,
+                                   WorkStealingPool* pool = nullptr) {
+    const std::vector<T> a = randomMatrix<T>(m * k, rng), b = randomMatrix<T>(k * n, rng);
+    std::vector<T> expected = randomMatrix<T>(m * n, rng);
+    std::vector<T> actual = expected;
+    referenceGemm<T>(m, n, k, MatrixRef<const T>::dense(a.data(), m, k, a_layout), MatrixRef<const T>::dense(b.data(), k, n, b_layout),
+                     MatrixRef<T>::dense(expected.data(), m, n, c_layout), accumulate);
+    gemm<T>(kernels, m, n, k, MatrixRef<const T>::dense(a.data(), m, k, a_layout), MatrixRef<const T>::dense(b.data(), k, n, b_layout),
+            MatrixRef<T>::dense(actual.data(), m, n, c_layout), accumulate, pool);
+    EXPECT_EQ(actual, expected) << simd::toString(kernels.level) << " " << m << "x" << n << "x" << k;
+}
+static std::vector<const GemmKernels*> availableTables() {
+    std::vector<const GemmKernels*> tables;
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        if (const GemmKernels* kernels = gemmKernelsFor(level)) tables.push_back(kernels);
+    }
+    return tables;
+}
+// --- Kernels ---
+TEST(GemmTest, EveryLevelMatchesTheTripleLoop) {
+    std::mt19937 rng(42);
+    const size_t shapes[][3] = {{1, 1, 1}, {7, 13, 5}, {6, 32, 256}, {37, 70, 300}, {150, 45, 9}}; // Edges, kc and mc overflow
+    const MatrixLayout row = MatrixLayout::ROW_MAJOR, col = MatrixLayout::COL_MAJOR;
+    for (const GemmKernels* kernels : availableTables()) {
+        for (const auto& shape : shapes) {
+            const auto [m, n, k] = std::tuple{shape[0], shape[1], shape[2]};
+            expectMatchesReference<float>(*kernels, m, n, k, row, row, row, false, rng);
+            expectMatchesReference<float>(*kernels, m, n, k, col, row, col, true, rng);
+            expectMatchesReference<double>(*kernels, m, n, k, row, col, row, false, rng);
+            expectMatchesReference<double>(*kernels, m, n, k, col, col, col, true, rng);
+            expectMatchesReference<int32_t>(*kernels, m, n, k, row, row, col, false, rng);
+            expectMatchesReference<int32_t>(*kernels, m, n, k, col, row, row, true, rng);
+        }
+    }
+}
+TEST(GemmTest, Int32ProductsWrapAndEmptyDimensionsAreHandled) {
+    const int32_t a[] = {1 << 20}, b[] = {1 << 12};
+    int32_t c[] = {7};
+    gemm<int32_t>(1, 1, 1, {a, 1, 1}, {b, 1, 1}, {c, 1, 1});
+    EXPECT_EQ(c[0], 0); // 2^32 wraps
+    float x[] = {1, 2}, y[] = {3, 4}, z[] = {5, 6, 7, 8};
+    gemm<float>(2, 2, 0, {x, 0, 1}, {y, 2, 1}, {z, 2, 1}, true);
+    EXPECT_EQ(z[0], 5); // k == 0 adds nothing...
+    gemm<float>(2, 2, 0, {x, 0, 1}, {y, 2, 1}, {z, 2, 1});
+    EXPECT_EQ(z[3], 0); // ...or clears C
+    EXPECT_EQ(parseLayoutHint("ColMajor"), MatrixLayout::COL_MAJOR);
+    EXPECT_EQ(parseLayoutHint("Contiguous"), MatrixLayout::ROW_MAJOR);
+    EXPECT_FALSE(parseLayoutHint("Tiled"));
+}
+TEST(GemmTest, ParallelTilesMatchTheSerialResult) {
+    std::mt19937 rng(3);
+    WorkStealingPool pool(3);
+    const size_t m = 300, n = 200, k = 90; // Above PARALLEL_MIN_WORK; two row tiles, so columns split too
+    static_assert(300 * 200 * 90 >= PARALLEL_MIN_WORK);
+    expectMatchesReference<float>(gemmKernels(), m, n, k, MatrixLayout::ROW_MAJOR, MatrixLayout::ROW_MAJOR, MatrixLayout::ROW_MAJOR, false, rng, &pool);
+    expectMatchesReference<int32_t>(gemmKernels(), m, n, k, MatrixLayout::COL_MAJOR, MatrixLayout::ROW_MAJOR, MatrixLayout::ROW_MAJOR, true, rng, &pool);
+}
+// --- LINALG_MATMUL ---
+TEST(MatmulOpTest, MultipliesMatricesInMemory) {
+    MemoryManager memory(4 * MemoryManager::PAGE_SIZE);
+    const float a[2 * 3] = {1, 2, 3, 4, 5, 6};     // Row-major 2x3
+    const float b[3 * 2] = {7, 9, 11, 8, 10, 12};  // Column-major 3x2: columns {7, 9, 11}, {8, 10, 12}
+    memory.writeMemory(0, reinterpret_cast<const std::byte*>(a), sizeof(a));
+    memory.writeMemory(64, reinterpret_cast<const std::byte*>(b), sizeof(b));
+    memory.takeDirtyPages();
+    BDINode node(1, BDIOperationType::LINALG_MATMUL);
+    node.payload = TypedPayload::createFrom(encodeMatmul({BDIType::FLOAT32, MatrixLayout::ROW_MAJOR, MatrixLayout::COL_MAJOR}));
+    const uint64_t c = 2 * MemoryManager::PAGE_SIZE;
+    std::vector<BDIValueVariant> inputs = {uint64_t{0}, uint64_t{64}, c, uint64_t{2}, uint64_t{3}, uint64_t{2}};
+    HeldValue result;
+    VMErrorInfo error;
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OK) << error.message();
+    float product[4] = {};
+    memory.readMemory(c, reinterpret_cast<std::byte*>(product), sizeof(product));
+    EXPECT_EQ(std::vector<float>(product, product + 4), (std::vector<float>{58, 64, 139, 154}));
+    EXPECT_EQ(memory.takeDirtyPages(), (std::vector<size_t>{2}));
+    inputs[2] = uint64_t{16}; // C overlaps A
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[2] = uint64_t{4 * MemoryManager::PAGE_SIZE - 8}; // C runs past the end
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[2] = c + 2; // Misaligned
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::MEMORY_FAULT);
+    inputs[2] = c;
+    inputs[3] = ~uint64_t{0}; // Byte size overflows
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::OUT_OF_RANGE);
+    node.payload = TypedPayload::createFrom(uint32_t{static_cast<uint8_t>(BDIType::INT8)});
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::TYPE_MISMATCH);
+    inputs.pop_back();
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(node, inputs, &memory, result, &error), VMStatus::ARITY);
+    BDINode plain(2, BDIOperationType::LINALG_MATMUL); // No payload: row-major FLOAT32
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(plain, {uint64_t{0}, uint64_t{0}, uint64_t{0}, uint64_t{1}, uint64_t{1}, uint64_t{1}}, nullptr, result, &error),
+              VMStatus::NO_MEMORY_MANAGER);
+}
+TEST(MatmulOpTest, SpecRoundTripsThroughThePayload) {
+    MatmulSpec spec{BDIType::INT32, MatrixLayout::COL_MAJOR, MatrixLayout::ROW_MAJOR, MatrixLayout::COL_MAJOR, true};
+    auto decoded = decodeMatmul(encodeMatmul(spec));
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(decoded->element_type, BDIType::INT32);
+    EXPECT_EQ(decoded->a_layout, MatrixLayout::COL_MAJOR);
+    EXPECT_EQ(decoded->b_layout, MatrixLayout::ROW_MAJOR);
+    EXPECT_EQ(decoded->c_layout, MatrixLayout::COL_MAJOR);
+    EXPECT_TRUE(decoded->accumulate);
+    EXPECT_FALSE(decodeMatmul(encodeMatmul(spec) | (1u << 12)));
+}
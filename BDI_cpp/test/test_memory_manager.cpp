@@ -1,5 +1,7 @@
  #include "gtest.h"
  #include "MemoryManager.hpp" // Adjust path as needed
+ #include <thread>
+ #include <vector>
  using namespace bdi::runtime;
  TEST(MemoryManagerTest, Initialization) {
     ASSERT_NO_THROW(MemoryManager manager(1024));
@@ -146,3 +148,48 @@
     ASSERT_TRUE(id_D.has_value());
     EXPECT_EQ(manager.getUsedSize(), 100);
  }
+ TEST(MemoryManagerTest, DirtyPagesTrackWrites) {
+    MemoryManager manager(4 * MemoryManager::PAGE_SIZE);
+    EXPECT_EQ(manager.getPageCount(), 4u);
+    EXPECT_TRUE(manager.takeDirtyPages().empty());
+    std::vector<std::byte> buffer(8, std::byte{1});
+    ASSERT_TRUE(manager.writeMemory(MemoryManager::PAGE_SIZE - 4, buffer.data(), buffer.size())); // Straddles pages 0 and 1
+    manager.markDirty(3 * MemoryManager::PAGE_SIZE + 10, 1);
+    EXPECT_EQ(manager.takeDirtyPages(), (std::vector<size_t>{0, 1, 3}));
+    EXPECT_TRUE(manager.takeDirtyPages().empty()); // Taking clears
+ }
+ TEST(MemoryManagerTest, AtomicRmwOpsOrdersAndFaults) {
+    MemoryManager manager(2 * MemoryManager::PAGE_SIZE);
+    const uintptr_t word = MemoryManager::PAGE_SIZE + 8;
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::ADD, 5), 0u);
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::OR, 0xF0, 0, AtomicOrder::RELAXED), 5u);
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::AND, 0xF1, 0, AtomicOrder::ACQ_REL), 0xF5u);
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::XOR, 0xFF, 0, AtomicOrder::RELEASE), 0xF1u);
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::XCHG, 7, 0, AtomicOrder::ACQUIRE), 0x0Eu);
+    EXPECT_EQ(manager.takeDirtyPages(), (std::vector<size_t>{1}));
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::CAS, 9, 3), 7u); // Fails: returns the current value, writes nothing
+    EXPECT_TRUE(manager.takeDirtyPages().empty());
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::CAS, 9, 7), 7u);
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::LOAD, 0, 0, AtomicOrder::ACQUIRE), 9u);
+    EXPECT_EQ(manager.atomicRmw(word, 1, AtomicOp::ADD, 0xFF), 9u); // Byte-wide, wraps without touching the next byte
+    EXPECT_EQ(manager.atomicRmw(word, 4, AtomicOp::LOAD, 0), 8u);
+    EXPECT_EQ(manager.atomicRmw(word, 8, AtomicOp::XCHG, 0x1122334455667788ull), 8u);
+    EXPECT_EQ(manager.atomicRmw(word + 4, 4, AtomicOp::LOAD, 0), 0x11223344u);
+    EXPECT_FALSE(manager.atomicRmw(word, 4, AtomicOp::LOAD, 0, 0, AtomicOrder::RELEASE)); // Invalid order for a load
+    EXPECT_FALSE(manager.atomicRmw(word + 2, 4, AtomicOp::ADD, 1));                        // Misaligned
+    EXPECT_FALSE(manager.atomicRmw(word, 3, AtomicOp::ADD, 1));                            // Not a power-of-two width
+    EXPECT_FALSE(manager.atomicRmw(2 * MemoryManager::PAGE_SIZE - 4, 8, AtomicOp::ADD, 1)); // Out of bounds
+ }
+ TEST(MemoryManagerTest, AtomicRmwIsAtomicAcrossThreads) {
+    MemoryManager manager(MemoryManager::PAGE_SIZE);
+    constexpr int kThreads = 4;
+    constexpr int kIterations = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kIterations; ++i) manager.atomicRmw(64, 8, AtomicOp::ADD, 1, 0, AtomicOrder::RELAXED);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(manager.atomicRmw(64, 8, AtomicOp::LOAD, 0), uint64_t{kThreads} * kIterations);
+ }
@@ -0,0 +1,153 @@
+#include "gtest.h"
+#include "Profiler.hpp"
+#include "ProfileExport.hpp"
+#include "HardwareAbstractionLayer.hpp"
+#include "OptimizationEngine.hpp"
+#include "TaskScheduler.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <sstream>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+// Timer that advances a fixed step per read, so every ProfileScope measures exactly 'step' ticks
+class SteppingTimerHAL : public bdi::hal::HardwareAbstractionLayer {
+public:
+    explicit SteppingTimerHAL(uint64_t step) : step_(step) {}
+    uint64_t readSpecialRegister(bdi::hal::SpecialRegister reg) override {
+        if (reg == bdi::hal::SpecialRegister::TimerFrequency) return 2'000'000'000; // 2 ticks per ns
+        return now_ += step_;
+    }
+    void writeSpecialRegister(bdi::hal::SpecialRegister, uint64_t) override {}
+    bool readPhysical(uint64_t, std::byte*, size_t) override { return false; }
+    bool writePhysical(uint64_t, const std::byte*, size_t) override { return false; }
+    std::optional<uintptr_t> mapPhysicalMemory(uint64_t, size_t, uint64_t) override { return std::nullopt; }
+    bool unmapMemory(uintptr_t, size_t) override { return false; }
+    void enableInterrupts() override {}
+    void disableInterrupts() override {}
+    void acknowledgeInterrupt(uint32_t) override {}
+    void waitForInterrupt() override {}
+    void systemHalt() override {}
+    void debugBreak() override {}
+private:
+    uint64_t step_;
+    uint64_t now_ = 0;
+};
+// Records the profile count of one node as seen from inside a pass
+class ProfileProbePass : public bdi::optimizer::OptimizationPassBase {
+public:
+    ProfileProbePass(NodeID probe, uint64_t& seen) : OptimizationPassBase("ProfileProbe"), probe_(probe), seen_(seen) {}
+    bool run(BDIGraph&) override {
+        seen_ = getProfile() ? getProfile()->getCount(probe_) : 0;
+        return false;
+    }
+private:
+    NodeID probe_;
+    uint64_t& seen_;
+};
+// --- Tests ---
+TEST(ProfilerTest, HalTimerGivesExactCyclesPerScope) {
+    SteppingTimerHAL hal(100);
+    Profiler profiler(&hal);
+    { ProfileScope off(profiler, nullptr, 1, 7); } // Disabled: not recorded
+    profiler.setEnabled(true);
+    EXPECT_DOUBLE_EQ(profiler.getCounter().getTicksPerNs(), 2.0);
+    for (int i = 0; i < 3; ++i) {
+        ProfileScope scope(profiler, nullptr, 1, 7);
+    }
+    { ProfileScope scope(profiler, nullptr, 2, 9); }
+    ProfileData data = profiler.snapshot();
+    EXPECT_EQ(data.getTotalCycles(), 400u);
+    EXPECT_EQ(data.byNode()[1].count, 3u);
+    EXPECT_EQ(data.byNode()[1].cycles, 300u);
+    EXPECT_EQ(data.byOpcode()[9].cycles, 100u);
+    std::ostringstream table;
+    writeHotSpotTable(data, table);
+    EXPECT_LT(table.str().find("By opcode"), table.str().find("By node"));
+    profiler.reset();
+    EXPECT_TRUE(profiler.snapshot().samples.empty());
+}
+TEST(ProfilerTest, TaskProfileAggregatesPerCallSubgraphAndFeedsOptimizer) {
+    // main: call sub(k); call sub(k); return.  sub: return arg + arg
+    GraphBuilder builder("ProfiledCalls");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID k = addConst(builder, TypedPayload::createFrom(int32_t{21}));
+    NodeID call1 = builder.addNode(BDIOperationType::CTRL_CALL);
+    builder.connectData(k, 0, call1, 0);
+    NodeID call2 = builder.addNode(BDIOperationType::CTRL_CALL);
+    builder.defineDataOutput(call2, 0, BDIType::INT32);
+    builder.connectData(k, 0, call2, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(call2, 0, ret, 0);
+    NodeID sub = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(sub, 0, BDIType::INT32);
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(sub, 0, add, 0);
+    builder.connectData(sub, 0, add, 1);
+    NodeID sub_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, sub_ret, 0);
+    builder.connectControl(start, call1);
+    builder.connectControl(call1, sub);   // Target
+    builder.connectControl(call1, call2); // Return address
+    builder.connectControl(call2, sub);
+    builder.connectControl(call2, ret);
+    builder.connectControl(sub, add);
+    builder.connectControl(add, sub_ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    Profiler& profiler = Profiler::global();
+    profiler.reset();
+    profiler.setEnabled(true);
+    uint64_t task_id = 0;
+    {
+        TaskScheduler os(nullptr, 1);
+        task_id = os.spawnTask(*graph, start);
+        os.start();
+        EXPECT_TRUE(os.waitForIdle());
+        auto result = os.getTaskResult(task_id);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(std::get<int32_t>(*result), 42);
+    }
+    profiler.setEnabled(false);
+    ProfileData data = profiler.snapshot();
+    auto nodes = data.byNode();
+    EXPECT_EQ(nodes[add].count, 2u);
+    EXPECT_EQ(nodes[call1].count, 1u);
+    EXPECT_EQ(data.byOpcode()[static_cast<uint16_t>(BDIOperationType::ARITH_ADD)].count, 2u);
+    // Each call site gets its own context; both fold into the 'sub' subgraph
+    int add_contexts = 0;
+    for (const auto& s : data.samples) {
+        if (s.node_id != add) continue;
+        ++add_contexts;
+        ASSERT_EQ(s.call_path.size(), 1u);
+        EXPECT_TRUE(s.call_path[0] == call1 || s.call_path[0] == call2);
+    }
+    EXPECT_EQ(add_contexts, 2);
+    auto subgraphs = data.bySubgraph(*graph);
+    EXPECT_EQ(subgraphs[sub].count, 6u); // sub, add, sub_ret per call
+    EXPECT_EQ(subgraphs[0].count, 4u);   // start, call1, call2, ret
+    std::ostringstream table;
+    writeHotSpotTable(data, table, 0, graph.get());
+    EXPECT_NE(table.str().find("By subgraph"), std::string::npos);
+    std::ostringstream folded;
+    writeFoldedStacks(data, folded);
+    std::string add_frame = "graph;call@" + std::to_string(call1) + ";op" +
+                            std::to_string(static_cast<uint16_t>(BDIOperationType::ARITH_ADD)) + "@" + std::to_string(add) + " ";
+    if (nodes[add].cycles != 0) {
+        EXPECT_NE(folded.str().find(add_frame), std::string::npos);
+    }
+    // Profile-guided passes see the counts through the engine
+    uint64_t seen = 0;
+    bdi::optimizer::OptimizationEngine engine;
+    engine.addPass(std::make_unique<ProfileProbePass>(add, seen));
+    engine.setProfile(data.toGuidance());
+    engine.run(*graph, 1);
+    EXPECT_EQ(seen, 2u);
+    profiler.reset();
+}
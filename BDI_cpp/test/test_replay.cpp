@@ -0,0 +1,357 @@
+#include "gtest.h"
+#include "ExecutionJournal.hpp"
+#include "TaskScheduler.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static NodeID addRead(GraphBuilder& builder, BDIOperationType op, TypedPayload address) {
+    NodeID id = builder.addNode(op);
+    builder.setNodePayload(id, address);
+    builder.defineDataOutput(id, 0, BDIType::UINT64);
+    return id;
+}
+static NodeID addBinary(GraphBuilder& builder, BDIOperationType op, NodeID a, NodeID b) {
+    NodeID id = builder.addNode(op);
+    builder.defineDataOutput(id, 0, BDIType::UINT64);
+    builder.connectData(a, 0, id, 0);
+    builder.connectData(b, 0, id, 1);
+    return id;
+}
+// Port values depend on which worker reads first; the timer on when
+class RacyDevice : public DeviceInputs {
+public:
+    std::optional<uint64_t> read(InputSource source, uint64_t address) override {
+        if (source == InputSource::SPECIAL_REGISTER) {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+        return next_.fetch_add(1) * 1000 + address;
+    }
+private:
+    std::atomic<uint64_t> next_{1};
+};
+// producer: v = port(0x60) + port(0x60) + timer; send(7, v); return v
+// consumer: return wait(7) + port(consumer_port)
+// sleeper:  wait(99)            halter: return halt(task 1)
+// late:     return wait(8)      (event 8 comes from outside)
+struct ReplayGraph {
+    std::unique_ptr<BDIGraph> graph;
+    NodeID producer = 0, consumer = 0, consumer_wait = 0, sleeper = 0, halter = 0, late = 0;
+};
+static ReplayGraph buildReplayGraph(uint64_t consumer_port = 0x61) {
+    ReplayGraph g;
+    GraphBuilder builder("ReplayTasks");
+    g.producer = builder.addNode(BDIOperationType::META_START);
+    NodeID p1 = addRead(builder, BDIOperationType::IO_READ_PORT, TypedPayload::createFrom(uint64_t{0x60}));
+    NodeID timer = addRead(builder, BDIOperationType::SYS_REG_READ, TypedPayload::createFrom(uint8_t{5})); // TimerCurrentValue
+    NodeID yield = builder.addNode(BDIOperationType::SYS_YIELD);
+    NodeID p2 = addRead(builder, BDIOperationType::IO_READ_PORT, TypedPayload::createFrom(uint64_t{0x60}));
+    NodeID sum = addBinary(builder, BDIOperationType::ARITH_ADD, p1, p2);
+    NodeID value = addBinary(builder, BDIOperationType::ARITH_ADD, sum, timer);
+    NodeID event = addConst(builder, TypedPayload::createFrom(uint64_t{7}));
+    NodeID send = builder.addNode(BDIOperationType::SYS_SEND_EVENT);
+    builder.connectData(event, 0, send, 0);
+    builder.connectData(value, 0, send, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(value, 0, ret, 0);
+    builder.connectControl(g.producer, p1);
+    builder.connectControl(p1, timer);
+    builder.connectControl(timer, yield);
+    builder.connectControl(yield, p2);
+    builder.connectControl(p2, sum);
+    builder.connectControl(sum, value);
+    builder.connectControl(value, send);
+    builder.connectControl(send, ret);
+    g.consumer = builder.addNode(BDIOperationType::META_START);
+    g.consumer_wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(g.consumer_wait, TypedPayload::createFrom(uint64_t{7}));
+    builder.defineDataOutput(g.consumer_wait, 0, BDIType::UINT64);
+    NodeID port = addRead(builder, BDIOperationType::IO_READ_PORT, TypedPayload::createFrom(consumer_port));
+    NodeID total = addBinary(builder, BDIOperationType::ARITH_ADD, g.consumer_wait, port);
+    NodeID consumer_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(total, 0, consumer_ret, 0);
+    builder.connectControl(g.consumer, g.consumer_wait);
+    builder.connectControl(g.consumer_wait, port);
+    builder.connectControl(port, total);
+    builder.connectControl(total, consumer_ret);
+    g.sleeper = builder.addNode(BDIOperationType::META_START);
+    NodeID forever = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(forever, TypedPayload::createFrom(uint64_t{99}));
+    NodeID sleeper_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(g.sleeper, forever);
+    builder.connectControl(forever, sleeper_end);
+    g.halter = builder.addNode(BDIOperationType::META_START);
+    NodeID target = addConst(builder, TypedPayload::createFrom(uint64_t{1}));
+    NodeID halt = builder.addNode(BDIOperationType::SYS_HALT_TASK);
+    builder.defineDataOutput(halt, 0, BDIType::BOOL);
+    builder.connectData(target, 0, halt, 0);
+    NodeID halter_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(halt, 0, halter_ret, 0);
+    builder.connectControl(g.halter, halt);
+    builder.connectControl(halt, halter_ret);
+    g.late = builder.addNode(BDIOperationType::META_START);
+    NodeID late_wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(late_wait, TypedPayload::createFrom(uint64_t{8}));
+    builder.defineDataOutput(late_wait, 0, BDIType::UINT64);
+    NodeID late_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(late_wait, 0, late_ret, 0);
+    builder.connectControl(g.late, late_wait);
+    builder.connectControl(late_wait, late_ret);
+    g.graph = builder.finalizeGraph();
+    return g;
+}
+constexpr int kPairs = 4;
+// Same order in the recording and every replay, so task ids line up
+static std::vector<uint64_t> spawnAll(TaskScheduler& os, const ReplayGraph& g) {
+    std::vector<uint64_t> ids;
+    ids.push_back(os.spawnTask(*g.graph, g.sleeper)); // Task 1
+    ids.push_back(os.spawnTask(*g.graph, g.halter));
+    for (int i = 0; i < kPairs; ++i) ids.push_back(os.spawnTask(*g.graph, g.producer));
+    for (int i = 0; i < kPairs; ++i) ids.push_back(os.spawnTask(*g.graph, g.consumer));
+    ids.push_back(os.spawnTask(*g.graph, g.late));
+    return ids;
+}
+struct Outcome {
+    std::vector<TaskStatus> status;
+    std::vector<std::optional<BDIValueVariant>> result;
+};
+static Outcome collect(const TaskScheduler& os, const std::vector<uint64_t>& ids) {
+    Outcome out;
+    for (uint64_t id : ids) {
+        out.status.push_back(os.getTaskStatus(id).value_or(TaskStatus::FAULTED));
+        out.result.push_back(os.getTaskResult(id));
+    }
+    return out;
+}
+static Outcome recordRun(const ReplayGraph& g, ExecutionJournal& journal, std::chrono::milliseconds& elapsed) {
+    RacyDevice device;
+    journal.startRecording();
+    TaskScheduler os(nullptr, 4, /*timeslice=*/2); // Tiny slices force preemption and stealing
+    os.setDevice(&device);
+    os.setJournal(&journal);
+    auto ids = spawnAll(os, g);
+    auto begin = std::chrono::steady_clock::now();
+    os.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    os.sendEvent(8, uint64_t{12345});
+    EXPECT_TRUE(os.waitForIdle());
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    os.stop();
+    journal.stop();
+    return collect(os, ids);
+}
+// --- Tests ---
+TEST(ReplayTest, ReplayReproducesRecordedRunWithoutWaiting) {
+    ReplayGraph g = buildReplayGraph();
+    ASSERT_NE(g.graph, nullptr);
+    ExecutionJournal journal;
+    std::chrono::milliseconds recorded_time{0};
+    Outcome recorded = recordRun(g, journal, recorded_time);
+    EXPECT_EQ(recorded.status[0], TaskStatus::HALTED);
+    EXPECT_EQ(std::get<bool>(*recorded.result[1]), true);
+    EXPECT_EQ(std::get<uint64_t>(*recorded.result.back()), 12345u);
+    // 2 port reads + 1 timer per producer, 1 port read per consumer, 1 halt result
+    EXPECT_EQ(journal.getInputCount(), static_cast<size_t>(kPairs * 4 + 1));
+    journal.startReplay();
+    TaskScheduler replayer(nullptr, 1, 2); // No device: every input must come from the journal
+    replayer.setJournal(&journal);
+    auto ids = spawnAll(replayer, g);
+    std::string divergence;
+    auto begin = std::chrono::steady_clock::now();
+    ASSERT_TRUE(replayer.replay(&divergence)) << divergence;
+    auto replay_time = std::chrono::steady_clock::now() - begin;
+    EXPECT_LT(replay_time, recorded_time); // The 100 ms wait for event 8 is skipped
+    Outcome replayed = collect(replayer, ids);
+    EXPECT_EQ(replayed.status, recorded.status);
+    EXPECT_EQ(replayed.result, recorded.result);
+    // Each consumer received the same producer's value as in the recording
+    for (int i = 0; i < kPairs; ++i) {
+        const ExecutionContext* ctx = replayer.getTaskContext(ids[2 + kPairs + i]);
+        ASSERT_NE(ctx, nullptr);
+        auto received = ctx->getPortValue(g.consumer_wait, 0);
+        ASSERT_TRUE(received.has_value());
+        EXPECT_NE(std::find(recorded.result.begin() + 2, recorded.result.begin() + 2 + kPairs, *received),
+                  recorded.result.begin() + 2 + kPairs);
+    }
+}
+TEST(ReplayTest, SavedJournalReplaysAndDivergenceIsReported) {
+    ReplayGraph g = buildReplayGraph();
+    ASSERT_NE(g.graph, nullptr);
+    ExecutionJournal journal;
+    std::chrono::milliseconds recorded_time{0};
+    Outcome recorded = recordRun(g, journal, recorded_time);
+    std::string path = (std::filesystem::temp_directory_path() / ("bdi_journal_" + std::to_string(::getpid()))).string();
+    ASSERT_TRUE(journal.save(path));
+    ExecutionJournal loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.getSchedule().size(), journal.getSchedule().size());
+    EXPECT_EQ(loaded.getInputCount(), journal.getInputCount());
+    loaded.startReplay();
+    {
+        TaskScheduler replayer(nullptr, 1);
+        replayer.setJournal(&loaded);
+        auto ids = spawnAll(replayer, g);
+        std::string divergence;
+        ASSERT_TRUE(replayer.replay(&divergence)) << divergence;
+        Outcome replayed = collect(replayer, ids);
+        EXPECT_EQ(replayed.result, recorded.result);
+    }
+    // Consumers now read another port: the first such read diverges
+    ReplayGraph changed = buildReplayGraph(0x62);
+    loaded.startReplay();
+    TaskScheduler replayer(nullptr, 1);
+    replayer.setJournal(&loaded);
+    spawnAll(replayer, changed);
+    std::string divergence;
+    EXPECT_FALSE(replayer.replay(&divergence));
+    EXPECT_NE(divergence.find("recorded port 97"), std::string::npos) << divergence;
+    // Garbage is rejected
+    {
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(f, nullptr);
+        std::fseek(f, 16, SEEK_SET);
+        uint64_t huge = ~uint64_t{0};
+        std::fwrite(&huge, sizeof(huge), 1, f);
+        std::fclose(f);
+    }
+    EXPECT_FALSE(ExecutionJournal().load(path));
+    std::remove(path.c_str());
+}
+TEST(ReplayTest, ChannelResultsReplayWithoutTheRecordedInterleaving) {
+    constexpr int kSenders = 4;
+    GraphBuilder builder("ChannelReplay");
+    NodeID ch = addConst(builder, TypedPayload::createFrom(uint64_t{1})); // First channel of each scheduler
+    NodeID sender = builder.addNode(BDIOperationType::META_START);
+    NodeID value = addRead(builder, BDIOperationType::IO_READ_PORT, TypedPayload::createFrom(uint64_t{0x60}));
+    NodeID send = builder.addNode(BDIOperationType::COMM_CHANNEL_SEND);
+    builder.connectData(ch, 0, send, 0);
+    builder.connectData(value, 0, send, 1);
+    NodeID sender_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(sender, value);
+    builder.connectControl(value, send);
+    builder.connectControl(send, sender_end);
+    NodeID receiver = builder.addNode(BDIOperationType::META_START);
+    NodeID recv = builder.addNode(BDIOperationType::COMM_CHANNEL_RECV);
+    builder.defineDataOutput(recv, 0, BDIType::UINT64);
+    builder.connectData(ch, 0, recv, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(recv, 0, ret, 0);
+    builder.connectControl(receiver, recv);
+    builder.connectControl(recv, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    auto spawn = [&](TaskScheduler& os) {
+        EXPECT_EQ(os.getChannels()->create(BDIType::UINT64, 1, Channel::Kind::MPMC), 1u);
+        std::vector<uint64_t> ids;
+        for (int i = 0; i < kSenders; ++i) ids.push_back(os.spawnTask(*graph, receiver));
+        for (int i = 0; i < kSenders; ++i) ids.push_back(os.spawnTask(*graph, sender));
+        return ids;
+    };
+    RacyDevice device;
+    ExecutionJournal journal;
+    journal.startRecording();
+    Outcome recorded;
+    {
+        TaskScheduler os(nullptr, 4, 2); // One slot: senders and receivers park on each other
+        os.setDevice(&device);
+        os.setJournal(&journal);
+        auto ids = spawn(os);
+        os.start();
+        EXPECT_TRUE(os.waitForIdle());
+        os.stop();
+        journal.stop();
+        recorded = collect(os, ids);
+    }
+    for (int i = 0; i < kSenders; ++i) ASSERT_EQ(recorded.status[i], TaskStatus::COMPLETED);
+    // A port read per sender, a received value per receiver, an outcome per channel op
+    EXPECT_GE(journal.getInputCount(), static_cast<size_t>(kSenders * 4));
+    journal.startReplay();
+    TaskScheduler replayer(nullptr, 1, 2);
+    replayer.setJournal(&journal);
+    auto ids = spawn(replayer);
+    std::string divergence;
+    ASSERT_TRUE(replayer.replay(&divergence)) << divergence;
+    Outcome replayed = collect(replayer, ids);
+    EXPECT_EQ(replayed.status, recorded.status);
+    EXPECT_EQ(replayed.result, recorded.result); // Each receiver got the same sender's value
+}
+TEST(ReplayTest, HaltOfARunningTaskReplaysAtTheRecordedNode) {
+    constexpr int kChain = 50000; // Straight-line adds: no backward edge to stop at
+    GraphBuilder builder("HaltRunning");
+    NodeID spinner = builder.addNode(BDIOperationType::META_START);
+    NodeID wake = addConst(builder, TypedPayload::createFrom(uint64_t{9}));
+    NodeID send = builder.addNode(BDIOperationType::SYS_SEND_EVENT);
+    builder.connectData(wake, 0, send, 0);
+    NodeID one = addConst(builder, TypedPayload::createFrom(uint64_t{1}));
+    builder.connectControl(spinner, send);
+    NodeID last = send, sum = one;
+    for (int i = 0; i < kChain; ++i) {
+        sum = addBinary(builder, BDIOperationType::ARITH_ADD, sum, one);
+        builder.connectControl(last, sum);
+        last = sum;
+    }
+    NodeID spinner_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(sum, 0, spinner_ret, 0);
+    builder.connectControl(last, spinner_ret);
+    // halter: wait(9); return halt(task 1), so the halt lands while the spinner is mid-chain
+    NodeID halter = builder.addNode(BDIOperationType::META_START);
+    NodeID wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(wait, TypedPayload::createFrom(uint64_t{9}));
+    NodeID target = addConst(builder, TypedPayload::createFrom(uint64_t{1}));
+    NodeID halt = builder.addNode(BDIOperationType::SYS_HALT_TASK);
+    builder.defineDataOutput(halt, 0, BDIType::BOOL);
+    builder.connectData(target, 0, halt, 0);
+    NodeID halter_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(halt, 0, halter_ret, 0);
+    builder.connectControl(halter, wait);
+    builder.connectControl(wait, halt);
+    builder.connectControl(halt, halter_ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    auto spawn = [&](TaskScheduler& os) {
+        return std::vector<uint64_t>{os.spawnTask(*graph, spinner), os.spawnTask(*graph, halter)}; // Spinner is task 1
+    };
+    ExecutionJournal journal;
+    journal.startRecording();
+    Outcome recorded;
+    {
+        TaskScheduler os(nullptr, 2, /*timeslice=*/1u << 30); // One slice covers the whole chain
+        os.setJournal(&journal);
+        auto ids = spawn(os);
+        os.start();
+        EXPECT_TRUE(os.waitForIdle());
+        os.stop();
+        journal.stop();
+        recorded = collect(os, ids);
+    }
+    ASSERT_EQ(recorded.status[0], TaskStatus::HALTED);
+    EXPECT_EQ(std::get<bool>(*recorded.result[1]), true);
+    const auto& schedule = journal.getSchedule();
+    auto halted = std::find_if(schedule.begin(), schedule.end(), [](const ExecutionJournal::ScheduleEntry& entry) {
+        return entry.task_id == 1 && entry.result == TaskEngine::SliceResult::HALTED_TASK;
+    });
+    ASSERT_NE(halted, schedule.end());
+    EXPECT_LT(halted->steps, static_cast<uint64_t>(kChain)); // Stopped short of the return
+    journal.startReplay();
+    TaskScheduler replayer(nullptr, 1);
+    replayer.setJournal(&journal);
+    auto ids = spawn(replayer);
+    std::string divergence;
+    ASSERT_TRUE(replayer.replay(&divergence)) << divergence;
+    Outcome replayed = collect(replayer, ids);
+    EXPECT_EQ(replayed.status, recorded.status);
+    EXPECT_EQ(replayed.result, recorded.result);
+}
@@ -0,0 +1,144 @@
+#include "gtest.h"
+#include "RequestPool.hpp"
+#include "LatencyHistogram.hpp"
+#include "MemoryManager.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <cstring>
+#include <thread>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+// total = *64 + 3 * x; *64 = total; return total. Sees 3 * x only if the arena was scrubbed.
+struct ScaleGraph {
+    std::shared_ptr<const BDIGraph> graph;
+    NodeID start = 0;
+};
+static ScaleGraph buildScaleGraph() {
+    GraphBuilder builder("Scale");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::INT64);
+    NodeID address = addConst(builder, TypedPayload::createFrom(uint64_t{64}));
+    NodeID three = addConst(builder, TypedPayload::createFrom(int64_t{3}));
+    NodeID load = builder.addNode(BDIOperationType::MEM_LOAD);
+    builder.defineDataOutput(load, 0, BDIType::INT64);
+    builder.connectData(address, 0, load, 0);
+    NodeID mul = builder.addNode(BDIOperationType::ARITH_MUL);
+    builder.defineDataOutput(mul, 0, BDIType::INT64);
+    builder.connectData(start, 0, mul, 0);
+    builder.connectData(three, 0, mul, 1);
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT64);
+    builder.connectData(load, 0, add, 0);
+    builder.connectData(mul, 0, add, 1);
+    NodeID store = builder.addNode(BDIOperationType::MEM_STORE);
+    builder.connectData(address, 0, store, 0);
+    builder.connectData(add, 0, store, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, ret, 0);
+    builder.connectControl(start, load);
+    builder.connectControl(load, mul);
+    builder.connectControl(mul, add);
+    builder.connectControl(add, store);
+    builder.connectControl(store, ret);
+    return {std::shared_ptr<const BDIGraph>(builder.finalizeGraph()), start};
+}
+// --- Latency Histogram ---
+TEST(LatencyHistogramTest, PercentilesStayWithinOneSubBucket) {
+    EXPECT_EQ(LatencyHistogram::bucketFor(15), 15u);
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketFor(16)), 16u);
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketFor(1000)), 1023u); // [960, 1023]
+    EXPECT_EQ(LatencyHistogram::bucketFor(~uint64_t{0}), LatencyHistogram::BUCKET_COUNT - 1);
+    EXPECT_EQ(LatencyHistogram::bucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1), ~uint64_t{0});
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    for (uint64_t ns = 1; ns <= 10000; ++ns) histogram.record(ns);
+    EXPECT_EQ(histogram.getCount(), 10000u);
+    EXPECT_EQ(histogram.getMax(), 10000u);
+    EXPECT_DOUBLE_EQ(histogram.getMean(), 5000.5);
+    for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const double exact = p * 100;
+        EXPECT_GE(static_cast<double>(histogram.percentile(p)), exact) << p;
+        EXPECT_LE(static_cast<double>(histogram.percentile(p)), exact * (1 + 1.0 / 16)) << p;
+    }
+    EXPECT_EQ(histogram.percentile(100), 10000u);
+    histogram.reset();
+    EXPECT_EQ(histogram.getCount(), 0u);
+}
+// --- Request Pool ---
+TEST(RequestPoolTest, ConcurrentRequestsShareTheGraphAndGetCleanInstances) {
+    ScaleGraph scale = buildScaleGraph();
+    ASSERT_NE(scale.graph, nullptr);
+    RequestPool pool(scale.graph, scale.start, 2, 4 * MemoryManager::PAGE_SIZE);
+    constexpr int kThreads = 6, kRequests = 300;
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> clients;
+    for (int t = 0; t < kThreads; ++t) {
+        clients.emplace_back([&, t] {
+            for (int i = 0; i < kRequests; ++i) {
+                const int64_t x = t * 1000 + i;
+                auto result = pool.serve([&](ExecutionContext& ctx, MemoryManager&) { ctx.setPortValue(scale.start, 0, BDIValueVariant(x)); });
+                if (result.status != TaskSliceResult::COMPLETED || std::get<int64_t>(*result.value) != 3 * x) ++wrong;
+            }
+        });
+    }
+    for (auto& client : clients) client.join();
+    EXPECT_EQ(wrong.load(), 0);
+    EXPECT_EQ(pool.getRunLatency().getCount(), static_cast<uint64_t>(kThreads * kRequests));
+    EXPECT_EQ(pool.getWaitLatency().getCount(), static_cast<uint64_t>(kThreads * kRequests));
+    EXPECT_EQ(pool.getScrubbedPages(), static_cast<uint64_t>(kThreads * kRequests)); // Only the page at 64
+    // Leases: allocations and memory are undone, the pool runs dry, a lease runs once
+    auto first = pool.acquire();
+    auto second = pool.tryAcquire();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_FALSE(pool.tryAcquire().has_value());
+    auto region = first.getMemory().allocateRegion(128);
+    ASSERT_TRUE(region.has_value());
+    const uintptr_t seeded = first.getMemory().getRegionInfo(*region)->base_address;
+    std::memset(first.getMemory().getRawPointer(seeded), 0xAB, 128); // Not marked dirty by the writer
+    first.getContext().setPortValue(scale.start, 0, BDIValueVariant(int64_t{5}));
+    EXPECT_EQ(std::get<int64_t>(*first.run().value), 15);
+    EXPECT_EQ(first.run().status, TaskSliceResult::ERROR);
+    second->release();
+    first.release();
+    for (int i = 0; i < 2; ++i) {
+        auto lease = pool.acquire();
+        EXPECT_FALSE(lease.getMemory().getRegionInfo(*region));
+        EXPECT_FALSE(lease.getContext().getPortValue(scale.start, 0));
+        int64_t stored = -1;
+        lease.getMemory().readMemory(64, reinterpret_cast<std::byte*>(&stored), sizeof(stored));
+        EXPECT_EQ(stored, 0);
+        lease.getMemory().readMemory(seeded, reinterpret_cast<std::byte*>(&stored), sizeof(stored));
+        EXPECT_EQ(stored, 0);
+    }
+}
+TEST(RequestPoolTest, RunawayAndWaitingRequestsFaultAndFreeTheirInstance) {
+    GraphBuilder builder("Bad");
+    NodeID spin_start = builder.addNode(BDIOperationType::META_START);
+    NodeID spin = builder.addNode(BDIOperationType::META_NOP);
+    builder.connectControl(spin_start, spin);
+    builder.connectControl(spin, spin);
+    NodeID wait_start = builder.addNode(BDIOperationType::META_START);
+    NodeID wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(wait, TypedPayload::createFrom(uint64_t{5}));
+    builder.connectControl(wait_start, wait);
+    std::shared_ptr<const BDIGraph> graph(builder.finalizeGraph());
+    ASSERT_NE(graph, nullptr);
+    RequestPool spinning(graph, spin_start, 1, MemoryManager::PAGE_SIZE);
+    spinning.setNodeLimit(1000);
+    auto result = spinning.serve();
+    EXPECT_EQ(result.status, TaskSliceResult::ERROR);
+    EXPECT_NE(result.error.find("node limit"), std::string::npos);
+    EXPECT_GE(result.nodes, 1000u);
+    EXPECT_TRUE(spinning.tryAcquire().has_value()); // Returned despite the fault
+    RequestPool waiting(graph, wait_start, 1, MemoryManager::PAGE_SIZE);
+    result = waiting.serve();
+    EXPECT_EQ(result.status, TaskSliceResult::ERROR);
+    EXPECT_NE(result.error.find("event 5"), std::string::npos);
+}
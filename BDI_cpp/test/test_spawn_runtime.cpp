@@ -0,0 +1,220 @@
+#include "gtest.h"
+#include "SpawnRuntime.hpp"
+#include "TaskScheduler.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static NodeID addBinary(GraphBuilder& builder, BDIOperationType op, NodeID lhs, NodeID rhs, BDIType type) {
+    NodeID id = builder.addNode(op);
+    builder.defineDataOutput(id, 0, type);
+    builder.connectData(lhs, 0, id, 0);
+    builder.connectData(rhs, 0, id, 1);
+    return id;
+}
+// Spawn node: control_outputs[0] = continuation, [1] = subgraph entry
+static NodeID addSpawn(GraphBuilder& builder, NodeID argument) {
+    NodeID id = builder.addNode(BDIOperationType::CONCURRENCY_SPAWN);
+    builder.defineDataOutput(id, 0, BDIType::UINT64);
+    builder.connectData(argument, 0, id, 0);
+    return id;
+}
+static void connectSpawn(GraphBuilder& builder, NodeID spawn, NodeID continuation, NodeID entry) {
+    builder.connectControl(spawn, continuation);
+    builder.connectControl(spawn, entry);
+}
+static NodeID addJoin(GraphBuilder& builder, NodeID spawn) {
+    NodeID id = builder.addNode(BDIOperationType::CONCURRENCY_JOIN);
+    builder.defineDataOutput(id, 0, BDIType::INT64);
+    builder.connectData(spawn, 0, id, 0);
+    return id;
+}
+// fib(n): if (n < 2) return n; a = spawn fib(n - 1); b = spawn fib(n - 2); return join(a) + join(b)
+// main: return join(spawn fib(N))
+struct FibGraph {
+    std::unique_ptr<BDIGraph> graph;
+    NodeID main = 0;
+    NodeID fib = 0;
+};
+static FibGraph buildFibGraph(int64_t n) {
+    GraphBuilder builder("SpawnFib");
+    NodeID fib = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(fib, 0, BDIType::INT64);
+    NodeID one = addConst(builder, TypedPayload::createFrom(int64_t{1}));
+    NodeID two = addConst(builder, TypedPayload::createFrom(int64_t{2}));
+    NodeID small = addBinary(builder, BDIOperationType::CMP_LT, fib, two, BDIType::BOOL);
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(small, 0, branch, 0);
+    NodeID base_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(fib, 0, base_ret, 0);
+    NodeID n1 = addBinary(builder, BDIOperationType::ARITH_SUB, fib, one, BDIType::INT64);
+    NodeID n2 = addBinary(builder, BDIOperationType::ARITH_SUB, fib, two, BDIType::INT64);
+    NodeID spawn_a = addSpawn(builder, n1);
+    NodeID spawn_b = addSpawn(builder, n2);
+    NodeID join_a = addJoin(builder, spawn_a);
+    NodeID join_b = addJoin(builder, spawn_b);
+    NodeID sum = addBinary(builder, BDIOperationType::ARITH_ADD, join_a, join_b, BDIType::INT64);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(sum, 0, ret, 0);
+    builder.connectControl(fib, small);
+    builder.connectControl(small, branch);
+    builder.connectControl(branch, base_ret); // true
+    builder.connectControl(branch, n1);       // false
+    builder.connectControl(n1, spawn_a);
+    connectSpawn(builder, spawn_a, n2, fib);
+    builder.connectControl(n2, spawn_b);
+    connectSpawn(builder, spawn_b, join_a, fib);
+    builder.connectControl(join_a, join_b);
+    builder.connectControl(join_b, sum);
+    builder.connectControl(sum, ret);
+    NodeID main = builder.addNode(BDIOperationType::META_START);
+    NodeID count = addConst(builder, TypedPayload::createFrom(n));
+    NodeID main_spawn = addSpawn(builder, count);
+    NodeID main_join = addJoin(builder, main_spawn);
+    NodeID main_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(main_join, 0, main_ret, 0);
+    builder.connectControl(main, main_spawn);
+    connectSpawn(builder, main_spawn, main_join, fib);
+    builder.connectControl(main_join, main_ret);
+    return {builder.finalizeGraph(), main, fib};
+}
+// --- Tests ---
+TEST(SpawnRuntimeTest, SpawnAndJoinFromOutsideThePool) {
+    FibGraph g = buildFibGraph(0);
+    ASSERT_NE(g.graph, nullptr);
+    WorkStealingPool pool(2);
+    SpawnRuntime runtime(pool);
+    std::vector<uint64_t> handles;
+    for (int64_t n = 0; n < 12; ++n) {
+        BDIValueVariant argument = n;
+        handles.push_back(runtime.spawn(*g.graph, g.fib, {&argument, 1}));
+    }
+    const int64_t expected[] = {0, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89};
+    for (size_t i = 0; i < handles.size(); ++i) {
+        HeldValue result;
+        std::string error;
+        ASSERT_TRUE(runtime.join(handles[i], result, &error)) << error;
+        EXPECT_EQ(std::get<int64_t>(result.get()), expected[i]);
+    }
+    EXPECT_EQ(runtime.getPendingCount(), 0u);
+    HeldValue result;
+    EXPECT_FALSE(runtime.join(handles[0], result)); // Handles are released by join
+}
+TEST(SpawnRuntimeTest, NestedFanOutFromSchedulerTaskHelpsInsteadOfBlocking) {
+    FibGraph g = buildFibGraph(16);
+    ASSERT_NE(g.graph, nullptr);
+    WorkStealingPool pool(2); // Far fewer threads than simultaneously joining tasks
+    SpawnRuntime runtime(pool);
+    TaskScheduler os(nullptr, 2);
+    os.setSpawnRuntime(&runtime);
+    uint64_t id = os.spawnTask(*g.graph, g.main);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    ASSERT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED) << os.getTaskError(id);
+    EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(id)), 987);
+    EXPECT_EQ(runtime.getPendingCount(), 0u);
+}
+TEST(SpawnRuntimeTest, FaultsPropagateToTheJoiningTask) {
+    GraphBuilder builder("SpawnFaults");
+    NodeID child = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(child, 0, BDIType::INT64);
+    NodeID zero = addConst(builder, TypedPayload::createFrom(int64_t{0}));
+    NodeID div = addBinary(builder, BDIOperationType::ARITH_DIV, child, zero, BDIType::INT64);
+    builder.connectControl(child, div);
+    NodeID waiter = builder.addNode(BDIOperationType::META_START);
+    NodeID wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(wait, TypedPayload::createFrom(uint64_t{3}));
+    builder.connectControl(waiter, wait);
+    NodeID main = builder.addNode(BDIOperationType::META_START);
+    NodeID value = addConst(builder, TypedPayload::createFrom(int64_t{5}));
+    NodeID spawn = addSpawn(builder, value);
+    NodeID join = addJoin(builder, spawn);
+    builder.connectControl(main, spawn);
+    connectSpawn(builder, spawn, join, child);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(2);
+    SpawnRuntime runtime(pool);
+    TaskScheduler os(nullptr, 1);
+    os.setSpawnRuntime(&runtime);
+    uint64_t faulted = os.spawnTask(*graph, main);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    EXPECT_EQ(os.getTaskStatus(faulted), TaskStatus::FAULTED);
+    EXPECT_NE(os.getTaskError(faulted).find("CONCURRENCY_JOIN"), std::string::npos);
+    EXPECT_NE(os.getTaskError(faulted).find(std::to_string(div)), std::string::npos); // The child's fault
+    HeldValue result;
+    std::string error;
+    EXPECT_FALSE(runtime.join(runtime.spawn(*graph, waiter, {}), result, &error));
+    EXPECT_NE(error.find("cannot wait on event 3"), std::string::npos);
+    TaskScheduler bare(nullptr, 1); // No SpawnRuntime: spawning faults instead of running inline
+    uint64_t unsupported = bare.spawnTask(*graph, main);
+    bare.start();
+    EXPECT_TRUE(bare.waitForIdle());
+    bare.stop();
+    EXPECT_EQ(bare.getTaskStatus(unsupported), TaskStatus::FAULTED);
+}
+TEST(SpawnRuntimeTest, UnjoinedChildrenOutliveTheirSpawnerAndAreReleased) {
+    // main: spawn outer(7), return without joining; outer(x): spawn inner(x), return x without joining
+    GraphBuilder builder("SpawnDetached");
+    NodeID inner = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(inner, 0, BDIType::INT64);
+    NodeID inner_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(inner, 0, inner_ret, 0);
+    builder.connectControl(inner, inner_ret);
+    NodeID outer = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(outer, 0, BDIType::INT64);
+    NodeID outer_spawn = addSpawn(builder, outer);
+    NodeID outer_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(outer, 0, outer_ret, 0);
+    builder.connectControl(outer, outer_spawn);
+    connectSpawn(builder, outer_spawn, outer_ret, inner);
+    NodeID main = builder.addNode(BDIOperationType::META_START);
+    NodeID seven = addConst(builder, TypedPayload::createFrom(int64_t{7}));
+    NodeID main_spawn = addSpawn(builder, seven);
+    NodeID main_ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectControl(main, main_spawn);
+    connectSpawn(builder, main_spawn, main_ret, outer);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(2);
+    SpawnRuntime runtime(pool);
+    TaskScheduler os(nullptr, 2);
+    os.setSpawnRuntime(&runtime);
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 20; ++i) ids.push_back(os.spawnTask(*graph, main));
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    pool.helpWhile([&runtime] { return runtime.getPendingCount() > 0; });
+    os.stop();
+    for (uint64_t id : ids) EXPECT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED) << os.getTaskError(id);
+    EXPECT_EQ(runtime.getHandleCount(), 0u); // Every handle was released with its spawner
+}
+TEST(SpawnRuntimeTest, ParkingFaultGivesUpTheChannelRegistration) {
+    TaskScheduler os(nullptr, 1); // Only lends its channels; never started
+    const uint32_t channel_id = os.getChannels()->create(BDIType::INT64, 4);
+    GraphBuilder builder("SpawnParks");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID recv = builder.addNode(BDIOperationType::COMM_CHANNEL_RECV);
+    builder.setNodePayload(recv, TypedPayload::createFrom(uint64_t{channel_id}));
+    builder.defineDataOutput(recv, 0, BDIType::INT64);
+    builder.connectControl(start, recv);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    WorkStealingPool pool(1);
+    SpawnRuntime runtime(pool);
+    HeldValue result;
+    std::string error;
+    EXPECT_FALSE(runtime.join(runtime.spawn(*graph, start, {}, &os), result, &error));
+    EXPECT_NE(error.find("cannot wait"), std::string::npos);
+    EXPECT_EQ(os.getChannels()->find(channel_id)->takeWaiters(Channel::Direction::RECV, 8), 0u);
+}
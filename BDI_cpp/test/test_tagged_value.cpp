@@ -0,0 +1,98 @@
+#include "gtest.h"
+#include "TaggedValue.hpp"
+#include "ExecutionContext.hpp"
+#include "NodeEvaluator.hpp"
+#include "BDITypes.hpp"
+#include <cstring>
+#include <limits>
+using namespace bdi::runtime;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+// --- Helpers --
+template <typename T>
+static void expectRoundTrip(T value, BDIType type) {
+    TaggedValue tagged = TaggedValue::of(value);
+    EXPECT_EQ(tagged.type, type);
+    EXPECT_EQ(tagged.as<T>(), value);
+    BDIValueVariant variant = value;
+    auto converted = TaggedValue::fromVariant(variant);
+    ASSERT_TRUE(converted.has_value());
+    EXPECT_EQ(*converted, tagged);
+    EXPECT_TRUE(tagged.toVariant() == variant);
+}
+// The tagged fast path must give what tryEvaluate gives for the same operands
+template <typename T>
+static void expectFastPathMatches(BDIOperationType op, T a, T b) {
+    TaggedValue tagged;
+    ASSERT_TRUE(NodeEvaluator::tryEvaluateTagged(op, {TaggedValue::of(a), TaggedValue::of(b)}, tagged));
+    HeldValue result;
+    ASSERT_EQ(NodeEvaluator::tryEvaluate(BDINode(1, op), {a, b}, nullptr, result), VMStatus::OK);
+    EXPECT_TRUE(tagged.toVariant() == result.get());
+}
+// --- Tests ---
+TEST(TaggedValueTest, IsTwoWordsAndTriviallyCopyable) {
+    EXPECT_EQ(sizeof(TaggedValue), 16u);
+    EXPECT_TRUE(std::is_trivially_copyable_v<TaggedValue>);
+    EXPECT_TRUE(TaggedValue{}.isVoid());
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(TaggedValue{}.toVariant()));
+}
+TEST(TaggedValueTest, ScalarsRoundTripThroughTheVariant) {
+    expectRoundTrip(true, BDIType::BOOL);
+    expectRoundTrip(int8_t{-7}, BDIType::INT8);
+    expectRoundTrip(uint8_t{250}, BDIType::UINT8);
+    expectRoundTrip(int16_t{-30000}, BDIType::INT16);
+    expectRoundTrip(uint16_t{65000}, BDIType::UINT16);
+    expectRoundTrip(std::numeric_limits<int32_t>::min(), BDIType::INT32);
+    expectRoundTrip(uint32_t{0xDEADBEEF}, BDIType::UINT32);
+    expectRoundTrip(std::numeric_limits<int64_t>::min(), BDIType::INT64);
+    expectRoundTrip(std::numeric_limits<uint64_t>::max(), BDIType::UINT64);
+    expectRoundTrip(-1.5f, BDIType::FLOAT32);
+    expectRoundTrip(6.02214076e23, BDIType::FLOAT64);
+    // Signed values are sign-extended, so a wider read keeps the value
+    EXPECT_EQ(TaggedValue::of(int8_t{-1}).as<int64_t>(), -1);
+    // Vectors do not fit in the payload
+    EXPECT_FALSE(TaggedValue::fromVariant(PackedVector::allocate(BDIType::FLOAT32, 4).ref()).has_value());
+}
+TEST(TaggedValueTest, ContextSlotsKeepVectorsOnTheSide) {
+    ExecutionContext ctx;
+    PortRef scalar{1, 0}, vector{2, 0};
+    ctx.setPortSlot(scalar, TaggedValue::of(int32_t{-42}));
+    ASSERT_NE(ctx.findPortSlot(scalar), nullptr);
+    EXPECT_EQ(ctx.findPortSlot(scalar)->as<int32_t>(), -42);
+    EXPECT_TRUE(ctx.getPortValue(scalar) == BDIValueVariant{int32_t{-42}});
+    PackedVector lanes = PackedVector::allocate(BDIType::FLOAT32, 4);
+    float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    std::memcpy(lanes.mutableData(), data, sizeof(data));
+    ctx.setPortValue(vector, lanes.ref());
+    lanes = PackedVector{}; // The context keeps its own reference
+    ASSERT_NE(ctx.findPortSlot(vector), nullptr);
+    EXPECT_EQ(ctx.findPortSlot(vector)->type, BDIType::ARRAY);
+    auto value = ctx.getPortValue(vector);
+    ASSERT_TRUE(value.has_value());
+    ASSERT_TRUE(std::holds_alternative<VectorRef>(*value));
+    EXPECT_EQ(std::memcmp(std::get<VectorRef>(*value).data(), data, sizeof(data)), 0);
+    // Overwriting an ARRAY slot with a scalar releases the vector
+    ctx.setPortSlot(vector, TaggedValue::of(2.5));
+    EXPECT_TRUE(ctx.getPortValue(vector) == BDIValueVariant{2.5});
+    ASSERT_TRUE(ctx.remapNodes({}, {{1, 11}}));
+    EXPECT_EQ(ctx.findPortSlot(vector), nullptr);
+    EXPECT_TRUE(ctx.getPortValue(PortRef{11, 0}) == BDIValueVariant{int32_t{-42}});
+}
+TEST(TaggedValueTest, FastPathMatchesTheVariantOps) {
+    using Op = BDIOperationType;
+    for (Op op : {Op::ARITH_ADD, Op::ARITH_SUB, Op::ARITH_MUL, Op::CMP_EQ, Op::CMP_NE, Op::CMP_LT, Op::CMP_LE, Op::CMP_GT, Op::CMP_GE}) {
+        expectFastPathMatches(op, int8_t{120}, int8_t{-100}); // Wraps in 8 bits
+        expectFastPathMatches(op, uint16_t{3}, uint16_t{65535});
+        expectFastPathMatches(op, int32_t{-7}, int32_t{7});
+        expectFastPathMatches(op, 1.5f, -0.25f);
+        expectFastPathMatches(op, 2.0, 2.0);
+    }
+    TaggedValue result;
+    EXPECT_TRUE(NodeEvaluator::tryEvaluateTagged(Op::CMP_EQ, {TaggedValue::of(true), TaggedValue::of(true)}, result));
+    EXPECT_EQ(result, TaggedValue::of(true));
+    // Everything else is left to tryEvaluate: BOOL arithmetic faults there, mixed types promote
+    EXPECT_FALSE(NodeEvaluator::tryEvaluateTagged(Op::ARITH_ADD, {TaggedValue::of(true), TaggedValue::of(false)}, result));
+    EXPECT_FALSE(NodeEvaluator::tryEvaluateTagged(Op::ARITH_ADD, {TaggedValue::of(int32_t{1}), TaggedValue::of(int64_t{1})}, result));
+    EXPECT_FALSE(NodeEvaluator::tryEvaluateTagged(Op::ARITH_DIV, {TaggedValue::of(int32_t{6}), TaggedValue::of(int32_t{3})}, result));
+    EXPECT_FALSE(NodeEvaluator::tryEvaluateTagged(Op::ARITH_ADD, {TaggedValue{}, TaggedValue{}}, result));
+}
@@ -0,0 +1,528 @@
+#include "gtest.h"
+#include "TaskScheduler.hpp"
+#include "ConstantPool.hpp"
+#include "MemoryManager.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include "TestGraphHelpers.hpp"
+#include <chrono>
+#include <mutex>
+#include <thread>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+// counter = *addr; counter += 1; *addr = counter; yield; if (counter < limit) repeat; return counter
+struct CounterGraph {
+    std::unique_ptr<BDIGraph> graph;
+    NodeID start = 0;
+    NodeID add = 0;
+    NodeID store = 0;
+};
+// 'padding' unconnected nodes come first and shift every node id
+static CounterGraph buildCounterGraph(int64_t limit, int padding = 0) {
+    GraphBuilder builder("CounterTask");
+    for (int i = 0; i < padding; ++i) builder.addNode(BDIOperationType::META_NOP);
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    builder.defineDataOutput(start, 0, BDIType::UINT64); // Address of this task's counter
+    NodeID one = addConst(builder, TypedPayload::createFrom(int64_t{1}));
+    NodeID max = addConst(builder, TypedPayload::createFrom(limit));
+    NodeID load = builder.addNode(BDIOperationType::MEM_LOAD);
+    builder.defineDataOutput(load, 0, BDIType::INT64);
+    builder.connectData(start, 0, load, 0);
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT64);
+    builder.connectData(load, 0, add, 0);
+    builder.connectData(one, 0, add, 1);
+    NodeID store = builder.addNode(BDIOperationType::MEM_STORE);
+    builder.connectData(start, 0, store, 0);
+    builder.connectData(add, 0, store, 1);
+    NodeID yield = builder.addNode(BDIOperationType::SYS_YIELD);
+    NodeID cmp = builder.addNode(BDIOperationType::CMP_LT);
+    builder.defineDataOutput(cmp, 0, BDIType::BOOL);
+    builder.connectData(add, 0, cmp, 0);
+    builder.connectData(max, 0, cmp, 1);
+    NodeID branch = builder.addNode(BDIOperationType::CTRL_BRANCH_COND);
+    builder.connectData(cmp, 0, branch, 0);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, ret, 0);
+    builder.connectControl(start, load);
+    builder.connectControl(load, add);
+    builder.connectControl(add, store);
+    builder.connectControl(store, yield);
+    builder.connectControl(yield, cmp);
+    builder.connectControl(cmp, branch);
+    builder.connectControl(branch, load); // true: loop
+    builder.connectControl(branch, ret);  // false: done
+    return {builder.finalizeGraph(), start, add, store};
+}
+static uint64_t spawnCounter(TaskScheduler& os, MemoryManager& memory, const CounterGraph& counter) {
+    auto region = memory.allocateRegion(sizeof(int64_t));
+    const uint64_t address = memory.getRegionInfo(*region)->base_address;
+    const int64_t zero = 0;
+    memory.writeMemory(address, reinterpret_cast<const std::byte*>(&zero), sizeof(zero));
+    auto ctx = std::make_unique<ExecutionContext>();
+    ctx->setPortValue(counter.start, 0, BDIValueVariant(address));
+    return os.spawnTask(*counter.graph, counter.start, std::move(ctx));
+}
+// --- Tests ---
+TEST(TaskSchedulerTest, ManyTasksRunToCompletionAcrossWorkers) {
+    constexpr int kTasks = 32;
+    constexpr int64_t kLimit = 200;
+    MemoryManager memory(4096);
+    auto region = memory.allocateRegion(kTasks * sizeof(int64_t));
+    ASSERT_TRUE(region.has_value());
+    uint64_t base = memory.getRegionInfo(*region)->base_address;
+    std::vector<std::byte> zeros(kTasks * sizeof(int64_t));
+    ASSERT_TRUE(memory.writeMemory(base, zeros.data(), zeros.size()));
+    CounterGraph counter = buildCounterGraph(kLimit);
+    ASSERT_NE(counter.graph, nullptr);
+    TaskScheduler os(&memory, 4, /*timeslice=*/3); // Tiny slices force preemption and stealing
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < kTasks; ++i) {
+        auto ctx = std::make_unique<ExecutionContext>();
+        ctx->setPortValue(counter.start, 0, BDIValueVariant(base + i * sizeof(int64_t)));
+        ids.push_back(os.spawnTask(*counter.graph, counter.start, std::move(ctx)));
+    }
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    for (int i = 0; i < kTasks; ++i) {
+        EXPECT_EQ(os.getTaskStatus(ids[i]), TaskStatus::COMPLETED);
+        auto result = os.getTaskResult(ids[i]);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(std::get<int64_t>(*result), kLimit);
+        int64_t stored = 0;
+        ASSERT_TRUE(memory.readMemory(base + i * sizeof(int64_t), reinterpret_cast<std::byte*>(&stored), sizeof(stored)));
+        EXPECT_EQ(stored, kLimit);
+    }
+    EXPECT_GT(os.getSliceCount(), static_cast<uint64_t>(kTasks));
+}
+// waiter: v = wait(7); return v + 1      sender: send(7, 41)
+static void runEventScenario(TaskScheduler::ExecutionMode mode) {
+    GraphBuilder builder("EventTasks");
+    NodeID wait_start = builder.addNode(BDIOperationType::META_START);
+    NodeID wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(wait, TypedPayload::createFrom(uint64_t{7}));
+    builder.defineDataOutput(wait, 0, BDIType::INT32);
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(wait, 0, add, 0);
+    builder.connectData(one, 0, add, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, ret, 0);
+    builder.connectControl(wait_start, wait);
+    builder.connectControl(wait, add);
+    builder.connectControl(add, ret);
+    NodeID send_start = builder.addNode(BDIOperationType::META_START);
+    NodeID event = addConst(builder, TypedPayload::createFrom(uint64_t{7}));
+    NodeID value = addConst(builder, TypedPayload::createFrom(int32_t{41}));
+    NodeID send = builder.addNode(BDIOperationType::SYS_SEND_EVENT);
+    builder.connectData(event, 0, send, 0);
+    builder.connectData(value, 0, send, 1);
+    NodeID send_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(send_start, send);
+    builder.connectControl(send, send_end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    TaskScheduler os(nullptr, 3, TaskScheduler::DEFAULT_TIMESLICE, mode);
+    std::vector<uint64_t> waiters;
+    for (int i = 0; i < 4; ++i) waiters.push_back(os.spawnTask(*graph, wait_start));
+    os.spawnTask(*graph, send_start); // May run before or after the waiters park: events are banked
+    os.spawnTask(*graph, send_start);
+    os.start();
+    EXPECT_FALSE(os.waitForIdle()); // Two waiters have no sender yet
+    os.sendEvent(7, BDIValueVariant(int32_t{41}));
+    os.sendEvent(7, BDIValueVariant(int32_t{41}));
+    EXPECT_TRUE(os.waitForIdle());
+    for (uint64_t id : waiters) {
+        ASSERT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED);
+        EXPECT_EQ(std::get<int32_t>(*os.getTaskResult(id)), 42);
+    }
+}
+TEST(TaskSchedulerTest, WaitEventIsWokenFromOtherTasksAndThreads) {
+    runEventScenario(TaskScheduler::ExecutionMode::SLICED);
+}
+TEST(TaskSchedulerTest, CoroutineTasksSuspendOnWaitEvent) {
+    runEventScenario(TaskScheduler::ExecutionMode::COROUTINE);
+}
+TEST(TaskSchedulerTest, CoroutineModeRunsManyLightweightTasks) {
+    // start -> yield -> yield -> return 5, as coroutines with pooled frames
+    GraphBuilder builder("LightTasks");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID y1 = builder.addNode(BDIOperationType::SYS_YIELD);
+    NodeID y2 = builder.addNode(BDIOperationType::SYS_YIELD);
+    NodeID five = addConst(builder, TypedPayload::createFrom(int32_t{5}));
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(five, 0, ret, 0);
+    builder.connectControl(start, y1);
+    builder.connectControl(y1, y2);
+    builder.connectControl(y2, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    constexpr int kTasks = 50000;
+    TaskScheduler os(nullptr, 4, TaskScheduler::DEFAULT_TIMESLICE, TaskScheduler::ExecutionMode::COROUTINE);
+    os.start();
+    for (int batch = 0; batch < 2; ++batch) {
+        uint64_t reused_before = CoroutineFramePool::getReusedAllocations();
+        std::vector<uint64_t> ids;
+        ids.reserve(kTasks);
+        for (int i = 0; i < kTasks; ++i) ids.push_back(os.spawnTask(*graph, start));
+        EXPECT_TRUE(os.waitForIdle());
+        for (uint64_t id : ids) {
+            ASSERT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED);
+            ASSERT_EQ(std::get<int32_t>(*os.getTaskResult(id)), 5);
+        }
+        // The second batch runs on frames released by the first
+        if (batch == 1) {
+            EXPECT_GT(CoroutineFramePool::getReusedAllocations(), reused_before);
+        }
+    }
+    EXPECT_GE(os.getSliceCount(), static_cast<uint64_t>(2 * kTasks * 3));
+}
+TEST(TaskSchedulerTest, HaltTaskStopsRunningAndWaitingTasks) {
+    GraphBuilder builder("HaltTasks");
+    // spinner: yield forever
+    NodeID spin_start = builder.addNode(BDIOperationType::META_START);
+    NodeID yield = builder.addNode(BDIOperationType::SYS_YIELD);
+    NodeID nop = builder.addNode(BDIOperationType::META_NOP);
+    builder.connectControl(spin_start, yield);
+    builder.connectControl(yield, nop);
+    builder.connectControl(nop, yield);
+    // sleeper: wait on an event nobody sends
+    NodeID sleep_start = builder.addNode(BDIOperationType::META_START);
+    NodeID wait = builder.addNode(BDIOperationType::SYS_WAIT_EVENT);
+    builder.setNodePayload(wait, TypedPayload::createFrom(uint64_t{99}));
+    builder.connectControl(sleep_start, wait);
+    // killer: halt(task 1) from whichever worker picks it up
+    NodeID kill_start = builder.addNode(BDIOperationType::META_START);
+    NodeID target = addConst(builder, TypedPayload::createFrom(uint64_t{1}));
+    NodeID halt = builder.addNode(BDIOperationType::SYS_HALT_TASK);
+    builder.defineDataOutput(halt, 0, BDIType::BOOL);
+    builder.connectData(target, 0, halt, 0);
+    NodeID kill_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(kill_start, halt);
+    builder.connectControl(halt, kill_end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    TaskScheduler os(nullptr, 2, /*timeslice=*/2);
+    uint64_t spinner = os.spawnTask(*graph, spin_start);
+    ASSERT_EQ(spinner, 1u);
+    uint64_t sleeper = os.spawnTask(*graph, sleep_start);
+    os.start();
+    uint64_t killer = os.spawnTask(*graph, kill_start);
+    EXPECT_FALSE(os.waitForIdle()); // Spinner halted by the killer; sleeper still parked
+    EXPECT_EQ(os.getTaskStatus(spinner), TaskStatus::HALTED);
+    EXPECT_EQ(os.getTaskStatus(killer), TaskStatus::COMPLETED);
+    EXPECT_EQ(os.getTaskStatus(sleeper), TaskStatus::WAITING);
+    EXPECT_TRUE(os.haltTask(sleeper));
+    EXPECT_TRUE(os.waitForIdle());
+    EXPECT_EQ(os.getTaskStatus(sleeper), TaskStatus::HALTED);
+    EXPECT_FALSE(os.haltTask(sleeper));
+}
+TEST(TaskSchedulerTest, FaultedTaskReportsErrorAndOthersContinue) {
+    GraphBuilder builder("FaultTasks");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID zero = addConst(builder, TypedPayload::createFrom(int32_t{0}));
+    NodeID div = builder.addNode(BDIOperationType::ARITH_DIV);
+    builder.defineDataOutput(div, 0, BDIType::INT32);
+    builder.connectData(zero, 0, div, 0);
+    builder.connectData(zero, 0, div, 1);
+    builder.connectControl(start, div);
+    NodeID ok_start = builder.addNode(BDIOperationType::META_START);
+    NodeID ok_end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(ok_start, ok_end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    TaskScheduler os(nullptr, 2);
+    uint64_t bad = os.spawnTask(*graph, start);
+    uint64_t good = os.spawnTask(*graph, ok_start);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    EXPECT_EQ(os.getTaskStatus(bad), TaskStatus::FAULTED);
+    EXPECT_NE(os.getTaskError(bad).find(std::to_string(div)), std::string::npos);
+    EXPECT_EQ(os.getTaskStatus(good), TaskStatus::COMPLETED);
+}
+// --- Preemption ---
+TEST(PreemptionTimerTest, RaisesTheArmedSlotAfterOneQuantum) {
+    using namespace std::chrono;
+    PreemptionTimer timer(2, milliseconds(2));
+    const auto armed = steady_clock::now();
+    timer.arm(0);
+    timer.arm(1);
+    timer.disarm(1);
+    while (!timer.flag(0).load() && steady_clock::now() - armed < seconds(5)) std::this_thread::yield();
+    EXPECT_TRUE(timer.flag(0).load());
+    EXPECT_GE(steady_clock::now() - armed, milliseconds(2));
+    std::this_thread::sleep_for(milliseconds(10));
+    EXPECT_FALSE(timer.flag(1).load());
+    EXPECT_EQ(timer.getFireCount(), 1u);
+    timer.arm(0); // Re-arming lowers the flag
+    EXPECT_FALSE(timer.flag(0).load());
+}
+// The engine checks the budget and the flag only where control goes backward
+TEST(TaskEngineTest, SlicesEndAtBackwardEdges) {
+    struct Services : TaskServices {
+        std::atomic<bool> flag{false};
+        void sendEvent(uint64_t, BDIValueVariant) override {}
+        bool haltTask(uint64_t) override { return false; }
+        const std::atomic<bool>* getPreemptFlag(const TaskControlBlock&) override { return &flag; }
+    };
+    GraphBuilder builder("Spin");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID a = builder.addNode(BDIOperationType::META_NOP);
+    NodeID b = builder.addNode(BDIOperationType::META_NOP);
+    NodeID c = builder.addNode(BDIOperationType::META_NOP);
+    builder.connectControl(start, a);
+    builder.connectControl(a, b);
+    builder.connectControl(b, c);
+    builder.connectControl(c, a); // The only backward edge
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    TaskControlBlock task;
+    task.graph = graph.get();
+    task.context = std::make_unique<ExecutionContext>();
+    task.resume_node_id = start;
+    TaskEngine engine;
+    Services services;
+    auto outcome = engine.runSlice(task, 0, &services);
+    EXPECT_EQ(outcome.instructions, 0u); // The slice start is a preemption point
+    outcome = engine.runSlice(task, 5, &services);
+    EXPECT_EQ(outcome.result, TaskEngine::SliceResult::YIELDED);
+    EXPECT_TRUE(outcome.preempted);
+    EXPECT_EQ(outcome.instructions, 7u); // start a b c | a b c: the budget is checked after each c
+    EXPECT_EQ(task.resume_node_id, a);
+    services.flag = true; // Still up at the next slice start: ignored until a node has run
+    outcome = engine.runSlice(task, ~uint64_t{0}, &services);
+    EXPECT_TRUE(outcome.preempted);
+    EXPECT_EQ(outcome.instructions, 3u);
+    EXPECT_EQ(task.instructions_executed, 10u);
+}
+TEST(TaskEngineTest, ConstantsAreReadFromThePool) {
+    // start -> k1 -> k2 -> k3 -> k1 ...: every node of the loop is a constant on the control path
+    GraphBuilder builder("Constants");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID k1 = addConst(builder, TypedPayload::createFrom(int32_t{-3}));
+    NodeID k2 = addConst(builder, TypedPayload::createFrom(2.5));
+    NodeID k3 = addConst(builder, TypedPayload::createFrom(uint8_t{200}));
+    NodeID nop = builder.addNode(BDIOperationType::META_NOP); // No payload: not a constant
+    builder.connectControl(start, k1);
+    builder.connectControl(k1, k2);
+    builder.connectControl(k2, k3);
+    builder.connectControl(k3, k1);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    ConstantPool pool(*graph);
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.find(nop), nullptr);
+    ASSERT_NE(pool.find(k1), nullptr);
+    EXPECT_EQ(pool.find(k1)->as<int32_t>(), -3);
+    EXPECT_TRUE(pool.getValue(k2) == BDIValueVariant{2.5});
+    constexpr uint64_t kNodes = 300000;
+    auto run = [&](const ConstantPool* constants) {
+        TaskControlBlock task;
+        task.graph = graph.get();
+        task.constants = constants;
+        task.context = std::make_unique<ExecutionContext>();
+        task.resume_node_id = start;
+        TaskEngine engine;
+        engine.runSlice(task, kNodes);
+        for (NodeID k : {k1, k2, k3}) EXPECT_TRUE(task.context->getPortValue(k, 0) == pool.getValue(k));
+    };
+    run(nullptr);
+    run(&pool);
+}
+TEST(TaskSchedulerTest, TimerPreemptsTasksThatNeverYield) {
+    GraphBuilder builder("Spinner");
+    NodeID spin_start = builder.addNode(BDIOperationType::META_START);
+    NodeID nop = builder.addNode(BDIOperationType::META_NOP);
+    builder.connectControl(spin_start, nop);
+    builder.connectControl(nop, nop);
+    auto spin_graph = builder.finalizeGraph();
+    ASSERT_NE(spin_graph, nullptr);
+    CounterGraph counter = buildCounterGraph(20);
+    MemoryManager memory(4096);
+    for (auto mode : {TaskScheduler::ExecutionMode::SLICED, TaskScheduler::ExecutionMode::COROUTINE}) {
+        TaskScheduler os(&memory, 1, /*timeslice=*/~uint64_t{0}, mode); // Only the timer can end a spinner slice
+        os.setTimeQuantum(std::chrono::microseconds(200));
+        const uint64_t spinner = os.spawnTask(*spin_graph, spin_start);
+        const uint64_t id = spawnCounter(os, memory, counter);
+        os.start();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (os.getTaskStatus(id) != TaskStatus::COMPLETED && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED);
+        EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(id)), 20);
+        EXPECT_TRUE(os.haltTask(spinner));
+        EXPECT_TRUE(os.waitForIdle());
+        os.stop();
+        EXPECT_GE(os.getSliceCount(), 40u); // Counter yields 20 times, each followed by a preempted spinner slice
+    }
+}
+// --- Hot Swap ---
+TEST(GraphRegistryTest, UpgradeCarriesResumePointsAndValuesThroughNodeMaps) {
+    GraphRegistry registry;
+    CounterGraph v1 = buildCounterGraph(10);
+    CounterGraph v2 = buildCounterGraph(20, /*padding=*/1);
+    auto first = registry.publish("counter", std::shared_ptr<const BDIGraph>(std::move(v1.graph)));
+    TaskControlBlock task;
+    task.graph = &first->getGraph();
+    task.version = first;
+    task.context = std::make_unique<ExecutionContext>();
+    task.context->setPortValue(v1.start, 0, BDIValueVariant(uint64_t{64}));
+    task.context->setPortValue(v1.add, 0, BDIValueVariant(int64_t{3}));
+    task.context->pushCallFrame(v1.store, v1.add);
+    task.resume_node_id = v1.store;
+    std::weak_ptr<const GraphVersion> old = first;
+    first.reset();
+    // Every id moved by one. Without a map only ids whose operation still matches carry over.
+    NodeMap shifted;
+    for (NodeID id = v1.start; id <= v1.store + 5; ++id) shifted[id] = id + 1;
+    shifted.erase(v1.add); // Resume point and frames are fine, but 'add' has no counterpart
+    auto second = registry.publish("counter", std::shared_ptr<const BDIGraph>(std::move(v2.graph)), shifted);
+    EXPECT_EQ(second->getVersion(), 2u);
+    EXPECT_EQ(GraphRegistry::upgrade(task), 0u); // The call frame returns to 'add'
+    EXPECT_FALSE(old.expired());
+    EXPECT_EQ(task.resume_node_id, v1.store);
+    EXPECT_EQ(task.failed_hop, 2u); // Call boundaries stop yielding for it
+    task.context->popCallFrame();
+    EXPECT_EQ(GraphRegistry::upgrade(task), 1u);
+    EXPECT_EQ(task.failed_hop, 0u);
+    EXPECT_TRUE(old.expired()); // Reclaimed with its last task
+    EXPECT_EQ(task.version, second);
+    EXPECT_EQ(task.graph, &second->getGraph());
+    EXPECT_EQ(task.resume_node_id, v2.store);
+    EXPECT_EQ(std::get<uint64_t>(*task.context->getPortValue(v2.start, 0)), 64u);
+    EXPECT_FALSE(task.context->getPortValue(v1.add, 0)); // Dropped, not left under a stale id
+    EXPECT_FALSE(task.context->getPortValue(v2.add, 0));
+}
+TEST(TaskSchedulerTest, RunningTasksMoveToNewlyPublishedGraphs) {
+    for (auto mode : {TaskScheduler::ExecutionMode::SLICED, TaskScheduler::ExecutionMode::COROUTINE}) {
+        MemoryManager memory(4096);
+        TaskScheduler os(&memory, 2, TaskScheduler::DEFAULT_TIMESLICE, mode);
+        GraphRegistry& graphs = os.getGraphRegistry();
+        CounterGraph endless = buildCounterGraph(int64_t{1} << 40);
+        CounterGraph stopping = buildCounterGraph(0); // Same ids and operations; only the limit changes
+        graphs.publish("counter", std::shared_ptr<const BDIGraph>(std::move(endless.graph)));
+        EXPECT_EQ(os.spawnTask("missing", endless.start), 0u);
+        std::vector<uint64_t> ids, addresses;
+        for (int i = 0; i < 4; ++i) {
+            auto region = memory.allocateRegion(sizeof(int64_t));
+            addresses.push_back(memory.getRegionInfo(*region)->base_address);
+            const int64_t zero = 0;
+            memory.writeMemory(addresses.back(), reinterpret_cast<const std::byte*>(&zero), sizeof(zero));
+            auto ctx = std::make_unique<ExecutionContext>();
+            ctx->setPortValue(endless.start, 0, BDIValueVariant(addresses.back()));
+            ids.push_back(os.spawnTask("counter", endless.start, std::move(ctx)));
+        }
+        std::weak_ptr<const GraphVersion> old = graphs.getCurrent("counter");
+        os.start();
+        auto counted = [&](size_t i) {
+            int64_t value = 0;
+            memory.readMemory(addresses[i], reinterpret_cast<std::byte*>(&value), sizeof(value));
+            return value;
+        };
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (os.getSliceCount() < 400 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield(); // Well under way
+        graphs.publish("counter", std::shared_ptr<const BDIGraph>(std::move(stopping.graph)));
+        EXPECT_TRUE(os.waitForIdle()); // Would spin for 2^40 iterations on the old version
+        os.stop();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ASSERT_EQ(os.getTaskStatus(ids[i]), TaskStatus::COMPLETED) << os.getTaskError(ids[i]);
+            EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(ids[i])), counted(i)); // Stopped right after the swap
+        }
+        EXPECT_EQ(os.getUpgradeCount(), ids.size());
+        EXPECT_TRUE(old.expired());
+    }
+}
+// --- Debugging ---
+// Records every stop and single-steps once past the first breakpoint
+class RecordingSession : public DebugSession {
+public:
+    struct Stop {
+        uint64_t task_id;
+        NodeID node_id;
+        BreakReason reason;
+        bool operator==(const Stop&) const = default;
+    };
+    std::mutex mutex;
+    std::vector<Stop> stops;
+    bool step_once = true;
+protected:
+    void onBreak(TaskControlBlock& task, NodeID node_id, BreakReason reason) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        stops.push_back({task.task_id, node_id, reason});
+        if (reason == BreakReason::BREAKPOINT && step_once) {
+            step_once = false;
+            requestStep(task.task_id);
+        }
+    }
+};
+TEST(TaskSchedulerTest, DebugSessionStopsAtBreakpointsAndSingleSteps) {
+    CounterGraph counter = buildCounterGraph(3);
+    ASSERT_NE(counter.graph, nullptr);
+    using Reason = DebugSession::BreakReason;
+    for (auto mode : {TaskScheduler::ExecutionMode::SLICED, TaskScheduler::ExecutionMode::COROUTINE}) {
+        MemoryManager memory(4096);
+        RecordingSession session;
+        CounterGraph other = buildCounterGraph(3);
+        ASSERT_TRUE(session.setBreakpoint(counter.graph.get(), counter.add));
+        ASSERT_TRUE(session.setBreakpoint(other.graph.get(), counter.start)); // Same id, another graph: never hit
+        EXPECT_FALSE(session.setBreakpoint(nullptr, DebugSession::DEFAULT_MAX_NODE_ID + 1));
+        TaskScheduler os(&memory, 1, /*timeslice=*/2, mode); // Stops carry across slice boundaries
+        os.attachDebugger(&session);
+        const uint64_t id = spawnCounter(os, memory, counter);
+        os.start();
+        EXPECT_TRUE(os.waitForIdle());
+        os.stop();
+        ASSERT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED) << os.getTaskError(id);
+        EXPECT_EQ(std::get<int64_t>(*os.getTaskResult(id)), 3);
+        const std::vector<RecordingSession::Stop> expected = {
+            {id, counter.add, Reason::BREAKPOINT}, {id, counter.store, Reason::STEP},
+            {id, counter.add, Reason::BREAKPOINT}, {id, counter.add, Reason::BREAKPOINT}};
+        EXPECT_EQ(session.stops, expected);
+        EXPECT_EQ(session.getBreakCount(), 4u);
+    }
+    MemoryManager memory(4096);
+    RecordingSession session;
+    session.requestPause();
+    TaskScheduler os(&memory, 1);
+    os.attachDebugger(&session);
+    const uint64_t paused = spawnCounter(os, memory, counter);
+    os.detachDebugger(); // Later slices run the plain loop
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    EXPECT_TRUE(session.stops.empty());
+    TaskScheduler attached(&memory, 1);
+    attached.attachDebugger(&session);
+    const uint64_t first = spawnCounter(attached, memory, counter);
+    attached.start();
+    EXPECT_TRUE(attached.waitForIdle());
+    attached.stop();
+    ASSERT_EQ(session.stops.size(), 1u);
+    EXPECT_EQ(session.stops[0], (RecordingSession::Stop{first, counter.start, Reason::PAUSE}));
+    EXPECT_EQ(os.getTaskStatus(paused), TaskStatus::COMPLETED);
+    // A pause and a step pending at once both stop their task; breakpoints match the graph
+    RecordingSession direct;
+    DebugSession::BreakReason reason;
+    direct.requestStep(7);
+    direct.requestPause();
+    EXPECT_TRUE(direct.shouldBreak(3, counter.graph.get(), counter.add, reason));
+    EXPECT_EQ(reason, Reason::PAUSE);
+    EXPECT_FALSE(direct.shouldBreak(3, counter.graph.get(), counter.add, reason));
+    EXPECT_TRUE(direct.shouldBreak(7, counter.graph.get(), counter.add, reason));
+    EXPECT_EQ(reason, Reason::STEP);
+    ASSERT_TRUE(direct.setBreakpoint(nullptr, counter.add));
+    ASSERT_TRUE(direct.setBreakpoint(counter.graph.get(), counter.add));
+    direct.removeBreakpoint(nullptr, counter.add);
+    EXPECT_TRUE(direct.shouldBreak(7, counter.graph.get(), counter.add, reason));
+    EXPECT_FALSE(direct.shouldBreak(7, nullptr, counter.add, reason));
+    direct.removeBreakpoint(counter.graph.get(), counter.add);
+    EXPECT_FALSE(direct.hasBreakpoint(counter.graph.get(), counter.add));
+}
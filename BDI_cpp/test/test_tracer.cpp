@@ -0,0 +1,108 @@
+#include "gtest.h"
+#include "Tracer.hpp"
+#include "TraceExport.hpp"
+#include "TaskScheduler.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()))).string();
+}
+// --- Tests ---
+TEST(TracerTest, RecordsFromManyThreadsAreDrainedInOrder) {
+    Tracer tracer;
+    tracer.setEnabled(true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tracer, t] {
+            for (uint64_t i = 0; i < 1000; ++i) tracer.record(i, static_cast<uint16_t>(t), 7, i * 10, i * 10 + 5);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::vector<TraceRecord> records;
+    EXPECT_EQ(tracer.drain(records), 4000u);
+    EXPECT_EQ(tracer.getDroppedCount(), 0u);
+    std::set<uint16_t> thread_indices;
+    std::vector<int64_t> last_node(4, -1);
+    for (const auto& r : records) {
+        thread_indices.insert(r.thread_index);
+        EXPECT_EQ(r.duration_ns, 5u);
+        EXPECT_EQ(r.task_id, 7u);
+        EXPECT_GT(static_cast<int64_t>(r.node_id), last_node[r.opcode]); // Per-thread order survives
+        last_node[r.opcode] = static_cast<int64_t>(r.node_id);
+    }
+    EXPECT_EQ(thread_indices.size(), 4u);
+    records.clear();
+    EXPECT_EQ(tracer.drain(records), 0u);
+}
+TEST(TracerTest, FullRingDropsInsteadOfBlocking) {
+    Tracer tracer(16);
+    for (uint64_t i = 0; i < 100; ++i) tracer.record(i, 0, 0, i, i + 1);
+    std::vector<TraceRecord> records;
+    EXPECT_EQ(tracer.drain(records), 16u);
+    EXPECT_EQ(tracer.getDroppedCount(), 84u);
+    EXPECT_EQ(records.front().node_id, 0u); // Oldest records are kept
+    tracer.record(500, 0, 0, 0, 1);          // Space again after the drain
+    records.clear();
+    EXPECT_EQ(tracer.drain(records), 1u);
+}
+TEST(TracerTest, DrainerWritesTaskTraceConvertibleToChromeJson) {
+    GraphBuilder builder("TracedTask");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID k = builder.addNode(BDIOperationType::META_CONST);
+    builder.setNodePayload(k, TypedPayload::createFrom(int32_t{3}));
+    builder.defineDataOutput(k, 0, BDIType::INT32);
+    NodeID add = builder.addNode(BDIOperationType::ARITH_ADD);
+    builder.defineDataOutput(add, 0, BDIType::INT32);
+    builder.connectData(k, 0, add, 0);
+    builder.connectData(k, 0, add, 1);
+    NodeID ret = builder.addNode(BDIOperationType::CTRL_RETURN);
+    builder.connectData(add, 0, ret, 0);
+    builder.connectControl(start, add);
+    builder.connectControl(add, ret);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    std::string trace_path = tempPath("bdi_trace.bin");
+    Tracer& tracer = Tracer::global();
+    ASSERT_TRUE(tracer.startDrainer(trace_path, std::chrono::milliseconds(1)));
+    tracer.setEnabled(true);
+    uint64_t task_id = 0;
+    {
+        TaskScheduler os(nullptr, 2);
+        task_id = os.spawnTask(*graph, start);
+        os.start();
+        EXPECT_TRUE(os.waitForIdle());
+    }
+    tracer.setEnabled(false);
+    tracer.stopDrainer();
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(readTraceFile(trace_path, records));
+    bool saw_add = false;
+    for (const auto& r : records) {
+        if (r.node_id == add && r.task_id == task_id) {
+            saw_add = true;
+            EXPECT_EQ(r.opcode, static_cast<uint16_t>(BDIOperationType::ARITH_ADD));
+        }
+    }
+    EXPECT_TRUE(saw_add);
+    std::ostringstream json;
+    writeChromeTrace(records, json);
+    EXPECT_NE(json.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"node\":" + std::to_string(add)), std::string::npos);
+    std::string json_path = tempPath("bdi_trace.json");
+    EXPECT_TRUE(convertTraceFileToChromeJson(trace_path, json_path));
+    std::remove(trace_path.c_str());
+    std::remove(json_path.c_str());
+}
@@ -0,0 +1,224 @@
+#include "gtest.h"
+#include "VectorKernels.hpp"
+#include "VectorOps.hpp"
+#include "VMCheckedOperations.hpp"
+#include "ScalarKernels.hpp"
+#include "StateCodec.hpp"
+#include "TaskScheduler.hpp"
+#include "MemoryManager.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+using namespace bdi::runtime;
+using namespace bdi::runtime::simd;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+template <typename T>
+static PackedVector makeVector(BDIType type, const std::vector<T>& lanes) {
+    PackedVector vector = PackedVector::allocate(type, lanes.size());
+    std::memcpy(vector.mutableData(), lanes.data(), lanes.size() * sizeof(T));
+    return vector;
+}
+template <typename T>
+static std::vector<T> lanesOf(VectorRef vector) {
+    return std::vector<T>(vector.lanes<T>(), vector.lanes<T>() + vector.getLaneCount());
+}
+static std::vector<SimdLevel> availableLevels() {
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        if (vectorKernelsFor(level)) levels.push_back(level);
+    }
+    return levels;
+}
+// --- Kernels ---
+TEST(VectorKernelsTest, EveryLevelMatchesTheScalarLoops) {
+    const VectorKernels& reference = *vectorKernelsFor(SimdLevel::SCALAR);
+    EXPECT_EQ(vectorKernels().level, detectSimdLevel());
+    const size_t widths[] = {1, 2, 4, 8, 4, 8}; // By LaneKind
+    std::mt19937 rng(7);
+    for (SimdLevel level : availableLevels()) {
+        const VectorKernels& kernels = *vectorKernelsFor(level);
+        for (size_t n : {0, 1, 3, 15, 16, 17, 63, 64, 65, 200}) {
+            for (size_t kind = 0; kind < LANE_KIND_COUNT; ++kind) {
+                const size_t bytes = n * widths[kind];
+                std::vector<uint8_t> a(bytes), b(bytes), expected(bytes), actual(bytes);
+                for (size_t i = 0; i < bytes; ++i) {
+                    a[i] = static_cast<uint8_t>(rng());
+                    b[i] = static_cast<uint8_t>(rng());
+                }
+                if (kind >= static_cast<size_t>(LaneKind::F32)) { // Small finite floats, so results are exact
+                    for (size_t i = 0; i < n; ++i) {
+                        if (kind == static_cast<size_t>(LaneKind::F32)) {
+                            reinterpret_cast<float*>(a.data())[i] = static_cast<float>(rng() % 1000) / 8;
+                            reinterpret_cast<float*>(b.data())[i] = static_cast<float>(rng() % 1000) / 8;
+                        } else {
+                            reinterpret_cast<double*>(a.data())[i] = static_cast<double>(rng() % 1000) / 8;
+                            reinterpret_cast<double*>(b.data())[i] = static_cast<double>(rng() % 1000) / 8;
+                        }
+                    }
+                }
+                reference.add[kind](a.data(), b.data(), expected.data(), n);
+                kernels.add[kind](a.data(), b.data(), actual.data(), n);
+                EXPECT_EQ(actual, expected) << toString(level) << " add, kind " << kind << ", n " << n;
+                reference.mul[kind](a.data(), b.data(), expected.data(), n);
+                kernels.mul[kind](a.data(), b.data(), actual.data(), n);
+                EXPECT_EQ(actual, expected) << toString(level) << " mul, kind " << kind << ", n " << n;
+            }
+            for (size_t size_class = 0; size_class < 4; ++size_class) {
+                const size_t width = size_t{1} << size_class;
+                std::vector<uint8_t> source(37 * width);
+                for (auto& byte : source) byte = static_cast<uint8_t>(rng());
+                std::vector<int32_t> indices(n);
+                for (auto& index : indices) index = static_cast<int32_t>(rng() % 37);
+                std::vector<uint8_t> expected(n * width), actual(n * width);
+                reference.gather[size_class](source.data(), indices.data(), expected.data(), n);
+                kernels.gather[size_class](source.data(), indices.data(), actual.data(), n);
+                EXPECT_EQ(actual, expected) << toString(level) << " gather, width " << width << ", n " << n;
+            }
+        }
+    }
+}
+TEST(VectorKernelsTest, ScalarLoopsWrapIntegers) {
+    uint16_t a = 300, b = 300, out = 0;
+    scalar::mul(&a, &b, &out, 1);
+    EXPECT_EQ(out, static_cast<uint16_t>(90000));
+    uint8_t x = 200, y = 100, sum = 0;
+    scalar::add(&x, &y, &sum, 1);
+    EXPECT_EQ(sum, 44);
+}
+// --- Ops ---
+TEST(VectorOpsTest, LoadComputeStoreThroughMemory) {
+    MemoryManager memory(2 * MemoryManager::PAGE_SIZE);
+    std::vector<int32_t> input = {1, -2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+    ASSERT_TRUE(memory.writeMemory(100, reinterpret_cast<const std::byte*>(input.data()), input.size() * sizeof(int32_t)));
+    memory.takeDirtyPages();
+    auto loaded = vm_ops::tryVectorLoad(&memory, 100, input.size(), BDIType::INT32);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(lanesOf<int32_t>(loaded.value().ref()), input);
+    auto scaled = vm_ops::tryVectorMultiply(loaded.value().ref(), int64_t{3}); // Scalar broadcast, converted to INT32
+    ASSERT_TRUE(scaled);
+    auto sum = vm_ops::tryVectorAdd(scaled.value().ref(), loaded.value().ref());
+    ASSERT_TRUE(sum);
+    ASSERT_EQ(vm_ops::tryVectorStore(&memory, MemoryManager::PAGE_SIZE, sum.value().ref()), VMStatus::OK);
+    EXPECT_EQ(memory.takeDirtyPages(), (std::vector<size_t>{1}));
+    std::vector<int32_t> stored(input.size());
+    ASSERT_TRUE(memory.readMemory(MemoryManager::PAGE_SIZE, reinterpret_cast<std::byte*>(stored.data()), stored.size() * sizeof(int32_t)));
+    for (size_t i = 0; i < input.size(); ++i) EXPECT_EQ(stored[i], input[i] * 4);
+    EXPECT_EQ(lanesOf<int32_t>(loaded.value().ref()), input); // Kernels never write into their operands
+    EXPECT_EQ(vm_ops::tryVectorLoad(&memory, 2 * MemoryManager::PAGE_SIZE - 8, 4, BDIType::INT32).error(), VMStatus::MEMORY_FAULT);
+    EXPECT_EQ(vm_ops::tryVectorLoad(&memory, 0, 4, BDIType::BOOL).error(), VMStatus::TYPE_MISMATCH);
+    EXPECT_EQ(vm_ops::tryVectorLoad(&memory, 0, 0, BDIType::INT32).error(), VMStatus::OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryVectorLoad(nullptr, 0, 4, BDIType::INT32).error(), VMStatus::NO_MEMORY_MANAGER);
+}
+TEST(VectorOpsTest, OperandsMustAgree) {
+    HeldValue f = makeVector<float>(BDIType::FLOAT32, {1, 2, 3});
+    HeldValue d = makeVector<double>(BDIType::FLOAT64, {1, 2, 3});
+    HeldValue shorter = makeVector<float>(BDIType::FLOAT32, {1, 2});
+    EXPECT_EQ(vm_ops::tryVectorAdd(f, d).error(), VMStatus::TYPE_MISMATCH);
+    EXPECT_EQ(vm_ops::tryVectorAdd(f, shorter).error(), VMStatus::TYPE_MISMATCH);
+    EXPECT_EQ(vm_ops::tryVectorAdd(int32_t{1}, int32_t{2}).error(), VMStatus::TYPE_MISMATCH); // Scalars use ARITH_ADD
+    EXPECT_EQ(vm_ops::tryVectorAdd(f, BDIValueVariant{}).error(), VMStatus::VOID_OPERAND);
+    EXPECT_EQ(vm_ops::tryAddition(f, f).error(), VMStatus::TYPE_MISMATCH); // Scalar ops reject vectors
+    EXPECT_EQ(vm_ops::tryConvert<int32_t>(f).error(), VMStatus::TYPE_MISMATCH);
+    EXPECT_EQ(lanesOf<float>(vm_ops::tryVectorMultiply(0.5, f).value().ref()), (std::vector<float>{0.5f, 1, 1.5f}));
+}
+TEST(VectorOpsTest, ShuffleSelectsFromOneOrTwoSources) {
+    HeldValue a = makeVector<uint64_t>(BDIType::UINT64, {10, 11, 12, 13});
+    HeldValue b = makeVector<uint64_t>(BDIType::UINT64, {20, 21});
+    HeldValue reverse = makeVector<int32_t>(BDIType::INT32, {3, 2, 1, 0, 0});
+    HeldValue interleave = makeVector<int32_t>(BDIType::INT32, {0, 4, 1, 5});
+    HeldValue minus_one = makeVector<int32_t>(BDIType::INT32, {-1});
+    HeldValue float_zero = makeVector<float>(BDIType::FLOAT32, {0});
+    std::vector<BDIValueVariant> one = {a, reverse};
+    EXPECT_EQ(lanesOf<uint64_t>(vm_ops::tryVectorShuffle(one).value().ref()), (std::vector<uint64_t>{13, 12, 11, 10, 10}));
+    std::vector<BDIValueVariant> two = {a, b, interleave};
+    EXPECT_EQ(lanesOf<uint64_t>(vm_ops::tryVectorShuffle(two).value().ref()), (std::vector<uint64_t>{10, 20, 11, 21}));
+    std::vector<BDIValueVariant> out_of_range = {b, interleave};
+    EXPECT_EQ(vm_ops::tryVectorShuffle(out_of_range).error(), VMStatus::OUT_OF_RANGE);
+    std::vector<BDIValueVariant> negative = {a, minus_one};
+    EXPECT_EQ(vm_ops::tryVectorShuffle(negative).error(), VMStatus::OUT_OF_RANGE);
+    std::vector<BDIValueVariant> float_indices = {a, float_zero};
+    EXPECT_EQ(vm_ops::tryVectorShuffle(float_indices).error(), VMStatus::TYPE_MISMATCH);
+}
+TEST(VectorOpsTest, StateCodecRoundTripsVectors) {
+    state_codec::ByteWriter writer;
+    writer.putValue(makeVector<int16_t>(BDIType::INT16, {1, -2, 3}).ref());
+    writer.putValue(int32_t{42});
+    state_codec::ByteReader reader(writer.buffer());
+    BDIValueVariant vector, scalar;
+    ASSERT_TRUE(reader.getValue(vector));
+    ASSERT_TRUE(reader.getValue(scalar));
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(lanesOf<int16_t>(std::get<VectorRef>(vector)), (std::vector<int16_t>{1, -2, 3})); // Owned by the reader
+    EXPECT_EQ(std::get<int32_t>(scalar), 42);
+    std::vector<std::byte> truncated(writer.buffer().begin(), writer.buffer().begin() + 12); // Header and half the lanes
+    state_codec::ByteReader short_reader(truncated);
+    EXPECT_FALSE(short_reader.getValue(vector));
+}
+// --- Tasks ---
+TEST(VectorOpsTest, GainAndMixGraphRunsInATask) {
+    // out[i] = in_a[i] * gain + in_b[i], 1000 FLOAT32 samples at a time
+    constexpr uint64_t kLanes = 1000, kA = 0, kB = 4096, kOut = 8192;
+    GraphBuilder builder("GainMix");
+    auto constant = [&](TypedPayload payload) {
+        NodeID id = builder.addNode(BDIOperationType::META_CONST);
+        builder.setNodePayload(id, payload);
+        builder.defineDataOutput(id, 0, payload.type);
+        return id;
+    };
+    auto load = [&](NodeID address, NodeID lanes) {
+        NodeID id = builder.addNode(BDIOperationType::VEC_LOAD_PACKED);
+        builder.defineDataOutput(id, 0, BDIType::FLOAT32); // Element type
+        builder.connectData(address, 0, id, 0);
+        builder.connectData(lanes, 0, id, 1);
+        return id;
+    };
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID lanes = constant(TypedPayload::createFrom(kLanes));
+    NodeID a = load(constant(TypedPayload::createFrom(kA)), lanes);
+    NodeID b = load(constant(TypedPayload::createFrom(kB)), lanes);
+    NodeID gain = constant(TypedPayload::createFrom(0.25f));
+    NodeID scaled = builder.addNode(BDIOperationType::VEC_MUL);
+    builder.defineDataOutput(scaled, 0, BDIType::FLOAT32);
+    builder.connectData(a, 0, scaled, 0);
+    builder.connectData(gain, 0, scaled, 1);
+    NodeID mixed = builder.addNode(BDIOperationType::VEC_ADD);
+    builder.defineDataOutput(mixed, 0, BDIType::FLOAT32);
+    builder.connectData(scaled, 0, mixed, 0);
+    builder.connectData(b, 0, mixed, 1);
+    NodeID store = builder.addNode(BDIOperationType::VEC_STORE_PACKED);
+    builder.connectData(constant(TypedPayload::createFrom(kOut)), 0, store, 0);
+    builder.connectData(mixed, 0, store, 1);
+    NodeID end = builder.addNode(BDIOperationType::META_END);
+    builder.connectControl(start, a);
+    builder.connectControl(a, b);
+    builder.connectControl(b, scaled);
+    builder.connectControl(scaled, mixed);
+    builder.connectControl(mixed, store);
+    builder.connectControl(store, end);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    MemoryManager memory(4 * MemoryManager::PAGE_SIZE);
+    std::vector<float> in_a(kLanes), in_b(kLanes);
+    for (size_t i = 0; i < kLanes; ++i) {
+        in_a[i] = static_cast<float>(i);
+        in_b[i] = 1.0f;
+    }
+    memory.writeMemory(kA, reinterpret_cast<const std::byte*>(in_a.data()), kLanes * sizeof(float));
+    memory.writeMemory(kB, reinterpret_cast<const std::byte*>(in_b.data()), kLanes * sizeof(float));
+    TaskScheduler os(&memory, 1);
+    uint64_t id = os.spawnTask(*graph, start);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    os.stop();
+    ASSERT_EQ(os.getTaskStatus(id), TaskStatus::COMPLETED) << os.getTaskError(id);
+    std::vector<float> out(kLanes);
+    memory.readMemory(kOut, reinterpret_cast<std::byte*>(out.data()), kLanes * sizeof(float));
+    for (size_t i = 0; i < kLanes; ++i) ASSERT_EQ(out[i], static_cast<float>(i) * 0.25f + 1.0f) << i;
+}
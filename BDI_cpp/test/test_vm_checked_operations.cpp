@@ -0,0 +1,110 @@
+#include "gtest.h"
+#include "VMCheckedOperations.hpp"
+#include "NodeEvaluator.hpp"
+#include "TaskScheduler.hpp"
+#include "GraphBuilder.hpp"
+#include "BDITypes.hpp"
+#include "TypedPayload.hpp"
+#if BDI_VM_EXCEPTIONS
+#include "VMTypeOperations.hpp"
+#include "TestGraphHelpers.hpp"
+#endif
+#include <cmath>
+#include <limits>
+using namespace bdi::runtime;
+using namespace bdi::frontend::api;
+using namespace bdi::core::graph;
+using namespace bdi::core::types;
+using namespace bdi::core::payload;
+// --- Helpers --
+static BDINode makeNode(NodeID id, BDIOperationType op, BDIType output = BDIType::VOID) {
+    BDINode node(id, op);
+    if (output != BDIType::VOID) node.data_outputs.push_back({output});
+    return node;
+}
+// --- Tests ---
+TEST(VMCheckedOperationsTest, ArithmeticPromotesAndWraps) {
+    auto sum = vm_ops::tryAddition(int32_t{2}, int64_t{40});
+    ASSERT_TRUE(sum);
+    EXPECT_EQ(std::get<int64_t>(*sum), 42);
+    auto wrapped = vm_ops::tryAddition(std::numeric_limits<int32_t>::max(), int32_t{1});
+    ASSERT_TRUE(wrapped);
+    EXPECT_EQ(std::get<int32_t>(*wrapped), std::numeric_limits<int32_t>::min());
+    auto product = vm_ops::tryMultiplication(1.5, 2.0f);
+    ASSERT_TRUE(product);
+    EXPECT_DOUBLE_EQ(std::get<double>(*product), 3.0);
+}
+TEST(VMCheckedOperationsTest, FaultsComeBackAsStatus) {
+    EXPECT_EQ(vm_ops::tryDivision(int32_t{1}, int32_t{0}).error(), VMStatus::DIVISION_BY_ZERO);
+    EXPECT_EQ(vm_ops::tryModulo(uint64_t{1}, uint64_t{0}).error(), VMStatus::DIVISION_BY_ZERO);
+    EXPECT_EQ(vm_ops::tryBitwiseSHL(uint32_t{1}, int32_t{32}).error(), VMStatus::SHIFT_OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryBitwiseSHR(uint32_t{1}, int32_t{-1}).error(), VMStatus::SHIFT_OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryAddition(std::monostate{}, int32_t{1}).error(), VMStatus::VOID_OPERAND);
+    EXPECT_EQ(vm_ops::tryAddition(true, int32_t{1}).error(), VMStatus::TYPE_MISMATCH);
+    EXPECT_EQ(vm_ops::tryBitwiseAND(1.0, int32_t{1}).error(), VMStatus::TYPE_MISMATCH);
+    auto shifted = vm_ops::tryBitwiseASHR(int8_t{-8}, int32_t{1});
+    ASSERT_TRUE(shifted);
+    EXPECT_EQ(std::get<int8_t>(*shifted), -4);
+}
+TEST(VMCheckedOperationsTest, ConversionsAreRangeChecked) {
+    EXPECT_EQ(vm_ops::tryConvert<int8_t>(int32_t{300}).error(), VMStatus::OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryConvert<uint32_t>(int64_t{-1}).error(), VMStatus::OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryConvert<int32_t>(std::nan("")).error(), VMStatus::OUT_OF_RANGE);
+    EXPECT_EQ(vm_ops::tryConvert<int32_t>(3.9).value_or(0), 3);
+    EXPECT_EQ(vm_ops::tryConvert<bool>(uint8_t{2}).value_or(false), true);
+    auto as_float = vm_ops::tryConversion(int64_t{7}, BDIType::FLOAT32);
+    ASSERT_TRUE(as_float);
+    EXPECT_FLOAT_EQ(std::get<float>(*as_float), 7.0f);
+    auto bits = vm_ops::tryBitcast(1.0f, BDIType::UINT32);
+    ASSERT_TRUE(bits);
+    EXPECT_EQ(std::get<uint32_t>(*bits), 0x3F800000u);
+    EXPECT_EQ(vm_ops::tryBitcast(1.0f, BDIType::UINT64).error(), VMStatus::TYPE_MISMATCH);
+}
+TEST(VMCheckedOperationsTest, EvaluatorFillsErrorInfo) {
+    HeldValue result;
+    VMErrorInfo error;
+    BDINode div = makeNode(11, BDIOperationType::ARITH_DIV, BDIType::INT32);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(div, {int32_t{6}, int32_t{0}}, nullptr, result, &error), VMStatus::DIVISION_BY_ZERO);
+    EXPECT_EQ(error.node_id, 11u);
+    EXPECT_NE(error.describe().find("node 11: division by zero"), std::string::npos);
+    EXPECT_NE(error.message().find("ARITH_DIV"), std::string::npos);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(div, {int32_t{6}}, nullptr, result, &error), VMStatus::ARITY);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(div, {int32_t{6}, int32_t{3}}, nullptr, result, &error), VMStatus::OK);
+    EXPECT_EQ(std::get<int32_t>(result.get()), 2);
+    BDINode load = makeNode(12, BDIOperationType::MEM_LOAD, BDIType::INT32);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(load, {uint64_t{0}}, nullptr, result, &error), VMStatus::NO_MEMORY_MANAGER);
+    BDINode yield = makeNode(13, BDIOperationType::SYS_YIELD);
+    EXPECT_EQ(NodeEvaluator::tryEvaluate(yield, {}, nullptr, result, &error), VMStatus::UNSUPPORTED_OP);
+    EXPECT_EQ(error.node_id, 13u);
+}
+TEST(VMCheckedOperationsTest, TaskFaultIsKeptOnContext) {
+    GraphBuilder builder("CheckedFault");
+    NodeID start = builder.addNode(BDIOperationType::META_START);
+    NodeID one = addConst(builder, TypedPayload::createFrom(int32_t{1}));
+    NodeID width = addConst(builder, TypedPayload::createFrom(int32_t{40}));
+    NodeID shl = builder.addNode(BDIOperationType::BIT_SHL);
+    builder.defineDataOutput(shl, 0, BDIType::INT32);
+    builder.connectData(one, 0, shl, 0);
+    builder.connectData(width, 0, shl, 1);
+    builder.connectControl(start, shl);
+    auto graph = builder.finalizeGraph();
+    ASSERT_NE(graph, nullptr);
+    TaskScheduler os(nullptr, 1);
+    uint64_t task = os.spawnTask(*graph, start);
+    os.start();
+    EXPECT_TRUE(os.waitForIdle());
+    EXPECT_EQ(os.getTaskStatus(task), TaskStatus::FAULTED);
+    EXPECT_NE(os.getTaskError(task).find("shift amount out of range"), std::string::npos);
+    const ExecutionContext* ctx = os.getTaskContext(task);
+    ASSERT_NE(ctx, nullptr);
+    EXPECT_EQ(ctx->getLastError().status, VMStatus::SHIFT_OUT_OF_RANGE);
+    EXPECT_EQ(ctx->getLastError().node_id, shl);
+}
+#if BDI_VM_EXCEPTIONS
+TEST(VMCheckedOperationsTest, ThrowingWrapperStillThrows) {
+    HeldValue result;
+    BDINode div = makeNode(21, BDIOperationType::ARITH_DIV, BDIType::INT32);
+    EXPECT_THROW(NodeEvaluator::evaluate(div, {int32_t{1}, int32_t{0}}, nullptr, result), vm_ops::BDIExecutionError);
+    EXPECT_FALSE(NodeEvaluator::evaluate(makeNode(22, BDIOperationType::SYS_YIELD), {}, nullptr, result));
+}
+#endif